@@ -12,6 +12,7 @@ set(SCRIPT_SYSTEM_SOURCES
 	${SOURCE_DIR}/corepp/mem_tempalloc.cpp
 	${SOURCE_DIR}/corepp/script.cpp
 	${SOURCE_DIR}/corepp/str.cpp
+	${SOURCE_DIR}/corepp/weakref.cpp
 	${SOURCE_DIR}/script/scriptexception.cpp
 	${SOURCE_DIR}/script/scriptvariable.cpp
 )
@@ -1,3 +1,16 @@
 enable_testing()
 
 include(tests/lz77)
+include(tests/con_timer)
+include(tests/con_set)
+include(tests/weakref)
+include(tests/entitygrid)
+include(tests/jobs)
+include(tests/msg)
+include(tests/cm_brush)
+include(tests/skeletor_frames)
+include(tests/skin)
+include(tests/memory)
+include(tests/cmd)
+include(tests/listener)
+include(tests/tempalloc)
@@ -0,0 +1,25 @@
+#
+# Unit tests
+#
+
+add_executable(test_cm_brush
+    ${SOURCE_DIR}/corepp/tests/test_cm_brush.cpp
+    ${SOURCE_DIR}/qcommon/cm_fencemask.c
+    ${SOURCE_DIR}/qcommon/cm_load.c
+    ${SOURCE_DIR}/qcommon/cm_patch.c
+    ${SOURCE_DIR}/qcommon/cm_polylib.c
+    ${SOURCE_DIR}/qcommon/cm_terrain.c
+    ${SOURCE_DIR}/qcommon/cm_test.c
+    ${SOURCE_DIR}/qcommon/cm_trace.c
+    ${SOURCE_DIR}/qcommon/cm_trace_obfuscation.cpp
+    ${SOURCE_DIR}/qcommon/jobs.cpp
+    ${SOURCE_DIR}/qcommon/q_math.c
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/common_light.c
+)
+
+# the collision code is built like in the server, without the client renderer
+target_compile_definitions(test_cm_brush PRIVATE APP_MODULE DEDICATED)
+target_link_libraries(test_cm_brush INTERFACE testing)
+add_test(NAME test_cm_brush COMMAND test_cm_brush)
+set_tests_properties(test_cm_brush PROPERTIES TIMEOUT 15)
@@ -0,0 +1,17 @@
+#
+# Unit tests
+#
+
+add_executable(test_cmd
+    ${SOURCE_DIR}/corepp/tests/test_cmd.cpp
+    ${SOURCE_DIR}/qcommon/cmd.c
+    ${SOURCE_DIR}/qcommon/memory.c
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/q_math.c
+)
+
+# the client isn't part of the test
+target_compile_definitions(test_cmd PRIVATE DEDICATED)
+target_link_libraries(test_cmd INTERFACE testing)
+add_test(NAME test_cmd COMMAND test_cmd)
+set_tests_properties(test_cmd PROPERTIES TIMEOUT 15)
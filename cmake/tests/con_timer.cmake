@@ -0,0 +1,16 @@
+#
+# Unit tests
+#
+
+add_executable(test_con_timer
+    ${SOURCE_DIR}/corepp/tests/test_con_timer.cpp
+    ${SOURCE_DIR}/corepp/con_timer.cpp
+    ${SOURCE_DIR}/corepp/con_set.cpp
+    ${SOURCE_DIR}/corepp/mem_blockalloc.cpp
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/common_light.c
+)
+
+target_link_libraries(test_con_timer INTERFACE testing)
+add_test(NAME test_con_timer COMMAND test_con_timer)
+set_tests_properties(test_con_timer PROPERTIES TIMEOUT 15)
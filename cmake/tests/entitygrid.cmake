@@ -0,0 +1,14 @@
+#
+# Unit tests
+#
+
+add_executable(test_entitygrid
+    ${SOURCE_DIR}/corepp/tests/test_entitygrid.cpp
+    ${SOURCE_DIR}/fgame/entitygrid.cpp
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/common_light.c
+)
+
+target_link_libraries(test_entitygrid INTERFACE testing)
+add_test(NAME test_entitygrid COMMAND test_entitygrid)
+set_tests_properties(test_entitygrid PROPERTIES TIMEOUT 15)
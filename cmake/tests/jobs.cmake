@@ -0,0 +1,12 @@
+#
+# Unit tests
+#
+
+add_executable(test_jobs
+    ${SOURCE_DIR}/corepp/tests/test_jobs.cpp
+    ${SOURCE_DIR}/qcommon/jobs.cpp
+)
+
+target_link_libraries(test_jobs INTERFACE testing)
+add_test(NAME test_jobs COMMAND test_jobs)
+set_tests_properties(test_jobs PROPERTIES TIMEOUT 15)
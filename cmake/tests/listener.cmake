@@ -0,0 +1,19 @@
+#
+# Unit tests
+#
+
+include(shared_script)
+
+add_executable(test_listener
+    ${SOURCE_DIR}/corepp/tests/test_listener.cpp
+    ${SCRIPT_SYSTEM_SOURCES}
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/q_math.c
+    ${SOURCE_DIR}/qcommon/common_light.c
+)
+
+# events are timed like in the dedicated server
+target_compile_definitions(test_listener PRIVATE DEDICATED)
+target_link_libraries(test_listener INTERFACE testing)
+add_test(NAME test_listener COMMAND test_listener)
+set_tests_properties(test_listener PROPERTIES TIMEOUT 30)
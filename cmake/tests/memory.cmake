@@ -0,0 +1,16 @@
+#
+# Unit tests
+#
+
+add_executable(test_memory
+    ${SOURCE_DIR}/corepp/tests/test_memory.cpp
+    ${SOURCE_DIR}/qcommon/memory.c
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/q_math.c
+)
+
+# the client renderer isn't part of the test
+target_compile_definitions(test_memory PRIVATE DEDICATED)
+target_link_libraries(test_memory INTERFACE testing)
+add_test(NAME test_memory COMMAND test_memory)
+set_tests_properties(test_memory PROPERTIES TIMEOUT 15)
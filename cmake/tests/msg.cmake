@@ -0,0 +1,16 @@
+#
+# Unit tests
+#
+
+add_executable(test_msg
+    ${SOURCE_DIR}/corepp/tests/test_msg.cpp
+    ${SOURCE_DIR}/qcommon/msg.cpp
+    ${SOURCE_DIR}/qcommon/huffman.cpp
+    ${SOURCE_DIR}/qcommon/q_math.c
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/common_light.c
+)
+
+target_link_libraries(test_msg INTERFACE testing)
+add_test(NAME test_msg COMMAND test_msg)
+set_tests_properties(test_msg PROPERTIES TIMEOUT 15)
@@ -0,0 +1,14 @@
+#
+# Unit tests
+#
+
+add_executable(test_skeletor_frames
+    ${SOURCE_DIR}/corepp/tests/test_skeletor_frames.cpp
+    ${SOURCE_DIR}/qcommon/q_math.c
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/common_light.c
+)
+
+target_link_libraries(test_skeletor_frames INTERFACE testing)
+add_test(NAME test_skeletor_frames COMMAND test_skeletor_frames)
+set_tests_properties(test_skeletor_frames PROPERTIES TIMEOUT 15)
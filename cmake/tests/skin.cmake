@@ -0,0 +1,15 @@
+#
+# Unit tests
+#
+
+add_executable(test_skin
+    ${SOURCE_DIR}/corepp/tests/test_skin.cpp
+    ${SOURCE_DIR}/renderercommon/tr_skin.c
+    ${SOURCE_DIR}/qcommon/q_math.c
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/common_light.c
+)
+
+target_link_libraries(test_skin INTERFACE testing)
+add_test(NAME test_skin COMMAND test_skin)
+set_tests_properties(test_skin PROPERTIES TIMEOUT 15)
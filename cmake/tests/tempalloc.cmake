@@ -0,0 +1,18 @@
+#
+# Unit tests
+#
+
+add_executable(test_tempalloc
+    ${SOURCE_DIR}/corepp/tests/test_tempalloc.cpp
+    ${SOURCE_DIR}/corepp/mem_tempalloc.cpp
+    ${SOURCE_DIR}/qcommon/memory.c
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/q_math.c
+)
+
+# the client renderer isn't part of the test
+target_compile_definitions(test_tempalloc PRIVATE DEDICATED)
+target_include_directories(test_tempalloc PRIVATE ${SOURCE_DIR}/qcommon)
+target_link_libraries(test_tempalloc INTERFACE testing)
+add_test(NAME test_tempalloc COMMAND test_tempalloc)
+set_tests_properties(test_tempalloc PROPERTIES TIMEOUT 15)
@@ -0,0 +1,15 @@
+#
+# Unit tests
+#
+
+add_executable(test_weakref
+    ${SOURCE_DIR}/corepp/tests/test_weakref.cpp
+    ${SOURCE_DIR}/corepp/weakref.cpp
+    ${SOURCE_DIR}/corepp/mem_blockalloc.cpp
+    ${SOURCE_DIR}/qcommon/q_shared.c
+    ${SOURCE_DIR}/qcommon/common_light.c
+)
+
+target_link_libraries(test_weakref INTERFACE testing)
+add_test(NAME test_weakref COMMAND test_weakref)
+set_tests_properties(test_weakref PROPERTIES TIMEOUT 15)
@@ -238,12 +238,14 @@ void CLASS_Print(fileHandle_t class_file, const char *fmt, ...)
 
 Class::Class()
 {
-    SafePtrList = NULL;
+    SafePtrList  = NULL;
+    weakRefIndex = 0;
 }
 
 Class::~Class()
 {
     ClearSafePointers();
+    ClearWeakRefs();
 }
 
 void Class::Archive(Archiver& arc) {}
@@ -255,6 +257,30 @@ void Class::ClearSafePointers(void)
     }
 }
 
+void Class::ClearWeakRefs(void)
+{
+    if (weakRefIndex) {
+        // all the weak references become NULL at once
+        WeakRefTable::FreeSlot(weakRefIndex);
+        weakRefIndex = 0;
+    }
+}
+
+void WeakRefBase::InitWeakRef(Class *newptr)
+{
+    if (!newptr) {
+        Clear();
+        return;
+    }
+
+    if (!newptr->weakRefIndex) {
+        newptr->weakRefIndex = WeakRefTable::AllocSlot(newptr);
+    }
+
+    index      = newptr->weakRefIndex;
+    generation = WeakRefTable::Generation(index);
+}
+
 void Class::warning(const char *function, const char *format, ...) const
 {
     char        buffer[MAX_STRING_CHARS];
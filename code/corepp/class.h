@@ -270,13 +270,16 @@ void      listAllClasses(void);
 void      listInheritanceOrder(const char *classname);
 
 class SafePtrBase;
+class WeakRefBase;
 class Archiver;
 
 class Class : public LightClass
 {
 private:
     friend class SafePtrBase;
+    friend class WeakRefBase;
     SafePtrBase *SafePtrList;
+    unsigned int weakRefIndex; // slot of the weak references, 0 if none
 
 public:
     static ClassDef           ClassInfo;
@@ -285,6 +288,7 @@ public:
 
 protected:
     void ClearSafePointers();
+    void ClearWeakRefs();
 
 public:
     Class();
@@ -309,3 +313,4 @@ public:
 };
 
 #include "safeptr.h"
+#include "weakref.h"
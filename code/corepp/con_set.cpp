@@ -45,13 +45,19 @@ int HashCode<const char *>(const char *const& key)
 template<>
 int HashCode<void *>(void *const& key)
 {
-    return 0;
+    return (int)(size_t)key;
 }
 
 template<>
 int HashCode<const void *>(const void *const& key)
 {
-    return 0;
+    return (int)(size_t)key;
+}
+
+template<>
+int HashCode<Class *>(Class *const& key)
+{
+    return (int)(size_t)key;
 }
 
 template<>
@@ -20,7 +20,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 ===========================================================================
 */
 
-// con_set.h: C++ map/set classes. Contains an hash table to improve the speed of finding a key
+// con_set.h: C++ map/set classes. Contains an open addressing hash table to improve the speed of finding a key
 
 #pragma once
 
@@ -51,6 +51,17 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #    define SET_Free  Z_Free
 #endif
 
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define CON_SET_SSE2
+#    include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#    include <intrin.h>
+#endif
+
 class Class;
 class Archiver;
 
@@ -89,8 +100,7 @@ class con_set_Entry
     friend con_set_enum<k, v>;
 
 private:
-    con_set_Entry *next;
-    k              key;
+    k key;
 
 public:
     v value;
@@ -103,7 +113,6 @@ public:
     con_set_Entry()
         : key(k())
         , value(v())
-        , next(NULL)
     {}
 
 #ifdef ARCHIVE_SUPPORTED
@@ -114,6 +123,161 @@ public:
     void SetKey(const k& newKey) { key = newKey; }
 };
 
+//
+// The table is open addressed and made of groups of slots.
+// Each slot has a control byte: empty, deleted, or the low 7 bits
+// of the hash of the key in the slot. The control bytes are kept apart
+// from the slots so they stay in the cache, and the control bytes
+// of a group are compared all at once, so a slot is only read
+// when its key very likely matches.
+// Small keys that can be copied as is are also kept in the slots,
+// the entries are only read once found.
+// The entries are allocated apart and never move,
+// the values can be pointed to and removed while enumerating.
+//
+#define CON_SET_GROUP_SIZE 8
+
+#define CON_SET_EMPTY   0x80
+#define CON_SET_DELETED 0xFE
+
+// a slot is at most two pointers, so the slots of a group
+// fill at most two cache lines and don't straddle another one
+#define CON_SET_TABLE_ALIGN 64
+
+template<typename k, typename v, bool inlineKey = std::is_trivially_copyable<k>::value && sizeof(k) <= sizeof(void *)>
+struct con_set_Slot {
+    con_set_Entry<k, v> *entry;
+
+    k& GetKey() const { return entry->GetKey(); }
+
+    void SetKey(const k& newKey) {}
+};
+
+template<typename k, typename v>
+struct con_set_Slot<k, v, true> {
+    k                    key;
+    con_set_Entry<k, v> *entry;
+
+    const k& GetKey() const { return key; }
+
+    void SetKey(const k& newKey) { key = newKey; }
+};
+
+#ifdef CON_SET_SSE2
+
+typedef __m128i con_set_control_t;
+
+// only the low 8 bytes are loaded, the others are zero
+#    define CON_SET_SLOTS_MASK 0xFF
+
+static inline con_set_control_t con_set_LoadControl(const unsigned char *control)
+{
+    return _mm_loadl_epi64((const __m128i *)control);
+}
+
+// Returns a mask of the slots that may hold the hash
+static inline unsigned int con_set_MatchHash(con_set_control_t control, unsigned int hash)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)(hash & 0x7F)))) & CON_SET_SLOTS_MASK;
+}
+
+static inline unsigned int con_set_MatchEmpty(con_set_control_t control)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)CON_SET_EMPTY))) & CON_SET_SLOTS_MASK;
+}
+
+// Returns a mask of the empty or deleted slots
+static inline unsigned int con_set_MatchFree(con_set_control_t control)
+{
+    return _mm_movemask_epi8(control) & CON_SET_SLOTS_MASK;
+}
+
+static inline unsigned int con_set_LowestSlot(unsigned int mask)
+{
+#    ifdef _MSC_VER
+    unsigned long index;
+
+    _BitScanForward(&index, mask);
+    return index;
+#    else
+    return __builtin_ctz(mask);
+#    endif
+}
+
+#else
+
+//
+// Without SSE2, the control bytes are compared as a 64-bit word,
+// the masks have the high bit of the bytes set
+//
+typedef uint64_t con_set_control_t;
+
+#    define CON_SET_LSB 0x0101010101010101ull
+#    define CON_SET_MSB 0x8080808080808080ull
+
+static inline con_set_control_t con_set_LoadControl(const unsigned char *control)
+{
+    uint64_t word;
+
+    memcpy(&word, control, sizeof(word));
+#    ifdef Q3_BIG_ENDIAN
+    word = __builtin_bswap64(word);
+#    endif
+
+    return word;
+}
+
+// Returns a mask of the slots that may hold the hash,
+// there can be a false positive but only on a slot in use
+static inline uint64_t con_set_MatchHash(con_set_control_t control, unsigned int hash)
+{
+    const uint64_t x = control ^ (CON_SET_LSB * (hash & 0x7F));
+
+    return (x - CON_SET_LSB) & ~x & CON_SET_MSB;
+}
+
+static inline uint64_t con_set_MatchEmpty(con_set_control_t control)
+{
+    return control & ~(control << 6) & CON_SET_MSB;
+}
+
+// Returns a mask of the empty or deleted slots
+static inline uint64_t con_set_MatchFree(con_set_control_t control)
+{
+    return control & ~(control << 7) & CON_SET_MSB;
+}
+
+static inline unsigned int con_set_LowestSlot(uint64_t mask)
+{
+#    ifdef _MSC_VER
+    unsigned long index;
+
+    _BitScanForward64(&index, mask);
+    return index >> 3;
+#    else
+    return __builtin_ctzll(mask) >> 3;
+#    endif
+}
+
+#endif
+
+static inline void con_set_Prefetch(const void *ptr)
+{
+#if defined(_MSC_VER) && defined(CON_SET_SSE2)
+    _mm_prefetch((const char *)ptr, _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(ptr);
+#endif
+}
+
+// A lot of keys hash to themselves, spread them over all the bits
+static inline unsigned int con_set_MixHash(int hash)
+{
+    const unsigned int h = (unsigned int)hash * 0x9E3779B1u;
+
+    return h ^ (h >> 15);
+}
+
 template<typename k, typename v>
 class con_set
 {
@@ -121,22 +285,28 @@ class con_set
 
 public:
     using Entry = con_set_Entry<k, v>;
+    using Slot  = con_set_Slot<k, v>;
 
 public:
     static MEM_BlockAlloc<Entry> Entry_allocator;
 
 protected:
-    Entry            **table; // hashtable
-    unsigned int       tableLength;
-    unsigned int       threshold;
-    unsigned int       count; // num of entries
-    short unsigned int tableLengthIndex;
-    Entry             *defaultEntry;
+    Slot          *table; // hashtable
+    unsigned char *control; // control byte of each slot
+    unsigned int   tableLength; // num of slots
+    unsigned int   tableMask; // num of groups - 1, a power of two
+    unsigned int   threshold; // num of used slots before growing
+    unsigned int   count; // num of entries
+    unsigned int   numDeleted; // num of deleted slots
 
 protected:
     Entry *findKeyEntry(const k& key) const;
+    Entry *findKeyEntry(const k& key, unsigned int hash) const;
     Entry *addKeyEntry(const k& key);
     Entry *addNewKeyEntry(const k& key);
+    Entry *addNewKeyEntry(const k& key, unsigned int hash);
+    void   insertEntry(Entry *entry, unsigned int hash);
+    void   rehash(unsigned int numGroups);
 
 public:
     static void *NewEntry(size_t size);
@@ -186,29 +356,43 @@ void con_set<k, v>::DeleteEntry(void *entry)
 template<typename k, typename v>
 void *con_set<k, v>::NewTable(size_t count)
 {
-    return SET_Alloc(sizeof(Entry *) * (int)count);
+    void  *memory;
+    void **table;
+
+    // the allocation is kept right before the aligned table,
+    // the control bytes follow the slots
+    memory = SET_Alloc(
+        (sizeof(Slot) + 1) * CON_SET_GROUP_SIZE * (int)count + CON_SET_TABLE_ALIGN + sizeof(void *)
+    );
+    table = (void **)(((size_t)memory + sizeof(void *) + CON_SET_TABLE_ALIGN - 1) & ~(size_t)(CON_SET_TABLE_ALIGN - 1));
+    table[-1] = memory;
+
+    return table;
 }
 
 template<typename k, typename v>
 void con_set<k, v>::DeleteTable(void *table)
 {
-    SET_Free(table);
+    SET_Free(((void **)table)[-1]);
 }
 
 template<typename k>
 int HashCode(const k& key);
 
+// defined in con_set.cpp, so every user of con_map<Class *, ...> hashes the same way
+template<>
+int HashCode<Class *>(Class *const& key);
+
 template<typename key, typename value>
 con_set<key, value>::con_set()
 {
-    tableLength = 1;
-    table       = &defaultEntry;
-
-    threshold        = 1;
-    count            = 0;
-    tableLengthIndex = 0;
-
-    defaultEntry = NULL;
+    table       = NULL;
+    control     = NULL;
+    tableLength = 0;
+    tableMask   = 0;
+    threshold   = 0;
+    count       = 0;
+    numDeleted  = 0;
 }
 
 template<typename key, typename value>
@@ -220,113 +404,202 @@ con_set<key, value>::~con_set()
 template<typename key, typename value>
 void con_set<key, value>::clear()
 {
-    Entry       *entry = NULL;
-    Entry       *next  = NULL;
     unsigned int i;
 
     for (i = 0; i < tableLength; i++) {
-        for (entry = table[i]; entry != NULL; entry = next) {
-            next = entry->next;
-            delete entry;
+        if (!(control[i] & 0x80)) {
+            delete table[i].entry;
         }
     }
 
-    if (tableLength > 1) {
+    if (table) {
         DeleteTable(table);
     }
 
-    tableLength = 1;
-    table       = &defaultEntry;
+    table       = NULL;
+    control     = NULL;
+    tableLength = 0;
+    tableMask   = 0;
+    threshold   = 0;
+    count       = 0;
+    numDeleted  = 0;
+}
 
-    threshold        = 1;
-    count            = 0;
-    tableLengthIndex = 0;
+/*
+====================
+rehash
 
-    defaultEntry = NULL;
+Move the entries to a new table, this also drops the deleted slots
+====================
+*/
+template<typename key, typename value>
+void con_set<key, value>::rehash(unsigned int numGroups)
+{
+    Slot          *oldTable       = table;
+    unsigned char *oldControl     = control;
+    unsigned int   oldTableLength = tableLength;
+    unsigned int   i;
+
+    // allocate a new table
+    tableLength = numGroups * CON_SET_GROUP_SIZE;
+    tableMask   = numGroups - 1;
+    // the control bytes of a whole group are compared at once, so the table can be quite full
+    threshold   = tableLength * 7 / 8;
+    numDeleted  = 0;
+    table       = (Slot *)NewTable(numGroups);
+    control     = (unsigned char *)(table + tableLength);
+
+    memset(control, CON_SET_EMPTY, tableLength);
+
+    // rehash all entries from the old table
+    for (i = 0; i < oldTableLength; i++) {
+        if (!(oldControl[i] & 0x80)) {
+            insertEntry(oldTable[i].entry, con_set_MixHash(HashCode<key>(oldTable[i].GetKey())));
+        }
+    }
+
+    if (oldTable) {
+        // delete the previous table
+        DeleteTable(oldTable);
+    }
 }
 
 template<typename key, typename value>
 void con_set<key, value>::resize(int count)
 {
-    Entry      **oldTable = table;
-    Entry       *e, *old;
-    unsigned int oldTableLength = tableLength;
-    unsigned int i;
-    unsigned int index;
+    unsigned int numGroups = tableMask + 1;
 
     if (count > 0) {
-        tableLength += count;
-        threshold = tableLength;
-    } else {
-        //threshold = ( unsigned int )( ( float )tableLength * 0.75f );
-        threshold = (unsigned int)((float)tableLength * 0.75);
-        if (threshold < 1) {
-            threshold = 1;
+        // make room for that many more entries
+        while ((this->count + count) * 8 > numGroups * CON_SET_GROUP_SIZE * 7) {
+            numGroups *= 2;
         }
 
-        tableLength += threshold;
+        if (numGroups * CON_SET_GROUP_SIZE > tableLength) {
+            rehash(numGroups);
+        }
+    } else if (this->count < threshold / 2) {
+        // mostly deleted slots, they just need to be cleaned up
+        rehash(numGroups);
+    } else {
+        rehash(tableLength ? numGroups * 2 : 1);
     }
+}
 
-    // allocate a new table
-    table = new (NewTable(tableLength)) Entry *[tableLength]();
+/*
+====================
+insertEntry
 
-    // rehash the table
-    for (i = oldTableLength; i > 0; i--) {
-        // rehash all entries from the old table
-        for (e = oldTable[i - 1]; e != NULL; e = old) {
-            old = e->next;
+Put the entry in the first free slot, its key must not be in the table
+====================
+*/
+template<typename k, typename v>
+void con_set<k, v>::insertEntry(Entry *entry, unsigned int hash)
+{
+    unsigned int index;
+    unsigned int probe;
+    unsigned int slot;
 
-            // insert the old entry to the table hashindex
-            index = HashCode<key>(e->GetKey()) % tableLength;
+    index = (hash >> 7) & tableMask;
 
-            e->next      = table[index];
-            table[index] = e;
+    for (probe = 1;; probe++) {
+        auto freeSlots = con_set_MatchFree(con_set_LoadControl(&control[index * CON_SET_GROUP_SIZE]));
+        if (freeSlots) {
+            slot = index * CON_SET_GROUP_SIZE + con_set_LowestSlot(freeSlots);
+
+            if (control[slot] == CON_SET_DELETED) {
+                numDeleted--;
+            }
+
+            control[slot]     = hash & 0x7F;
+            table[slot].entry = entry;
+            table[slot].SetKey(entry->GetKey());
+            return;
         }
-    }
 
-    if (oldTableLength > 1) {
-        // delete the previous table
-        DeleteTable(oldTable);
+        index = (index + probe) & tableMask;
     }
 }
 
 template<typename k, typename v>
 typename con_set<k, v>::Entry *con_set<k, v>::findKeyEntry(const k& key) const
 {
-    Entry *entry;
+    if (!count) {
+        return NULL;
+    }
+
+    return findKeyEntry(key, con_set_MixHash(HashCode<k>(key)));
+}
 
-    entry = table[HashCode<k>(key) % tableLength];
+template<typename k, typename v>
+inline typename con_set<k, v>::Entry *con_set<k, v>::findKeyEntry(const k& key, unsigned int hash) const
+{
+    unsigned int      index;
+    unsigned int      probe;
+    con_set_control_t groupControl;
+    const Slot       *slots;
 
-    for (; entry != NULL; entry = entry->next) {
-        if (entry->GetKey() == key) {
-            return entry;
-        }
+    if (!tableLength) {
+        return NULL;
     }
 
-    return NULL;
+    index = (hash >> 7) & tableMask;
+
+    // the table is never full so there is always an empty slot to stop at
+    for (probe = 1;; probe++) {
+        slots = &table[index * CON_SET_GROUP_SIZE];
+
+        // load the slots along with the control bytes rather than after them
+        con_set_Prefetch(slots);
+        if (sizeof(Slot) * CON_SET_GROUP_SIZE > CON_SET_TABLE_ALIGN) {
+            con_set_Prefetch(slots + CON_SET_GROUP_SIZE / 2);
+        }
+
+        groupControl = con_set_LoadControl(&control[index * CON_SET_GROUP_SIZE]);
+
+        for (auto match = con_set_MatchHash(groupControl, hash); match; match &= match - 1) {
+            const Slot& slot = slots[con_set_LowestSlot(match)];
+
+            if (slot.GetKey() == key) {
+                return slot.entry;
+            }
+        }
+
+        if (con_set_MatchEmpty(groupControl)) {
+            return NULL;
+        }
+
+        index = (index + probe) & tableMask;
+    }
 }
 
 template<typename k, typename v>
 typename con_set<k, v>::Entry *con_set<k, v>::addKeyEntry(const k& key)
 {
-    Entry *entry;
+    Entry             *entry;
+    const unsigned int hash = con_set_MixHash(HashCode<k>(key));
 
-    entry = findKeyEntry(key);
+    entry = findKeyEntry(key, hash);
 
     if (entry != NULL) {
         return entry;
     } else {
-        return addNewKeyEntry(key);
+        return addNewKeyEntry(key, hash);
     }
 }
 
 template<typename k, typename v>
 typename con_set<k, v>::Entry *con_set<k, v>::addNewKeyEntry(const k& key)
+{
+    return addNewKeyEntry(key, con_set_MixHash(HashCode<k>(key)));
+}
+
+template<typename k, typename v>
+typename con_set<k, v>::Entry *con_set<k, v>::addNewKeyEntry(const k& key, unsigned int hash)
 {
     Entry *entry;
-    int    hash;
 
-    if (count >= threshold) {
+    if (count + numDeleted >= threshold) {
         resize();
     }
 
@@ -334,15 +607,7 @@ typename con_set<k, v>::Entry *con_set<k, v>::addNewKeyEntry(const k& key)
 
     entry = new Entry;
     entry->SetKey(key);
-    hash = HashCode<k>(entry->GetKey()) % tableLength;
-
-    if (defaultEntry == NULL) {
-        defaultEntry = entry;
-        entry->next  = NULL;
-    } else {
-        entry->next = table[hash];
-    }
-    table[hash] = entry;
+    insertEntry(entry, hash);
 
     return entry;
 }
@@ -356,47 +621,51 @@ bool con_set<key, value>::isEmpty(void)
 template<typename k, typename v>
 bool con_set<k, v>::remove(const k& key)
 {
-    int    hash;
-    int    i;
-    Entry *prev = NULL;
-    Entry *entry, *e;
+    const unsigned int hash = con_set_MixHash(HashCode<k>(key));
+    unsigned int       index;
+    unsigned int       probe;
+    unsigned int       slot;
+    con_set_control_t  groupControl;
+    Entry             *entry;
 
-    hash = HashCode<k>(key) % tableLength;
+    if (!count) {
+        return false;
+    }
 
-    for (entry = table[hash]; entry != NULL; entry = entry->next) {
-        // just to make sure we're using the correct overloaded operator for the key
-        if (!(entry->GetKey() == key)) {
-            prev = entry;
-            continue;
-        }
+    index = (hash >> 7) & tableMask;
+
+    for (probe = 1;; probe++) {
+        groupControl = con_set_LoadControl(&control[index * CON_SET_GROUP_SIZE]);
 
-        if (defaultEntry == entry) {
-            defaultEntry = prev ? prev : table[hash];
-            // find a default entry
-            for (i = 0; i < tableLength && !defaultEntry; i++) {
-                for (e = table[i]; e; e = e->next) {
-                    if (e == entry) {
-                        continue;
-                    }
-                    defaultEntry = e;
-                    break;
-                }
+        for (auto match = con_set_MatchHash(groupControl, hash); match; match &= match - 1) {
+            slot = index * CON_SET_GROUP_SIZE + con_set_LowestSlot(match);
+
+            // just to make sure we're using the correct overloaded operator for the key
+            if (!(table[slot].GetKey() == key)) {
+                continue;
             }
-        }
 
-        if (prev) {
-            prev->next = entry->next;
-        } else {
-            table[hash] = entry->next;
+            if (con_set_MatchEmpty(groupControl)) {
+                // the group was never full, so no key was pushed past it
+                control[slot] = CON_SET_EMPTY;
+            } else {
+                control[slot] = CON_SET_DELETED;
+                numDeleted++;
+            }
+
+            entry = table[slot].entry;
+            count--;
+            delete entry;
+
+            return true;
         }
 
-        count--;
-        delete entry;
+        if (con_set_MatchEmpty(groupControl)) {
+            return false;
+        }
 
-        return true;
+        index = (index + probe) & tableMask;
     }
-
-    return false;
 }
 
 template<typename k, typename v>
@@ -414,11 +683,15 @@ v *con_set<k, v>::findKeyValue(const k& key) const
 template<typename key, typename value>
 key *con_set<key, value>::firstKeyValue(void)
 {
-    if (defaultEntry) {
-        return &defaultEntry->GetKey();
-    } else {
-        return NULL;
+    unsigned int i;
+
+    for (i = 0; i < tableLength; i++) {
+        if (!(control[i] & 0x80)) {
+            return &table[i].entry->GetKey();
+        }
     }
+
+    return NULL;
 }
 
 template<typename k, typename v>
@@ -440,15 +713,7 @@ v& con_set<k, v>::addNewKeyValue(const k& key)
 template<typename k, typename v>
 bool con_set<k, v>::keyExists(const k& key)
 {
-    Entry *entry;
-
-    for (entry = table; entry != NULL; entry = entry->next) {
-        if (entry->GetKey() == key) {
-            return true;
-        }
-    }
-
-    return false;
+    return findKeyEntry(key) != NULL;
 }
 
 template<typename key, typename value>
@@ -469,7 +734,6 @@ protected:
     con_set<key, value> *m_Set;
     unsigned int         m_Index;
     Entry               *m_CurrentEntry;
-    Entry               *m_NextEntry;
 
 public:
     con_set_enum();
@@ -487,7 +751,6 @@ con_set_enum<key, value>::con_set_enum()
     m_Set          = NULL;
     m_Index        = 0;
     m_CurrentEntry = NULL;
-    m_NextEntry    = NULL;
 }
 
 template<typename key, typename value>
@@ -502,7 +765,6 @@ bool con_set_enum<key, value>::operator=(con_set<key, value>& set)
     m_Set          = &set;
     m_Index        = m_Set->tableLength;
     m_CurrentEntry = NULL;
-    m_NextEntry    = NULL;
 
     return true;
 }
@@ -516,30 +778,18 @@ typename con_set_enum<key, value>::Entry *con_set_enum<key, value>::CurrentEleme
 template<typename key, typename value>
 typename con_set_enum<key, value>::Entry *con_set_enum<key, value>::NextElement(void)
 {
-    if (!m_NextEntry) {
-        while (1) {
-            if (!m_Index) {
-                break;
-            }
-
-            m_Index--;
-            m_NextEntry = m_Set->table[m_Index];
-
-            if (m_NextEntry) {
-                break;
-            }
-        }
+    // the slots don't move when entries are removed, so the current one can be removed
+    while (m_Index) {
+        m_Index--;
 
-        if (!m_NextEntry) {
-            m_CurrentEntry = NULL;
-            return NULL;
+        if (!(m_Set->control[m_Index] & 0x80)) {
+            m_CurrentEntry = m_Set->table[m_Index].entry;
+            return m_CurrentEntry;
         }
     }
 
-    m_CurrentEntry = m_NextEntry;
-    m_NextEntry    = m_NextEntry->next;
-
-    return m_CurrentEntry;
+    m_CurrentEntry = NULL;
+    return NULL;
 }
 
 template<typename key, typename value>
@@ -629,7 +879,6 @@ con_map_enum<key, value>::con_map_enum()
     m_Set_Enum.m_Set          = NULL;
     m_Set_Enum.m_Index        = 0;
     m_Set_Enum.m_CurrentEntry = NULL;
-    m_Set_Enum.m_NextEntry    = NULL;
 }
 
 template<typename key, typename value>
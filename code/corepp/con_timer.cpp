@@ -4,20 +4,197 @@
 #    include "../fgame/archive.h"
 #endif
 
+con_timer::Entry::Entry()
+{
+    element.obj     = NULL;
+    element.inttime = 0;
+    sequence        = 0;
+    heapIndex       = -1;
+    newerEntry      = -1;
+    olderEntry      = -1;
+}
+
 con_timer::con_timer(void)
 {
-    m_inttime = 0;
-    m_bDirty  = false;
+    m_Sequence = 0;
+    m_bRebuild = false;
+    m_inttime  = 0;
+    m_bDirty   = false;
+}
+
+bool con_timer::Before(int entry1, int entry2) const
+{
+    const Entry& e1 = m_Entries[entry1];
+    const Entry& e2 = m_Entries[entry2];
+
+    if (e1.element.inttime != e2.element.inttime) {
+        return e1.element.inttime < e2.element.inttime;
+    }
+
+    // elements with the same time are returned in the order they were added
+    return (int)(e1.sequence - e2.sequence) < 0;
+}
+
+void con_timer::SetHeapAt(int index, int entry)
+{
+    m_Heap[index]               = entry;
+    m_Entries[entry].heapIndex = index;
+}
+
+void con_timer::SiftUp(int index)
+{
+    int entry = m_Heap[index];
+
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+
+        if (!Before(entry, m_Heap[parent])) {
+            break;
+        }
+
+        SetHeapAt(index, m_Heap[parent]);
+        index = parent;
+    }
+
+    SetHeapAt(index, entry);
+}
+
+void con_timer::SiftDown(int index)
+{
+    int entry = m_Heap[index];
+    int num   = m_Heap.NumObjects();
+
+    for (;;) {
+        int child = index * 2 + 1;
+
+        if (child >= num) {
+            break;
+        }
+
+        if (child + 1 < num && Before(m_Heap[child + 1], m_Heap[child])) {
+            child++;
+        }
+
+        if (!Before(m_Heap[child], entry)) {
+            break;
+        }
+
+        SetHeapAt(index, m_Heap[child]);
+        index = child;
+    }
+
+    SetHeapAt(index, entry);
+}
+
+void con_timer::LinkEntry(int entry)
+{
+    Entry& e      = m_Entries[entry];
+    int&   handle = m_Handles[e.element.obj];
+
+    // con_map default-constructs new values to 0,
+    // the handle is stored as entry + 1
+    e.newerEntry = -1;
+    e.olderEntry = handle - 1;
+    if (e.olderEntry != -1) {
+        m_Entries[e.olderEntry].newerEntry = entry;
+    }
+
+    handle = entry + 1;
+
+    m_Heap.AddObject(entry);
+    SiftUp(m_Heap.NumObjects() - 1);
+}
+
+void con_timer::RemoveEntry(int entry)
+{
+    Entry& e = m_Entries[entry];
+    int    index;
+    int    last;
+
+    //
+    // unlink from the entries of the same object
+    //
+    if (e.olderEntry != -1) {
+        m_Entries[e.olderEntry].newerEntry = e.newerEntry;
+    }
+
+    if (e.newerEntry != -1) {
+        m_Entries[e.newerEntry].olderEntry = e.olderEntry;
+    } else if (e.olderEntry != -1) {
+        m_Handles[e.element.obj] = e.olderEntry + 1;
+    } else {
+        m_Handles.remove(e.element.obj);
+    }
+
+    //
+    // remove from the heap
+    //
+    index = e.heapIndex;
+    last  = m_Heap[m_Heap.NumObjects() - 1];
+    m_Heap.RemoveObjectAt(m_Heap.NumObjects());
+
+    if (last != entry) {
+        SetHeapAt(index, last);
+        if (index > 0 && Before(last, m_Heap[(index - 1) / 2])) {
+            SiftUp(index);
+        } else {
+            SiftDown(index);
+        }
+    }
+
+    e.element.obj = NULL;
+    e.heapIndex   = -1;
+    e.newerEntry  = -1;
+    e.olderEntry  = -1;
+
+    m_FreeEntries.AddObject(entry);
+}
+
+void con_timer::Rebuild(void)
+{
+    int i;
+
+    //
+    // entries are loaded in place so the archive can fix up their pointers,
+    // the heap is built once they are resolved
+    //
+    m_bRebuild = false;
+
+    m_Heap.ClearObjectList();
+    m_FreeEntries.ClearObjectList();
+    m_Handles.clear();
+
+    m_Sequence = 0;
+    for (i = 0; i < m_Entries.NumObjects(); i++) {
+        Entry& e = m_Entries[i];
+
+        e.sequence = m_Sequence++;
+        LinkEntry(i);
+    }
 }
 
 void con_timer::AddElement(Class *e, int inttime)
 {
-    Element element;
+    int entry;
+
+    if (m_bRebuild) {
+        Rebuild();
+    }
+
+    if (m_FreeEntries.NumObjects()) {
+        entry = m_FreeEntries.ObjectAt(m_FreeEntries.NumObjects());
+        m_FreeEntries.RemoveObjectAt(m_FreeEntries.NumObjects());
+    } else {
+        entry = m_Entries.AddObject(Entry()) - 1;
+    }
+
+    Entry& newEntry = m_Entries[entry];
 
-    element.obj     = e;
-    element.inttime = inttime;
+    newEntry.element.obj     = e;
+    newEntry.element.inttime = inttime;
+    newEntry.sequence        = m_Sequence++;
 
-    m_Elements.AddObject(element);
+    LinkEntry(entry);
 
     if (inttime <= m_inttime) {
         SetDirty();
@@ -26,45 +203,51 @@ void con_timer::AddElement(Class *e, int inttime)
 
 void con_timer::RemoveElement(Class *e)
 {
-    for (int i = m_Elements.NumObjects(); i > 0; i--) {
-        Element *index = &m_Elements.ObjectAt(i);
+    int *handle;
 
-        if (index->obj == e) {
-            m_Elements.RemoveObjectAt(i);
-            return;
-        }
+    if (m_bRebuild) {
+        Rebuild();
+    }
+
+    // the most recently added element of the object is removed
+    handle = m_Handles.find(e);
+    if (handle) {
+        RemoveEntry(*handle - 1);
     }
 }
 
 Class *con_timer::GetNextElement(int& foundtime)
 {
-    int    best_inttime;
-    int    i;
-    int    foundIndex;
     Class *result;
+    int    entry;
 
-    foundIndex   = 0;
-    best_inttime = m_inttime;
-
-    for (i = m_Elements.NumObjects(); i > 0; i--) {
-        if (m_Elements.ObjectAt(i).inttime <= best_inttime) {
-            best_inttime = m_Elements.ObjectAt(i).inttime;
-            foundIndex   = i;
-        }
+    if (m_bRebuild) {
+        Rebuild();
     }
 
-    if (foundIndex) {
-        result = m_Elements.ObjectAt(foundIndex).obj;
-        m_Elements.RemoveObjectAt(foundIndex);
-        foundtime = best_inttime;
-    } else {
-        result   = NULL;
+    if (!m_Heap.NumObjects() || m_Entries[m_Heap[0]].element.inttime > m_inttime) {
         m_bDirty = false;
+        return NULL;
     }
 
+    entry     = m_Heap[0];
+    result    = m_Entries[entry].element.obj;
+    foundtime = m_Entries[entry].element.inttime;
+
+    RemoveEntry(entry);
+
     return result;
 }
 
+int con_timer::NumElements(void) const
+{
+    if (m_bRebuild) {
+        return m_Entries.NumObjects();
+    }
+
+    return m_Heap.NumObjects();
+}
+
 #if defined(ARCHIVE_SUPPORTED)
 
 void con_timer::ArchiveElement(Archiver& arc, Element *e)
@@ -73,11 +256,49 @@ void con_timer::ArchiveElement(Archiver& arc, Element *e)
     arc.ArchiveInteger(&e->inttime);
 }
 
+void con_timer::ArchiveEntry(Archiver& arc, Entry *e)
+{
+    ArchiveElement(arc, &e->element);
+}
+
+int con_timer::CompareEntries(const void *elem1, const void *elem2)
+{
+    const Entry *e1 = (const Entry *)elem1;
+    const Entry *e2 = (const Entry *)elem2;
+
+    return (int)(e1->sequence - e2->sequence);
+}
+
 void con_timer::Archive(Archiver& arc)
 {
     arc.ArchiveBool(&m_bDirty);
     arc.ArchiveInteger(&m_inttime);
 
-    m_Elements.Archive(arc, con_timer::ArchiveElement);
+    if (arc.Loading()) {
+        m_Entries.FreeObjectList();
+
+        // pointers are not fixed up until the archive is closed,
+        // so the entries must not move until the heap is built
+        m_Entries.Archive(arc, con_timer::ArchiveEntry);
+        m_bRebuild = true;
+    } else {
+        Container<Entry> entries;
+        int              i;
+
+        if (m_bRebuild) {
+            Rebuild();
+        }
+
+        //
+        // write elements in the order they were added
+        //
+        entries.Resize(m_Heap.NumObjects());
+        for (i = 0; i < m_Heap.NumObjects(); i++) {
+            entries.AddObject(m_Entries[m_Heap[i]]);
+        }
+        entries.Sort(con_timer::CompareEntries);
+
+        entries.Archive(arc, con_timer::ArchiveEntry);
+    }
 }
 #endif
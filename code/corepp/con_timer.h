@@ -1,6 +1,13 @@
-#include "../corepp/class.h"
+#include "../corepp/container.h"
+#include "../corepp/con_set.h"
 
-class con_timer : public Class
+class Class;
+
+//
+// Elements are kept in a binary heap ordered by (inttime, insertion order),
+// so the next element is found in O(1) and elements are added and removed in O(log n).
+//
+class con_timer
 {
 public:
     class Element
@@ -11,9 +18,37 @@ public:
     };
 
 private:
-    Container<con_timer::Element> m_Elements;
-    bool                          m_bDirty;
-    int                           m_inttime;
+    class Entry
+    {
+    public:
+        Element      element;
+        unsigned int sequence;
+        // index in the heap, -1 if the entry is free
+        int heapIndex;
+        // other entries of the same object, from the most recent to the oldest
+        int newerEntry;
+        int olderEntry;
+
+        Entry();
+    };
+
+    Container<Entry>      m_Entries;
+    Container<int>        m_FreeEntries;
+    Container<int>        m_Heap;
+    con_map<Class *, int> m_Handles;
+    unsigned int          m_Sequence;
+    bool                  m_bRebuild;
+    bool                  m_bDirty;
+    int                   m_inttime;
+
+private:
+    bool Before(int entry1, int entry2) const;
+    void SetHeapAt(int index, int entry);
+    void SiftUp(int index);
+    void SiftDown(int index);
+    void LinkEntry(int entry);
+    void RemoveEntry(int entry);
+    void Rebuild(void);
 
 public:
     con_timer();
@@ -27,9 +62,13 @@ public:
     bool IsDirty(void);
     void SetTime(int inttime);
 
+    int NumElements(void) const;
+
 #if defined(ARCHIVE_SUPPORTED)
     static void ArchiveElement(class Archiver& arc, Element *e);
-    void        Archive(class Archiver       &arc) override;
+    static void ArchiveEntry(class Archiver& arc, Entry *e);
+    static int  CompareEntries(const void *elem1, const void *elem2);
+    void        Archive(class Archiver& arc);
 #endif
 };
 
@@ -75,12 +75,26 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #    define CONTAINER_Free           Z_Free
 #endif
 
+#include "container_fwd.h"
+
 #include <utility>
 #include <new>
 
 class Archiver;
 
-template<class Type>
+//
+// Default storage of containers. Containers with a different allocator,
+// given as the second template parameter, are distinct types
+//
+class ContainerAllocator
+{
+public:
+    static void *Alloc(size_t size) { return CONTAINER_Alloc(size); }
+
+    static void Free(void *ptr) { CONTAINER_Free(ptr); }
+};
+
+template<class Type, class Allocator>
 class Container
 {
 private:
@@ -89,16 +103,16 @@ private:
     int   maxobjects;
 
 private:
-    void Copy(const Container<Type>& container);
+    void Copy(const Container<Type, Allocator>& container);
 
 public:
     Container();
 
-    Container(const Container<Type>& container);
-    Container<Type>& operator=(const Container<Type>& container);
+    Container(const Container<Type, Allocator>& container);
+    Container<Type, Allocator>& operator=(const Container<Type, Allocator>& container);
 
-    Container(Container<Type>&& container);
-    Container<Type>& operator=(Container<Type>&& container);
+    Container(Container<Type, Allocator>&& container);
+    Container<Type, Allocator>& operator=(Container<Type, Allocator>&& container);
 
     ~Container();
 
@@ -128,32 +142,32 @@ public:
     Type& operator[](const uintptr_t index) const;
 };
 
-template<class Type>
-Container<Type>::Container()
+template<class Type, class Allocator>
+Container<Type, Allocator>::Container()
 {
     objlist    = NULL;
     numobjects = 0;
     maxobjects = 0;
 }
 
-template<class Type>
-Container<Type>::Container(const Container<Type>& container)
+template<class Type, class Allocator>
+Container<Type, Allocator>::Container(const Container<Type, Allocator>& container)
 {
     objlist = NULL;
 
     Copy(container);
 }
 
-template<class Type>
-Container<Type>& Container<Type>::operator=(const Container<Type>& container)
+template<class Type, class Allocator>
+Container<Type, Allocator>& Container<Type, Allocator>::operator=(const Container<Type, Allocator>& container)
 {
     Copy(container);
 
     return *this;
 }
 
-template<class Type>
-Container<Type>::Container(Container<Type>&& container)
+template<class Type, class Allocator>
+Container<Type, Allocator>::Container(Container<Type, Allocator>&& container)
 {
     objlist              = container.objlist;
     numobjects           = container.numobjects;
@@ -163,8 +177,8 @@ Container<Type>::Container(Container<Type>&& container)
     container.maxobjects = 0;
 }
 
-template<class Type>
-Container<Type>& Container<Type>::operator=(Container<Type>&& container)
+template<class Type, class Allocator>
+Container<Type, Allocator>& Container<Type, Allocator>::operator=(Container<Type, Allocator>&& container)
 {
     FreeObjectList();
 
@@ -178,14 +192,14 @@ Container<Type>& Container<Type>::operator=(Container<Type>&& container)
     return *this;
 }
 
-template<class Type>
-Container<Type>::~Container()
+template<class Type, class Allocator>
+Container<Type, Allocator>::~Container()
 {
     FreeObjectList();
 }
 
-template<class Type>
-int Container<Type>::AddObject(const Type& obj)
+template<class Type, class Allocator>
+int Container<Type, Allocator>::AddObject(const Type& obj)
 {
     if (!objlist) {
         Resize(10);
@@ -201,8 +215,8 @@ int Container<Type>::AddObject(const Type& obj)
     return numobjects;
 }
 
-template<class Type>
-int Container<Type>::AddObject()
+template<class Type, class Allocator>
+int Container<Type, Allocator>::AddObject()
 {
     if (!objlist) {
         Resize(10);
@@ -218,8 +232,8 @@ int Container<Type>::AddObject()
     return numobjects;
 }
 
-template<class Type>
-int Container<Type>::AddUniqueObject(const Type& obj)
+template<class Type, class Allocator>
+int Container<Type, Allocator>::AddUniqueObject(const Type& obj)
 {
     int index;
 
@@ -232,8 +246,8 @@ int Container<Type>::AddUniqueObject(const Type& obj)
     return index;
 }
 
-template<class Type>
-void Container<Type>::AddObjectAt(int index, const Type& obj)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::AddObjectAt(int index, const Type& obj)
 {
     int i;
 
@@ -252,8 +266,8 @@ void Container<Type>::AddObjectAt(int index, const Type& obj)
     SetObjectAt(index, obj);
 }
 
-template<class Type>
-Type *Container<Type>::AddressOfObjectAt(int index)
+template<class Type, class Allocator>
+Type *Container<Type, Allocator>::AddressOfObjectAt(int index)
 {
     if (index > maxobjects) {
         CONTAINER_Error(ERR_DROP, "Container::AddressOfObjectAt : index is greater than maxobjects");
@@ -266,8 +280,8 @@ Type *Container<Type>::AddressOfObjectAt(int index)
     return &objlist[index - 1];
 }
 
-template<class Type>
-void Container<Type>::ClearObjectList(void)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::ClearObjectList(void)
 {
     size_t i;
 
@@ -281,8 +295,8 @@ void Container<Type>::ClearObjectList(void)
     }
 }
 
-template<class Type>
-void Container<Type>::FreeObjectList(void)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::FreeObjectList(void)
 {
     size_t i;
 
@@ -291,7 +305,7 @@ void Container<Type>::FreeObjectList(void)
             objlist[i].~Type();
         }
 
-        CONTAINER_Free(objlist);
+        Allocator::Free(objlist);
     }
 
     objlist    = NULL;
@@ -299,8 +313,8 @@ void Container<Type>::FreeObjectList(void)
     maxobjects = 0;
 }
 
-template<class Type>
-int Container<Type>::IndexOfObject(const Type& obj)
+template<class Type, class Allocator>
+int Container<Type, Allocator>::IndexOfObject(const Type& obj)
 {
     int i;
 
@@ -317,8 +331,8 @@ int Container<Type>::IndexOfObject(const Type& obj)
     return 0;
 }
 
-template<class Type>
-void Container<Type>::InsertObjectAt(int index, const Type& obj)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::InsertObjectAt(int index, const Type& obj)
 {
     size_t i;
 
@@ -333,7 +347,7 @@ void Container<Type>::InsertObjectAt(int index, const Type& obj)
     if (numobjects > maxobjects) {
         maxobjects = numobjects;
         if (!objlist) {
-            objlist = (Type *)CONTAINER_Alloc(sizeof(Type) * maxobjects);
+            objlist = (Type *)Allocator::Alloc(sizeof(Type) * maxobjects);
 
             for (i = 0; i < arrayIndex; ++i) {
                 new (objlist + i) Type();
@@ -346,7 +360,7 @@ void Container<Type>::InsertObjectAt(int index, const Type& obj)
                 maxobjects = numobjects;
             }
 
-            objlist = (Type *)CONTAINER_Alloc(sizeof(Type) * maxobjects);
+            objlist = (Type *)Allocator::Alloc(sizeof(Type) * maxobjects);
 
             for (i = 0; i < arrayIndex; ++i) {
                 new (objlist + i) Type(std::move(temp[i]));
@@ -357,7 +371,7 @@ void Container<Type>::InsertObjectAt(int index, const Type& obj)
                 new (objlist + i + 1) Type(std::move(temp[i]));
             }
 
-            CONTAINER_Free(temp);
+            Allocator::Free(temp);
         }
     } else {
         for (i = numobjects - 1; i > arrayIndex; i--) {
@@ -367,20 +381,20 @@ void Container<Type>::InsertObjectAt(int index, const Type& obj)
     }
 }
 
-template<class Type>
-int Container<Type>::MaxObjects(void) const
+template<class Type, class Allocator>
+int Container<Type, Allocator>::MaxObjects(void) const
 {
     return maxobjects;
 }
 
-template<class Type>
-int Container<Type>::NumObjects(void) const
+template<class Type, class Allocator>
+int Container<Type, Allocator>::NumObjects(void) const
 {
     return numobjects;
 }
 
-template<class Type>
-Type& Container<Type>::ObjectAt(const size_t index) const
+template<class Type, class Allocator>
+Type& Container<Type, Allocator>::ObjectAt(const size_t index) const
 {
     if ((index <= 0) || (index > numobjects)) {
         CONTAINER_Error(ERR_DROP, "Container::ObjectAt : index out of range");
@@ -389,8 +403,8 @@ Type& Container<Type>::ObjectAt(const size_t index) const
     return objlist[index - 1];
 }
 
-template<class Type>
-bool Container<Type>::ObjectInList(const Type& obj)
+template<class Type, class Allocator>
+bool Container<Type, Allocator>::ObjectInList(const Type& obj)
 {
     if (!IndexOfObject(obj)) {
         return false;
@@ -399,8 +413,8 @@ bool Container<Type>::ObjectInList(const Type& obj)
     return true;
 }
 
-template<class Type>
-void Container<Type>::RemoveObjectAt(int index)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::RemoveObjectAt(int index)
 {
     int i;
 
@@ -423,8 +437,8 @@ void Container<Type>::RemoveObjectAt(int index)
     objlist[numobjects].~Type();
 }
 
-template<class Type>
-void Container<Type>::RemoveObject(const Type& obj)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::RemoveObject(const Type& obj)
 {
     int index;
 
@@ -439,8 +453,8 @@ void Container<Type>::RemoveObject(const Type& obj)
     RemoveObjectAt(index);
 }
 
-template<class Type>
-void Container<Type>::RemoveObject(const Type* obj)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::RemoveObject(const Type* obj)
 {
     unsigned int index;
 
@@ -452,16 +466,16 @@ void Container<Type>::RemoveObject(const Type* obj)
     RemoveObjectAt(index + 1);
 }
 
-template<class Type>
-void Container<Type>::Reset()
+template<class Type, class Allocator>
+void Container<Type, Allocator>::Reset()
 {
     objlist    = NULL;
     numobjects = 0;
     maxobjects = 0;
 }
 
-template<class Type>
-void Container<Type>::Resize(int maxelements)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::Resize(int maxelements)
 {
     Type  *temp;
     size_t i;
@@ -473,7 +487,7 @@ void Container<Type>::Resize(int maxelements)
 
     if (!objlist) {
         maxobjects = maxelements;
-        objlist    = (Type *)CONTAINER_Alloc(sizeof(Type) * maxobjects);
+        objlist    = (Type *)Allocator::Alloc(sizeof(Type) * maxobjects);
     } else {
         temp = objlist;
 
@@ -483,7 +497,7 @@ void Container<Type>::Resize(int maxelements)
             maxobjects = numobjects;
         }
 
-        objlist = (Type *)CONTAINER_Alloc(sizeof(Type) * maxobjects);
+        objlist = (Type *)Allocator::Alloc(sizeof(Type) * maxobjects);
 
         for (i = 0; i < numobjects; i++) {
             // move the older type
@@ -493,12 +507,12 @@ void Container<Type>::Resize(int maxelements)
             temp[i].~Type();
         }
 
-        CONTAINER_Free(temp);
+        Allocator::Free(temp);
     }
 }
 
-template<class Type>
-void Container<Type>::SetObjectAt(int index, const Type& obj)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::SetObjectAt(int index, const Type& obj)
 {
     if (!objlist) {
         return;
@@ -511,8 +525,8 @@ void Container<Type>::SetObjectAt(int index, const Type& obj)
     objlist[index - 1] = obj;
 }
 
-template<class Type>
-void Container<Type>::Sort(int (*compare)(const void *elem1, const void *elem2))
+template<class Type, class Allocator>
+void Container<Type, Allocator>::Sort(int (*compare)(const void *elem1, const void *elem2))
 {
     if (!objlist) {
         return;
@@ -521,14 +535,14 @@ void Container<Type>::Sort(int (*compare)(const void *elem1, const void *elem2))
     qsort((void *)objlist, (size_t)numobjects, sizeof(Type), compare);
 }
 
-template<class Type>
-Type& Container<Type>::operator[](const uintptr_t index) const
+template<class Type, class Allocator>
+Type& Container<Type, Allocator>::operator[](const uintptr_t index) const
 {
     return ObjectAt(index + 1);
 }
 
-template<class Type>
-void Container<Type>::Copy(const Container<Type>& container)
+template<class Type, class Allocator>
+void Container<Type, Allocator>::Copy(const Container<Type, Allocator>& container)
 {
     int i;
 
@@ -559,8 +573,8 @@ void Container<Type>::Copy(const Container<Type>& container)
     return;
 }
 
-template<typename T>
-void *operator new(size_t count, Container<T>& container)
+template<typename T, typename A>
+void *operator new(size_t count, Container<T, A>& container)
 {
     (void)count;
 
@@ -568,8 +582,8 @@ void *operator new(size_t count, Container<T>& container)
     return &container.ObjectAt(container.AddObject());
 }
 
-template<typename T>
-void operator delete(void *ptr, Container<T>& container)
+template<typename T, typename A>
+void operator delete(void *ptr, Container<T, A>& container)
 {
     container.RemoveObject((T *)ptr);
 }
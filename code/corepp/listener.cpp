@@ -70,7 +70,7 @@ con_map<const_str, unsigned int> Event::setterCommandList;
 
 #endif
 
-EventQueueNode Event::EventQueue;
+EventQueueHeap Event::EventQueue;
 
 int DisableListenerNotify = 0;
 
@@ -412,6 +412,384 @@ int HashCode<command_t>(const command_t& key)
     return hash;
 }
 
+/*
+=======================
+EventQueueHeap
+=======================
+*/
+EventQueueHeap::EventQueueHeap()
+{
+    sequence         = 0;
+    hasUnlinkedNodes = false;
+}
+
+/*
+=======================
+Before
+
+Returns true if node1 must be processed before node2
+=======================
+*/
+bool EventQueueHeap::Before(const EventQueueNode *node1, const EventQueueNode *node2)
+{
+    if (node1->inttime != node2->inttime) {
+        return node1->inttime < node2->inttime;
+    }
+
+    // posted nodes go before the appended ones
+    if (node1->appended != node2->appended) {
+        return node2->appended;
+    }
+
+    // wrap-safe comparison of the queue order:
+    // the newest posted node fires first, the oldest appended node fires first
+    if (node1->appended) {
+        return (int)(node1->sequence - node2->sequence) < 0;
+    } else {
+        return (int)(node1->sequence - node2->sequence) > 0;
+    }
+}
+
+/*
+=======================
+CompareNodes
+=======================
+*/
+int EventQueueHeap::CompareNodes(const void *elem1, const void *elem2)
+{
+    const EventQueueNode *node1 = *(const EventQueueNode **)elem1;
+    const EventQueueNode *node2 = *(const EventQueueNode **)elem2;
+
+    if (Before(node1, node2)) {
+        return -1;
+    } else if (Before(node2, node1)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+=======================
+SetNodeAt
+=======================
+*/
+void EventQueueHeap::SetNodeAt(int index, EventQueueNode *node)
+{
+    heap[index]     = node;
+    node->heapIndex = index;
+}
+
+/*
+=======================
+SiftUp
+=======================
+*/
+void EventQueueHeap::SiftUp(int index)
+{
+    EventQueueNode *node = heap[index];
+
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+
+        if (!Before(node, heap[parent])) {
+            break;
+        }
+
+        SetNodeAt(index, heap[parent]);
+        index = parent;
+    }
+
+    SetNodeAt(index, node);
+}
+
+/*
+=======================
+SiftDown
+=======================
+*/
+void EventQueueHeap::SiftDown(int index)
+{
+    EventQueueNode *node = heap[index];
+    int             num  = heap.NumObjects();
+
+    for (;;) {
+        int child = index * 2 + 1;
+
+        if (child >= num) {
+            break;
+        }
+
+        if (child + 1 < num && Before(heap[child + 1], heap[child])) {
+            child++;
+        }
+
+        if (!Before(heap[child], node)) {
+            break;
+        }
+
+        SetNodeAt(index, heap[child]);
+        index = child;
+    }
+
+    SetNodeAt(index, node);
+}
+
+/*
+=======================
+Link
+
+Links the node into the pending list of its listener
+=======================
+*/
+void EventQueueHeap::Link(EventQueueNode *node)
+{
+    Listener *obj = node->GetSourceObject();
+
+    if (!obj) {
+        // unarchived nodes don't have their listener
+        // until the archive pointers are resolved
+        hasUnlinkedNodes = true;
+        return;
+    }
+
+    node->owner = obj;
+    node->prev  = NULL;
+    node->next  = obj->m_PendingEvents;
+    if (obj->m_PendingEvents) {
+        obj->m_PendingEvents->prev = node;
+    }
+    obj->m_PendingEvents = node;
+}
+
+/*
+=======================
+Unlink
+=======================
+*/
+void EventQueueHeap::Unlink(EventQueueNode *node)
+{
+    if (!node->owner) {
+        return;
+    }
+
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        node->owner->m_PendingEvents = node->next;
+    }
+
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+
+    node->owner = NULL;
+    node->prev  = NULL;
+    node->next  = NULL;
+}
+
+/*
+=======================
+Add
+
+Queues the node before any node already scheduled at the same time
+=======================
+*/
+void EventQueueHeap::Add(EventQueueNode *node)
+{
+    node->sequence = sequence++;
+    node->appended = false;
+
+    heap.AddObject(node);
+    SiftUp(heap.NumObjects() - 1);
+
+    Link(node);
+}
+
+/*
+=======================
+Append
+
+Queues the node after any node already scheduled at the same time
+=======================
+*/
+void EventQueueHeap::Append(EventQueueNode *node)
+{
+    node->sequence = sequence++;
+    node->appended = true;
+
+    heap.AddObject(node);
+    SiftUp(heap.NumObjects() - 1);
+
+    Link(node);
+}
+
+/*
+=======================
+Remove
+=======================
+*/
+void EventQueueHeap::Remove(EventQueueNode *node)
+{
+    EventQueueNode *last;
+    int             index;
+
+    assert(node->heapIndex >= 0 && node->heapIndex < heap.NumObjects() && heap[node->heapIndex] == node);
+
+    Unlink(node);
+
+    index           = node->heapIndex;
+    last            = heap[heap.NumObjects() - 1];
+    node->heapIndex = -1;
+
+    heap.RemoveObjectAt(heap.NumObjects());
+
+    if (last == node) {
+        return;
+    }
+
+    SetNodeAt(index, last);
+    if (index > 0 && Before(last, heap[(index - 1) / 2])) {
+        SiftUp(index);
+    } else {
+        SiftDown(index);
+    }
+}
+
+/*
+=======================
+Reschedule
+
+Moves the node to a new time, after any node already scheduled at that time
+=======================
+*/
+void EventQueueHeap::Reschedule(EventQueueNode *node, int inttime)
+{
+    int index = node->heapIndex;
+
+    node->inttime  = inttime;
+    node->sequence = sequence++;
+    node->appended = true;
+
+    SiftUp(index);
+    SiftDown(node->heapIndex);
+}
+
+/*
+=======================
+LinkListeners
+
+Links nodes that were unarchived before their listener pointer was resolved
+=======================
+*/
+void EventQueueHeap::LinkListeners(void)
+{
+    int i;
+
+    if (!hasUnlinkedNodes) {
+        return;
+    }
+
+    hasUnlinkedNodes = false;
+
+    for (i = 0; i < heap.NumObjects(); i++) {
+        if (!heap[i]->owner) {
+            Link(heap[i]);
+        }
+    }
+}
+
+/*
+=======================
+Clear
+
+Deletes all pending events
+=======================
+*/
+void EventQueueHeap::Clear(void)
+{
+    int i;
+
+    for (i = 0; i < heap.NumObjects(); i++) {
+        EventQueueNode *node = heap[i];
+
+        Unlink(node);
+
+        delete node->event;
+        delete node;
+    }
+
+    heap.ClearObjectList();
+    hasUnlinkedNodes = false;
+}
+
+/*
+=======================
+FreeNodes
+=======================
+*/
+void EventQueueHeap::FreeNodes(void)
+{
+    Clear();
+    heap.FreeObjectList();
+}
+
+/*
+=======================
+First
+=======================
+*/
+EventQueueNode *EventQueueHeap::First(void) const
+{
+    if (!heap.NumObjects()) {
+        return NULL;
+    }
+
+    return heap[0];
+}
+
+/*
+=======================
+FirstOf
+
+Returns the first event that will be processed for the specified listener
+=======================
+*/
+EventQueueNode *EventQueueHeap::FirstOf(Listener *listener) const
+{
+    EventQueueNode *node;
+    EventQueueNode *first;
+
+    first = NULL;
+    for (node = listener->m_PendingEvents; node; node = node->next) {
+        if (!first || Before(node, first)) {
+            first = node;
+        }
+    }
+
+    return first;
+}
+
+/*
+=======================
+NodeAt
+=======================
+*/
+EventQueueNode *EventQueueHeap::NodeAt(int index) const
+{
+    return heap[index];
+}
+
+/*
+=======================
+NumNodes
+=======================
+*/
+int EventQueueHeap::NumNodes(void) const
+{
+    return heap.NumObjects();
+}
+
 #if defined(ARCHIVE_SUPPORTED)
 
 void ArchiveListenerPtr(Archiver& arc, SafePtr<Listener> *obj)
@@ -449,7 +827,11 @@ void Event::Archive(Archiver& arc)
     arc.ArchiveUnsignedShort(&dataSize);
 
     if (arc.Loading()) {
-        data = new ScriptVariable[dataSize + 1];
+        AllocData(dataSize + 1);
+
+        for (int i = 0; i < dataSize; i++) {
+            new (&data[i]) ScriptVariable();
+        }
     }
 
     for (int i = dataSize; i > 0; i--) {
@@ -459,13 +841,18 @@ void Event::Archive(Archiver& arc)
 
 void L_ArchiveEvents(Archiver& arc)
 {
-    EventQueueNode *event;
-    int             num;
+    Container<EventQueueNode *> events;
+    EventQueueNode             *event;
+    int                         i;
+    int                         num;
 
-    num = 0;
-    for (event = Event::EventQueue.next; event != &Event::EventQueue; event = event->next) {
+    events.Resize(Event::EventQueue.NumNodes());
+
+    for (i = 0; i < Event::EventQueue.NumNodes(); i++) {
         Listener *obj;
 
+        event = Event::EventQueue.NodeAt(i);
+
         assert(event);
 
         obj = event->GetSourceObject();
@@ -478,24 +865,16 @@ void L_ArchiveEvents(Archiver& arc)
         }
 #    endif
 
-        num++;
+        events.AddObject(event);
     }
 
-    arc.ArchiveInteger(&num);
-    for (event = Event::EventQueue.next; event != &Event::EventQueue; event = event->next) {
-        Listener *obj;
-
-        assert(event);
-
-        obj = event->GetSourceObject();
-
-        assert(obj);
+    // events are written in the order they will be processed
+    events.Sort(EventQueueHeap::CompareNodes);
 
-#    if defined(GAME_DLL)
-        if (obj->isSubclassOf(Entity) && (((Entity *)obj)->flags & FL_DONTSAVE)) {
-            continue;
-        }
-#    endif
+    num = events.NumObjects();
+    arc.ArchiveInteger(&num);
+    for (i = 1; i <= num; i++) {
+        event = events.ObjectAt(i);
 
         event->event->Archive(arc);
         arc.ArchiveInteger(&event->inttime);
@@ -523,25 +902,16 @@ void L_UnarchiveEvents(Archiver& arc)
         arc.ArchiveInteger(&node->flags);
         arc.ArchiveSafePointer(&node->m_sourceobject);
 
-        LL_Add(&Event::EventQueue, node, next, prev);
+        // events were written in firing order, and
+        // the listener is linked later, once the pointer is resolved
+        Event::EventQueue.Append(node);
     }
 }
 #endif
 
 void L_ClearEventList()
 {
-    EventQueueNode *node = Event::EventQueue.next, *tmp;
-
-    while (node != &Event::EventQueue) {
-        tmp = node->next;
-
-        delete node->event;
-        delete node;
-
-        node = tmp;
-    }
-
-    LL_Reset(&Event::EventQueue, next, prev);
+    Event::EventQueue.Clear();
 
     Event_allocator.FreeAll();
 
@@ -567,8 +937,6 @@ void L_InitEvents(void)
     Event::LoadEvents();
     ClassDef::BuildEventResponses();
 
-    LL_Reset(&Event::EventQueue, next, prev);
-
     L_ClearEventList();
     Listener::EventSystemStarted = true;
 }
@@ -579,14 +947,12 @@ void L_ProcessPendingEvents()
 
     Listener::ProcessingEvents = true;
 
+    Event::EventQueue.LinkListeners();
+
     int t = EVENT_msec;
-    while (!LL_Empty(&Event::EventQueue, next, prev)) {
+    while ((node = Event::EventQueue.First()) != NULL) {
         Listener *obj;
 
-        node = Event::EventQueue.next;
-
-        assert(node);
-
         obj = node->GetSourceObject();
 
         assert(obj);
@@ -596,7 +962,7 @@ void L_ProcessPendingEvents()
         }
 
         // the event is removed from its list
-        LL_Remove(node, next, prev);
+        Event::EventQueue.Remove(node);
         //gi.DPrintf2("Event: %s\n", node->event->getName().c_str());
 
         // ProcessEvent will dispose of this event when it is done
@@ -615,6 +981,7 @@ void L_ShutdownEvents(void)
     }
 
     L_ClearEventList();
+    Event::EventQueue.FreeNodes();
 
     Event::commandList.clear();
     Event::eventDefList.clear();
@@ -1631,6 +1998,121 @@ void Event::operator delete(void *ptr)
 
 #endif
 
+//
+// Argument storage of events that don't fit in the event itself,
+// by size class. Bigger ones come from the heap
+//
+template<size_t numArgs>
+struct eventArgs_t {
+    alignas(ScriptVariable) unsigned char values[numArgs * sizeof(ScriptVariable)];
+};
+
+MEM_BlockAlloc<eventArgs_t<8>, 64>  EventArgs8_allocator;
+MEM_BlockAlloc<eventArgs_t<16>, 32> EventArgs16_allocator;
+MEM_BlockAlloc<eventArgs_t<32>, 16> EventArgs32_allocator;
+
+/*
+=======================
+FreeEventArgs
+
+Destroys the arguments and gives the storage back to where it came from
+=======================
+*/
+static void FreeEventArgs(ScriptVariable *args, int numArgs, int maxArgs)
+{
+    int i;
+
+    for (i = 0; i < numArgs; i++) {
+        args[i].~ScriptVariable();
+    }
+
+    switch (maxArgs) {
+    case EVENT_INLINE_ARGS:
+        break;
+    case 8:
+        EventArgs8_allocator.Free(args);
+        break;
+    case 16:
+        EventArgs16_allocator.Free(args);
+        break;
+    case 32:
+        EventArgs32_allocator.Free(args);
+        break;
+    default:
+        ::operator delete(args);
+        break;
+    }
+}
+
+/*
+=======================
+AllocData
+
+Sets up storage for at least numArgs arguments, the current arguments
+must have been cleared. Only the first dataSize arguments are constructed
+=======================
+*/
+void Event::AllocData(int numArgs)
+{
+    void *storage;
+
+    static_assert(sizeof(inlineData) >= EVENT_INLINE_ARGS * sizeof(ScriptVariable), "Inline arguments don't fit");
+    static_assert(alignof(Event) >= alignof(ScriptVariable), "Inline arguments are misaligned");
+
+    if (numArgs <= EVENT_INLINE_ARGS) {
+        maxDataSize = EVENT_INLINE_ARGS;
+        storage     = inlineData;
+    } else if (numArgs <= 8) {
+        maxDataSize = 8;
+        storage     = EventArgs8_allocator.Alloc();
+    } else if (numArgs <= 16) {
+        maxDataSize = 16;
+        storage     = EventArgs16_allocator.Alloc();
+    } else if (numArgs <= 32) {
+        maxDataSize = 32;
+        storage     = EventArgs32_allocator.Alloc();
+    } else {
+        maxDataSize = numArgs;
+        storage     = ::operator new(numArgs * sizeof(ScriptVariable));
+    }
+
+    data = (ScriptVariable *)storage;
+}
+
+/*
+=======================
+TakeData
+
+Moves the arguments of ev to this event, which must have none
+=======================
+*/
+void Event::TakeData(Event& ev)
+{
+    int i;
+
+    if (ev.maxDataSize != EVENT_INLINE_ARGS) {
+        data        = ev.data;
+        dataSize    = ev.dataSize;
+        maxDataSize = ev.maxDataSize;
+
+        ev.data        = NULL;
+        ev.dataSize    = 0;
+        ev.maxDataSize = 0;
+        return;
+    }
+
+    // inline arguments can't be stolen
+    AllocData(EVENT_INLINE_ARGS);
+
+    for (i = 0; i < ev.dataSize; i++) {
+        new (&data[i]) ScriptVariable(std::move(ev.data[i]));
+    }
+
+    dataSize = ev.dataSize;
+
+    ev.Clear();
+}
+
 /*
 =======================
 FindEventNum
@@ -1842,15 +2324,17 @@ void Event::PendingEvents(const char *mask)
     EventQueueNode *event;
     size_t          l;
     int             num;
+    int             i;
 
     l = 0;
     if (mask) {
         l = strlen(mask);
     }
 
-    num   = 0;
-    event = EventQueue.next;
-    while (event != &EventQueue) {
+    num = 0;
+    for (i = 0; i < EventQueue.NumNodes(); i++) {
+        event = EventQueue.NodeAt(i);
+
         assert(event);
         assert(event->m_sourceobject);
 
@@ -1858,8 +2342,6 @@ void Event::PendingEvents(const char *mask)
             num++;
             //Event::PrintEvent( event );
         }
-
-        event = event->next;
     }
     EVENT_Printf("%d pending events as of %.2f\n", num, EVENT_time);
 }
@@ -2235,16 +2717,15 @@ Event::Event(const Event& ev)
     fromScript  = ev.fromScript;
     eventnum    = ev.eventnum;
     dataSize    = ev.dataSize;
-    maxDataSize = ev.maxDataSize;
+    maxDataSize = 0;
+    data        = NULL;
 
     if (dataSize) {
-        data = new ScriptVariable[maxDataSize];
+        AllocData(dataSize);
 
         for (int i = 0; i < dataSize; i++) {
-            data[i] = ev.data[i];
+            new (&data[i]) ScriptVariable(ev.data[i]);
         }
-    } else {
-        data = NULL;
     }
 
 #ifdef _DEBUG
@@ -2257,18 +2738,17 @@ Event::Event(const Event& ev, int numArgs)
     fromScript  = ev.fromScript;
     eventnum    = ev.eventnum;
     dataSize    = ev.dataSize;
-    maxDataSize = ev.maxDataSize;
+    maxDataSize = 0;
+    data        = NULL;
 
     if (dataSize) {
-        data = new ScriptVariable[maxDataSize];
+        AllocData(dataSize);
 
         for (int i = 0; i < dataSize; i++) {
-            data[i] = ev.data[i];
+            new (&data[i]) ScriptVariable(ev.data[i]);
         }
-    } else {
-        data        = new ScriptVariable[numArgs];
-        dataSize    = 0;
-        maxDataSize = numArgs;
+    } else if (numArgs) {
+        AllocData(numArgs);
     }
 
 #ifdef _DEBUG
@@ -2280,18 +2760,17 @@ Event::Event(Event&& ev)
 {
     fromScript  = ev.fromScript;
     eventnum    = ev.eventnum;
-    dataSize    = ev.dataSize;
-    maxDataSize = ev.maxDataSize;
-    data        = ev.data;
+    dataSize    = 0;
+    maxDataSize = 0;
+    data        = NULL;
+
+    TakeData(ev);
 
 #ifdef _DEBUG
     name = ev.name;
 #endif
 
-    ev.data        = NULL;
-    ev.dataSize    = 0;
-    ev.maxDataSize = 0;
-    ev.eventnum    = 0;
+    ev.eventnum = 0;
 
 #ifdef _DEBUG
     ev.name = NULL;
@@ -2329,9 +2808,13 @@ Event::Event(int index, int numArgs)
 {
     fromScript  = false;
     eventnum    = index;
-    data        = new ScriptVariable[numArgs];
+    data        = NULL;
     dataSize    = 0;
-    maxDataSize = numArgs;
+    maxDataSize = 0;
+
+    if (numArgs) {
+        AllocData(numArgs);
+    }
 
 #ifdef _DEBUG
     name = GetEventName(index);
@@ -2377,14 +2860,12 @@ Event::Event(const char *command, int numArgs)
     }
 
     fromScript  = qfalse;
-    maxDataSize = numArgs;
+    maxDataSize = 0;
+    dataSize    = 0;
+    data        = NULL;
 
     if (numArgs) {
-        data     = new ScriptVariable[numArgs];
-        dataSize = 0;
-    } else {
-        dataSize = 0;
-        data     = NULL;
+        AllocData(numArgs);
     }
 
 #ifdef _DEBUG
@@ -2404,20 +2885,22 @@ Event::~Event()
 
 Event& Event::operator=(const Event& ev)
 {
+    if (&ev == this) {
+        return *this;
+    }
+
     Clear();
-    fromScript  = ev.fromScript;
-    eventnum    = ev.eventnum;
-    dataSize    = ev.dataSize;
-    maxDataSize = ev.maxDataSize;
+    fromScript = ev.fromScript;
+    eventnum   = ev.eventnum;
 
-    if (dataSize) {
-        data = new ScriptVariable[dataSize];
+    if (ev.dataSize) {
+        AllocData(ev.dataSize);
 
-        for (int i = 0; i < dataSize; i++) {
-            data[i] = ev.data[i];
+        for (int i = 0; i < ev.dataSize; i++) {
+            new (&data[i]) ScriptVariable(ev.data[i]);
         }
-    } else {
-        data = NULL;
+
+        dataSize = ev.dataSize;
     }
 
 #ifdef _DEBUG
@@ -2429,21 +2912,21 @@ Event& Event::operator=(const Event& ev)
 
 Event& Event::operator=(Event&& ev)
 {
+    if (&ev == this) {
+        return *this;
+    }
+
     Clear();
-    fromScript  = ev.fromScript;
-    eventnum    = ev.eventnum;
-    dataSize    = ev.dataSize;
-    maxDataSize = ev.maxDataSize;
-    data        = ev.data;
+    fromScript = ev.fromScript;
+    eventnum   = ev.eventnum;
+
+    TakeData(ev);
 
 #ifdef _DEBUG
     name = ev.name;
 #endif
 
-    ev.data        = NULL;
-    ev.dataSize    = 0;
-    ev.maxDataSize = 0;
-    ev.eventnum    = 0;
+    ev.eventnum = 0;
 
 #ifdef _DEBUG
     ev.name = NULL;
@@ -2614,12 +3097,44 @@ SetValue
 */
 void Event::CopyValues(const ScriptVariable *values, size_t count)
 {
+    size_t i;
+
     assert(count <= maxDataSize);
 
-    for (size_t i = 0; i < count; i++) {
+    for (i = 0; i < count && i < dataSize; i++) {
         data[i] = values[i];
     }
 
+    for (; i < count; i++) {
+        new (&data[i]) ScriptVariable(values[i]);
+    }
+
+    for (; i < dataSize; i++) {
+        data[i].~ScriptVariable();
+    }
+
+    dataSize = count;
+}
+
+/*
+=======================
+MoveValues
+=======================
+*/
+void Event::MoveValues(ScriptVariable *values, size_t count)
+{
+    Clear();
+
+    if (!count) {
+        return;
+    }
+
+    AllocData(count);
+
+    for (size_t i = 0; i < count; i++) {
+        new (&data[i]) ScriptVariable(std::move(values[i]));
+    }
+
     dataSize = count;
 }
 
@@ -2631,7 +3146,7 @@ Clear
 void Event::Clear(void)
 {
     if (data) {
-        delete[] data;
+        FreeEventArgs(data, dataSize, maxDataSize);
 
         data        = NULL;
         dataSize    = 0;
@@ -2791,35 +3306,41 @@ GetValue
 ScriptVariable& Event::GetValue(void)
 {
     ScriptVariable *tmp;
+    int             tmpSize;
     int             i;
 
     if (fromScript) {
         // an event method will emit the return value
         // to the first index of the array
         // so there is no reallocation
-        if (!data) {
-            data        = new ScriptVariable[1];
-            dataSize    = 1;
-            maxDataSize = 1;
+        if (!dataSize) {
+            if (!data) {
+                AllocData(1);
+            }
+
+            new (&data[0]) ScriptVariable();
+            dataSize = 1;
         }
         return data[0];
     }
 
     if (dataSize == maxDataSize) {
-        tmp = data;
+        tmp     = data;
+        tmpSize = maxDataSize;
 
-        maxDataSize += 3;
-        data = new ScriptVariable[maxDataSize];
+        // inline storage first, then the next size class
+        AllocData(maxDataSize * 2);
 
         if (tmp != NULL) {
             for (i = 0; i < dataSize; i++) {
-                data[i] = std::move(tmp[i]);
+                new (&data[i]) ScriptVariable(std::move(tmp[i]));
             }
 
-            delete[] tmp;
+            FreeEventArgs(tmp, dataSize, tmpSize);
         }
     }
 
+    new (&data[dataSize]) ScriptVariable();
     dataSize++;
 
     return data[dataSize - 1];
@@ -3016,6 +3537,8 @@ Listener::Listener()
     vars = NULL;
 
 #endif
+
+    m_PendingEvents = NULL;
 }
 
 /*
@@ -3126,17 +3649,16 @@ void Listener::CancelEventsOfType(Event *ev)
     EventQueueNode *next;
     int             eventnum;
 
-    node = Event::EventQueue.next;
+    Event::EventQueue.LinkListeners();
 
     eventnum = ev->eventnum;
-    while (node != &Event::EventQueue) {
+    for (node = m_PendingEvents; node; node = next) {
         next = node->next;
-        if ((node->GetSourceObject() == this) && (node->event->eventnum == eventnum)) {
-            LL_Remove(node, next, prev);
+        if (node->event->eventnum == eventnum) {
+            Event::EventQueue.Remove(node);
             delete node->event;
             delete node;
         }
-        node = next;
     }
 }
 
@@ -3160,12 +3682,12 @@ void Listener::CancelFlaggedEvents(int flags)
     EventQueueNode *node;
     EventQueueNode *next;
 
-    node = Event::EventQueue.next;
+    Event::EventQueue.LinkListeners();
 
-    while (node != &Event::EventQueue) {
+    for (node = m_PendingEvents; node; node = next) {
         next = node->next;
-        if ((node->GetSourceObject() == this) && (node->flags & flags)) {
-            LL_Remove(node, next, prev);
+        if (node->flags & flags) {
+            Event::EventQueue.Remove(node);
             // Added in OPM
             //  Original doesn't delete the posted Event
             //  which would cause a memory leak
@@ -3173,7 +3695,6 @@ void Listener::CancelFlaggedEvents(int flags)
 
             delete node;
         }
-        node = next;
     }
 }
 
@@ -3185,18 +3706,13 @@ CancelPendingEvents
 void Listener::CancelPendingEvents(void)
 {
     EventQueueNode *node;
-    EventQueueNode *next;
 
-    node = Event::EventQueue.next;
+    Event::EventQueue.LinkListeners();
 
-    while (node != &Event::EventQueue) {
-        next = node->next;
-        if (node->GetSourceObject() == this) {
-            LL_Remove(node, next, prev);
-            delete node->event;
-            delete node;
-        }
-        node = next;
+    while ((node = m_PendingEvents) != NULL) {
+        Event::EventQueue.Remove(node);
+        delete node->event;
+        delete node;
     }
 }
 
@@ -3210,16 +3726,14 @@ qboolean Listener::EventPending(Event& ev)
     EventQueueNode *event;
     int             eventnum;
 
-    event = Event::EventQueue.next;
+    Event::EventQueue.LinkListeners();
 
     eventnum = ev.eventnum;
 
-    while (event != &Event::EventQueue) {
-        if ((event->GetSourceObject() == this) && (event->event->eventnum == ev.eventnum)) {
+    for (event = m_PendingEvents; event; event = event->next) {
+        if (event->event->eventnum == eventnum) {
             return true;
         }
-
-        event = event->next;
     }
 
     return false;
@@ -3233,8 +3747,6 @@ PostEventInternal
 EventQueueNode *Listener::PostEventInternal(Event *ev, float delay, int flags)
 {
     EventQueueNode *node;
-    EventQueueNode *i;
-    int             inttime;
 
 #if defined(GAME_DLL)
     if (LoadingSavegame) {
@@ -3257,14 +3769,7 @@ EventQueueNode *Listener::PostEventInternal(Event *ev, float delay, int flags)
 
     node = new EventQueueNode;
 
-    i       = Event::EventQueue.next;
-    inttime = EVENT_msec + (delay * 1000.0f + 0.5f);
-
-    while (i != &Event::EventQueue && inttime > i->inttime) {
-        i = i->next;
-    }
-
-    node->inttime = inttime;
+    node->inttime = EVENT_msec + (delay * 1000.0f + 0.5f);
     node->event   = ev;
     node->flags   = flags;
     node->SetSourceObject(this);
@@ -3273,7 +3778,7 @@ EventQueueNode *Listener::PostEventInternal(Event *ev, float delay, int flags)
     node->name = ev->name;
 #endif
 
-    LL_Add(i, node, next, prev);
+    Event::EventQueue.Add(node);
 
     return node;
 }
@@ -3300,6 +3805,18 @@ void Listener::PostEvent(const Event& ev, float delay, int flags)
     PostEventInternal(e, delay, flags);
 }
 
+/*
+=======================
+PostEvent
+=======================
+*/
+void Listener::PostEvent(Event&& ev, float delay, int flags)
+{
+    Event *e = new Event(std::move(ev));
+
+    PostEventInternal(e, delay, flags);
+}
+
 /*
 =======================
 PostponeAllEvents
@@ -3308,27 +3825,22 @@ PostponeAllEvents
 qboolean Listener::PostponeAllEvents(float time)
 {
     EventQueueNode *event;
-    EventQueueNode *node;
+    int             inttime;
 
-    event = Event::EventQueue.next;
-    while (event != &Event::EventQueue) {
-        if (event->GetSourceObject() == this) {
-            event->inttime += time * 1000.0f + 0.5f;
+    Event::EventQueue.LinkListeners();
 
-            node = event->next;
-            while ((node != &Event::EventQueue) && (event->inttime >= node->inttime)) {
-                node = node->next;
-            }
+    // only the first pending event is postponed
+    event = Event::EventQueue.FirstOf(this);
+    if (!event) {
+        return false;
+    }
 
-            LL_Remove(event, next, prev);
-            LL_Add(node, event, next, prev);
+    inttime = event->inttime;
+    inttime += time * 1000.0f + 0.5f;
 
-            return true;
-        }
-        event = event->next;
-    }
+    Event::EventQueue.Reschedule(event, inttime);
 
-    return false;
+    return true;
 }
 
 /*
@@ -3339,30 +3851,31 @@ PostponeEvent
 qboolean Listener::PostponeEvent(Event& ev, float time)
 {
     EventQueueNode *event;
-    EventQueueNode *node;
+    EventQueueNode *first;
     int             eventnum;
+    int             inttime;
+
+    Event::EventQueue.LinkListeners();
 
     eventnum = ev.eventnum;
 
-    event = Event::EventQueue.next;
-    while (event != &Event::EventQueue) {
-        if ((event->GetSourceObject() == this) && (event->event->eventnum == eventnum)) {
-            event->inttime += time * 1000.0f + 0.5f;
+    first = NULL;
+    for (event = m_PendingEvents; event; event = event->next) {
+        if (event->event->eventnum == eventnum && (!first || EventQueueHeap::CompareNodes(&event, &first) < 0)) {
+            first = event;
+        }
+    }
 
-            node = event->next;
-            while ((node != &Event::EventQueue) && (event->inttime >= node->inttime)) {
-                node = node->next;
-            }
+    if (!first) {
+        return false;
+    }
 
-            LL_Remove(event, next, prev);
-            LL_Add(node, event, next, prev);
+    inttime = first->inttime;
+    inttime += time * 1000.0f + 0.5f;
 
-            return true;
-        }
-        event = event->next;
-    }
+    Event::EventQueue.Reschedule(first, inttime);
 
-    return false;
+    return true;
 }
 
 /*
@@ -3399,6 +3912,18 @@ bool Listener::ProcessEvent(Event& ev)
     }
 }
 
+/*
+=======================
+ProcessEvent
+
+Temporary events are processed in place rather than copied
+=======================
+*/
+bool Listener::ProcessEvent(Event&& ev)
+{
+    return ProcessEvent(static_cast<Event&>(ev));
+}
+
 /*
 =======================
 ProcessEvent
@@ -3531,46 +4056,38 @@ ProcessPendingEvents
 */
 qboolean Listener::ProcessPendingEvents(void)
 {
-    EventQueueNode *event;
-    qboolean        processedEvents;
-    float           t;
+    SafePtr<Listener> self;
+    EventQueueNode   *event;
+    qboolean          processedEvents;
+    float             t;
 
     processedEvents = false;
+    // the listener may be deleted by one of its events
+    self = this;
 
     t = EVENT_msec;
 
     Listener::ProcessingEvents = true;
 
-    event = Event::EventQueue.next;
-    while (event != &Event::EventQueue) {
-        Listener *obj;
-
-        assert(event);
-
-        obj = event->GetSourceObject();
+    Event::EventQueue.LinkListeners();
 
+    // processing an event may post or cancel other events,
+    // so look for the first pending event again every time
+    while (self && (event = Event::EventQueue.FirstOf(this)) != NULL) {
         if (event->inttime > t) {
             break;
         }
 
-        if (obj != this) {
-            // traverse normally
-            event = event->next;
-        } else {
-            // the event is removed from its list and temporarily added to the active list
-            LL_Remove(event, next, prev);
-
-            // ProcessEvent will dispose of this event when it is done
-            obj->ProcessEvent(event->event);
+        // the event is removed from its list
+        Event::EventQueue.Remove(event);
 
-            // free up the node
-            delete event;
+        // ProcessEvent will dispose of this event when it is done
+        ProcessEvent(event->event);
 
-            // start over, since can't guarantee that we didn't process any previous or following events
-            event = Event::EventQueue.next;
+        // free up the node
+        delete event;
 
-            processedEvents = true;
-        }
+        processedEvents = true;
     }
 
     Listener::ProcessingEvents = false;
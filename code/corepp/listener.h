@@ -40,6 +40,7 @@ class ScriptVM;
 class SimpleEntity;
 class Archiver;
 class EventQueueNode;
+class EventQueueHeap;
 
 // entity subclass
 #define ECF_ENTITY        (1 << 0)
@@ -298,6 +299,10 @@ public:
     friend bool operator==(const command_t& cmd1, const command_t& cmd2);
 };
 
+// number of arguments stored inside the event itself,
+// events with more arguments take them from a pool
+#define EVENT_INLINE_ARGS 4
+
 class Event : public Class
 {
 public:
@@ -315,6 +320,12 @@ public:
 private:
     static DataNode *DataNodeList;
 
+    // ScriptVariable isn't complete here, listener.cpp checks the size
+    alignas(8) unsigned char inlineData[EVENT_INLINE_ARGS * 24];
+
+    void AllocData(int numArgs);
+    void TakeData(Event& ev);
+
 public:
     CLASS_PROTOTYPE(Event);
 
@@ -328,7 +339,7 @@ public:
 
     static void LoadEvents(void);
 
-    static EventQueueNode EventQueue;
+    static EventQueueHeap EventQueue;
 
     static int NumEventCommands();
 
@@ -417,6 +428,7 @@ public:
     void AddValue(const ScriptVariable& value);
     void AddVector(const Vector& vector);
     void CopyValues(const ScriptVariable *values, size_t count);
+    void MoveValues(ScriptVariable *values, size_t count);
 
     void Clear(void);
 
@@ -472,6 +484,15 @@ public:
     int               flags;
     SafePtr<Listener> m_sourceobject;
 
+    // index in the event queue heap, -1 when not queued
+    int heapIndex;
+    // queue order, used to break ties between events with the same time
+    unsigned int sequence;
+    // true if the node was placed after the nodes already at its time
+    bool appended;
+
+    // listener whose pending event list this node is linked into
+    Listener       *owner;
     EventQueueNode *prev;
     EventQueueNode *next;
 
@@ -481,8 +502,13 @@ public:
 
     EventQueueNode()
     {
-        prev = this;
-        next = this;
+        heapIndex = -1;
+        sequence  = 0;
+        appended  = false;
+
+        owner = NULL;
+        prev  = NULL;
+        next  = NULL;
 
 #ifdef _DEBUG
         name = NULL;
@@ -494,6 +520,48 @@ public:
     void SetSourceObject(Listener *obj) { m_sourceobject = obj; }
 };
 
+//
+// Pending events, kept in a binary heap ordered by inttime so posting
+// and cancelling are O(log n). Like the sorted list it replaces, a posted
+// event fires before the events already pending at the same time, while
+// a postponed or unarchived event fires after them. Each node is also linked
+// into the pending list of its listener so per-listener lookups
+// don't have to scan the whole queue.
+//
+class EventQueueHeap
+{
+private:
+    Container<EventQueueNode *> heap;
+    unsigned int                sequence;
+    bool                        hasUnlinkedNodes;
+
+private:
+    static bool Before(const EventQueueNode *node1, const EventQueueNode *node2);
+
+    void SetNodeAt(int index, EventQueueNode *node);
+    void SiftUp(int index);
+    void SiftDown(int index);
+    void Link(EventQueueNode *node);
+    void Unlink(EventQueueNode *node);
+
+public:
+    EventQueueHeap();
+
+    void            Add(EventQueueNode *node);
+    void            Append(EventQueueNode *node);
+    void            Remove(EventQueueNode *node);
+    void            Reschedule(EventQueueNode *node, int inttime);
+    void            LinkListeners(void);
+    void            Clear(void);
+    void            FreeNodes(void);
+    EventQueueNode *First(void) const;
+    EventQueueNode *FirstOf(Listener *listener) const;
+    EventQueueNode *NodeAt(int index) const;
+    int             NumNodes(void) const;
+
+    static int CompareNodes(const void *elem1, const void *elem2);
+};
+
 template<class Type1, class Type2>
 class con_map;
 
@@ -504,6 +572,8 @@ using ListenerPtr = SafePtr<Listener>;
 
 class Listener : public Class
 {
+    friend class EventQueueHeap;
+
 public:
 #ifdef WITH_SCRIPT_ENGINE
     con_set<const_str, ConList> *m_NotifyList;
@@ -516,6 +586,8 @@ public:
     static bool ProcessingEvents;
 
 private:
+    EventQueueNode *m_PendingEvents;
+
 #ifdef WITH_SCRIPT_ENGINE
     void ExecuteScriptInternal(Event *ev, ScriptVariable& scriptVariable);
     void ExecuteThreadInternal(Event *ev, ScriptVariable& returnValue);
@@ -554,6 +626,7 @@ public:
 
     void PostEvent(Event *ev, float delay, int flags = 0);
     void PostEvent(const Event& ev, float delay, int flags = 0);
+    void PostEvent(Event&& ev, float delay, int flags = 0);
 
     qboolean PostponeAllEvents(float time);
     qboolean PostponeEvent(Event& ev, float time);
@@ -561,6 +634,7 @@ public:
     bool            ProcessEvent(const Event& ev);
     bool            ProcessEvent(Event *ev);
     bool            ProcessEvent(Event& ev);
+    bool            ProcessEvent(Event&& ev);
     ScriptVariable& ProcessEventReturn(Event *ev);
 
     void ProcessContainerEvent(const Container<Event *>& conev);
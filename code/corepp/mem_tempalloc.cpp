@@ -60,10 +60,27 @@ MEM_TempAlloc::MEM_TempAlloc()
     m_CurrentMemoryPos   = 0;
     m_BlockSize          = 0;
     m_LastPos            = 0;
+    m_Used               = 0;
+    m_HighWaterMark      = 0;
+}
+
+MEM_TempAlloc::MEM_TempAlloc(size_t blockSize)
+{
+    m_CurrentMemoryBlock = nullptr;
+    m_CurrentMemoryPos   = 0;
+    m_BlockSize          = blockSize;
+    m_LastPos            = 0;
+    m_Used               = 0;
+    m_HighWaterMark      = 0;
 }
 
 void *MEM_TempAlloc::Alloc(size_t len)
 {
+    m_Used += len;
+    if (m_Used > m_HighWaterMark) {
+        m_HighWaterMark = m_Used;
+    }
+
     if (m_CurrentMemoryBlock && m_CurrentMemoryPos + len <= m_BlockSize) {
         void *data = m_CurrentMemoryBlock->GetData(m_CurrentMemoryPos);
         m_LastPos  = m_CurrentMemoryPos;
@@ -77,10 +94,20 @@ void *MEM_TempAlloc::Alloc(size_t len)
 void *MEM_TempAlloc::Alloc(size_t len, size_t alignment)
 {
     if (m_CurrentMemoryBlock) {
-        if (m_CurrentMemoryPos % alignment != 0) {
-            m_CurrentMemoryPos += alignment - m_CurrentMemoryPos % alignment;
-        }
+        // the alignment is a power of two,
+        // the padding counts towards the high-water mark
+        size_t alignedPos = (m_CurrentMemoryPos + alignment - 1) & ~(alignment - 1);
+
+        m_Used += alignedPos - m_CurrentMemoryPos;
+        m_CurrentMemoryPos = alignedPos;
+    }
+
+    m_Used += len;
+    if (m_Used > m_HighWaterMark) {
+        m_HighWaterMark = m_Used;
+    }
 
+    if (m_CurrentMemoryBlock) {
         if (m_CurrentMemoryPos + len <= m_BlockSize) {
             void *data = m_CurrentMemoryBlock->GetData(m_CurrentMemoryPos);
             m_LastPos  = m_CurrentMemoryPos;
@@ -99,6 +126,40 @@ void MEM_TempAlloc::FreeAll(void)
         MEM_TempFree(m_CurrentMemoryBlock);
         m_CurrentMemoryBlock = prev_block;
     }
+
+    m_CurrentMemoryPos = 0;
+    m_Used             = 0;
+}
+
+void MEM_TempAlloc::Reset(void)
+{
+    if (m_CurrentMemoryBlock && m_CurrentMemoryBlock->prev) {
+        // it didn't fit in one block, so use a block as big as
+        // the high-water mark from now on
+        FreeAll();
+
+        if (m_BlockSize && m_BlockSize < m_HighWaterMark) {
+            m_BlockSize = m_HighWaterMark;
+        }
+    }
+
+    m_CurrentMemoryPos = 0;
+    m_Used             = 0;
+}
+
+size_t MEM_TempAlloc::Used(void) const
+{
+    return m_Used;
+}
+
+size_t MEM_TempAlloc::HighWaterMark(void) const
+{
+    return m_HighWaterMark;
+}
+
+size_t MEM_TempAlloc::BlockSize(void) const
+{
+    return m_BlockSize;
 }
 
 void *MEM_TempAlloc::CreateBlock(size_t len)
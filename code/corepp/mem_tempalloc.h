@@ -32,16 +32,27 @@ class MEM_TempAlloc
 {
 public:
     MEM_TempAlloc();
+    // allocations are carved out of blocks of at least blockSize bytes
+    explicit MEM_TempAlloc(size_t blockSize);
 
     void *Alloc(size_t len);
+    // alignment must be a power of two
     void *Alloc(size_t len, size_t alignment);
     void  FreeAll(void);
+    // Frees everything but keeps a block big enough for the high-water mark
+    void  Reset(void);
     // This was added to fix issues with alignment
     void *CreateBlock(size_t len);
 
+    size_t Used(void) const;
+    size_t HighWaterMark(void) const;
+    size_t BlockSize(void) const;
+
 private:
     tempBlock_t *m_CurrentMemoryBlock;
     size_t       m_CurrentMemoryPos;
     size_t       m_BlockSize;
     size_t       m_LastPos;
+    size_t       m_Used;
+    size_t       m_HighWaterMark;
 };
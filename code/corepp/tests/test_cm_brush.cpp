@@ -0,0 +1,548 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../../qcommon/cm_local.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+cvar_t *developer;
+
+cvar_t *Cvar_Get(const char *var_name, const char *value, int flags)
+{
+    return NULL;
+}
+
+void Alias_Clear(void) {}
+
+void UI_LoadResource(const char *name) {}
+
+void *Hunk_Alloc(int size, ha_pref preference)
+{
+    return calloc(1, size);
+}
+
+void *Hunk_AllocateTempMemory(int size)
+{
+    return malloc(size);
+}
+
+void Hunk_FreeTempMemory(void *buf)
+{
+    free(buf);
+}
+
+// the map is built by the test, nothing is loaded
+long FS_FOpenFileRead(const char *filename, fileHandle_t *file, qboolean uniqueFILE, qboolean quiet)
+{
+    *file = 0;
+    return -1;
+}
+
+fileHandle_t FS_FOpenFileWrite(const char *qpath)
+{
+    return 0;
+}
+
+void FS_FCloseFile(fileHandle_t f) {}
+
+qboolean FS_FileNewer(const char *source, const char *destination)
+{
+    return qfalse;
+}
+
+void FS_FreeFile(void *buffer) {}
+
+char **FS_ListFiles(const char *directory, const char *extension, qboolean wantSubs, int *numfiles)
+{
+    *numfiles = 0;
+    return NULL;
+}
+
+size_t FS_Read(void *buffer, size_t len, fileHandle_t f)
+{
+    return 0;
+}
+
+long FS_ReadFile(const char *qpath, void **buffer)
+{
+    if (buffer) {
+        *buffer = NULL;
+    }
+    return -1;
+}
+
+int FS_Seek(fileHandle_t f, long offset, int origin)
+{
+    return -1;
+}
+
+size_t FS_Write(const void *buffer, size_t len, fileHandle_t f)
+{
+    return 0;
+}
+}
+
+static unsigned int seed = 0x4d6f4841;
+
+static int random_int(int max)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % max;
+}
+
+static float random_float(float min, float max)
+{
+    return min + (max - min) * random_int(65536) / 65535.f;
+}
+
+class test_brush
+{
+public:
+    cbrush_t                  brush;
+    std::vector<cplane_t>     planes;
+    std::vector<cbrushside_t> sides;
+    std::vector<csidebatch_t> batches;
+};
+
+class test_trace
+{
+public:
+    int      brushnum;
+    vec3_t   start;
+    vec3_t   end;
+    vec3_t   offsets[8];
+    sphere_t sphere;
+};
+
+static void set_plane(cplane_t& plane, const vec3_t normal, float dist)
+{
+    int j;
+
+    VectorCopy(normal, plane.normal);
+    plane.dist     = dist;
+    plane.signbits = 0;
+    for (j = 0; j < 3; j++) {
+        if (normal[j] < 0) {
+            plane.signbits |= 1 << j;
+        }
+    }
+}
+
+// the six axial planes first, like in the BSP, then bevels
+static void random_brush(test_brush& b)
+{
+    vec3_t center, normal;
+    float  size;
+    int    numsides;
+    int    i, j;
+
+    for (j = 0; j < 3; j++) {
+        center[j] = (float)(random_int(4096) - 2048);
+    }
+    size     = (float)(8 + random_int(256));
+    numsides = 6 + random_int(15);
+
+    b.planes.resize(numsides);
+    b.sides.resize(numsides);
+    b.batches.resize(CM_NumSideBatches(numsides));
+
+    for (i = 0; i < 6; i++) {
+        VectorClear(normal);
+        normal[i >> 1] = (i & 1) ? -1 : 1;
+        set_plane(b.planes[i], normal, DotProduct(center, normal) + size);
+    }
+
+    for (; i < numsides; i++) {
+        for (j = 0; j < 3; j++) {
+            normal[j] = random_float(-1, 1);
+        }
+        // some axial components, as in most maps
+        normal[random_int(3)] = 0;
+        VectorNormalize(normal);
+        set_plane(b.planes[i], normal, DotProduct(center, normal) + size * random_float(0.5f, 1.f));
+    }
+
+    memset(&b.brush, 0, sizeof(b.brush));
+    for (i = 0; i < numsides; i++) {
+        b.sides[i].plane = &b.planes[i];
+    }
+
+    b.brush.numsides = numsides;
+    b.brush.sides    = b.sides.data();
+    b.brush.batches  = b.batches.data();
+    CM_SetSideBatches(&b.brush);
+}
+
+static void random_trace(test_trace& tr, const test_brush& b)
+{
+    vec3_t size[2];
+    int    i, j;
+
+    // around the brush
+    for (j = 0; j < 3; j++) {
+        tr.start[j] = random_float(-b.planes[j * 2 + 1].dist - 200, b.planes[j * 2].dist + 200);
+        tr.end[j]   = random_int(4) ? tr.start[j] + random_float(-400, 400) : tr.start[j];
+    }
+
+    if (random_int(3)) {
+        for (j = 0; j < 3; j++) {
+            size[0][j] = -(float)random_int(32);
+            size[1][j] = (float)random_int(72);
+        }
+    } else {
+        VectorClear(size[0]);
+        VectorClear(size[1]);
+    }
+
+    // same as CM_BoxTrace
+    for (i = 0; i < 8; i++) {
+        for (j = 0; j < 3; j++) {
+            tr.offsets[i][j] = size[(i >> j) & 1][j];
+        }
+    }
+
+    tr.sphere.use    = random_int(4) == 0;
+    tr.sphere.radius = random_float(0, 32);
+    tr.sphere.offset[0] = random_float(-8, 8);
+    tr.sphere.offset[1] = random_float(-8, 8);
+    tr.sphere.offset[2] = random_float(0, 40);
+}
+
+// the distances as CM_TraceThroughBrush computed them before the batches, one plane at a time
+static void legacy_distance(const test_trace& tr, const cplane_t *plane, float& d1, float& d2)
+{
+    float dist;
+    float t;
+
+    if (tr.sphere.use) {
+        t = DotProduct(plane->normal, tr.sphere.offset);
+        if (t < 0) {
+            t = -t;
+        }
+
+        dist = t + plane->dist + tr.sphere.radius;
+    } else {
+        dist = plane->dist - DotProduct(tr.offsets[plane->signbits], plane->normal);
+    }
+
+    d1 = DotProduct(tr.start, plane->normal) - dist;
+    d2 = DotProduct(tr.end, plane->normal) - dist;
+}
+
+// returns the first plane the trace is completely in front of, or -1
+static int legacy_test_brush(const test_trace& tr, const test_brush& b)
+{
+    float d1, d2;
+    int   i;
+
+    for (i = 0; i < b.brush.numsides; i++) {
+        legacy_distance(tr, b.sides[i].plane, d1, d2);
+
+        if (d1 > 0 && (d2 >= SURFACE_CLIP_EPSILON || d2 >= d1)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static bool batched_test_brush(const test_trace& tr, const test_brush& b)
+{
+    float d1[CM_SIDE_BATCH], d2[CM_SIDE_BATCH];
+    int   i;
+
+    for (i = 0; i < b.brush.numsides; i += CM_SIDE_BATCH) {
+        if (CM_TestSideBatch(
+                &b.brush.batches[i / CM_SIDE_BATCH],
+                tr.start,
+                tr.end,
+                tr.offsets,
+                tr.sphere.use ? &tr.sphere : NULL,
+                d1,
+                d2
+            )) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool test_side_batches()
+{
+    test_brush b;
+    test_trace tr;
+    float      d1[CM_SIDE_BATCH], d2[CM_SIDE_BATCH];
+    float      ld1, ld2;
+    int        pass;
+    int        mask;
+    int        i, j;
+    int        numOut = 0;
+
+    for (pass = 0; pass < 20000; pass++) {
+        if (!(pass % 16)) {
+            random_brush(b);
+        }
+        random_trace(tr, b);
+
+        for (i = 0; i < b.brush.numsides; i += CM_SIDE_BATCH) {
+            mask = CM_TestSideBatch(
+                &b.brush.batches[i / CM_SIDE_BATCH],
+                tr.start,
+                tr.end,
+                tr.offsets,
+                tr.sphere.use ? &tr.sphere : NULL,
+                d1,
+                d2
+            );
+
+            for (j = 0; j < CM_SIDE_BATCH; j++) {
+                if (i + j >= b.brush.numsides) {
+                    // padding
+                    if (mask & (1 << j)) {
+                        std::cerr << "Pass " << pass << ": the trace is in front of an empty plane" << std::endl;
+                        return false;
+                    }
+                    continue;
+                }
+
+                legacy_distance(tr, b.sides[i + j].plane, ld1, ld2);
+
+                // must be the same bits
+                if (memcmp(&ld1, &d1[j], sizeof(float)) || memcmp(&ld2, &d2[j], sizeof(float))) {
+                    std::cerr << "Pass " << pass << ", side " << i + j << ": distances " << d1[j] << " " << d2[j]
+                              << " instead of " << ld1 << " " << ld2 << std::endl;
+                    return false;
+                }
+
+                if (!!(mask & (1 << j)) != (ld1 > 0 && (ld2 >= SURFACE_CLIP_EPSILON || ld2 >= ld1))) {
+                    std::cerr << "Pass " << pass << ", side " << i + j << ": wrong mask" << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        if ((legacy_test_brush(tr, b) != -1) != batched_test_brush(tr, b)) {
+            std::cerr << "Pass " << pass << ": the brush test differs" << std::endl;
+            return false;
+        }
+
+        if (legacy_test_brush(tr, b) != -1) {
+            numOut++;
+        }
+    }
+
+    // make sure both cases were covered
+    if (!numOut || numOut == pass) {
+        std::cerr << "The traces are all on the same side (" << numOut << "/" << pass << ")" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void bench_side_batches()
+{
+    const int               numBrushes = 256;
+    const int               numTraces  = 4096;
+    const int               numPasses  = 50;
+    std::vector<test_brush> brushes(numBrushes);
+    std::vector<test_trace> traces(numTraces);
+    int                     count1, count2;
+    int                     pass;
+    int                     i;
+
+    for (i = 0; i < numBrushes; i++) {
+        random_brush(brushes[i]);
+    }
+
+    for (i = 0; i < numTraces; i++) {
+        traces[i].brushnum = random_int(numBrushes);
+        random_trace(traces[i], brushes[traces[i].brushnum]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    count1 = 0;
+    for (pass = 0; pass < numPasses; pass++) {
+        for (i = 0; i < numTraces; i++) {
+            count1 += legacy_test_brush(traces[i], brushes[traces[i].brushnum]) != -1;
+        }
+    }
+
+    auto middle = std::chrono::steady_clock::now();
+
+    count2 = 0;
+    for (pass = 0; pass < numPasses; pass++) {
+        for (i = 0; i < numTraces; i++) {
+            count2 += batched_test_brush(traces[i], brushes[traces[i].brushnum]);
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    double legacy  = std::chrono::duration<double, std::nano>(middle - start).count() / (numTraces * numPasses);
+    double batched = std::chrono::duration<double, std::nano>(end - middle).count() / (numTraces * numPasses);
+
+    std::cout << "Brush planes: one by one " << legacy << " ns, batches of " << CM_SIDE_BATCH << " " << batched
+              << " ns per brush";
+    if (count1 != count2) {
+        std::cout << " (MISMATCH " << count1 << " != " << count2 << ")";
+    }
+    std::cout << std::endl;
+}
+
+static bool same_trace(const trace_t& a, const trace_t& b)
+{
+    return a.fraction == b.fraction && a.allsolid == b.allsolid && a.startsolid == b.startsolid
+        && VectorCompare(a.endpos, b.endpos) && VectorCompare(a.plane.normal, b.plane.normal);
+}
+
+bool test_box_trace_batch()
+{
+    const int               numBrushes = 64;
+    const int               numTraces  = 4096;
+    std::vector<test_brush> brushes(numBrushes);
+    std::vector<cbrush_t>   cmBrushes(numBrushes);
+    std::vector<int>        leafBrushes(numBrushes);
+    std::vector<boxTrace_t> traces(numTraces);
+    std::vector<trace_t>    expected(numTraces);
+    cplane_t                nodePlane;
+    cNode_t                 node;
+    cLeaf_t                 leafs[2];
+    cmodel_t                world;
+    cvar_t                  noCurves;
+    vec3_t                  normal;
+    int                     numHit;
+    int                     pass;
+    int                     i, j;
+
+    for (i = 0; i < numBrushes; i++) {
+        random_brush(brushes[i]);
+        cmBrushes[i]          = brushes[i].brush;
+        cmBrushes[i].contents = CONTENTS_SOLID;
+        leafBrushes[i]        = i;
+    }
+
+    // a single node splitting the world in two leafs that both hold every brush,
+    // so a trace crossing the node must skip the brushes it already tested
+    VectorSet(normal, 1, 0, 0);
+    set_plane(nodePlane, normal, 0);
+    nodePlane.type   = PLANE_X;
+    node.plane       = &nodePlane;
+    node.children[0] = -1;
+    node.children[1] = -2;
+
+    memset(leafs, 0, sizeof(leafs));
+    for (i = 0; i < 2; i++) {
+        leafs[i].numLeafBrushes = numBrushes;
+    }
+
+    memset(&world, 0, sizeof(world));
+    memset(&noCurves, 0, sizeof(noCurves));
+    noCurves.integer = 1;
+    cm_noCurves      = &noCurves;
+
+    cm.numBrushes     = numBrushes;
+    cm.brushes        = cmBrushes.data();
+    cm.numLeafBrushes = numBrushes;
+    cm.leafbrushes    = leafBrushes.data();
+    cm.numNodes       = 1;
+    cm.nodes          = &node;
+    cm.numLeafs       = 2;
+    cm.leafs          = leafs;
+    cm.numSubModels   = 1;
+    cm.cmodels        = &world;
+
+    for (i = 0; i < numTraces; i++) {
+        boxTrace_t& bt = traces[i];
+
+        for (j = 0; j < 3; j++) {
+            bt.start[j] = random_float(-2400, 2400);
+            bt.end[j]   = bt.start[j] + random_float(-1200, 1200);
+            bt.mins[j]  = (i & 1) ? -(float)random_int(32) : 0;
+            bt.maxs[j]  = (i & 1) ? (float)random_int(72) : 0;
+        }
+
+        bt.model     = 0;
+        bt.brushmask = CONTENTS_SOLID;
+        bt.cylinder  = (i % 8) == 1;
+    }
+
+    numHit = 0;
+    for (i = 0; i < numTraces; i++) {
+        boxTrace_t& bt = traces[i];
+
+        CM_BoxTrace(&expected[i], bt.start, bt.end, bt.mins, bt.maxs, bt.model, bt.brushmask, bt.cylinder);
+        if (expected[i].fraction < 1) {
+            numHit++;
+        }
+    }
+
+    if (!numHit || numHit == numTraces) {
+        std::cerr << "The traces all have the same result (" << numHit << "/" << numTraces << ")" << std::endl;
+        return false;
+    }
+
+    for (pass = 0; pass < 8; pass++) {
+        for (i = 0; i < numTraces; i++) {
+            memset(&traces[i].trace, 0, sizeof(traces[i].trace));
+        }
+
+        CM_BoxTraceBatch(traces.data(), numTraces, pass % 4);
+
+        for (i = 0; i < numTraces; i++) {
+            if (!same_trace(traces[i].trace, expected[i])) {
+                std::cerr << "Pass " << pass << ", trace " << i << ": fraction " << traces[i].trace.fraction
+                          << " instead of " << expected[i].fraction << std::endl;
+                return false;
+            }
+        }
+    }
+
+    Com_ShutdownJobs();
+    memset(&cm, 0, sizeof(cm));
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!test_side_batches()) {
+        std::cerr << "Side batches differ from the plane by plane test!" << std::endl;
+        return 1;
+    }
+
+    if (!test_box_trace_batch()) {
+        std::cerr << "Batched traces differ from single traces!" << std::endl;
+        return 1;
+    }
+
+    bench_side_batches();
+
+    return 0;
+}
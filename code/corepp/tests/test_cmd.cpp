@@ -0,0 +1,267 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../../qcommon/q_shared.h"
+#include "../../qcommon/qcommon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+extern "C" {
+void Z_InitMemory(void);
+void Z_Shutdown(void);
+
+const char *Cmd_CompleteCommand(const char *partial);
+
+cvar_t *com_cl_running;
+cvar_t *com_sv_running;
+int     cvar_modifiedFlags;
+
+static int numForwarded;
+
+void QDECL Com_Printf(const char *fmt, ...) {}
+
+void QDECL Com_DPrintf(const char *fmt, ...) {}
+
+void QDECL Com_Error(int code, const char *fmt, ...)
+{
+    va_list argptr;
+
+    va_start(argptr, fmt);
+    vfprintf(stderr, fmt, argptr);
+    va_end(argptr);
+
+    fputc('\n', stderr);
+    exit(1);
+}
+
+char *CopyString(const char *in)
+{
+    char *out = (char *)Z_Malloc(strlen(in) + 1);
+    strcpy(out, in);
+    return out;
+}
+
+int Com_Filter(const char *filter, const char *name, int casesensitive)
+{
+    return 1;
+}
+
+qboolean Cvar_Command(void)
+{
+    return qfalse;
+}
+
+void Cvar_CompleteCvarName(const char *args, int argNum) {}
+
+char *Cvar_VariableString(const char *var_name)
+{
+    static char empty[1];
+    return empty;
+}
+
+qboolean CL_GameCommand(void)
+{
+    return qfalse;
+}
+
+qboolean SV_GameCommand(void)
+{
+    return qfalse;
+}
+
+void CL_ForwardCommandToServer(const char *string)
+{
+    numForwarded++;
+}
+
+void Field_CompleteFilename(const char *dir, const char *ext, qboolean stripExt, qboolean allowNonPureFilesOnDisk) {}
+
+long FS_ReadFile(const char *qpath, void **buffer)
+{
+    return -1;
+}
+
+void FS_FreeFile(void *buffer) {}
+
+void QDECL FS_Printf(fileHandle_t f, const char *fmt, ...) {}
+
+int Sys_Milliseconds(void)
+{
+    return 0;
+}
+}
+
+static int numExecuted;
+
+static void Test_f(void)
+{
+    numExecuted++;
+}
+
+static std::vector<std::string> make_names(int count)
+{
+    static const char        *prefixes[] = {"cl_", "sv_", "g_", "r_", "snd_", "ui_", "net_", "com_"};
+    std::vector<std::string> names;
+    int                      i;
+
+    for (i = 0; i < count; i++) {
+        names.push_back(std::string(prefixes[i % 8]) + "cmd" + std::to_string(i));
+    }
+
+    return names;
+}
+
+static bool test_execute(const std::vector<std::string>& names)
+{
+    size_t i;
+
+    for (i = 0; i < names.size(); i++) {
+        Cmd_AddCommand(names[i].c_str(), Test_f);
+    }
+
+    numExecuted = 0;
+    for (i = 0; i < names.size(); i++) {
+        std::string upper = names[i];
+
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        Cmd_ExecuteString(upper.c_str());
+    }
+
+    if (numExecuted != (int)names.size()) {
+        std::cerr << "Executed " << numExecuted << " commands instead of " << names.size() << std::endl;
+        return false;
+    }
+
+    // commands only differing in case aren't removed
+    Cmd_RemoveCommand("CL_CMD0");
+    numForwarded = 0;
+    Cmd_ExecuteString("cl_cmd0");
+    if (numForwarded || numExecuted != (int)names.size() + 1) {
+        std::cerr << "Command was removed with a different case" << std::endl;
+        return false;
+    }
+
+    // remove every other command, then check the remaining ones
+    for (i = 0; i < names.size(); i += 2) {
+        Cmd_RemoveCommand(names[i].c_str());
+    }
+
+    numExecuted  = 0;
+    numForwarded = 0;
+    for (i = 0; i < names.size(); i++) {
+        Cmd_ExecuteString(names[i].c_str());
+    }
+
+    if (numExecuted != (int)names.size() / 2 || numForwarded != (int)names.size() / 2) {
+        std::cerr << "Removed commands are still executed" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+static bool test_completion(const std::vector<std::string>& names, const char *partial)
+{
+    std::vector<std::string> expected;
+    const char              *name;
+    size_t                   i;
+
+    for (i = 1; i < names.size(); i += 2) {
+        if (!Q_stricmpn(partial, names[i].c_str(), strlen(partial))) {
+            expected.push_back(names[i]);
+        }
+    }
+
+    std::sort(expected.begin(), expected.end(), [](const std::string& a, const std::string& b) {
+        return Q_stricmp(a.c_str(), b.c_str()) < 0;
+    });
+
+    for (i = 0; (name = Cmd_CompleteCommandByNumber(partial, (int)i)); i++) {
+        if (i >= expected.size() || expected[i] != name) {
+            std::cerr << "Wrong completion " << name << " for " << partial << std::endl;
+            return false;
+        }
+    }
+
+    if (i != expected.size()) {
+        std::cerr << "Found " << i << " completions for " << partial << " instead of " << expected.size()
+                  << std::endl;
+        return false;
+    }
+
+    name = Cmd_CompleteCommand(partial);
+    if (expected.size() ? !name || expected[0] != name : name != NULL) {
+        std::cerr << "Wrong first completion for " << partial << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+static void bench_execute(const std::vector<std::string>& names)
+{
+    const int iterations = 200000;
+    int       i;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (i = 0; i < iterations; i++) {
+        Cmd_ExecuteString(names[(i * 7919) % names.size() | 1].c_str());
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << names.size() / 2 << " commands: "
+              << std::chrono::duration<double, std::nano>(end - start).count() / iterations
+              << " ns per Cmd_ExecuteString" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> names = make_names(1200);
+
+    Z_InitMemory();
+
+    if (!test_execute(names)) {
+        return 1;
+    }
+
+    for (const char *partial : {"c", "CL_", "sv_cmd1", "g_cmd1199", "net_cmd9", "x", "com_cmd1199_"}) {
+        if (!test_completion(names, partial)) {
+            return 1;
+        }
+    }
+
+    bench_execute(names);
+
+    Z_Shutdown();
+
+    return 0;
+}
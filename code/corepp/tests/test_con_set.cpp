@@ -0,0 +1,290 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../con_set.h"
+#include "../str.h"
+#include "../short3.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+static unsigned int seed = 0x4d6f4841;
+
+static int random_int(int max)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % max;
+}
+
+static bool test_against_map()
+{
+    con_set<int, int>  set;
+    std::map<int, int> reference;
+    int                i;
+
+    for (i = 0; i < 200000; i++) {
+        int key = random_int(5000);
+
+        switch (random_int(3)) {
+        case 0:
+            set.addKeyValue(key) = i;
+            reference[key]       = i;
+            break;
+        case 1:
+            if (set.remove(key) != (reference.erase(key) != 0)) {
+                std::cerr << "Removing key " << key << " failed" << std::endl;
+                return false;
+            }
+            break;
+        case 2:
+            {
+                int *value = set.findKeyValue(key);
+                auto it    = reference.find(key);
+
+                if ((value != NULL) != (it != reference.end()) || (value && *value != it->second)) {
+                    std::cerr << "Finding key " << key << " failed" << std::endl;
+                    return false;
+                }
+            }
+            break;
+        }
+
+        if (set.size() != reference.size()) {
+            std::cerr << "Size mismatch: " << set.size() << " != " << reference.size() << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool test_stability()
+{
+    con_set<int, int>                  set;
+    con_set_enum<int, int>             en;
+    con_set_enum<int, int>::Entry     *entry;
+    std::vector<int *>                 values;
+    std::map<int, int>                 seen;
+    int                                i;
+
+    for (i = 0; i < 1000; i++) {
+        int *value = &set.addKeyValue(i);
+
+        *value = i * 3;
+        values.push_back(value);
+    }
+
+    // growing the table doesn't move the entries
+    for (i = 1000; i < 50000; i++) {
+        set.addKeyValue(i) = i * 3;
+    }
+
+    for (i = 0; i < 1000; i++) {
+        if (set.findKeyValue(i) != values[i] || *values[i] != i * 3) {
+            std::cerr << "Entry " << i << " moved" << std::endl;
+            return false;
+        }
+    }
+
+    // remove the odd keys while enumerating
+    en = set;
+    for (entry = en.NextElement(); entry; entry = en.NextElement()) {
+        int key = entry->GetKey();
+
+        seen[key]++;
+        if (key & 1) {
+            set.remove(key);
+        }
+    }
+
+    if (seen.size() != 50000 || set.size() != 25000) {
+        std::cerr << "Enumeration visited " << seen.size() << " entries, " << set.size() << " left" << std::endl;
+        return false;
+    }
+
+    for (auto& it : seen) {
+        if (it.second != 1) {
+            std::cerr << "Entry " << it.first << " was enumerated twice" << std::endl;
+            return false;
+        }
+    }
+
+    for (i = 0; i < 50000; i++) {
+        if (set.keyExists(i) == ((i & 1) != 0)) {
+            std::cerr << "Key " << i << " is wrong after enumeration" << std::endl;
+            return false;
+        }
+    }
+
+    set.clear();
+    if (!set.isEmpty() || set.findKeyValue(0) || set.firstKeyValue()) {
+        std::cerr << "Cleared set isn't empty" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+static bool test_map()
+{
+    con_map<str, int>      map;
+    con_map_enum<str, int> en;
+    int                   *value;
+    int                    total;
+    int                    i;
+
+    for (i = 0; i < 1000; i++) {
+        map[str(i)] = i;
+    }
+
+    for (i = 0; i < 1000; i += 2) {
+        map.remove(str(i));
+    }
+
+    total = 0;
+    en    = map;
+    for (value = en.NextValue(); value; value = en.NextValue()) {
+        if (*en.CurrentKey() != str(*value) || !(*value & 1)) {
+            std::cerr << "Map entry " << *value << " is wrong" << std::endl;
+            return false;
+        }
+        total++;
+    }
+
+    if (total != 500 || map.size() != 500 || !map.find("999") || map.find("998")) {
+        std::cerr << "Map has " << total << " entries" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+template<typename k>
+static void bench_set(const char *name, const std::vector<k>& keys)
+{
+    const int         numRounds = 20;
+    con_set<k, int>   set;
+    size_t            i;
+    int               round;
+    int               found = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (i = 0; i < keys.size(); i++) {
+        set.addKeyValue(keys[i]) = (int)i;
+    }
+
+    auto middle = std::chrono::steady_clock::now();
+
+    for (round = 0; round < numRounds; round++) {
+        for (i = 0; i < keys.size(); i++) {
+            found += set.findKeyValue(keys[i]) != NULL;
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << name << " keys: " << std::chrono::duration<double, std::nano>(middle - start).count() / keys.size()
+              << " ns per insert, "
+              << std::chrono::duration<double, std::nano>(end - middle).count() / (keys.size() * numRounds)
+              << " ns per lookup (" << found << " found)" << std::endl;
+}
+
+// Like the variable lists of the script objects, a lot of small sets
+static void bench_small_sets()
+{
+    const int                             numSets   = 20000;
+    const int                             numVars   = 8;
+    const int                             numRounds = 20;
+    std::vector<con_set<short3, int> *>   sets;
+    int                                   i, j;
+    int                                   round;
+    int                                   found = 0;
+
+    for (i = 0; i < numSets; i++) {
+        sets.push_back(new con_set<short3, int>);
+        for (j = 0; j < numVars; j++) {
+            sets[i]->addKeyValue(short3(random_int(2000))) = j;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (round = 0; round < numRounds; round++) {
+        for (i = 0; i < numSets; i++) {
+            for (j = 0; j < numVars; j++) {
+                found += sets[i]->findKeyValue(short3(j * 250)) != NULL;
+            }
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "small sets: "
+              << std::chrono::duration<double, std::nano>(end - start).count() / (numSets * numVars * numRounds)
+              << " ns per lookup (" << found << " found)" << std::endl;
+
+    for (i = 0; i < numSets; i++) {
+        delete sets[i];
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<int> intKeys;
+    std::vector<str> strKeys;
+    int              i;
+
+    if (!test_against_map()) {
+        return 1;
+    }
+
+    if (!test_stability()) {
+        return 1;
+    }
+
+    if (!test_map()) {
+        return 1;
+    }
+
+    for (i = 0; i < 200000; i++) {
+        intKeys.push_back(i * 7);
+        strKeys.push_back(str("local.var") + str(i));
+    }
+
+    // don't look up the keys in the order of the allocations
+    for (i = (int)intKeys.size() - 1; i > 0; i--) {
+        int j = random_int(i + 1);
+
+        std::swap(intKeys[i], intKeys[j]);
+        std::swap(strKeys[i], strKeys[j]);
+    }
+
+    bench_set<int>("int", intKeys);
+    bench_set<str>("str", strKeys);
+    bench_small_sets();
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../con_timer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+static unsigned int seed = 0x4d6f4841;
+
+static int random_int(int max)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % max;
+}
+
+static Class *thread_at(int index)
+{
+    // the timer never dereferences the elements
+    return (Class *)(uintptr_t)(index + 1);
+}
+
+//
+// Reference implementation: the linear scan used before the heap
+//
+class reference_timer
+{
+public:
+    std::vector<std::pair<Class *, int>> elements;
+    int                                  inttime = 0;
+
+    void AddElement(Class *e, int time) { elements.push_back(std::make_pair(e, time)); }
+
+    void RemoveElement(Class *e)
+    {
+        for (size_t i = elements.size(); i > 0; i--) {
+            if (elements[i - 1].first == e) {
+                elements.erase(elements.begin() + (i - 1));
+                return;
+            }
+        }
+    }
+
+    Class *GetNextElement(int& foundtime)
+    {
+        int best_inttime = inttime;
+        int foundIndex   = -1;
+
+        for (size_t i = elements.size(); i > 0; i--) {
+            if (elements[i - 1].second <= best_inttime) {
+                best_inttime = elements[i - 1].second;
+                foundIndex   = (int)i - 1;
+            }
+        }
+
+        if (foundIndex == -1) {
+            return NULL;
+        }
+
+        Class *result = elements[foundIndex].first;
+        foundtime     = best_inttime;
+        elements.erase(elements.begin() + foundIndex);
+        return result;
+    }
+};
+
+bool test_order()
+{
+    con_timer       timer;
+    reference_timer reference;
+    int             frame;
+    int             i;
+
+    for (frame = 0; frame < 200; frame++) {
+        int time = frame * 50;
+
+        // threads waiting a few frames, with many sharing the same time
+        for (i = 0; i < 50; i++) {
+            Class *e    = thread_at(random_int(300));
+            int    wait = time + random_int(8) * 25;
+
+            timer.AddElement(e, wait);
+            reference.AddElement(e, wait);
+        }
+
+        // threads being stopped or deleted while waiting
+        for (i = 0; i < 10; i++) {
+            Class *e = thread_at(random_int(300));
+
+            timer.RemoveElement(e);
+            reference.RemoveElement(e);
+        }
+
+        timer.SetTime(time);
+        reference.inttime = time;
+
+        for (;;) {
+            int    foundTime1 = 0, foundTime2 = 0;
+            Class *e1 = timer.GetNextElement(foundTime1);
+            Class *e2 = reference.GetNextElement(foundTime2);
+
+            if (e1 != e2 || foundTime1 != foundTime2) {
+                std::cerr << "Frame " << frame << ": got element " << (uintptr_t)e1 << " at " << foundTime1
+                          << ", expected " << (uintptr_t)e2 << " at " << foundTime2 << std::endl;
+                return false;
+            }
+
+            if (!e1) {
+                break;
+            }
+        }
+
+        if (timer.NumElements() != (int)reference.elements.size()) {
+            std::cerr << "Frame " << frame << ": " << timer.NumElements() << " elements, expected "
+                      << reference.elements.size() << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void bench_frames(int numThreads)
+{
+    const int numFrames = 400;
+    const int frameTime = 25; // sv_fps 40
+    con_timer timer;
+    int       frame;
+    int       woken;
+    int       i;
+
+    for (i = 0; i < numThreads; i++) {
+        timer.AddElement(thread_at(i), random_int(1000));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    woken = 0;
+    for (frame = 0; frame < numFrames; frame++) {
+        int    time = frame * frameTime;
+        int    foundTime;
+        Class *e;
+
+        timer.SetTime(time);
+
+        // like ScriptMaster::ExecuteRunning, each thread waits again once woken up
+        while ((e = timer.GetNextElement(foundTime))) {
+            timer.AddElement(e, time + frameTime + random_int(1000));
+            woken++;
+        }
+    }
+
+    auto   end   = std::chrono::steady_clock::now();
+    double total = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::cout << numThreads << " waiting threads: " << (total / numFrames) << " ms per frame, "
+              << (woken / numFrames) << " threads woken per frame" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!test_order()) {
+        std::cerr << "Timer order differs from the reference!" << std::endl;
+        return 1;
+    }
+
+    bench_frames(5000);
+    bench_frames(20000);
+
+    return 0;
+}
@@ -0,0 +1,324 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../../fgame/entitygrid.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+static unsigned int seed = 0x4d6f4841;
+
+static int random_int(int max)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % max;
+}
+
+static float random_coord()
+{
+    // roughly the size of a large map
+    return (float)(random_int(8192) - 4096);
+}
+
+class test_entity
+{
+public:
+    bool         inuse;
+    vec3_t       centroid;
+    float        radius;
+    unsigned int order;
+    test_entity *prev;
+    test_entity *next;
+};
+
+static EntityGrid               grid;
+static std::vector<test_entity> entities(MAX_GENTITIES);
+static unsigned int             order;
+// like the active edicts in the game, in the order they were spawned
+static test_entity              active_entities;
+
+static void spawn_entity(int num)
+{
+    test_entity& e = entities[num];
+
+    e.inuse       = true;
+    e.centroid[0] = random_coord();
+    e.centroid[1] = random_coord();
+    e.centroid[2] = (float)random_int(512);
+    // mostly small entities, with a few large brush models
+    e.radius = random_int(100) ? (float)random_int(64) : (float)random_int(2048);
+    e.order  = ++order;
+
+    e.prev                     = active_entities.prev;
+    e.next                     = &active_entities;
+    active_entities.prev->next = &e;
+    active_entities.prev       = &e;
+
+    grid.Insert(num, e.centroid, e.radius);
+}
+
+static void move_entity(int num)
+{
+    test_entity& e = entities[num];
+
+    e.centroid[0] += random_int(512) - 256;
+    e.centroid[1] += random_int(512) - 256;
+
+    grid.Update(num, e.centroid, e.radius);
+}
+
+static void free_entity(int num)
+{
+    test_entity& e = entities[num];
+
+    e.inuse      = false;
+    e.prev->next = e.next;
+    e.next->prev = e.prev;
+    grid.Remove(num);
+}
+
+// same test as findradius
+static bool in_radius(const test_entity& e, const vec3_t org, float rad)
+{
+    vec3_t delta;
+    float  distance;
+
+    VectorSubtract(org, e.centroid, delta);
+    distance = DotProduct(delta, delta);
+
+    return distance <= rad * rad || distance - e.radius * e.radius <= rad * rad;
+}
+
+static void clear_entities()
+{
+    int i;
+
+    for (i = 0; i < MAX_GENTITIES; i++) {
+        entities[i].inuse = false;
+    }
+
+    active_entities.prev = &active_entities;
+    active_entities.next = &active_entities;
+    grid.Clear();
+}
+
+// what findradius did before the grid, walking the active list
+static int find_linear(const vec3_t org, float rad)
+{
+    test_entity *e;
+    int          count = 0;
+
+    for (e = active_entities.next; e != &active_entities; e = e->next) {
+        if (in_radius(*e, org, rad)) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+// what findradius does now
+static int find_grid(const vec3_t org, float rad, int *list)
+{
+    int count = 0;
+    int num;
+    int i;
+
+    if (!grid.IsLocalQuery(org, rad)) {
+        return find_linear(org, rad);
+    }
+
+    num = grid.Query(org, rad, list, MAX_GENTITIES);
+    for (i = 0; i < num; i++) {
+        if (in_radius(entities[list[i]], org, rad)) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+bool test_queries()
+{
+    static const float radii[] = {50, 384, 1024, 4096};
+    int                list[MAX_GENTITIES];
+    int                numEntities = 800;
+    int                frame;
+    int                i, j;
+
+    clear_entities();
+    for (i = 0; i < numEntities; i++) {
+        spawn_entity(i);
+    }
+
+    for (frame = 0; frame < 200; frame++) {
+        for (i = 0; i < 50; i++) {
+            int num = random_int(numEntities);
+
+            if (!entities[num].inuse) {
+                spawn_entity(num);
+            } else if (random_int(4)) {
+                move_entity(num);
+            } else {
+                free_entity(num);
+            }
+        }
+
+        for (i = 0; i < 20; i++) {
+            vec3_t org;
+            float  rad = radii[random_int(4)];
+            int    count;
+
+            org[0] = random_coord();
+            org[1] = random_coord();
+            org[2] = (float)random_int(512);
+
+            count = grid.Query(org, rad, list, MAX_GENTITIES);
+
+            // the grid must return the entities in the order they were inserted
+            for (j = 1; j < count; j++) {
+                if (entities[list[j - 1]].order >= entities[list[j]].order) {
+                    std::cerr << "Frame " << frame << ": entities are not returned in order" << std::endl;
+                    return false;
+                }
+            }
+
+            // and never miss an entity
+            for (j = 0; j < numEntities; j++) {
+                if (!entities[j].inuse || !in_radius(entities[j], org, rad)) {
+                    continue;
+                }
+
+                int k;
+                for (k = 0; k < count; k++) {
+                    if (list[k] == j) {
+                        break;
+                    }
+                }
+
+                if (k == count) {
+                    std::cerr << "Frame " << frame << ": entity " << j << " is missing with radius " << rad
+                              << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// returns false if the grid is slower than walking the active list
+bool bench_queries(int numEntities, float rad)
+{
+    const int numQueries = 20000;
+    const int numRuns    = 5;
+    int       list[MAX_GENTITIES];
+    int       found1, found2;
+    double    linear, query;
+    int       run;
+    int       i;
+
+    clear_entities();
+    for (i = 0; i < numEntities; i++) {
+        spawn_entity(i);
+    }
+
+    // let entities come and go for a while so the active list is no longer sorted by number
+    for (i = 0; i < numEntities * 4; i++) {
+        int num = random_int(numEntities);
+
+        free_entity(num);
+        spawn_entity(num);
+    }
+
+    std::vector<vec3_t> origins(numQueries);
+    for (i = 0; i < numQueries; i++) {
+        origins[i][0] = random_coord();
+        origins[i][1] = random_coord();
+        origins[i][2] = (float)random_int(512);
+    }
+
+    // best of a few runs, to keep the noise out of the comparison
+    linear = query = 0;
+    for (run = 0; run < numRuns; run++) {
+        auto start = std::chrono::steady_clock::now();
+
+        found1 = 0;
+        for (i = 0; i < numQueries; i++) {
+            found1 += find_linear(origins[i], rad);
+        }
+
+        auto middle = std::chrono::steady_clock::now();
+
+        found2 = 0;
+        for (i = 0; i < numQueries; i++) {
+            found2 += find_grid(origins[i], rad, list);
+        }
+
+        auto end = std::chrono::steady_clock::now();
+
+        double runLinear = std::chrono::duration<double, std::micro>(middle - start).count() / numQueries;
+        double runQuery  = std::chrono::duration<double, std::micro>(end - middle).count() / numQueries;
+
+        if (!run || runLinear < linear) {
+            linear = runLinear;
+        }
+        if (!run || runQuery < query) {
+            query = runQuery;
+        }
+    }
+
+    std::cout << numEntities << " entities, radius " << rad << ": linear " << linear << " us, grid " << query
+              << " us per query";
+    if (found1 != found2) {
+        std::cout << " (MISMATCH " << found1 << " != " << found2 << ")";
+    }
+    std::cout << std::endl;
+
+    // large radii take the same path as the linear search, so only allow for noise
+    if (query > linear * 1.2) {
+        std::cerr << "The grid is slower than the linear search with radius " << rad << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!test_queries()) {
+        std::cerr << "Grid queries differ from the linear search!" << std::endl;
+        return 1;
+    }
+
+    for (float rad : {384.0f, 1024.0f, 4096.0f}) {
+        for (int numEntities : {100, 500, 1000}) {
+            if (!bench_queries(numEntities, rad)) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
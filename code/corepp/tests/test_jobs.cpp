@@ -0,0 +1,90 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../../qcommon/q_shared.h"
+#include "../../qcommon/qcommon.h"
+
+#include <atomic>
+#include <iostream>
+
+static const int        maxJobs = 256;
+static std::atomic<int> calls[maxJobs];
+static int              total;
+
+static void count_job(void *data, int index)
+{
+    calls[index]++;
+
+    // shared state must be locked
+    Com_LockJobs();
+    total += *(int *)data;
+    Com_UnlockJobs();
+}
+
+static bool run_jobs(int numThreads, int count)
+{
+    int value = 3;
+    int i;
+
+    for (i = 0; i < maxJobs; i++) {
+        calls[i] = 0;
+    }
+    total = 0;
+
+    Com_RunJobs(numThreads, count, count_job, &value);
+
+    for (i = 0; i < maxJobs; i++) {
+        int expected = i < count ? 1 : 0;
+
+        if (calls[i] != expected) {
+            std::cerr << numThreads << " threads, " << count << " jobs: job " << i << " was called " << calls[i]
+                      << " times" << std::endl;
+            return false;
+        }
+    }
+
+    if (total != count * value) {
+        std::cerr << numThreads << " threads, " << count << " jobs: total is " << total << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    static const int threads[] = {0, 1, 3, 8, 3};
+    int              i, j;
+
+    for (i = 0; i < (int)(sizeof(threads) / sizeof(threads[0])); i++) {
+        // the same pool is reused for each batch
+        for (j = 0; j < 500; j++) {
+            if (!run_jobs(threads[i], (j * 37) % maxJobs)) {
+                return 1;
+            }
+        }
+    }
+
+    Com_ShutdownJobs();
+
+    return 0;
+}
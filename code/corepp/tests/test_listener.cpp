@@ -0,0 +1,412 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../listener.h"
+#include "../../script/scriptvariable.h"
+#include "../../client/client.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+clientStatic_t cls;
+
+static cvar_t  nullCvar;
+cvar_t        *developer = &nullCvar;
+
+cvar_t *Cvar_Get(const char *var_name, const char *var_value, int flags)
+{
+    return &nullCvar;
+}
+
+long FS_ReadFile(const char *qpath, void **buffer)
+{
+    return -1;
+}
+
+void FS_FreeFile(void *buffer) {}
+
+fileHandle_t FS_FOpenFileWrite(const char *qpath)
+{
+    return 0;
+}
+
+size_t FS_Write(const void *buffer, size_t len, fileHandle_t f)
+{
+    return 0;
+}
+
+void FS_FCloseFile(fileHandle_t f) {}
+
+class TestListener : public Listener
+{
+public:
+    CLASS_PROTOTYPE(TestListener);
+
+    int numEvents;
+    int sum;
+    str order;
+
+    TestListener();
+
+    void EventArgs(Event *ev);
+    void EventOrder(Event *ev);
+};
+
+Event EV_TestListener_Args
+(
+    "testargs",
+    EV_DEFAULT,
+    NULL,
+    NULL,
+    "Adds up the arguments"
+);
+
+Event EV_TestListener_Order
+(
+    "testorder",
+    EV_DEFAULT,
+    "s",
+    "name",
+    "Records the order of the events"
+);
+
+CLASS_DECLARATION(Listener, TestListener, NULL) {
+    {&EV_TestListener_Args,  &TestListener::EventArgs },
+    {&EV_TestListener_Order, &TestListener::EventOrder},
+    {NULL,                   NULL                     }
+};
+
+TestListener::TestListener()
+{
+    numEvents = 0;
+    sum       = 0;
+}
+
+void TestListener::EventArgs(Event *ev)
+{
+    int i;
+
+    numEvents++;
+
+    for (i = 1; i <= ev->NumArgs(); i++) {
+        if (ev->IsStringAt(i)) {
+            sum += ev->GetString(i).length();
+        } else if (ev->IsVectorAt(i)) {
+            sum += ev->GetVector(i).x;
+        } else {
+            sum += ev->GetInteger(i);
+        }
+    }
+}
+
+void TestListener::EventOrder(Event *ev)
+{
+    order += ev->GetString(1);
+}
+
+static Event make_event(int numArgs)
+{
+    Event ev(EV_TestListener_Args);
+    int   i;
+
+    for (i = 0; i < numArgs; i++) {
+        switch (i % 3) {
+        case 0:
+            ev.AddInteger(i);
+            break;
+        case 1:
+            ev.AddString(str(i));
+            break;
+        case 2:
+            ev.AddVector(Vector(i, 0, 0));
+            break;
+        }
+    }
+
+    return ev;
+}
+
+static bool check_event(const Event& ev, int numArgs)
+{
+    int i;
+
+    if (ev.NumArgs() != numArgs) {
+        std::cerr << "Event has " << ev.NumArgs() << " arguments instead of " << numArgs << std::endl;
+        return false;
+    }
+
+    for (i = 0; i < numArgs; i++) {
+        bool valid;
+
+        switch (i % 3) {
+        case 0:
+            valid = ev.GetInteger(i + 1) == i;
+            break;
+        case 1:
+            valid = ev.GetString(i + 1) == str(i);
+            break;
+        default:
+            valid = ev.GetVector(i + 1) == Vector(i, 0, 0);
+            break;
+        }
+
+        if (!valid) {
+            std::cerr << "Argument " << i + 1 << " of " << numArgs << " is wrong" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool test_arguments()
+{
+    int numArgs;
+
+    // inline, pooled and heap arguments
+    for (numArgs = 0; numArgs < 80; numArgs++) {
+        Event ev = make_event(numArgs);
+        Event copy(ev);
+        Event moved(std::move(copy));
+        Event assigned;
+        Event moveAssigned = make_event(3);
+
+        if (!check_event(ev, numArgs) || !check_event(moved, numArgs) || !check_event(copy, 0)) {
+            return false;
+        }
+
+        assigned = moved;
+        if (!check_event(assigned, numArgs)) {
+            return false;
+        }
+
+        moveAssigned = std::move(assigned);
+        if (!check_event(moveAssigned, numArgs) || !check_event(assigned, 0)) {
+            return false;
+        }
+
+        moveAssigned.AddInteger(numArgs * 3);
+        if (moveAssigned.GetInteger(numArgs + 1) != numArgs * 3 || !check_event(moved, numArgs)) {
+            std::cerr << "Adding an argument to a moved event failed" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool test_process()
+{
+    TestListener *listener = new TestListener();
+    int           expected = 0;
+    int           i;
+
+    for (i = 0; i < 10; i++) {
+        listener->ProcessEvent(make_event(i));
+    }
+
+    for (i = 0; i < 10; i++) {
+        listener->PostEvent(make_event(i), 0);
+    }
+
+    L_ProcessPendingEvents();
+
+    for (i = 0; i < 10; i++) {
+        TestListener check;
+        Event        ev = make_event(i);
+
+        check.EventArgs(&ev);
+        expected += check.sum;
+    }
+
+    if (listener->numEvents != 20 || listener->sum != expected * 2) {
+        std::cerr << "Events weren't processed with their arguments" << std::endl;
+        return false;
+    }
+
+    delete listener;
+
+    return true;
+}
+
+static void post_order(TestListener *listener, const char *name, float delay)
+{
+    Event *ev = new Event(EV_TestListener_Order);
+
+    ev->AddString(name);
+    listener->PostEvent(ev, delay);
+}
+
+static bool test_order()
+{
+    TestListener *listener = new TestListener();
+    Event         ev(EV_TestListener_Order);
+
+    cls.realtime = 0;
+
+    // events posted for the same time fire newest first,
+    // a postponed event fires after the ones already at its new time
+    post_order(listener, "a", 0.1f);
+    post_order(listener, "b", 0.1f);
+    post_order(listener, "c", 0);
+    listener->PostponeEvent(ev, 0.1f);
+    post_order(listener, "d", 0.1f);
+    post_order(listener, "e", 0.2f);
+
+    cls.realtime = 100;
+    L_ProcessPendingEvents();
+
+    if (listener->order != "dbac") {
+        std::cerr << "Events fired in the order " << listener->order << " instead of dbac" << std::endl;
+        return false;
+    }
+
+    delete listener;
+
+    cls.realtime = 0;
+
+    return true;
+}
+
+static bool test_variable_allocs()
+{
+    ScriptVariable a, b, scale;
+    int            i;
+
+    a.setVectorValue(Vector(1, 2, 3));
+    b.setVectorValue(Vector(4, 5, 6));
+    scale.setFloatValue(0.5f);
+    script_allocsthisframe = 0;
+
+    // vector arithmetic stays inline
+    for (i = 0; i < 100; i++) {
+        a += b;
+        a -= b;
+        a *= scale;
+        a /= scale;
+    }
+
+    if (script_allocsthisframe) {
+        std::cerr << "Vector arithmetic made " << script_allocsthisframe << " allocations" << std::endl;
+        return false;
+    }
+
+    // listeners stay inline too
+    {
+        TestListener  *listener = new TestListener();
+        ScriptVariable copy;
+
+        for (i = 0; i < 100; i++) {
+            a.setListenerValue(listener);
+            copy = a;
+            b    = copy;
+        }
+
+        if (script_allocsthisframe || copy.listenerValue() != listener || !(a == b)) {
+            std::cerr << "Listener values made " << script_allocsthisframe << " allocations" << std::endl;
+            return false;
+        }
+
+        delete listener;
+
+        if (b.listenerValue() || b.booleanValue()) {
+            std::cerr << "Listener value wasn't cleared with its listener" << std::endl;
+            return false;
+        }
+    }
+
+    a.setStringValue("a");
+    b.setIntValue(1);
+    a += b;
+
+    if (!script_allocsthisframe || a.stringValue() != "a1") {
+        std::cerr << "String concatenation wasn't counted" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+static void bench_process(int numArgs, bool strings)
+{
+    const int     iterations = 1000000;
+    TestListener *listener   = new TestListener();
+    int           i, j;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (i = 0; i < iterations; i++) {
+        Event *ev = new Event(EV_TestListener_Args);
+
+        for (j = 0; j < numArgs; j++) {
+            if (strings) {
+                ev->AddString("argument");
+            } else {
+                ev->AddInteger(j);
+            }
+        }
+
+        listener->ProcessEvent(ev);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << numArgs << (strings ? " string" : " integer") << " arguments: "
+              << iterations / std::chrono::duration<double>(end - start).count() / 1000000.0
+              << " million events/sec" << std::endl;
+
+    delete listener;
+}
+
+int main(int argc, char *argv[])
+{
+    L_InitEvents();
+
+    if (!test_arguments()) {
+        return 1;
+    }
+
+    if (!test_process()) {
+        return 1;
+    }
+
+    if (!test_order()) {
+        return 1;
+    }
+
+    if (!test_variable_allocs()) {
+        return 1;
+    }
+
+    for (int numArgs : {0, 1, 3, 6}) {
+        bench_process(numArgs, false);
+    }
+
+    bench_process(3, true);
+
+    L_ShutdownEvents();
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../../qcommon/q_shared.h"
+#include "../../qcommon/qcommon.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+void Z_InitMemory(void);
+void Z_Shutdown(void);
+void Z_CheckHeap(void);
+
+void QDECL Com_Printf(const char *fmt, ...) {}
+
+void QDECL Com_DPrintf(const char *fmt, ...) {}
+
+void QDECL Com_Error(int code, const char *fmt, ...)
+{
+    va_list argptr;
+
+    va_start(argptr, fmt);
+    vfprintf(stderr, fmt, argptr);
+    va_end(argptr);
+
+    fputc('\n', stderr);
+    exit(1);
+}
+
+void Cmd_AddCommand(const char *cmd_name, xcommand_t function) {}
+
+int Cmd_Argc(void)
+{
+    return 1;
+}
+
+int Sys_Milliseconds(void)
+{
+    return 0;
+}
+}
+
+static unsigned int seed = 0x4d6f4841;
+
+static int random_int(int max)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % max;
+}
+
+struct allocation_t {
+    byte *ptr;
+    int   size;
+    byte  value;
+};
+
+static bool check_allocation(const allocation_t& a)
+{
+    int i;
+
+    if ((uintptr_t)a.ptr % sizeof(intptr_t)) {
+        std::cerr << "Allocation of " << a.size << " bytes is misaligned" << std::endl;
+        return false;
+    }
+
+    for (i = 0; i < a.size; i++) {
+        if (a.ptr[i] != a.value) {
+            std::cerr << "Allocation of " << a.size << " bytes was overwritten" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool test_tag(int tag, bool freeEach)
+{
+    std::vector<allocation_t> allocs;
+    int                       pass;
+    int                       i;
+
+    for (pass = 0; pass < 4; pass++) {
+        for (i = 0; i < 3000; i++) {
+            allocation_t a;
+
+            // mostly small blocks, and a few that don't fit in a chunk
+            if (i % 500 == 499) {
+                a.size = 300000 + random_int(300000);
+            } else if (i % 10 == 0) {
+                a.size = 512 + random_int(4096);
+            } else {
+                a.size = 1 + random_int(600);
+            }
+
+            a.value = (byte)(i + pass);
+            a.ptr   = (byte *)Z_TagMalloc(a.size, tag);
+            memset(a.ptr, a.value, a.size);
+            allocs.push_back(a);
+
+            // free some blocks on the way, so they get reused
+            if (freeEach && allocs.size() > 64 && random_int(3) == 0) {
+                size_t index = random_int((int)allocs.size());
+
+                if (!check_allocation(allocs[index])) {
+                    return false;
+                }
+
+                Z_Free(allocs[index].ptr);
+                allocs[index] = allocs.back();
+                allocs.pop_back();
+            }
+        }
+
+        for (i = 0; i < (int)allocs.size(); i++) {
+            if (!check_allocation(allocs[i])) {
+                return false;
+            }
+        }
+
+        Z_CheckHeap();
+        Z_FreeTags(tag);
+        allocs.clear();
+    }
+
+    return true;
+}
+
+static bool test_constants()
+{
+    char *empty = (char *)Z_EmptyStringPointer();
+
+    if (strcmp(Z_EmptyStringPointer(), "") || strcmp(Z_NumberStringPointer('7'), "7")) {
+        std::cerr << "Constant strings are wrong" << std::endl;
+        return false;
+    }
+
+    // constant memory is never freed
+    Z_Free(empty);
+
+    return true;
+}
+
+static void bench_map_change()
+{
+    const int           numBlocks = 100000;
+    std::vector<void *> blocks(numBlocks);
+    int                 i;
+
+    // the second round of each tag reuses the memory
+    for (int tag : {TAG_GAME, TAG_GAME, TAG_STATIC, TAG_STATIC}) {
+        auto start = std::chrono::steady_clock::now();
+
+        for (i = 0; i < numBlocks; i++) {
+            blocks[i] = Z_TagMalloc(16 + (i % 64) * 8, tag);
+        }
+
+        auto middle = std::chrono::steady_clock::now();
+
+        Z_FreeTags(tag);
+
+        auto end = std::chrono::steady_clock::now();
+
+        std::cout << (tag == TAG_STATIC ? "arena" : "heap") << " tag: "
+                  << std::chrono::duration<double, std::nano>(middle - start).count() / numBlocks
+                  << " ns per allocation, Z_FreeTags "
+                  << std::chrono::duration<double, std::milli>(end - middle).count() << " ms" << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Z_InitMemory();
+
+    if (!test_constants()) {
+        return 1;
+    }
+
+    if (!test_tag(TAG_GAME, true)) {
+        std::cerr << "Blocks of a heap tag are wrong!" << std::endl;
+        return 1;
+    }
+
+    if (!test_tag(TAG_STATIC, false)) {
+        std::cerr << "Blocks of an arena tag are wrong!" << std::endl;
+        return 1;
+    }
+
+    if (!test_tag(TAG_STATIC_RENDERER, true)) {
+        std::cerr << "Freeing blocks of an arena tag one by one failed!" << std::endl;
+        return 1;
+    }
+
+    bench_map_change();
+
+    Z_Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,341 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../../qcommon/q_shared.h"
+#include "../../qcommon/qcommon.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+extern huffman_t msgHuff;
+
+static cvar_t protocol;
+static cvar_t shownet;
+static cvar_t msgstats;
+cvar_t       *com_protocol = &protocol;
+cvar_t       *cl_shownet   = &shownet;
+cvar_t       *com_msgstats = &msgstats;
+
+static unsigned int seed = 0x4d6f4841;
+
+static unsigned int random_int()
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) | ((seed & 0xffff) << 16);
+}
+
+static int random_int(int max)
+{
+    return random_int() % max;
+}
+
+// what MSG_WriteBits did for bitstreams before the code table, one bit at a time
+static void legacy_write_bits(msg_t *msg, int value, int bits)
+{
+    int i;
+
+    if (msg->overflowed) {
+        return;
+    }
+
+    value &= (0xffffffff >> (32 - bits));
+    if (bits & 7) {
+        int nbits;
+        nbits = bits & 7;
+        if ((size_t)(msg->bit + nbits) >= msg->maxsize << 3) {
+            msg->overflowed = qtrue;
+            return;
+        }
+        for (i = 0; i < nbits; i++) {
+            Huff_putBit((value & 1), msg->data, &msg->bit);
+            value = (value >> 1);
+        }
+        bits = bits - nbits;
+    }
+    if (bits) {
+        for (i = 0; i < bits; i += 8) {
+            Huff_offsetTransmit(&msgHuff.compressor, (value & 0xff), msg->data, &msg->bit, msg->maxsize << 3);
+            value = (value >> 8);
+
+            if ((size_t)msg->bit >= msg->maxsize << 3) {
+                msg->overflowed = qtrue;
+                return;
+            }
+        }
+    }
+    msg->cursize = (msg->bit >> 3) + 1;
+}
+
+// mostly small values like most fields, with a few full ones
+static void random_field(int& value, int& bits)
+{
+    bits  = 1 + random_int(32);
+    value = random_int();
+    if (random_int(2)) {
+        value &= 0xff;
+    }
+    if (bits < 32) {
+        value &= (1 << bits) - 1;
+    }
+}
+
+bool test_round_trip()
+{
+    const int         maxFields = 512;
+    byte              data1[MAX_MSGLEN];
+    byte              data2[MAX_MSGLEN];
+    msg_t             msg1, msg2;
+    std::vector<int>  values(maxFields);
+    std::vector<int>  sizes(maxFields);
+    int               pass;
+    int               i;
+
+    for (pass = 0; pass < 2000; pass++) {
+        // small buffers to hit the overflow on any bit
+        int maxsize   = 1 + random_int(pass % 4 ? 64 : 2048);
+        int numFields = 1 + random_int(maxFields);
+
+        // garbage from older messages must be handled the same way
+        for (i = 0; i < maxsize; i++) {
+            data1[i] = data2[i] = random_int(256);
+        }
+
+        MSG_Init(&msg1, data1, maxsize);
+        MSG_Init(&msg2, data2, maxsize);
+
+        for (i = 0; i < numFields; i++) {
+            random_field(values[i], sizes[i]);
+
+            MSG_WriteBits(&msg1, values[i], sizes[i]);
+            legacy_write_bits(&msg2, values[i], sizes[i]);
+
+            if (msg1.overflowed != msg2.overflowed || msg1.bit != msg2.bit || msg1.cursize != msg2.cursize) {
+                std::cerr << "Pass " << pass << ", field " << i << ": the message state differs" << std::endl;
+                return false;
+            }
+        }
+
+        if (memcmp(data1, data2, maxsize)) {
+            std::cerr << "Pass " << pass << ": the encoded data differs" << std::endl;
+            return false;
+        }
+
+        if (msg1.overflowed) {
+            continue;
+        }
+
+        MSG_BeginReading(&msg1);
+        for (i = 0; i < numFields; i++) {
+            int value = MSG_ReadBits(&msg1, sizes[i]);
+
+            if (value != values[i]) {
+                std::cerr << "Pass " << pass << ", field " << i << ": read " << value << " instead of " << values[i]
+                          << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void random_entity(entityState_t& from, entityState_t& to, int number)
+{
+    int j;
+
+    memset(&from, 0, sizeof(from));
+    from.number     = number;
+    from.modelindex = 1 + random_int(256);
+    for (j = 0; j < 3; j++) {
+        from.origin[j]    = (float)(random_int(8192) - 4096);
+        from.netorigin[j] = from.origin[j];
+        from.angles[j]    = (float)random_int(360);
+        from.netangles[j] = from.angles[j];
+    }
+    from.scale = 1;
+    from.alpha = 1;
+
+    // a typical frame, moving and animating
+    to = from;
+    for (j = 0; j < 3; j++) {
+        to.origin[j] += (float)(random_int(64) - 32);
+        to.netorigin[j] = to.origin[j];
+    }
+    to.angles[1] += (float)random_int(30);
+    to.netangles[1]       = to.angles[1];
+    to.frameInfo[0].index = random_int(64);
+    to.frameInfo[0].time  = random_int(100) / 30.f;
+}
+
+bool test_delta_entity()
+{
+    static byte   data[MAX_MSGLEN];
+    msg_t         msg;
+    entityState_t from, to, unsent, decoded;
+    int           pass;
+    int           number;
+    int           j;
+
+    for (pass = 0; pass < 1000; pass++) {
+        random_entity(from, to, pass % MAX_GENTITIES);
+
+        // identical states, or states that only differ by fields that are not sent, write nothing
+        unsent = from;
+        unsent.bone_quat[0][0] += 1;
+
+        MSG_Init(&msg, data, sizeof(data));
+        MSG_WriteDeltaEntity(&msg, &from, &from, qfalse, 0.05f);
+        MSG_WriteDeltaEntity(&msg, &from, &unsent, qfalse, 0.05f);
+        if (msg.cursize) {
+            std::cerr << "Pass " << pass << ": an unchanged entity was written" << std::endl;
+            return false;
+        }
+
+        MSG_WriteDeltaEntity(&msg, &from, &to, qfalse, 0.05f);
+
+        // the delta must contain all the changed fields
+        MSG_BeginReading(&msg);
+        number = MSG_ReadEntityNum(&msg);
+        if (number != to.number) {
+            std::cerr << "Pass " << pass << ": read entity " << number << " instead of " << to.number << std::endl;
+            return false;
+        }
+
+        MSG_ReadDeltaEntity(&msg, &from, &decoded, number, 0.05f);
+
+        if (decoded.modelindex != to.modelindex || decoded.frameInfo[0].index != to.frameInfo[0].index) {
+            std::cerr << "Pass " << pass << ": a changed field is missing from the delta" << std::endl;
+            return false;
+        }
+
+        for (j = 0; j < 3; j++) {
+            if (fabs(decoded.netorigin[j] - to.netorigin[j]) > 0.5f) {
+                std::cerr << "Pass " << pass << ": decoded origin " << decoded.netorigin[j] << " instead of "
+                          << to.netorigin[j] << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void bench_write_bits()
+{
+    const int        numFields = 4096;
+    const int        numPasses = 200;
+    static byte      data[MAX_MSGLEN];
+    msg_t            msg;
+    std::vector<int> values(numFields);
+    std::vector<int> sizes(numFields);
+    int              pass;
+    int              i;
+
+    for (i = 0; i < numFields; i++) {
+        random_field(values[i], sizes[i]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (pass = 0; pass < numPasses; pass++) {
+        MSG_Init(&msg, data, sizeof(data));
+        for (i = 0; i < numFields; i++) {
+            legacy_write_bits(&msg, values[i], sizes[i]);
+        }
+    }
+
+    auto middle = std::chrono::steady_clock::now();
+
+    for (pass = 0; pass < numPasses; pass++) {
+        MSG_Init(&msg, data, sizeof(data));
+        for (i = 0; i < numFields; i++) {
+            MSG_WriteBits(&msg, values[i], sizes[i]);
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    double legacy = std::chrono::duration<double, std::nano>(middle - start).count() / (numFields * numPasses);
+    double table  = std::chrono::duration<double, std::nano>(end - middle).count() / (numFields * numPasses);
+
+    std::cout << "MSG_WriteBits: bit by bit " << legacy << " ns, code table " << table << " ns per field"
+              << std::endl;
+}
+
+void bench_write_delta_entity()
+{
+    const int                  numEntities = 256;
+    const int                  numPasses   = 200;
+    static byte                data[MAX_MSGLEN];
+    msg_t                      msg;
+    std::vector<entityState_t> from(numEntities);
+    std::vector<entityState_t> to(numEntities);
+    size_t                     bytes;
+    int                        pass;
+    int                        i;
+
+    for (i = 0; i < numEntities; i++) {
+        random_entity(from[i], to[i], i);
+    }
+
+    bytes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (pass = 0; pass < numPasses; pass++) {
+        MSG_Init(&msg, data, sizeof(data));
+        for (i = 0; i < numEntities; i++) {
+            MSG_WriteDeltaEntity(&msg, &from[i], &to[i], qfalse, 0.05f);
+        }
+        bytes += msg.cursize;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    double elapsed = std::chrono::duration<double, std::micro>(end - start).count();
+
+    std::cout << "MSG_WriteDeltaEntity: " << elapsed * 1000 / (numEntities * numPasses) << " ns per entity, "
+              << bytes / elapsed << " MB/s" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    protocol.integer = PROTOCOL_MOHTA;
+
+    if (!test_round_trip()) {
+        std::cerr << "The code table doesn't match the Huffman tree!" << std::endl;
+        return 1;
+    }
+
+    if (!test_delta_entity()) {
+        std::cerr << "Entity deltas are wrong!" << std::endl;
+        return 1;
+    }
+
+    bench_write_bits();
+    bench_write_delta_entity();
+
+    return 0;
+}
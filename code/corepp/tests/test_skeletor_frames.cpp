@@ -0,0 +1,212 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../../qcommon/q_shared.h"
+#include "../../qcommon/qcommon.h"
+#include "../../skeletor/skeletor.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+static unsigned int seed = 0x4d6f4841;
+
+static int random_int(int max)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % max;
+}
+
+// same layout as the rotation channels, a quaternion per keyframe
+static const size_t frameSize = sizeof(skanGameFrame) - sizeof(skanGameFrame::pChannelData) + sizeof(vec4_t);
+
+class test_channel
+{
+public:
+    skanChannelHdr    hdr;
+    std::vector<byte> data;
+    int               numFrames;
+};
+
+static skanGameFrame *channel_frame(test_channel& c, int index)
+{
+    return (skanGameFrame *)(c.data.data() + index * frameSize);
+}
+
+// like the loader, only the frames where the value changes are kept, and the last one
+static void random_channel(test_channel& c, int numFrames)
+{
+    int numKeys;
+    int frameNum;
+    int i;
+
+    c.numFrames = numFrames;
+    c.data.assign(numFrames * frameSize, 0);
+
+    numKeys  = 0;
+    frameNum = 0;
+    while (frameNum < numFrames) {
+        skanGameFrame *frame = channel_frame(c, numKeys);
+
+        frame->nFrameNum       = frameNum;
+        frame->nPrevFrameIndex = numKeys ? numKeys - 1 : 0;
+        for (i = 0; i < 4; i++) {
+            frame->pChannelData[i] = (float)random_int(1000);
+        }
+        numKeys++;
+
+        if (frameNum == numFrames - 1) {
+            break;
+        }
+
+        // mostly animated channels, with some long holds
+        frameNum += random_int(8) ? 1 + random_int(2) : 1 + random_int(30);
+        // the last frame is always kept
+        if (frameNum > numFrames - 1) {
+            frameNum = numFrames - 1;
+        }
+    }
+
+    c.hdr.nFramesInChannel = numKeys;
+    c.hdr.ary_frames       = channel_frame(c, 0);
+}
+
+// what the decode functions did before the binary search
+static skanGameFrame *legacy_find_frame(skanChannelHdr *channelFrames, int desiredFrameNum)
+{
+    skanGameFrame *foundFrame = channelFrames->ary_frames;
+    int            i;
+
+    for (i = 0; i < channelFrames->nFramesInChannel; i++) {
+        if (foundFrame->nFrameNum >= desiredFrameNum) {
+            break;
+        }
+
+        foundFrame = (skanGameFrame *)((byte *)foundFrame + frameSize);
+    }
+
+    if (foundFrame->nFrameNum > desiredFrameNum) {
+        foundFrame = (skanGameFrame *)((byte *)channelFrames->ary_frames + foundFrame->nPrevFrameIndex * frameSize);
+    }
+
+    return foundFrame;
+}
+
+bool test_find_frame()
+{
+    test_channel c;
+    int          pass;
+    int          frameNum;
+
+    for (pass = 0; pass < 2000; pass++) {
+        random_channel(c, 1 + random_int(pass % 4 ? 64 : 2000));
+
+        // the legacy search can only be used within the animation
+        for (frameNum = 0; frameNum < c.numFrames; frameNum++) {
+            skanGameFrame *found    = SkelFindChannelFrame(&c.hdr, frameNum, frameSize);
+            skanGameFrame *expected = legacy_find_frame(&c.hdr, frameNum);
+
+            if (found != expected) {
+                std::cerr << "Pass " << pass << ", frame " << frameNum << ": found keyframe "
+                          << found->nFrameNum << " instead of " << expected->nFrameNum << std::endl;
+                return false;
+            }
+        }
+
+        // past the end, the last keyframe holds
+        if (SkelFindChannelFrame(&c.hdr, c.numFrames + random_int(100), frameSize)
+            != channel_frame(c, c.hdr.nFramesInChannel - 1)) {
+            std::cerr << "Pass " << pass << ": the last keyframe isn't used past the end" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void bench_find_frame(int numFrames)
+{
+    const int                 numChannels = 128;
+    const int                 numPasses   = 20;
+    std::vector<test_channel> channels(numChannels);
+    std::vector<int>          frames(numFrames);
+    float                     sum1, sum2;
+    int                       pass;
+    int                       i, j;
+
+    for (i = 0; i < numChannels; i++) {
+        random_channel(channels[i], numFrames);
+    }
+
+    // evaluate the whole pose at random frames of the animation
+    for (i = 0; i < numFrames; i++) {
+        frames[i] = random_int(numFrames);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    sum1 = 0;
+    for (pass = 0; pass < numPasses; pass++) {
+        for (i = 0; i < numFrames; i++) {
+            for (j = 0; j < numChannels; j++) {
+                sum1 += legacy_find_frame(&channels[j].hdr, frames[i])->pChannelData[0];
+            }
+        }
+    }
+
+    auto middle = std::chrono::steady_clock::now();
+
+    sum2 = 0;
+    for (pass = 0; pass < numPasses; pass++) {
+        for (i = 0; i < numFrames; i++) {
+            for (j = 0; j < numChannels; j++) {
+                sum2 += SkelFindChannelFrame(&channels[j].hdr, frames[i], frameSize)->pChannelData[0];
+            }
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    double linear = std::chrono::duration<double, std::micro>(middle - start).count() / (numFrames * numPasses);
+    double search = std::chrono::duration<double, std::micro>(end - middle).count() / (numFrames * numPasses);
+
+    std::cout << numFrames << " frames, " << numChannels << " channels: linear " << linear << " us, binary search "
+              << search << " us per pose";
+    if (sum1 != sum2) {
+        std::cout << " (MISMATCH " << sum1 << " != " << sum2 << ")";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!test_find_frame()) {
+        std::cerr << "The binary search differs from the linear search!" << std::endl;
+        return 1;
+    }
+
+    bench_find_frame(30);
+    bench_find_frame(300);
+    bench_find_frame(3000);
+
+    return 0;
+}
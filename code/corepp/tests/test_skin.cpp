@@ -0,0 +1,377 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../../renderercommon/tr_skin.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+static unsigned int seed = 0x4d6f4841;
+
+static int random_int(int max)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) % max;
+}
+
+static float random_float(float min, float max)
+{
+    return min + (max - min) * random_int(65536) / 65535.f;
+}
+
+class test_mesh
+{
+public:
+    std::vector<byte>            data;
+    std::vector<skelBoneCache_t> bones;
+    std::vector<int>             boneMap;
+    std::vector<int>             morphs;
+    int                          numVerts;
+};
+
+class test_output
+{
+public:
+    std::vector<float> xyz;
+    std::vector<float> normal;
+    std::vector<float> texCoords;
+
+    void clear(int numVerts)
+    {
+        xyz.assign(numVerts * 4, 0);
+        normal.assign(numVerts * 4, 0);
+        texCoords.assign(numVerts * 4, 0);
+    }
+
+    // same layout as tess in the renderer
+    skinOutput_t skin()
+    {
+        skinOutput_t out;
+
+        out.xyz            = xyz.data();
+        out.xyzStride      = 4;
+        out.normal         = normal.data();
+        out.normalStride   = 4;
+        out.texCoords      = texCoords.data();
+        out.texCoordStride = 4;
+
+        return out;
+    }
+};
+
+static void random_bone(skelBoneCache_t& bone)
+{
+    vec3_t angles;
+    vec3_t axis[3];
+    int    i, j;
+
+    for (i = 0; i < 3; i++) {
+        angles[i] = random_float(0, 360);
+    }
+    AnglesToAxis(angles, axis);
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            bone.matrix[i][j] = axis[i][j];
+        }
+        bone.matrix[i][3] = 0;
+        bone.offset[i]    = random_float(-64, 64);
+    }
+    bone.offset[3] = 0;
+}
+
+// a vertex stream like the loaded skd surfaces, with a few morph targets
+static void random_mesh(test_mesh& m, int numVerts, int numBones, int numMorphTargets)
+{
+    skeletorVertex_t *vert;
+    skeletorMorph_t  *morph;
+    skelWeight_t     *weight;
+    size_t            ofs;
+    int               numWeights, numMorphs;
+    float             total;
+    int               i, j;
+
+    m.bones.resize(numBones);
+    for (i = 0; i < numBones; i++) {
+        random_bone(m.bones[i]);
+    }
+
+    // the bones of the mesh don't have the same numbers as the entity bones
+    m.boneMap.resize(numBones);
+    for (i = 0; i < numBones; i++) {
+        m.boneMap[i] = numBones - 1 - i;
+    }
+
+    m.morphs.resize(numMorphTargets);
+    for (i = 0; i < numMorphTargets; i++) {
+        m.morphs[i] = random_int(2) ? random_int(256) : 0;
+    }
+
+    m.numVerts = numVerts;
+    m.data.clear();
+
+    for (i = 0; i < numVerts; i++) {
+        numWeights = 1 + random_int(4);
+        numMorphs  = numMorphTargets && !random_int(4) ? 1 + random_int(3) : 0;
+
+        ofs = m.data.size();
+        m.data.resize(
+            ofs + sizeof(skeletorVertex_t) + sizeof(skeletorMorph_t) * numMorphs + sizeof(skelWeight_t) * numWeights
+        );
+
+        vert = (skeletorVertex_t *)(m.data.data() + ofs);
+        for (j = 0; j < 3; j++) {
+            vert->normal[j] = random_float(-1, 1);
+        }
+        VectorNormalize(vert->normal);
+        vert->texCoords[0] = random_float(0, 1);
+        vert->texCoords[1] = random_float(0, 1);
+        vert->numWeights   = numWeights;
+        vert->numMorphs    = numMorphs;
+
+        morph = (skeletorMorph_t *)(vert + 1);
+        for (j = 0; j < numMorphs; j++) {
+            morph[j].morphIndex = random_int(numMorphTargets);
+            morph[j].offset[0]  = random_float(-1, 1);
+            morph[j].offset[1]  = random_float(-1, 1);
+            morph[j].offset[2]  = random_float(-1, 1);
+        }
+
+        weight = (skelWeight_t *)(morph + numMorphs);
+        total  = 0;
+        for (j = 0; j < numWeights; j++) {
+            weight[j].boneIndex  = random_int(numBones);
+            weight[j].boneWeight = random_float(0.1f, 1);
+            weight[j].offset[0]  = random_float(-16, 16);
+            weight[j].offset[1]  = random_float(-16, 16);
+            weight[j].offset[2]  = random_float(-16, 16);
+            total += weight[j].boneWeight;
+        }
+
+        for (j = 0; j < numWeights; j++) {
+            weight[j].boneWeight /= total;
+        }
+    }
+}
+
+static int legacy_map_bone(const test_mesh& m, int boneIndex)
+{
+    return m.boneMap[boneIndex];
+}
+
+// RB_SkelMesh before the skinning kernel, one weight at a time,
+// looking up the entity bone for every weight on meshes other than the first
+static void legacy_skin(const test_mesh& m, bool hasMorph, bool mapBones, float scale, test_output& o)
+{
+    int (*volatile mapBone)(const test_mesh&, int) = legacy_map_bone;
+    const skeletorVertex_t *newVerts;
+    const skeletorMorph_t  *morph;
+    const skelWeight_t     *weight;
+    const skelBoneCache_t  *bone;
+    const int              *morphcache;
+    float                  *outXyz;
+    int                     vertNum, morphNum, weightNum;
+
+    newVerts = (const skeletorVertex_t *)m.data.data();
+
+    for (vertNum = 0; vertNum < m.numVerts; vertNum++) {
+        vec3_t normal;
+        vec3_t out;
+        vec3_t totalmorph;
+        vec3_t point;
+        int    boneNum;
+
+        outXyz = &o.xyz[vertNum * 4];
+
+        VectorClear(out);
+        VectorClear(outXyz);
+        VectorClear(totalmorph);
+
+        weight = (const skelWeight_t *)((const byte *)newVerts + sizeof(skeletorVertex_t)
+                                        + sizeof(skeletorMorph_t) * newVerts->numMorphs);
+        morph  = (const skeletorMorph_t *)((const byte *)newVerts + sizeof(skeletorVertex_t));
+
+        if (hasMorph) {
+            for (morphNum = 0; morphNum < newVerts->numMorphs; morphNum++) {
+                morphcache = &m.morphs[morph->morphIndex];
+
+                if (*morphcache) {
+                    VectorMA(totalmorph, *morphcache, morph->offset, totalmorph);
+                }
+
+                morph++;
+            }
+        }
+
+        boneNum = mapBones ? mapBone(m, weight->boneIndex) : weight->boneIndex;
+        bone    = &m.bones[boneNum];
+
+        normal[0] = newVerts->normal[0] * bone->matrix[0][0] + newVerts->normal[1] * bone->matrix[1][0]
+                  + newVerts->normal[2] * bone->matrix[2][0];
+        normal[1] = newVerts->normal[0] * bone->matrix[0][1] + newVerts->normal[1] * bone->matrix[1][1]
+                  + newVerts->normal[2] * bone->matrix[2][1];
+        normal[2] = newVerts->normal[0] * bone->matrix[0][2] + newVerts->normal[1] * bone->matrix[1][2]
+                  + newVerts->normal[2] * bone->matrix[2][2];
+
+        for (weightNum = 0; weightNum < newVerts->numWeights; weightNum++) {
+            boneNum = mapBones ? mapBone(m, weight->boneIndex) : weight->boneIndex;
+            bone    = &m.bones[boneNum];
+
+            if (!weightNum && hasMorph) {
+                VectorAdd(totalmorph, weight->offset, point);
+            } else {
+                VectorCopy(weight->offset, point);
+            }
+
+            out[0] += ((point[0] * bone->matrix[0][0] + point[1] * bone->matrix[1][0] + point[2] * bone->matrix[2][0])
+                       + bone->offset[0])
+                    * weight->boneWeight;
+            out[1] += ((point[0] * bone->matrix[0][1] + point[1] * bone->matrix[1][1] + point[2] * bone->matrix[2][1])
+                       + bone->offset[1])
+                    * weight->boneWeight;
+            out[2] += ((point[0] * bone->matrix[0][2] + point[1] * bone->matrix[1][2] + point[2] * bone->matrix[2][2])
+                       + bone->offset[2])
+                    * weight->boneWeight;
+
+            weight++;
+        }
+
+        VectorCopy(normal, &o.normal[vertNum * 4]);
+        VectorScale(out, scale, outXyz);
+
+        o.texCoords[vertNum * 4]     = newVerts->texCoords[0];
+        o.texCoords[vertNum * 4 + 1] = newVerts->texCoords[1];
+
+        newVerts = (const skeletorVertex_t *)((const byte *)newVerts + sizeof(skeletorVertex_t)
+                                              + sizeof(skeletorMorph_t) * newVerts->numMorphs
+                                              + sizeof(skelWeight_t) * newVerts->numWeights);
+    }
+}
+
+static void skin(const test_mesh& m, bool hasMorph, bool mapBones, float scale, test_output& o)
+{
+    skinOutput_t out = o.skin();
+
+    R_SkinVertexes(
+        (const skeletorVertex_t *)m.data.data(),
+        m.numVerts,
+        m.bones.data(),
+        mapBones ? m.boneMap.data() : NULL,
+        hasMorph ? m.morphs.data() : NULL,
+        scale,
+        &out
+    );
+}
+
+bool test_skin()
+{
+    test_mesh   m;
+    test_output o1, o2;
+    int         pass;
+    bool        hasMorph, mapBones;
+    float       scale;
+
+    for (pass = 0; pass < 200; pass++) {
+        random_mesh(m, 1 + random_int(1000), 1 + random_int(TIKI_MAX_BONES), random_int(2) ? 16 : 0);
+
+        hasMorph = m.morphs.size() > 0;
+        mapBones = random_int(2);
+        scale    = random_float(0.5f, 2);
+
+        o1.clear(m.numVerts);
+        o2.clear(m.numVerts);
+        legacy_skin(m, hasMorph, mapBones, scale, o1);
+        skin(m, hasMorph, mapBones, scale, o2);
+
+        // must be the same values
+        if (o1.xyz != o2.xyz) {
+            std::cerr << "Pass " << pass << ": the positions differ" << std::endl;
+            return false;
+        }
+
+        if (o1.normal != o2.normal) {
+            std::cerr << "Pass " << pass << ": the normals differ" << std::endl;
+            return false;
+        }
+
+        if (o1.texCoords != o2.texCoords) {
+            std::cerr << "Pass " << pass << ": the texture coordinates differ" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void bench_skin(bool hasMorph, bool mapBones)
+{
+    // about the vertex count of 30 player models
+    const int   numModels = 30;
+    const int   numPasses = 20;
+    test_mesh   m;
+    test_output o;
+    int         pass;
+    int         i;
+
+    random_mesh(m, 2000, 60, hasMorph ? 16 : 0);
+    o.clear(m.numVerts);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (pass = 0; pass < numPasses; pass++) {
+        for (i = 0; i < numModels; i++) {
+            legacy_skin(m, hasMorph, mapBones, 1, o);
+        }
+    }
+
+    auto middle = std::chrono::steady_clock::now();
+
+    for (pass = 0; pass < numPasses; pass++) {
+        for (i = 0; i < numModels; i++) {
+            skin(m, hasMorph, mapBones, 1, o);
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    double legacy = std::chrono::duration<double, std::micro>(middle - start).count() / numPasses;
+    double kernel = std::chrono::duration<double, std::micro>(end - middle).count() / numPasses;
+
+    std::cout << numModels << " models of " << m.numVerts << " vertexes" << (hasMorph ? ", morphs" : "")
+              << (mapBones ? ", mapped bones" : "") << ": scalar " << legacy << " us, kernel " << kernel
+              << " us per frame" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!test_skin()) {
+        std::cerr << "The skinning kernel differs from the scalar skinning!" << std::endl;
+        return 1;
+    }
+
+    bench_skin(false, false);
+    bench_skin(true, false);
+    bench_skin(false, true);
+
+    return 0;
+}
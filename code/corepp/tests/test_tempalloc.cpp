@@ -0,0 +1,203 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../../qcommon/q_shared.h"
+#include "../../qcommon/qcommon.h"
+#include "../mem_tempalloc.h"
+#include "../container.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+extern "C" {
+void Z_InitMemory(void);
+void Z_Shutdown(void);
+
+void QDECL Com_Printf(const char *fmt, ...) {}
+
+void QDECL Com_DPrintf(const char *fmt, ...) {}
+
+void QDECL Com_Error(int code, const char *fmt, ...)
+{
+    va_list argptr;
+
+    va_start(argptr, fmt);
+    vfprintf(stderr, fmt, argptr);
+    va_end(argptr);
+
+    fputc('\n', stderr);
+    exit(1);
+}
+
+void Cmd_AddCommand(const char *cmd_name, xcommand_t function) {}
+
+int Cmd_Argc(void)
+{
+    return 1;
+}
+
+int Sys_Milliseconds(void)
+{
+    return 0;
+}
+}
+
+static MEM_TempAlloc frameMemory(1024);
+
+class TestFrameAllocator
+{
+public:
+    static void *Alloc(size_t size) { return frameMemory.Alloc(size, sizeof(void *)); }
+
+    static void Free(void *ptr) {}
+};
+
+static bool test_reset()
+{
+    void *first = NULL;
+    int   frame;
+    int   i;
+
+    for (frame = 0; frame < 4; frame++) {
+        // the first frame doesn't fit in a single block
+        for (i = 0; i < 10; i++) {
+            void *ptr = frameMemory.Alloc(300, sizeof(void *));
+
+            if ((uintptr_t)ptr % sizeof(void *)) {
+                std::cerr << "Frame allocation is misaligned" << std::endl;
+                return false;
+            }
+
+            if (!i) {
+                first = ptr;
+            }
+        }
+
+        if (frameMemory.Used() < 3000 || frameMemory.HighWaterMark() < frameMemory.Used()) {
+            std::cerr << "Frame memory usage is wrong" << std::endl;
+            return false;
+        }
+
+        frameMemory.Reset();
+
+        if (frameMemory.Used()) {
+            std::cerr << "Frame memory wasn't reset" << std::endl;
+            return false;
+        }
+    }
+
+    if (frameMemory.BlockSize() < frameMemory.HighWaterMark()) {
+        std::cerr << "Block didn't grow to the high-water mark" << std::endl;
+        return false;
+    }
+
+    // the next frame starts at the beginning of the same block
+    if (frameMemory.Alloc(300, sizeof(void *)) != first) {
+        std::cerr << "Block wasn't reused after a reset" << std::endl;
+        return false;
+    }
+
+    frameMemory.Reset();
+
+    return true;
+}
+
+static bool test_container()
+{
+    Container<int, TestFrameAllocator> list;
+    int                                i;
+
+    for (i = 0; i < 1000; i++) {
+        list.AddObject(i);
+    }
+
+    for (i = 1; i <= list.NumObjects(); i++) {
+        if (list.ObjectAt(i) != i - 1) {
+            std::cerr << "Frame container has wrong content" << std::endl;
+            return false;
+        }
+    }
+
+    list.FreeObjectList();
+    frameMemory.Reset();
+
+    return true;
+}
+
+static void bench_frame()
+{
+    const int numFrames = 10000;
+    int       frame;
+    int       i;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (frame = 0; frame < numFrames; frame++) {
+        Container<int> list;
+
+        for (i = 0; i < 64; i++) {
+            list.AddObject(i);
+        }
+    }
+
+    auto middle = std::chrono::steady_clock::now();
+
+    for (frame = 0; frame < numFrames; frame++) {
+        Container<int, TestFrameAllocator> list;
+
+        for (i = 0; i < 64; i++) {
+            list.AddObject(i);
+        }
+
+        frameMemory.Reset();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "heap container: " << std::chrono::duration<double, std::nano>(middle - start).count() / numFrames
+              << " ns, frame container: "
+              << std::chrono::duration<double, std::nano>(end - middle).count() / numFrames << " ns" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    Z_InitMemory();
+
+    if (!test_reset()) {
+        return 1;
+    }
+
+    if (!test_container()) {
+        return 1;
+    }
+
+    bench_frame();
+
+    frameMemory.FreeAll();
+    Z_Shutdown();
+
+    return 0;
+}
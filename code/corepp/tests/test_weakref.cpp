@@ -0,0 +1,123 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+#include "../weakref.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+static Class *object_at(int index)
+{
+    // the table never dereferences the objects
+    return (Class *)(uintptr_t)((index + 1) * 16);
+}
+
+struct reference_t {
+    unsigned int index;
+    unsigned int generation;
+    int          object;
+};
+
+static bool test_invalidation()
+{
+    std::vector<unsigned int> slots;
+    std::vector<reference_t>  refs;
+    std::vector<bool>         alive;
+    int                       i;
+
+    for (i = 0; i < 5000; i++) {
+        reference_t ref;
+
+        slots.push_back(WeakRefTable::AllocSlot(object_at(i)));
+        alive.push_back(true);
+
+        ref.index      = slots[i];
+        ref.generation = WeakRefTable::Generation(slots[i]);
+        ref.object     = i;
+        refs.push_back(ref);
+
+        if (!slots[i]) {
+            std::cerr << "Slot 0 was allocated" << std::endl;
+            return false;
+        }
+    }
+
+    // delete every third object, the slots are reused by new objects
+    for (i = 0; i < 5000; i += 3) {
+        WeakRefTable::FreeSlot(slots[i]);
+        alive[i] = false;
+    }
+
+    for (i = 5000; i < 6000; i++) {
+        reference_t ref;
+
+        slots.push_back(WeakRefTable::AllocSlot(object_at(i)));
+        alive.push_back(true);
+
+        ref.index      = slots[i];
+        ref.generation = WeakRefTable::Generation(slots[i]);
+        ref.object     = i;
+        refs.push_back(ref);
+    }
+
+    for (i = 0; i < (int)refs.size(); i++) {
+        Class *expected = alive[refs[i].object] ? object_at(refs[i].object) : nullptr;
+
+        if (WeakRefTable::Lookup(refs[i].index, refs[i].generation) != expected) {
+            std::cerr << "Reference " << i << " is wrong" << std::endl;
+            return false;
+        }
+    }
+
+    if (WeakRefTable::Lookup(0, 0) != nullptr) {
+        std::cerr << "NULL reference isn't NULL" << std::endl;
+        return false;
+    }
+
+    if (WeakRefTable::NumUsed() != 6000 - 1667) {
+        std::cerr << WeakRefTable::NumUsed() << " slots used" << std::endl;
+        return false;
+    }
+
+    if (WeakRefTable::NumSlots() != 5000) {
+        std::cerr << "Freed slots weren't reused, " << WeakRefTable::NumSlots() << " slots" << std::endl;
+        return false;
+    }
+
+    for (i = 0; i < (int)slots.size(); i++) {
+        if (alive[i]) {
+            WeakRefTable::FreeSlot(slots[i]);
+        }
+    }
+
+    return WeakRefTable::NumUsed() == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!test_invalidation()) {
+        return 1;
+    }
+
+    return 0;
+}
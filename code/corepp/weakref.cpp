@@ -0,0 +1,116 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// weakref.cpp: Global slot table of the weak references
+
+#include "weakref.h"
+#include "mem_blockalloc.h"
+
+#include <cstring>
+
+weakRefSlot_t *WeakRefTable::slots     = nullptr;
+unsigned int   WeakRefTable::numSlots  = 0;
+unsigned int   WeakRefTable::maxSlots  = 0;
+unsigned int   WeakRefTable::firstFree = 0;
+unsigned int   WeakRefTable::numUsed   = 0;
+
+/*
+============
+WeakRefTable::AllocSlot
+
+Returns the slot of the object, slot 0 is never used so a NULL reference is 0
+============
+*/
+unsigned int WeakRefTable::AllocSlot(Class *ptr)
+{
+    weakRefSlot_t *slot;
+    unsigned int   index;
+
+    if (firstFree) {
+        index     = firstFree;
+        firstFree = slots[index].nextFree;
+    } else {
+        if (numSlots >= maxSlots) {
+            weakRefSlot_t *newSlots;
+            unsigned int   newMaxSlots = maxSlots ? maxSlots * 2 : 1024;
+
+            // only indexes are kept by the references, so the table can move
+            newSlots = (weakRefSlot_t *)MEM_Alloc(sizeof(weakRefSlot_t) * newMaxSlots);
+            if (slots) {
+                memcpy(newSlots, slots, sizeof(weakRefSlot_t) * numSlots);
+                MEM_Free(slots);
+            } else {
+                // reserve the NULL slot
+                newSlots[0].ptr        = nullptr;
+                newSlots[0].generation = 0;
+                newSlots[0].nextFree   = 0;
+                numSlots               = 1;
+            }
+
+            slots    = newSlots;
+            maxSlots = newMaxSlots;
+        }
+
+        index                   = numSlots++;
+        slots[index].generation = 1;
+    }
+
+    slot           = &slots[index];
+    slot->ptr      = ptr;
+    slot->nextFree = 0;
+    numUsed++;
+
+    return index;
+}
+
+/*
+============
+WeakRefTable::FreeSlot
+
+Called when the object is deleted, the references to the previous generation become NULL
+============
+*/
+void WeakRefTable::FreeSlot(unsigned int index)
+{
+    weakRefSlot_t *slot = &slots[index];
+
+    slot->ptr = nullptr;
+    slot->generation++;
+    if (!slot->generation) {
+        // 0 is the generation of NULL references
+        slot->generation = 1;
+    }
+
+    slot->nextFree = firstFree;
+    firstFree      = index;
+    numUsed--;
+}
+
+unsigned int WeakRefTable::NumUsed()
+{
+    return numUsed;
+}
+
+unsigned int WeakRefTable::NumSlots()
+{
+    return numSlots ? numSlots - 1 : 0;
+}
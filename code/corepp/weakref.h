@@ -0,0 +1,153 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// weakref.h: Weak references, an index and a generation into a global slot table.
+//
+// Unlike a SafePtr, a WeakRef isn't linked to the object it refers to:
+// copying or destroying it doesn't touch the object, and deleting the object
+// invalidates all its references at once by bumping the generation of its slot.
+
+#pragma once
+
+class Class;
+
+typedef struct weakRefSlot_s {
+    Class       *ptr;
+    unsigned int generation;
+    unsigned int nextFree; // next free slot, when the slot is free
+} weakRefSlot_t;
+
+class WeakRefTable
+{
+private:
+    static weakRefSlot_t *slots;
+    static unsigned int   numSlots;
+    static unsigned int   maxSlots;
+    static unsigned int   firstFree;
+    static unsigned int   numUsed;
+
+public:
+    static unsigned int AllocSlot(Class *ptr);
+    static void         FreeSlot(unsigned int index);
+
+    static Class       *Lookup(unsigned int index, unsigned int generation);
+    static unsigned int Generation(unsigned int index);
+
+    static unsigned int NumUsed();
+    static unsigned int NumSlots();
+};
+
+class WeakRefBase
+{
+protected:
+    unsigned int index; // 0 if NULL
+    unsigned int generation;
+
+public:
+    WeakRefBase();
+
+    void   InitWeakRef(Class *newptr);
+    Class *Pointer(void) const;
+    void   Clear(void);
+};
+
+inline Class *WeakRefTable::Lookup(unsigned int index, unsigned int generation)
+{
+    if (!index || slots[index].generation != generation) {
+        return nullptr;
+    }
+
+    return slots[index].ptr;
+}
+
+inline unsigned int WeakRefTable::Generation(unsigned int index)
+{
+    return slots[index].generation;
+}
+
+inline WeakRefBase::WeakRefBase()
+{
+    index      = 0;
+    generation = 0;
+}
+
+inline Class *WeakRefBase::Pointer(void) const
+{
+    return WeakRefTable::Lookup(index, generation);
+}
+
+inline void WeakRefBase::Clear(void)
+{
+    index      = 0;
+    generation = 0;
+}
+
+template<class T>
+class WeakRef : public WeakRefBase
+{
+public:
+    WeakRef(T *objptr = nullptr);
+
+    WeakRef& operator=(T *const obj);
+
+    bool operator!() const;
+    operator T *() const;
+    T *operator->() const;
+    T& operator*() const;
+};
+
+template<class T>
+inline WeakRef<T>::WeakRef(T *objptr)
+{
+    InitWeakRef((Class *)objptr);
+}
+
+template<class T>
+inline WeakRef<T>& WeakRef<T>::operator=(T *const obj)
+{
+    InitWeakRef((Class *)obj);
+    return *this;
+}
+
+template<class T>
+inline bool WeakRef<T>::operator!() const
+{
+    return Pointer() == nullptr;
+}
+
+template<class T>
+inline WeakRef<T>::operator T *() const
+{
+    return (T *)Pointer();
+}
+
+template<class T>
+inline T *WeakRef<T>::operator->() const
+{
+    return (T *)Pointer();
+}
+
+template<class T>
+inline T& WeakRef<T>::operator*() const
+{
+    return *(T *)Pointer();
+}
@@ -214,7 +214,10 @@ qboolean ArchiveFile::OpenRead(const char *name)
         tempbuf = (byte *)gi.Malloc(new_len);
 
         if (g_lz77.Decompress(pos, length - 8, tempbuf, &iCSVGLength) || iCSVGLength != new_len) {
-            gi.Error(ERR_DROP, "Decompression of save game failed\n");
+            // the caller reports the error
+            gi.DPrintf("Decompression of '%s' failed\n", name);
+            gi.Free(tempbuf);
+            Close();
             return false;
         }
 
@@ -261,6 +264,11 @@ qboolean ArchiveFile::Read(void *dest, size_t size)
 
 qboolean ArchiveFile::Write(const void *source, size_t size)
 {
+    if (!writing) {
+        // closed after an error
+        return false;
+    }
+
     if ((pos + size) > (buffer + bufferlength)) {
         byte *oldbuf;
 
@@ -380,6 +388,10 @@ void Archiver::Close(void)
                 SafePtrBase *fixupptr;
                 fixupptr = (SafePtrBase *)fixup->ptr;
                 fixupptr->InitSafePtr(static_cast<Class *>(classpointerList.ObjectAt(fixup->index)));
+            } else if (fixup->type == pointer_fixup_weak) {
+                WeakRefBase *fixupptr;
+                fixupptr = (WeakRefBase *)fixup->ptr;
+                fixupptr->InitWeakRef(static_cast<Class *>(classpointerList.ObjectAt(fixup->index)));
             }
             delete fixup;
         }
@@ -708,6 +720,44 @@ void Archiver::ArchiveSafePointer(SafePtrBase *ptr)
     }
 }
 
+/*
+============
+Archiver::ArchiveWeakRef
+
+Same data as a safe pointer, so a SafePtr can become a WeakRef without breaking saves
+============
+*/
+void Archiver::ArchiveWeakRef(WeakRefBase *ptr)
+{
+    int index = 0;
+
+    if (archivemode == ARCHIVE_READ) {
+        pointer_fixup_t *fixup;
+
+        ArchiveData(ARC_SafePointer, &index, sizeof(index));
+        index = LittleLong(index);
+
+        // init the reference with NULL until we can fix it
+        ptr->Clear();
+
+        if (index != ARCHIVE_NULL_POINTER) {
+            fixup        = new pointer_fixup_t;
+            fixup->ptr   = (void **)ptr;
+            fixup->index = index;
+            fixup->type  = pointer_fixup_weak;
+            fixupList.AddObject(fixup);
+        }
+    } else {
+        if (ptr->Pointer()) {
+            index = classpointerList.AddUniqueObject(ptr->Pointer());
+        } else {
+            index = ARCHIVE_NULL_POINTER;
+        }
+        index = LittleLong(index);
+        ArchiveData(ARC_SafePointer, &index, sizeof(index));
+    }
+}
+
 void Archiver::ArchiveEventPointer(Event **ev)
 {
     int index;
@@ -1003,6 +1053,11 @@ void Archiver::ArchiveObject(SafePtrBase* obj)
     ArchiveSafePointer(obj);
 }
 
+void Archiver::ArchiveObject(WeakRefBase *obj)
+{
+    ArchiveWeakRef(obj);
+}
+
 void Archiver::ArchiveObjectPosition(LightClass *obj)
 {
     int index = 0;
@@ -1023,6 +1078,10 @@ qboolean Archiver::ObjectPositionExists(void *obj)
 
 void Archiver::CheckRead(void)
 {
+    if (fileerror) {
+        return;
+    }
+
     assert(archivemode == ARCHIVE_READ);
     if (!fileerror && (archivemode != ARCHIVE_READ)) {
         FileError("File read during a write operation.");
@@ -1031,6 +1090,10 @@ void Archiver::CheckRead(void)
 
 void Archiver::CheckWrite(void)
 {
+    if (fileerror) {
+        return;
+    }
+
     assert(archivemode == ARCHIVE_WRITE);
     if (!fileerror && (archivemode != ARCHIVE_WRITE)) {
         FileError("File write during a read operation.");
@@ -1143,7 +1206,7 @@ void Archiver::CheckType(int type)
                 }
             }
         }
-    } else {
+    } else if (archivemode == ARCHIVE_WRITE) {
         WriteType(type);
     }
 }
@@ -44,7 +44,8 @@ typedef enum {
 enum {
     pointer_fixup_ptr,
     pointer_fixup_normal,
-    pointer_fixup_safe
+    pointer_fixup_safe,
+    pointer_fixup_weak
 };
 
 typedef struct {
@@ -143,6 +144,7 @@ public:
     void ArchiveObjectPointer(Class **ptr);
     void ArchiveObjectPosition(LightClass *obj);
     void ArchiveSafePointer(SafePtrBase *ptr);
+    void ArchiveWeakRef(WeakRefBase *ptr);
     void ArchiveEventPointer(Event **ev);
     void ArchiveBool(bool *boolean);
     void ArchivePosition(int *pos);
@@ -154,6 +156,7 @@ public:
     void ArchiveRaw(void *data, size_t size);
     void ArchiveObject(Class *obj);
     void ArchiveObject(SafePtrBase *obj); // Added in OPM
+    void ArchiveObject(WeakRefBase *obj);
 
     qboolean ObjectPositionExists(void *obj);
 
@@ -164,8 +167,8 @@ public:
     void SetSilent(bool bSilent);
 };
 
-template<class Type>
-inline void Container<Type>::Archive(Archiver& arc, void (*ArchiveFunc)(Archiver& arc, Type *obj))
+template<class Type, class Allocator>
+inline void Container<Type, Allocator>::Archive(Archiver& arc, void (*ArchiveFunc)(Archiver& arc, Type *obj))
 {
     Type *obj;
     int   num;
@@ -271,8 +274,8 @@ inline void ArchiveClass(Archiver& arc, c *obj)
     arc.ArchiveObject(obj);
 }
 
-template<typename Type>
-void Container<Type>::Archive(Archiver& arc)
+template<typename Type, typename Allocator>
+void Container<Type, Allocator>::Archive(Archiver& arc)
 {
     Archive(arc, ArchiveClass<Type>);
 }
@@ -282,53 +285,48 @@ void Container<Type>::Archive(Archiver& arc)
 template<typename key, typename value>
 void con_set<key, value>::Archive(Archiver& arc)
 {
-    Entry *e = NULL;
-    int    hash;
-    int    i;
-
-    arc.ArchiveUnsigned(&tableLength);
-    arc.ArchiveUnsigned(&threshold);
-    arc.ArchiveUnsigned(&count);
-    arc.ArchiveUnsignedShort(&tableLengthIndex);
+    Entry             *e = NULL;
+    unsigned int       length;
+    unsigned int       limit;
+    unsigned int       total;
+    short unsigned int lengthIndex;
+    unsigned int       i;
+
+    // the table is rebuilt when loading, the size is kept for the format
+    length      = tableLength;
+    limit       = threshold;
+    total       = count;
+    lengthIndex = 0;
+
+    arc.ArchiveUnsigned(&length);
+    arc.ArchiveUnsigned(&limit);
+    arc.ArchiveUnsigned(&total);
+    arc.ArchiveUnsignedShort(&lengthIndex);
 
     if (arc.Loading()) {
-        if (tableLength != 1) {
-            table = new (NewTable(tableLength)) Entry *[tableLength]();
-            memset(table, 0, tableLength * sizeof(Entry *));
+        clear();
+        if (total) {
+            resize(total);
         }
 
-        for (i = 0; i < count; i++) {
+        for (i = 0; i < total; i++) {
             e = new Entry;
             e->Archive(arc);
 
-            hash = HashCode<key>(e->GetKey()) % tableLength;
-
-            e->next     = table[hash];
-            table[hash] = e;
+            insertEntry(e, con_set_MixHash(HashCode<key>(e->GetKey())));
+            count++;
         }
-
-        defaultEntry = e;
     } else {
-#    ifndef NDEBUG
-        int total;
-
         total = 0;
 
         for (i = 0; i < tableLength; i++) {
-            for (e = table[i]; e != NULL; e = e->next) {
-                e->Archive(arc);
+            if (!(control[i] & 0x80)) {
+                table[i].entry->Archive(arc);
                 total++;
             }
         }
         // it must match the number of elements
         assert(total == count);
-#    else
-        for (i = 0; i < tableLength; i++) {
-            for (e = table[i]; e != NULL; e = e->next) {
-                e->Archive(arc);
-            }
-        }
-#    endif
     }
 }
 
@@ -2075,6 +2075,8 @@ void Entity::SetSize(void)
 
     edict->r.radius = size.length() * 0.5;
     edict->radius2  = edict->r.radius * edict->r.radius;
+
+    entityGrid.Update(edict->s.number, centroid, edict->r.radius);
 }
 
 void Entity::ProcessInitCommands(void)
@@ -2265,6 +2267,8 @@ void Entity::link(void)
     centroid = (absmin + absmax) * 0.5;
     centroid.copyTo(edict->r.centroid);
 
+    entityGrid.Update(edict->s.number, centroid, edict->r.radius);
+
     // If this has a parent, then set the areanum the same
     // as the parent's
     if (edict->s.parent != ENTITYNUM_NONE) {
@@ -5761,6 +5765,10 @@ void Entity::Archive(Archiver& arc)
 
     G_ArchiveEdict(arc, edict);
 
+    if (arc.Loading()) {
+        entityGrid.Update(edict->s.number, centroid, edict->r.radius);
+    }
+
     arc.ArchiveInteger(&entnum);
     arc.ArchiveInteger(&radnum);
     arc.ArchiveInteger(&spawnflags);
@@ -0,0 +1,376 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// entitygrid.cpp: Spatial index of the game entities for proximity queries
+
+#include "entitygrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+static int CellForCoord(float value)
+{
+    return (int)floor(value) >> ENTITYGRID_CELL_SHIFT;
+}
+
+EntityGrid::EntityGrid()
+{
+    m_Order      = 0;
+    m_Generation = 0;
+
+    Clear();
+}
+
+/*
+====================
+Clear
+
+Removes all entries
+====================
+*/
+void EntityGrid::Clear(void)
+{
+    int i;
+
+    for (i = 0; i < MAX_GENTITIES; i++) {
+        m_Entries[i].linked = false;
+        m_Entries[i].large  = false;
+        m_Entries[i].order  = 0;
+        m_Stamps[i]         = 0;
+    }
+
+    for (i = 0; i < ENTITYGRID_NUM_BUCKETS; i++) {
+        m_Buckets[i] = -1;
+    }
+
+    m_LargeEntries = -1;
+    m_FirstEntry   = -1;
+    m_LastEntry    = -1;
+    m_Stamp        = 0;
+    m_NumEntries   = 0;
+    m_Generation++;
+}
+
+int EntityGrid::BucketForCell(int x, int y)
+{
+    return (int)(((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u)) & (ENTITYGRID_NUM_BUCKETS - 1);
+}
+
+void EntityGrid::LinkNode(int *head, int node)
+{
+    m_NodePrev[node] = -1;
+    m_NodeNext[node] = *head;
+    if (*head != -1) {
+        m_NodePrev[*head] = node;
+    }
+
+    *head = node;
+}
+
+void EntityGrid::UnlinkNode(int *head, int node)
+{
+    if (m_NodePrev[node] != -1) {
+        m_NodeNext[m_NodePrev[node]] = m_NodeNext[node];
+    } else {
+        *head = m_NodeNext[node];
+    }
+
+    if (m_NodeNext[node] != -1) {
+        m_NodePrev[m_NodeNext[node]] = m_NodePrev[node];
+    }
+}
+
+void EntityGrid::LinkEntry(int num)
+{
+    Entry& e    = m_Entries[num];
+    int    node = num * ENTITYGRID_MAX_ENTRY_CELLS;
+    int    x, y;
+
+    if (e.large) {
+        LinkNode(&m_LargeEntries, node);
+        return;
+    }
+
+    for (y = e.cellMins[1]; y <= e.cellMaxs[1]; y++) {
+        for (x = e.cellMins[0]; x <= e.cellMaxs[0]; x++) {
+            LinkNode(&m_Buckets[BucketForCell(x, y)], node++);
+        }
+    }
+}
+
+void EntityGrid::UnlinkEntry(int num)
+{
+    Entry& e    = m_Entries[num];
+    int    node = num * ENTITYGRID_MAX_ENTRY_CELLS;
+    int    x, y;
+
+    if (e.large) {
+        UnlinkNode(&m_LargeEntries, node);
+        return;
+    }
+
+    // the nodes are assigned in the same order as they were linked
+    for (y = e.cellMins[1]; y <= e.cellMaxs[1]; y++) {
+        for (x = e.cellMins[0]; x <= e.cellMaxs[0]; x++) {
+            UnlinkNode(&m_Buckets[BucketForCell(x, y)], node++);
+        }
+    }
+}
+
+void EntityGrid::SetBounds(int num, const vec3_t center, float radius)
+{
+    Entry& e = m_Entries[num];
+    int    i;
+
+    for (i = 0; i < 3; i++) {
+        e.mins[i] = center[i] - radius;
+        e.maxs[i] = center[i] + radius;
+    }
+
+    for (i = 0; i < 2; i++) {
+        e.cellMins[i] = CellForCoord(e.mins[i]);
+        e.cellMaxs[i] = CellForCoord(e.maxs[i]);
+    }
+
+    e.large = (e.cellMaxs[0] - e.cellMins[0] >= ENTITYGRID_MAX_ENTRY_WIDTH)
+           || (e.cellMaxs[1] - e.cellMins[1] >= ENTITYGRID_MAX_ENTRY_WIDTH);
+}
+
+/*
+====================
+Insert
+
+Adds the entry as the most recent one, queries return entries in the order they were inserted
+====================
+*/
+void EntityGrid::Insert(int num, const vec3_t center, float radius)
+{
+    Entry& e = m_Entries[num];
+
+    if (e.linked) {
+        Remove(num);
+    }
+
+    SetBounds(num, center, radius);
+    e.order  = ++m_Order;
+    e.linked = true;
+    LinkEntry(num);
+
+    e.nextEntry = -1;
+    e.prevEntry = m_LastEntry;
+    if (m_LastEntry != -1) {
+        m_Entries[m_LastEntry].nextEntry = num;
+    } else {
+        m_FirstEntry = num;
+    }
+    m_LastEntry = num;
+    m_NumEntries++;
+
+    m_Generation++;
+}
+
+/*
+====================
+Update
+
+Moves an entry that was inserted before
+====================
+*/
+void EntityGrid::Update(int num, const vec3_t center, float radius)
+{
+    Entry& e = m_Entries[num];
+    int    i;
+
+    if (!e.linked) {
+        return;
+    }
+
+    for (i = 0; i < 3; i++) {
+        if (e.mins[i] != center[i] - radius || e.maxs[i] != center[i] + radius) {
+            break;
+        }
+    }
+
+    if (i == 3) {
+        // didn't move
+        return;
+    }
+
+    UnlinkEntry(num);
+    SetBounds(num, center, radius);
+    LinkEntry(num);
+
+    m_Generation++;
+}
+
+void EntityGrid::Remove(int num)
+{
+    Entry& e = m_Entries[num];
+
+    if (!e.linked) {
+        return;
+    }
+
+    UnlinkEntry(num);
+
+    if (e.prevEntry != -1) {
+        m_Entries[e.prevEntry].nextEntry = e.nextEntry;
+    } else {
+        m_FirstEntry = e.nextEntry;
+    }
+
+    if (e.nextEntry != -1) {
+        m_Entries[e.nextEntry].prevEntry = e.prevEntry;
+    } else {
+        m_LastEntry = e.prevEntry;
+    }
+
+    e.linked = false;
+    m_NumEntries--;
+
+    m_Generation++;
+}
+
+bool EntityGrid::EntryIntersects(const Entry& e, const vec3_t mins, const vec3_t maxs)
+{
+    return e.mins[0] <= maxs[0] && e.mins[1] <= maxs[1] && e.mins[2] <= maxs[2] && e.maxs[0] >= mins[0]
+        && e.maxs[1] >= mins[1] && e.maxs[2] >= mins[2];
+}
+
+int EntityGrid::GatherNodes(int node, const vec3_t mins, const vec3_t maxs, Candidate *candidates, int count)
+{
+    int num;
+
+    for (; node != -1; node = m_NodeNext[node]) {
+        num = node / ENTITYGRID_MAX_ENTRY_CELLS;
+
+        // entries covering multiple cells are only checked once
+        if (m_Stamps[num] == m_Stamp) {
+            continue;
+        }
+        m_Stamps[num] = m_Stamp;
+
+        if (!EntryIntersects(m_Entries[num], mins, maxs)) {
+            continue;
+        }
+
+        candidates[count].order = m_Entries[num].order;
+        candidates[count].num   = num;
+        count++;
+    }
+
+    return count;
+}
+
+/*
+====================
+IsLocalQuery
+
+Returns true if the query only covers a few cells,
+otherwise walking all entries is faster
+====================
+*/
+bool EntityGrid::IsLocalQuery(const vec3_t center, float radius) const
+{
+    int width, height;
+
+    width  = CellForCoord(center[0] + radius) - CellForCoord(center[0] - radius) + 1;
+    height = CellForCoord(center[1] + radius) - CellForCoord(center[1] - radius) + 1;
+
+    if (width > ENTITYGRID_MAX_QUERY_CELLS || height > ENTITYGRID_MAX_QUERY_CELLS) {
+        return false;
+    }
+
+    return width * height <= ENTITYGRID_MAX_QUERY_CELLS && width * height * 4 < m_NumEntries;
+}
+
+/*
+====================
+Query
+
+Returns the entries whose bounds intersect the bounds of the sphere, in the order they were inserted.
+The caller does the exact test
+====================
+*/
+int EntityGrid::Query(const vec3_t center, float radius, int *list, int maxcount)
+{
+    static Candidate candidates[MAX_GENTITIES];
+    vec3_t           mins, maxs;
+    int              cellMins[2], cellMaxs[2];
+    int              count;
+    int              num;
+    int              x, y;
+    int              i;
+
+    for (i = 0; i < 3; i++) {
+        mins[i] = center[i] - radius;
+        maxs[i] = center[i] + radius;
+    }
+
+    if (++m_Stamp < 0) {
+        // wrapped around
+        for (i = 0; i < MAX_GENTITIES; i++) {
+            m_Stamps[i] = 0;
+        }
+        m_Stamp = 1;
+    }
+
+    if (!IsLocalQuery(center, radius)) {
+        // check all entries, they are already sorted
+        count = 0;
+        for (num = m_FirstEntry; num != -1 && count < maxcount; num = m_Entries[num].nextEntry) {
+            if (EntryIntersects(m_Entries[num], mins, maxs)) {
+                list[count++] = num;
+            }
+        }
+
+        return count;
+    }
+
+    for (i = 0; i < 2; i++) {
+        cellMins[i] = CellForCoord(mins[i]);
+        cellMaxs[i] = CellForCoord(maxs[i]);
+    }
+
+    count = 0;
+    for (y = cellMins[1]; y <= cellMaxs[1]; y++) {
+        for (x = cellMins[0]; x <= cellMaxs[0]; x++) {
+            count = GatherNodes(m_Buckets[BucketForCell(x, y)], mins, maxs, candidates, count);
+        }
+    }
+
+    count = GatherNodes(m_LargeEntries, mins, maxs, candidates, count);
+
+    std::sort(candidates, candidates + count, [](const Candidate& c1, const Candidate& c2) {
+        return c1.order < c2.order;
+    });
+
+    if (count > maxcount) {
+        count = maxcount;
+    }
+
+    for (i = 0; i < count; i++) {
+        list[i] = candidates[i].num;
+    }
+
+    return count;
+}
@@ -0,0 +1,130 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// entitygrid.h: Spatial index of the game entities for proximity queries
+
+#pragma once
+
+#include "../qcommon/q_shared.h"
+
+//
+// Entities are hashed into a 2D grid of cells by the bounds of their sphere.
+// Entities covering too many cells are kept in a separate list that is always checked.
+//
+#define ENTITYGRID_CELL_SHIFT      9 // 512 units
+#define ENTITYGRID_NUM_BUCKETS     1024
+#define ENTITYGRID_MAX_ENTRY_WIDTH 4
+#define ENTITYGRID_MAX_ENTRY_CELLS (ENTITYGRID_MAX_ENTRY_WIDTH * ENTITYGRID_MAX_ENTRY_WIDTH)
+// past 3x3 cells, gathering and sorting the candidates is slower
+// than walking all entities (see test_entitygrid, 512 to 1024 units with 1000 entities)
+#define ENTITYGRID_MAX_QUERY_CELLS 9
+
+class EntityGrid
+{
+private:
+    class Entry
+    {
+    public:
+        float        mins[3];
+        float        maxs[3];
+        int          cellMins[2];
+        int          cellMaxs[2];
+        unsigned int order;
+        bool         linked;
+        bool         large;
+        // linked entries, in the order they were inserted
+        int nextEntry;
+        int prevEntry;
+    };
+
+    class Candidate
+    {
+    public:
+        unsigned int order;
+        int          num;
+    };
+
+    Entry m_Entries[MAX_GENTITIES];
+
+    // each entry has ENTITYGRID_MAX_ENTRY_CELLS nodes, one per cell it covers
+    int m_NodeNext[MAX_GENTITIES * ENTITYGRID_MAX_ENTRY_CELLS];
+    int m_NodePrev[MAX_GENTITIES * ENTITYGRID_MAX_ENTRY_CELLS];
+    int m_Buckets[ENTITYGRID_NUM_BUCKETS];
+    int m_LargeEntries;
+    int m_FirstEntry;
+    int m_LastEntry;
+
+    int          m_Stamps[MAX_GENTITIES];
+    int          m_Stamp;
+    int          m_NumEntries;
+    unsigned int m_Order;
+    unsigned int m_Generation;
+
+private:
+    static int BucketForCell(int x, int y);
+
+    void LinkNode(int *head, int node);
+    void UnlinkNode(int *head, int node);
+    void LinkEntry(int num);
+    void UnlinkEntry(int num);
+    void SetBounds(int num, const vec3_t center, float radius);
+    int  GatherNodes(int node, const vec3_t mins, const vec3_t maxs, Candidate *candidates, int count);
+
+    static bool EntryIntersects(const Entry& e, const vec3_t mins, const vec3_t maxs);
+
+public:
+    EntityGrid();
+
+    void Clear(void);
+
+    void Insert(int num, const vec3_t center, float radius);
+    void Update(int num, const vec3_t center, float radius);
+    void Remove(int num);
+
+    int  Query(const vec3_t center, float radius, int *list, int maxcount);
+    bool IsLocalQuery(const vec3_t center, float radius) const;
+
+    bool         IsLinked(int num) const;
+    unsigned int GetOrder(int num) const;
+    unsigned int GetGeneration(void) const;
+    int          NumEntries(void) const;
+};
+
+inline bool EntityGrid::IsLinked(int num) const
+{
+    return m_Entries[num].linked;
+}
+
+inline unsigned int EntityGrid::GetOrder(int num) const
+{
+    return m_Entries[num].order;
+}
+
+inline unsigned int EntityGrid::GetGeneration(void) const
+{
+    return m_Generation;
+}
+
+inline int EntityGrid::NumEntries(void) const
+{
+    return m_NumEntries;
+}
@@ -315,6 +315,8 @@ void G_BotShift(int clientNum)
     newEnt->entity->entnum       = newEnt->s.number;
     newEnt->client->ps.clientNum = newEnt->s.number;
 
+    entityGrid.Update(newEnt->s.number, newEnt->entity->centroid, newEnt->r.radius);
+
     G_ChangeParent(ent->s.number, newEnt->s.number);
 
     //
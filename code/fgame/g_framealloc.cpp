@@ -0,0 +1,79 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// g_framealloc.cpp: Scratch memory that only lives until the end of the server frame
+
+#include "g_local.h"
+#include "g_framealloc.h"
+#include "../corepp/mem_tempalloc.h"
+
+// most frames fit in one block, it grows to the high-water mark otherwise
+static MEM_TempAlloc frameMemory(64 * 1024);
+
+void *G_FrameAlloc(size_t size)
+{
+    return frameMemory.Alloc(size, sizeof(void *));
+}
+
+/*
+===============
+G_ResetFrameMemory
+
+Called at the end of every server frame, everything
+that was allocated from the frame memory is gone after this
+===============
+*/
+void G_ResetFrameMemory(void)
+{
+    if (g_showframemem->integer && frameMemory.Used()) {
+        gi.DPrintf(
+            "frame memory: %zu bytes used, %zu high-water mark, %zu block size\n",
+            frameMemory.Used(),
+            frameMemory.HighWaterMark(),
+            frameMemory.BlockSize()
+        );
+    }
+
+    frameMemory.Reset();
+}
+
+/*
+===============
+G_FreeFrameMemory
+
+Gives the blocks back when the game is shut down
+===============
+*/
+void G_FreeFrameMemory(void)
+{
+    frameMemory.FreeAll();
+}
+
+size_t G_FrameMemoryUsed(void)
+{
+    return frameMemory.Used();
+}
+
+size_t G_FrameMemoryHighWaterMark(void)
+{
+    return frameMemory.HighWaterMark();
+}
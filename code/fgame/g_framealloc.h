@@ -0,0 +1,50 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// g_framealloc.h: Scratch memory that only lives until the end of the server frame
+
+#pragma once
+
+#include "../corepp/container_fwd.h"
+
+#include <cstddef>
+
+void  *G_FrameAlloc(size_t size);
+void   G_ResetFrameMemory(void);
+void   G_FreeFrameMemory(void);
+size_t G_FrameMemoryUsed(void);
+size_t G_FrameMemoryHighWaterMark(void);
+
+//
+// Allocator for containers that are filled and thrown away within a frame,
+// the memory is reclaimed all at once by G_ResetFrameMemory
+//
+class FrameAllocator
+{
+public:
+    static void *Alloc(size_t size) { return G_FrameAlloc(size); }
+
+    static void Free(void *ptr) {}
+};
+
+template<class Type>
+using FrameContainer = Container<Type, FrameAllocator>;
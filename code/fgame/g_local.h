@@ -72,13 +72,12 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 //============================================================================
 
 #include "g_main.h"
+#include "../corepp/container_fwd.h"
 
 class str;
 class Vector;
 class Archiver;
 class Entity;
-template<typename T>
-class Container;
 
 typedef enum {
     SPECTATOR_NOT,
@@ -525,3 +524,4 @@ extern gentity_t *g_entities;
 #define FOFS(x) ((size_t) & (((gentity_t *)0)->x))
 
 #include "g_utils.h"
+#include "g_framealloc.h"
@@ -62,6 +62,8 @@ game_import_t gi;
 gentity_t active_edicts;
 gentity_t free_edicts;
 
+EntityGrid entityGrid;
+
 int sv_numtraces   = 0;
 int sv_numpmtraces = 0;
 
@@ -203,6 +205,7 @@ void G_AllocGameData(void)
     // Add all the edicts to the free list
     LL_Reset(&free_edicts, next, prev);
     LL_Reset(&active_edicts, next, prev);
+    entityGrid.Clear();
 
     for (i = 0; i < game.maxentities; i++) {
         LL_Add(&free_edicts, &g_entities[i], next, prev);
@@ -338,6 +341,8 @@ void G_ShutdownGame()
 
     L_ShutdownEvents();
 
+    G_FreeFrameMemory();
+
     G_DeAllocGameData();
 }
 
@@ -446,6 +451,15 @@ void G_AddGEntity(gentity_t *edict, qboolean showentnums)
     }
 }
 
+//
+// Resets the frame memory however G_RunFrame returns
+//
+class FrameMemoryScope
+{
+public:
+    ~FrameMemoryScope() { G_ResetFrameMemory(); }
+};
+
 /*
 ================
 G_RunFrame
@@ -462,6 +476,7 @@ void G_RunFrame(int levelTime, int frameTime)
     unsigned long long end;
     static int         processed[MAX_GENTITIES] = {0};
     static int         processedFrameID         = 0;
+    FrameMemoryScope   frameMemoryScope;
 
     try {
         g_iInThinks = 0;
@@ -539,7 +554,25 @@ void G_RunFrame(int levelTime, int frameTime)
         // Process any pending events that got posted during the script code
         L_ProcessPendingEvents();
 
-        path_checksthisframe = 0;
+        if (ai_showpathstats->integer && path_searchesthisframe) {
+            gi.DPrintf(
+                "%d path searches, %d from the cache, %d nodes expanded\n",
+                path_searchesthisframe,
+                path_cachehitsthisframe,
+                path_expandedthisframe
+            );
+        }
+
+        path_checksthisframe    = 0;
+        path_searchesthisframe  = 0;
+        path_cachehitsthisframe = 0;
+        path_expandedthisframe  = 0;
+
+        if (g_showscriptallocs->integer && script_allocsthisframe) {
+            gi.DPrintf("%u script variable allocations\n", script_allocsthisframe);
+        }
+
+        script_allocsthisframe = 0;
 
         // Reset debug lines
         G_InitDebugLines();
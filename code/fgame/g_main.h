@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "g_local.h"
 #include "gamecvars.h"
+#include "entitygrid.h"
 
 class Player;
 
@@ -42,6 +43,8 @@ extern qboolean g_bBeforeThinks;
 extern gentity_t active_edicts;
 extern gentity_t free_edicts;
 
+extern EntityGrid entityGrid;
+
 extern int sv_numtraces;
 extern int sv_numpmtraces;
 
@@ -30,7 +30,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 // Version 11 is >= 0.05 and <= 1.00
 // Version 12 is >= 1.10
 // Version 15 is >= 2.0
-#define GAME_API_VERSION 15
+// Version 16 adds RunJobs to the game imports
+#define GAME_API_VERSION 16
 
 // entity->svFlags
 // the server does not know how to interpret most of the values
@@ -500,6 +501,12 @@ typedef struct gameImport_s {
 
     cvar_t *fsDebug;
 
+    /**
+     * Run func for each index in [0, count) on worker threads, returns once all jobs are done.
+     * Jobs must not call any other import
+     */
+    void (*RunJobs)(int numThreads, int count, void (*func)(void *data, int index), void *data);
+
 } game_import_t;
 
 typedef struct gameExport_s {
@@ -1014,16 +1014,22 @@ qboolean IsNumeric(const char *str)
     return true;
 }
 
+static int          findradius_candidates[MAX_GENTITIES];
+static int          findradius_numCandidates;
+static int          findradius_next;
+static Entity      *findradius_last;
+static Vector       findradius_org;
+static float        findradius_rad;
+static unsigned int findradius_generation;
+
 /*
 =================
-findradius
-
-Returns entities that have origins within a spherical area
+findradius_linear
 
-findradius (org, radius)
+Walks the whole active list, faster than the grid for large radii
 =================
 */
-Entity *findradius(Entity *startent, Vector org, float rad)
+static Entity *findradius_linear(Entity *startent, const Vector& org, float rad)
 {
     Vector     eorg;
     gentity_t *from;
@@ -1068,6 +1074,78 @@ Entity *findradius(Entity *startent, Vector org, float rad)
     return NULL;
 }
 
+/*
+=================
+findradius
+
+Returns entities that have origins within a spherical area
+
+findradius (org, radius)
+=================
+*/
+Entity *findradius(Entity *startent, Vector org, float rad)
+{
+    Vector       eorg;
+    gentity_t   *from;
+    float        r2, distance;
+    unsigned int startOrder;
+
+    if (!entityGrid.IsLocalQuery(org, rad)) {
+        findradius_last = NULL;
+        return findradius_linear(startent, org, rad);
+    }
+
+    // the candidates are kept while iterating over the results,
+    // until an entity is added, moved or removed
+    if (!startent || startent != findradius_last || org != findradius_org || rad != findradius_rad
+        || entityGrid.GetGeneration() != findradius_generation) {
+        findradius_numCandidates = entityGrid.Query(org, rad, findradius_candidates, MAX_GENTITIES);
+        findradius_next          = 0;
+        findradius_org           = org;
+        findradius_rad           = rad;
+        findradius_generation    = entityGrid.GetGeneration();
+
+        if (startent) {
+            // entities are returned in the order of the active list
+            startOrder = entityGrid.GetOrder(startent->edict->s.number);
+            while (findradius_next < findradius_numCandidates
+                   && entityGrid.GetOrder(findradius_candidates[findradius_next]) <= startOrder) {
+                findradius_next++;
+            }
+        }
+    }
+
+    // square the radius so that we don't have to do a square root
+    r2 = rad * rad;
+
+    while (findradius_next < findradius_numCandidates) {
+        from = &g_entities[findradius_candidates[findradius_next++]];
+
+        assert(from->inuse);
+        assert(from->entity);
+
+        eorg = org - from->entity->centroid;
+
+        // dot product returns length squared
+        distance = eorg * eorg;
+
+        if (distance <= r2) {
+            findradius_last = from->entity;
+            return from->entity;
+        } else {
+            // subtract the object's own radius from this distance
+            distance -= from->radius2;
+            if (distance <= r2) {
+                findradius_last = from->entity;
+                return from->entity;
+            }
+        }
+    }
+
+    findradius_last = NULL;
+    return NULL;
+}
+
 /*
 =================
 findclientinradius
@@ -1783,17 +1861,50 @@ void G_BroadcastAIEvent(Entity *originator, Vector origin, char *pszType)
     G_BroadcastAIEvent(originator, origin, G_AIEventTypeFromString(pszType), -1.0f);
 }
 
+static void G_SendAIEvent(Sentient *ent, Entity *originator, Vector& origin, int iType, float r2, int iAreaNum)
+{
+    Actor *act;
+    Vector delta;
+    float  dist2;
+
+    if ((ent == originator) || ent->deadflag) {
+        return;
+    }
+
+    if (!ent->IsSubclassOfActor()) {
+        return;
+    }
+
+    act = static_cast<Actor *>(ent);
+    if (act->IgnoreSound(iType)) {
+        return;
+    }
+
+    delta = origin - ent->centroid;
+
+    // dot product returns length squared
+    dist2 = Square(delta);
+
+    if (dist2 > r2) {
+        return;
+    }
+
+    if (iAreaNum != ent->edict->r.areanum && !gi.AreasConnected(iAreaNum, ent->edict->r.areanum)) {
+        return;
+    }
+
+    act->ReceiveAIEvent(origin, iType, originator, dist2, r2);
+}
+
 void G_BroadcastAIEvent(Entity *originator, Vector origin, int iType, float radius)
 {
     Sentient *ent;
-    Actor    *act;
-    Vector    delta;
-    str       name;
     float     r2;
-    float     dist2;
     int       i;
     int       iNumSentients;
+    int       iNumEntities;
     int       iAreaNum;
+    int       entities[MAX_GENTITIES];
 
     if (iType == AI_EVENT_MISC || iType == AI_EVENT_MISC_LOUD) {
         ent = static_cast<Sentient *>(G_GetEntity(0));
@@ -1809,43 +1920,29 @@ void G_BroadcastAIEvent(Entity *originator, Vector origin, int iType, float radi
 
     assert(originator);
 
-    r2            = Square(radius);
-    iNumSentients = SentientList.NumObjects();
-    for (i = 1; i <= iNumSentients; i++) {
-        ent = SentientList.ObjectAt(i);
-        if ((ent == originator) || ent->deadflag) {
-            continue;
-        }
-
-        if (!ent->IsSubclassOfActor()) {
-            continue;
-        }
-
-        act = static_cast<Actor *>(ent);
-        if (act->IgnoreSound(iType)) {
-            continue;
-        }
-
-        delta = origin - ent->centroid;
+    if (originator) {
+        iAreaNum = originator->edict->r.areanum;
+    } else {
+        iAreaNum = gi.AreaForPoint(origin);
+    }
 
-        // dot product returns length squared
-        dist2 = Square(delta);
+    r2 = Square(radius);
 
-        if (originator) {
-            iAreaNum = originator->edict->r.areanum;
-        } else {
-            iAreaNum = gi.AreaForPoint(origin);
-        }
+    if (entityGrid.IsLocalQuery(origin, radius)) {
+        // only check the entities around
+        iNumEntities = entityGrid.Query(origin, radius, entities, MAX_GENTITIES);
+        for (i = 0; i < iNumEntities; i++) {
+            Entity *e = g_entities[entities[i]].entity;
 
-        if (dist2 > r2) {
-            continue;
+            if (e && e->IsSubclassOfSentient()) {
+                G_SendAIEvent(static_cast<Sentient *>(e), originator, origin, iType, r2, iAreaNum);
+            }
         }
-
-        if (iAreaNum != ent->edict->r.areanum && !gi.AreasConnected(iAreaNum, ent->edict->r.areanum)) {
-            continue;
+    } else {
+        iNumSentients = SentientList.NumObjects();
+        for (i = 1; i <= iNumSentients; i++) {
+            G_SendAIEvent(SentientList.ObjectAt(i), originator, origin, iType, r2, iAreaNum);
         }
-
-        act->ReceiveAIEvent(origin, iType, originator, dist2, r2);
     }
 
     botManager.BroadcastEvent(originator, origin, iType, radius);
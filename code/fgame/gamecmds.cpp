@@ -35,6 +35,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "playerbot.h"
 #include "consoleevent.h"
 #include "g_bot.h"
+#include "navigation_recast_load.h"
+#include "navigation_recast_path.h"
 
 typedef struct {
     const char *command;
@@ -73,6 +75,8 @@ consolecmd_t G_ConsoleCmds[] = {
     {"addbot",          G_AddBotCommand,      qfalse},
     {"addbotnamed",     G_AddBotNamedCommand, qfalse},
     {"removebot",       G_RemoveBotCommand,   qfalse},
+    {"navcache_build",  G_NavCacheBuild,      qfalse},
+    {"navstats",        G_NavStatsCmd,        qfalse},
 #ifdef _DEBUG
     {"bot",             G_BotCommand,         qfalse},
 #endif
@@ -634,6 +638,34 @@ qboolean G_CompileScript(gentity_t *ent)
     return qtrue;
 }
 
+qboolean G_NavCacheBuild(gentity_t *ent)
+{
+    str maps;
+    int i;
+
+    if (gi.Argc() <= 1) {
+        // the whole map rotation
+        maps = gi.Cvar_Get("sv_maplist", "", 0)->string;
+    } else {
+        for (i = 1; i < gi.Argc(); i++) {
+            if (i > 1) {
+                maps += " ";
+            }
+            maps += gi.Argv(i);
+        }
+    }
+
+    navigationMap.BuildCaches(maps.c_str());
+
+    return qtrue;
+}
+
+qboolean G_NavStatsCmd(gentity_t *ent)
+{
+    pathMaster.PrintStats();
+    return qtrue;
+}
+
 qboolean G_AddBotCommand(gentity_t *ent)
 {
     unsigned int numbots;
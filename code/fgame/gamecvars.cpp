@@ -97,8 +97,10 @@ cvar_t *sv_invulnerabletime;
 cvar_t *sv_team_spawn_interval;
 
 cvar_t *g_showmem;
+cvar_t *g_showframemem;
 cvar_t *g_timeents;
 cvar_t *g_timescripts;
+cvar_t *g_showscriptallocs;
 
 cvar_t *g_showaxis;
 cvar_t *g_showplayerstate;
@@ -128,6 +130,7 @@ cvar_t *g_logstats;
 cvar_t *g_showtokens;
 cvar_t *g_showopcodes;
 cvar_t *g_scriptcheck;
+cvar_t *g_scriptcache;
 cvar_t *g_nodecheck;
 cvar_t *g_scriptdebug;
 cvar_t *g_scripttrace;
@@ -280,6 +283,14 @@ cvar_t *sv_minPlayers;
 //  because when a client connects and the slot is used by a bot
 //  the bot will be relocated to a free entity slot
 cvar_t *sv_sharedbots;
+// Whether or not the built navigation meshes are saved and loaded from navcache/
+cvar_t *sv_navcache;
+// The maps left to build the navigation cache for, set by navcache_build
+cvar_t *sv_navcachebuild;
+// Worker threads building the navigation tiles, -1 for one per core
+cvar_t *sv_navthreads;
+// Time spent finding bot paths per frame, in milliseconds, 0 for no limit
+cvar_t *sv_navBudgetMs;
 
 cvar_t *g_bot_attack_burst_min_time;
 cvar_t *g_bot_attack_burst_random_delay;
@@ -413,6 +424,7 @@ void CVAR_Init(void)
     }
 
     g_showmem         = gi.Cvar_Get("g_showmem", "0", 0);
+    g_showframemem    = gi.Cvar_Get("g_showframemem", "0", 0);
     g_timeents        = gi.Cvar_Get("g_timeents", "0", 0);
     g_timescripts     = gi.Cvar_Get("g_timescripts", "0", 0);
     g_showaxis        = gi.Cvar_Get("g_showaxis", "0", 0);
@@ -423,6 +435,8 @@ void CVAR_Init(void)
     g_entinfo         = gi.Cvar_Get("g_entinfo", "0", CVAR_CHEAT);
     g_showlookat      = gi.Cvar_Get("g_showlookat", "0", CVAR_CHEAT);
 
+    g_showscriptallocs = gi.Cvar_Get("g_showscriptallocs", "0", 0);
+
     g_numdebuglines      = gi.Cvar_Get("g_numdebuglines", "4096", CVAR_LATCH);
     g_numdebuglinedelays = gi.Cvar_Get("g_numdebuglinedelays", "0", 0);
     g_numdebugstrings    = gi.Cvar_Get("g_numdebugstrings", "256", CVAR_LATCH);
@@ -442,6 +456,7 @@ void CVAR_Init(void)
     g_showtokens   = gi.Cvar_Get("g_showtokens", "0", 0);
     g_showopcodes  = gi.Cvar_Get("g_showopcodes", "0", 0);
     g_scriptcheck  = gi.Cvar_Get("g_scriptcheck", "0", 0);
+    g_scriptcache  = gi.Cvar_Get("g_scriptcache", "1", CVAR_ARCHIVE);
     g_nodecheck    = gi.Cvar_Get("g_nodecheck", "0", 0);
     g_scriptdebug  = gi.Cvar_Get("g_scriptdebug", "0", 0);
     g_scripttrace  = gi.Cvar_Get("g_scripttrace", "0", 0);
@@ -672,6 +687,11 @@ void CVAR_Init(void)
     sv_numbots     = gi.Cvar_Get("sv_numbots", "0", 0);
     sv_minPlayers  = gi.Cvar_Get("sv_minPlayers", "0", 0);
 
+    sv_navcache      = gi.Cvar_Get("sv_navcache", "1", 0);
+    sv_navcachebuild = gi.Cvar_Get("sv_navcachebuild", "", CVAR_TEMP);
+    sv_navthreads    = gi.Cvar_Get("sv_navthreads", "-1", CVAR_ARCHIVE);
+    sv_navBudgetMs   = gi.Cvar_Get("sv_navBudgetMs", "2", 0);
+
     g_bot_attack_burst_min_time                = gi.Cvar_Get("g_bot_attack_burst_min_time", "0.1", 0);
     g_bot_attack_burst_random_delay            = gi.Cvar_Get("g_bot_attack_burst_random_delay", "0.5", 0);
     g_bot_attack_continuousfire_min_firetime    = gi.Cvar_Get("g_bot_attack_continuousfire_min_firetime", "0.5", 0);
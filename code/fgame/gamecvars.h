@@ -102,8 +102,10 @@ extern cvar_t *sv_invulnerabletime;
 extern cvar_t *sv_team_spawn_interval;
 
 extern cvar_t *g_showmem;
+extern cvar_t *g_showframemem;
 extern cvar_t *g_timeents;
 extern cvar_t *g_timescripts;
+extern cvar_t *g_showscriptallocs;
 
 extern cvar_t *g_showaxis;
 extern cvar_t *g_showplayerstate;
@@ -133,6 +135,7 @@ extern cvar_t *g_logstats;
 extern cvar_t *g_showtokens;
 extern cvar_t *g_showopcodes;
 extern cvar_t *g_scriptcheck;
+extern cvar_t *g_scriptcache;
 extern cvar_t *g_nodecheck;
 extern cvar_t *g_scriptdebug;
 extern cvar_t *g_scripttrace;
@@ -272,6 +275,10 @@ extern cvar_t *sv_maxbots;
 extern cvar_t *sv_numbots;
 extern cvar_t *sv_minPlayers;
 extern cvar_t *sv_sharedbots;
+extern cvar_t *sv_navcache;
+extern cvar_t *sv_navcachebuild;
+extern cvar_t *sv_navthreads;
+extern cvar_t *sv_navBudgetMs;
 
 /**
  * @brief Minimum time to pause (bursting).
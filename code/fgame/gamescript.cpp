@@ -218,9 +218,9 @@ void con_set<const_str, script_label_t>::Entry::Archive(Archiver& arc)
     } else {
         arc.ArchiveUnsigned(&offset);
         value.codepos = current_progBuffer + offset;
-        value.key     = key;
     }
 
+    Director.ArchiveString(arc, value.key);
     arc.ArchiveBool(&value.isprivate);
 }
 
@@ -350,298 +350,174 @@ GameScript::~GameScript()
     Close();
 }
 
-struct pfixup_t {
-    bool          isString;
-    unsigned int *ptr;
-};
+template<>
+void con_set<const unsigned char *, sourceinfo_t>::Entry::Archive(Archiver& arc)
+{
+    unsigned int offset;
+
+    if (arc.Loading()) {
+        arc.ArchiveUnsigned(&offset);
+        key = current_progBuffer + offset;
+    } else {
+        offset = key - current_progBuffer;
+        arc.ArchiveUnsigned(&offset);
+    }
 
-static Container<const_str>  archivedEvents;
-static Container<const_str>  archivedStrings;
-static Container<pfixup_t *> archivedPointerFixup;
+    arc.ArchiveUnsigned(&value.sourcePos);
+    arc.ArchiveUnsigned(&value.startLinePos);
+    arc.ArchiveInteger(&value.column);
+    arc.ArchiveInteger(&value.line);
+}
 
-void ArchiveOpcode(Archiver& arc, unsigned char *code)
+void GameScript::Archive(Archiver& arc)
 {
-    unsigned int index;
+    unsigned int   length;
+    unsigned int   offset;
+    unsigned char *tryStart;
+    unsigned char *tryEnd;
+    StateScript   *stateScript = NULL;
+    CatchBlock    *catchBlock;
+    const_str      s;
+    int            count;
+    int            i;
 
-    arc.ArchiveByte(code);
+    if (arc.Loading()) {
+        Close();
+    }
 
-    switch (*code) {
-    case OP_STORE_NIL:
-    case OP_STORE_NULL:
-    case OP_DONE:
-        break;
+    offset = 0;
+    length = m_ProgLength;
+    arc.ArchiveUnsigned(&length);
+
+    if (arc.Loading()) {
+        m_ProgLength = length;
+        m_ProgBuffer = (unsigned char *)gi.Malloc(m_ProgLength);
+    }
 
-    case OP_EXEC_CMD_COUNT1:
-    case OP_EXEC_CMD_METHOD_COUNT1:
-    case OP_EXEC_METHOD_COUNT1:
-        arc.ArchiveByte(code + 1);
-        goto __exec;
-
-    case OP_EXEC_CMD0:
-    case OP_EXEC_CMD1:
-    case OP_EXEC_CMD2:
-    case OP_EXEC_CMD3:
-    case OP_EXEC_CMD4:
-    case OP_EXEC_CMD5:
-    case OP_EXEC_CMD_METHOD0:
-    case OP_EXEC_CMD_METHOD1:
-    case OP_EXEC_CMD_METHOD2:
-    case OP_EXEC_CMD_METHOD3:
-    case OP_EXEC_CMD_METHOD4:
-    case OP_EXEC_CMD_METHOD5:
-    case OP_EXEC_METHOD0:
-    case OP_EXEC_METHOD1:
-    case OP_EXEC_METHOD2:
-    case OP_EXEC_METHOD3:
-    case OP_EXEC_METHOD4:
-    case OP_EXEC_METHOD5:
-        code--;
-    __exec:
-        if (!arc.Loading()) {
-            index = archivedEvents.AddUniqueObject(*reinterpret_cast<const_str *>(code + 2));
+    current_progBuffer = m_ProgBuffer;
+
+    arc.ArchiveRaw(m_ProgBuffer, m_ProgLength);
+
+    if (!arc.NoErrors()) {
+        successCompile     = false;
+        current_progBuffer = NULL;
+        return;
+    }
+
+    //
+    // string indexes are only valid for the current session
+    //
+    count = m_StringPositions.NumObjects();
+    arc.ArchiveInteger(&count);
+
+    if (arc.Loading()) {
+        m_StringPositions.Resize(count);
+    }
+
+    for (i = 1; i <= count && arc.NoErrors(); i++) {
+        if (arc.Saving()) {
+            offset = m_StringPositions.ObjectAt(i);
+            Com_Memcpy(&s, m_ProgBuffer + offset, sizeof(unsigned int));
         }
 
-        arc.ArchiveUnsigned(&index);
+        arc.ArchiveUnsigned(&offset);
+        Director.ArchiveString(arc, s);
 
         if (arc.Loading()) {
-            pfixup_t *p = new pfixup_t;
-
-            p->isString = false;
-            p->ptr      = reinterpret_cast<unsigned int *>(code + 2);
+            if (offset + sizeof(unsigned int) > m_ProgLength) {
+                arc.FileError("String offset %u is out of the program", offset);
+                break;
+            }
 
-            *reinterpret_cast<unsigned int *>(code + 2) = index;
-            archivedPointerFixup.AddObject(p);
+            Com_Memcpy(m_ProgBuffer + offset, &s, sizeof(unsigned int));
+            m_StringPositions.AddObject(offset);
         }
-        break;
+    }
+
+    //
+    // switch state scripts
+    //
+    count = m_SwitchPositions.NumObjects();
+    arc.ArchiveInteger(&count);
 
-    case OP_LOAD_FIELD_VAR:
-    case OP_LOAD_GAME_VAR:
-    case OP_LOAD_GROUP_VAR:
-    case OP_LOAD_LEVEL_VAR:
-    case OP_LOAD_LOCAL_VAR:
-    case OP_LOAD_OWNER_VAR:
-    case OP_LOAD_PARM_VAR:
-    case OP_LOAD_SELF_VAR:
-    case OP_LOAD_STORE_GAME_VAR:
-    case OP_LOAD_STORE_GROUP_VAR:
-    case OP_LOAD_STORE_LEVEL_VAR:
-    case OP_LOAD_STORE_LOCAL_VAR:
-    case OP_LOAD_STORE_OWNER_VAR:
-    case OP_LOAD_STORE_PARM_VAR:
-    case OP_LOAD_STORE_SELF_VAR:
-    case OP_STORE_FIELD:
-    case OP_STORE_FIELD_REF:
-    case OP_STORE_GAME_VAR:
-    case OP_STORE_GROUP_VAR:
-    case OP_STORE_LEVEL_VAR:
-    case OP_STORE_LOCAL_VAR:
-    case OP_STORE_OWNER_VAR:
-    case OP_STORE_PARM_VAR:
-    case OP_STORE_SELF_VAR:
-    case OP_STORE_STRING:
-        if (!arc.Loading()) {
-            index = archivedStrings.AddUniqueObject(*reinterpret_cast<const_str *>(code + 1));
+    if (arc.Loading()) {
+        m_SwitchPositions.Resize(count);
+    }
+
+    for (i = 1; i <= count && arc.NoErrors(); i++) {
+        if (arc.Saving()) {
+            offset = m_SwitchPositions.ObjectAt(i);
+            Com_Memcpy(&stateScript, m_ProgBuffer + offset, sizeof(StateScript *));
         }
 
-        arc.ArchiveUnsigned(&index);
+        arc.ArchiveUnsigned(&offset);
 
         if (arc.Loading()) {
-            pfixup_t *p = new pfixup_t;
+            if (offset + sizeof(StateScript *) > m_ProgLength) {
+                arc.FileError("Switch offset %u is out of the program", offset);
+                break;
+            }
 
-            p->isString = true;
-            p->ptr      = reinterpret_cast<unsigned int *>(code + 1);
+            stateScript = CreateSwitchStateScript();
+            Com_Memcpy(m_ProgBuffer + offset, &stateScript, sizeof(StateScript *));
+            m_SwitchPositions.AddObject(offset);
+        }
+
+        stateScript->Archive(arc);
+    }
+
+    //
+    // catch blocks
+    //
+    count = m_CatchBlocks.NumObjects();
+    arc.ArchiveInteger(&count);
+
+    for (i = 1; i <= count && arc.NoErrors(); i++) {
+        if (arc.Saving()) {
+            catchBlock = m_CatchBlocks.ObjectAt(i);
+
+            offset = catchBlock->m_TryStartCodePos - m_ProgBuffer;
+            arc.ArchiveUnsigned(&offset);
+            offset = catchBlock->m_TryEndCodePos - m_ProgBuffer;
+            arc.ArchiveUnsigned(&offset);
 
-            *reinterpret_cast<unsigned int *>(code + 1) = index;
-            archivedPointerFixup.AddObject(p);
+            stateScript = &catchBlock->m_StateScript;
+        } else {
+            arc.ArchiveUnsigned(&offset);
+            tryStart = m_ProgBuffer + offset;
+            arc.ArchiveUnsigned(&offset);
+            tryEnd = m_ProgBuffer + offset;
+
+            stateScript = CreateCatchStateScript(tryStart, tryEnd);
         }
-        break;
 
-    default:
-        if (OpcodeLength(*code) > 1) {
-            arc.ArchiveRaw(code + 1, OpcodeLength(*code) - 1);
+        stateScript->Archive(arc);
+    }
+
+    m_State.Archive(arc);
+
+    //
+    // debug information
+    //
+    count = m_ProgToSource ? m_ProgToSource->size() : 0;
+    arc.ArchiveInteger(&count);
+
+    if (count) {
+        if (arc.Loading()) {
+            m_ProgToSource = new con_set<const unsigned char *, sourceinfo_t>;
         }
+
+        m_ProgToSource->Archive(arc);
     }
-}
 
-template<>
-void con_set<unsigned char *, sourceinfo_t>::Entry::Archive(Archiver& arc)
-{
-    unsigned int offset;
+    arc.ArchiveUnsigned(&requiredStackSize);
+    arc.ArchiveBool(&m_bPrecompiled);
 
     if (arc.Loading()) {
-        arc.ArchiveUnsigned(&offset);
-        key = current_progBuffer + offset;
-    } else {
-        offset = key - current_progBuffer;
-        arc.ArchiveUnsigned(&offset);
+        successCompile = arc.NoErrors() ? true : false;
     }
 
-    arc.ArchiveUnsigned(&value.sourcePos);
-    arc.ArchiveInteger(&value.column);
-    arc.ArchiveInteger(&value.line);
-}
-
-void GameScript::Archive(Archiver& arc)
-{
-    /*
-	int count = 0, i;
-	unsigned char *p, *code_pos, *code_end;
-	const_str s;
-	command_t *c, cmd;
-
-	arc.ArchiveSize( ( long * )&m_ProgLength );
-
-	if( arc.Saving() )
-	{
-		p = m_ProgBuffer;
-		current_progBuffer = m_ProgBuffer;
-
-		// archive opcodes
-		while( *p != OP_DONE )
-		{
-			ArchiveOpcode( arc, p );
-
-			p += OpcodeLength( *p );
-		}
-
-		ArchiveOpcode( arc, p );
-
-		// archive string dictionary list
-		i = archivedStrings.NumObjects();
-		arc.ArchiveInteger( &i );
-
-		for( ; i > 0; i-- )
-		{
-			Director.ArchiveString( arc, archivedStrings.ObjectAt( i ) );
-		}
-
-		// archive event list
-		i = archivedEvents.NumObjects();
-		arc.ArchiveInteger( &i );
-
-		for( ; i > 0; i-- )
-		{
-			c = Event::GetEventInfo( archivedEvents.ObjectAt( i ) );
-
-			arc.ArchiveString( &c->command );
-			arc.ArchiveInteger( &c->flags );
-			arc.ArchiveByte( &c->type );
-		}
-	}
-	else
-	{
-		m_ProgBuffer = ( unsigned char * )gi.Malloc( m_ProgLength );
-		code_pos = m_ProgBuffer;
-		code_end = m_ProgBuffer + m_ProgLength;
-
-		current_progBuffer = m_ProgBuffer;
-
-		do
-		{
-			ArchiveOpcode( arc, code_pos );
-
-			code_pos += OpcodeLength( *code_pos );
-		} while( *code_pos != OP_DONE && arc.NoErrors() );
-
-		if( !arc.NoErrors() )
-		{
-			return;
-		}
-
-		// retrieve the string dictionary list
-		arc.ArchiveInteger( &i );
-		archivedStrings.Resize( i + 1 );
-
-		for( ; i > 0; i-- )
-		{
-			Director.ArchiveString( arc, s );
-			archivedStrings.AddObjectAt( i, s );
-		}
-
-		// retrieve the event list
-		arc.ArchiveInteger( &i );
-		archivedEvents.Resize( i + 1 );
-
-		for( ; i > 0; i-- )
-		{
-			arc.ArchiveString( &cmd.command );
-			arc.ArchiveInteger( &cmd.flags );
-			arc.ArchiveByte( &cmd.type );
-
-			archivedEvents.AddObjectAt( i, Event::GetEventWithFlags( cmd.command, cmd.flags, cmd.type ) );
-		}
-
-		// fix program string/event pointers
-		for( i = archivedPointerFixup.NumObjects(); i > 0; i-- )
-		{
-			pfixup_t *fixup = archivedPointerFixup.ObjectAt( i );
-
-			if( fixup->isString )
-			{
-				*fixup->ptr = archivedStrings.ObjectAt( *fixup->ptr );
-			}
-			else
-			{
-				*fixup->ptr = archivedEvents.ObjectAt( *fixup->ptr );
-			}
-
-			delete fixup;
-		}
-
-		successCompile = true;
-	}
-
-	// cleanup
-	archivedStrings.FreeObjectList();
-	archivedEvents.FreeObjectList();
-	archivedPointerFixup.FreeObjectList();
-
-	if( !arc.Loading() )
-	{
-		if( m_ProgToSource )
-		{
-			count = m_ProgToSource->size();
-			arc.ArchiveInteger( &count );
-
-			m_ProgToSource->Archive( arc );
-		}
-		else
-		{
-			arc.ArchiveInteger( &count );
-		}
-	}
-	else
-	{
-		arc.ArchiveInteger( &count );
-
-		if( count )
-		{
-			m_ProgToSource = new con_set < unsigned char *, sourceinfo_t >;
-			m_ProgToSource->Archive( arc );
-		}
-	}
-
-	arc.ArchiveUnsigned( &requiredStackSize );
-	arc.ArchiveBool( &m_bPrecompiled );
-
-	if( !m_bPrecompiled && arc.Loading() )
-	{
-		fileHandle_t filehandle = NULL;
-
-		m_SourceLength = gi.FS_ReadFile( Filename().c_str(), ( void ** )&m_SourceBuffer, true );
-
-		if( m_SourceLength > 0 )
-		{
-			m_SourceBuffer = ( char * )gi.Malloc( m_SourceLength );
-
-			gi.FS_Read( m_SourceBuffer, m_SourceLength, filehandle );
-			gi.FS_FCloseFile( filehandle );
-		}
-	}
-
-	m_State.Archive( arc );
-
-	current_progBuffer = NULL;*/
+    current_progBuffer = NULL;
 }
 
 void GameScript::Archive(Archiver& arc, GameScript *& scr)
@@ -698,6 +574,11 @@ void GameScript::Close(void)
     }
 
     m_CatchBlocks.FreeObjectList();
+    m_StateScripts.FreeObjectList();
+    m_State.label_list.clear();
+
+    m_StringPositions.FreeObjectList();
+    m_SwitchPositions.FreeObjectList();
 
     if (m_ProgToSource) {
         delete m_ProgToSource;
@@ -719,11 +600,8 @@ void GameScript::Close(void)
     m_bPrecompiled = false;
 }
 
-void GameScript::Load(const void *sourceBuffer, size_t sourceLength)
+void GameScript::LoadSource(const void *sourceBuffer, size_t sourceLength)
 {
-    size_t nodeLength;
-    char  *m_PreprocessedBuffer;
-
     m_SourceBuffer = (char *)gi.Malloc(sourceLength + 2);
     m_SourceLength = sourceLength;
 
@@ -734,6 +612,14 @@ void GameScript::Load(const void *sourceBuffer, size_t sourceLength)
     m_SourceBuffer[sourceLength + 1] = 0;
 
     memcpy(m_SourceBuffer, sourceBuffer, sourceLength);
+}
+
+void GameScript::Load(const void *sourceBuffer, size_t sourceLength)
+{
+    size_t nodeLength;
+    char  *m_PreprocessedBuffer;
+
+    LoadSource(sourceBuffer, sourceLength);
 
     Compiler.Reset();
 
@@ -134,6 +134,10 @@ public:
     // stack variables
     unsigned int requiredStackSize;
 
+    // program offsets to relocate when the program is archived
+    Container<unsigned int> m_StringPositions;
+    Container<unsigned int> m_SwitchPositions;
+
 public:
     GameScript();
     GameScript(const char *filename);
@@ -145,6 +149,7 @@ public:
 
     void Close(void);
     void Load(const void *sourceBuffer, size_t sourceLength);
+    void LoadSource(const void *sourceBuffer, size_t sourceLength);
 
     bool GetCodePos(unsigned char *codePos, str& filename, int& pos);
     bool SetCodePos(unsigned char *& codePos, str& filename, int pos);
@@ -1005,6 +1005,8 @@ void Level::ResetEdicts(void)
     // Add all the edicts to the free list
     LL_Reset(&free_edicts, next, prev);
     LL_Reset(&active_edicts, next, prev);
+    entityGrid.Clear();
+
     for (i = 0; i < game.maxentities; i++) {
         LL_Add(&free_edicts, &g_entities[i], next, prev);
     }
@@ -1757,6 +1759,9 @@ gentity_t *Level::AllocEdict(Entity *entity)
 
     edict->entity = entity;
 
+    // queries return entities in the same order as the active list
+    entityGrid.Insert(edict->s.number, entity->centroid, edict->r.radius);
+
     return edict;
 }
 
@@ -1772,6 +1777,7 @@ void Level::FreeEdict(gentity_t *ed)
     gi.unlinkentity(ed);
 
     LL_Remove(ed, next, prev);
+    entityGrid.Remove(ed->s.number);
 
     client = ed->client;
 
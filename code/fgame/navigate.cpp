@@ -47,6 +47,7 @@ cvar_t *ai_debugpath;
 cvar_t *ai_pathchecktime;
 cvar_t *ai_pathcheckdist;
 cvar_t *ai_editmode; // Added in OPM
+cvar_t *ai_showpathstats;
 
 static const vec_t *path_start;
 static const vec_t *path_end;
@@ -64,7 +65,8 @@ static qboolean pathnodescalculated  = false;
 int             ai_maxnode;
 
 MapCell   PathSearch::PathMap[PATHMAP_GRIDSIZE][PATHMAP_GRIDSIZE];
-PathNode *PathSearch::open;
+PathNode *PathSearch::openHeap[MAX_PATHNODES];
+int       PathSearch::numOpen;
 int       PathSearch::findFrame;
 qboolean  PathSearch::m_bNodesloaded;
 qboolean  PathSearch::m_NodeCheckFailed;
@@ -114,6 +116,237 @@ struct {
 PathSearch PathManager;
 
 int path_checksthisframe;
+int path_searchesthisframe;
+int path_cachehitsthisframe;
+int path_expandedthisframe;
+
+//
+// Recent paths found by FindPath, indexed by start node, end node, fall height and team.
+// Searches bounded by a leash or a maximum path distance don't use the cache.
+// The whole cache is cleared when a pathway is connected, disconnected or marked as a bad place.
+//
+#define PATHCACHE_SIZE     32
+#define PATHCACHE_MAXNODES 128
+
+typedef struct pathcache_s {
+    int   numNodes;
+    int   fallheight;
+    int   team;
+    int   lastUsed;
+    short nodes[PATHCACHE_MAXNODES];
+    short pathways[PATHCACHE_MAXNODES];
+} pathcache_t;
+
+static pathcache_t path_cache[PATHCACHE_SIZE];
+static int         path_cacheframe;
+
+static void ClearPathCache(void)
+{
+    int i;
+
+    for (i = 0; i < PATHCACHE_SIZE; i++) {
+        path_cache[i].numNodes = 0;
+    }
+}
+
+static int PathTeam(Entity *ent)
+{
+    if (!ent || !ent->IsSubclassOfSentient()) {
+        return -1;
+    }
+
+    return static_cast<Sentient *>(ent)->m_Team;
+}
+
+static pathcache_t *FindCachedPath(PathNode *from, PathNode *to, int fallheight, int team)
+{
+    int i;
+
+    for (i = 0; i < PATHCACHE_SIZE; i++) {
+        pathcache_t *cache = &path_cache[i];
+
+        if (cache->numNodes && cache->nodes[0] == from->nodenum && cache->nodes[cache->numNodes - 1] == to->nodenum
+            && cache->fallheight == fallheight && cache->team == team) {
+            cache->lastUsed = ++path_cacheframe;
+            return cache;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+============
+LoadCachedPath
+
+Link the nodes of the cached path like FindPath does, Node is set to the end node
+============
+*/
+static bool LoadCachedPath(pathcache_t *cache, const vec3_t end)
+{
+    PathNode  *parent;
+    PathNode  *node;
+    pathway_t *pathway;
+    vec2_t     delta;
+    int        i;
+
+    parent = PathSearch::pathnodes[cache->nodes[0]];
+
+    for (i = 1; i < cache->numNodes; i++) {
+        node = PathSearch::pathnodes[cache->nodes[i]];
+        if (!node || cache->pathways[i] >= parent->numChildren) {
+            // Stale entry
+            cache->numNodes = 0;
+            return false;
+        }
+
+        pathway = &parent->Child[cache->pathways[i]];
+        if (pathway->node != cache->nodes[i]) {
+            cache->numNodes = 0;
+            return false;
+        }
+
+        VectorSub2D(end, pathway->pos2, delta);
+
+        node->m_Depth   = parent->m_Depth + 1;
+        node->Parent    = parent;
+        node->pathway   = cache->pathways[i];
+        node->g         = (float)(int)(pathway->dist + parent->g + 1.0f);
+        node->h         = VectorLength2D(delta);
+        node->f         = (float)(int)(node->g + node->h);
+        node->m_PathPos = pathway->pos2;
+
+        parent = node;
+    }
+
+    Node = parent;
+    return true;
+}
+
+/*
+============
+CachePath
+
+Store the path from the root of Node to Node, replacing the least recently used path
+============
+*/
+static void CachePath(int fallheight, int team)
+{
+    pathcache_t *cache;
+    PathNode    *node;
+    int          numNodes;
+    int          i;
+
+    numNodes = 0;
+    for (node = Node; node; node = node->Parent) {
+        numNodes++;
+    }
+
+    if (numNodes < 2 || numNodes > PATHCACHE_MAXNODES) {
+        return;
+    }
+
+    cache = &path_cache[0];
+    for (i = 1; i < PATHCACHE_SIZE && cache->numNodes; i++) {
+        if (!path_cache[i].numNodes || path_cache[i].lastUsed < cache->lastUsed) {
+            cache = &path_cache[i];
+        }
+    }
+
+    cache->numNodes   = numNodes;
+    cache->fallheight = fallheight;
+    cache->team       = team;
+    cache->lastUsed   = ++path_cacheframe;
+
+    for (node = Node, i = numNodes - 1; node; node = node->Parent, i--) {
+        cache->nodes[i]    = node->nodenum;
+        cache->pathways[i] = node->pathway;
+    }
+}
+
+/*
+============
+PathSearch::OpenRaise
+
+The open list is a binary heap sorted by f
+============
+*/
+void PathSearch::OpenRaise(int i)
+{
+    PathNode *node = openHeap[i];
+    int       parent;
+
+    for (; i > 0; i = parent) {
+        parent = (i - 1) / 2;
+        if (openHeap[parent]->f <= node->f) {
+            break;
+        }
+
+        openHeap[i]            = openHeap[parent];
+        openHeap[i]->openIndex = i;
+    }
+
+    openHeap[i]     = node;
+    node->openIndex = i;
+}
+
+void PathSearch::OpenSink(int i)
+{
+    PathNode *node = openHeap[i];
+    int       child;
+
+    for (; (child = i * 2 + 1) < numOpen; i = child) {
+        if (child + 1 < numOpen && openHeap[child + 1]->f < openHeap[child]->f) {
+            child++;
+        }
+
+        if (node->f <= openHeap[child]->f) {
+            break;
+        }
+
+        openHeap[i]            = openHeap[child];
+        openHeap[i]->openIndex = i;
+    }
+
+    openHeap[i]     = node;
+    node->openIndex = i;
+}
+
+void PathSearch::OpenPush(PathNode *node)
+{
+    openHeap[numOpen] = node;
+    OpenRaise(numOpen++);
+}
+
+PathNode *PathSearch::OpenPop(void)
+{
+    PathNode *node = openHeap[0];
+
+    numOpen--;
+    if (numOpen) {
+        openHeap[0] = openHeap[numOpen];
+        OpenSink(0);
+    }
+
+    return node;
+}
+
+void PathSearch::OpenRemove(PathNode *node)
+{
+    int i = node->openIndex;
+
+    numOpen--;
+    if (i == numOpen) {
+        return;
+    }
+
+    openHeap[i] = openHeap[numOpen];
+    if (i > 0 && openHeap[i]->f < openHeap[(i - 1) / 2]->f) {
+        OpenRaise(i);
+    } else {
+        OpenSink(i);
+    }
+}
 
 PathInfo *PathSearch::GeneratePath(PathInfo *path)
 {
@@ -311,15 +544,16 @@ int PathSearch::FindPath(
     int          fallheight
 )
 {
-    int        i;
-    int        g;
-    PathNode  *NewNode;
-    pathway_t *pathway;
-    PathNode  *prev;
-    PathNode  *next;
-    int        f;
-    vec2_t     delta;
-    PathNode  *to;
+    int          i;
+    int          g;
+    PathNode    *NewNode;
+    pathway_t   *pathway;
+    int          f;
+    vec2_t       delta;
+    PathNode    *to;
+    int          team;
+    pathcache_t *cache;
+    bool         useCache;
 
     if (ent) {
         // Added in OPM
@@ -346,12 +580,17 @@ int PathSearch::FindPath(
 
     total_dist = 1e+12f;
 
+    // a bounded search must fail as soon as any expanded node exceeds the bound,
+    // which a cached path can't tell
+    useCache = !vLeashHome && !maxPath;
+
     if (!maxPath) {
         maxPath = 1e+12f;
     }
 
     findFrame++;
-    open = NULL;
+    numOpen = 0;
+    path_searchesthisframe++;
 
     VectorSub2D(Node->origin, start, path_startdir);
     Node->g = VectorNormalize2D(path_startdir);
@@ -363,22 +602,34 @@ int PathSearch::FindPath(
     Node->m_Depth   = 3;
     Node->findCount = findFrame;
     Node->inopen    = true;
-    Node->PrevNode  = NULL;
-    Node->NextNode  = NULL;
     Node->m_PathPos = start;
 
-    open = Node;
+    team = PathTeam(ent);
+
+    if (useCache) {
+        cache = FindCachedPath(Node, to, fallheight, team);
 
-    while (open) {
-        Node         = open;
-        open->inopen = false;
-        open         = Node->NextNode;
+        if (cache && LoadCachedPath(cache, end)) {
+            path_cachehitsthisframe++;
 
-        if (open) {
-            open->PrevNode = NULL;
+            path_start = start;
+            path_end   = end;
+            return Node->m_Depth;
         }
+    }
+
+    OpenPush(Node);
+
+    while (numOpen) {
+        Node         = OpenPop();
+        Node->inopen = false;
+        path_expandedthisframe++;
 
         if (Node == to) {
+            if (useCache) {
+                CachePath(fallheight, team);
+            }
+
             path_start = start;
             path_end   = end;
             return Node->m_Depth;
@@ -410,18 +661,7 @@ int PathSearch::FindPath(
 
                 if (NewNode->inopen) {
                     NewNode->inopen = false;
-                    next            = NewNode->NextNode;
-                    prev            = NewNode->PrevNode;
-
-                    if (next) {
-                        next->PrevNode = prev;
-                    }
-
-                    if (prev) {
-                        prev->NextNode = next;
-                    } else {
-                        open = next;
-                    }
+                    OpenRemove(NewNode);
                 }
             }
 
@@ -447,36 +687,7 @@ int PathSearch::FindPath(
                 NewNode->findCount = findFrame;
                 NewNode->inopen    = true;
 
-                if (!open) {
-                    NewNode->NextNode = NULL;
-                    NewNode->PrevNode = NULL;
-                    open              = NewNode;
-                    continue;
-                }
-
-                if (open->f >= f) {
-                    NewNode->NextNode = open;
-                    NewNode->PrevNode = NULL;
-
-                    open->PrevNode = NewNode;
-                    open           = NewNode;
-                    continue;
-                }
-
-                prev = open;
-                for (next = open->NextNode; next; next = next->NextNode) {
-                    if (next->f >= f) {
-                        break;
-                    }
-                    prev = next;
-                }
-
-                NewNode->NextNode = next;
-                if (next) {
-                    next->PrevNode = NewNode;
-                }
-                prev->NextNode    = NewNode;
-                NewNode->PrevNode = prev;
+                OpenPush(NewNode);
             }
         }
     }
@@ -500,8 +711,6 @@ int PathSearch::FindPathNear(
     int        g;
     PathNode  *NewNode;
     pathway_t *pathway;
-    PathNode  *prev;
-    PathNode  *next;
     int        f;
     vec2_t     dir;
     vec2_t     delta;
@@ -530,7 +739,8 @@ int PathSearch::FindPathNear(
     }
 
     findFrame++;
-    open = NULL;
+    numOpen = 0;
+    path_searchesthisframe++;
 
     VectorSub2D(Node->origin, start, path_startdir);
     VectorSub2D(end, start, delta);
@@ -542,20 +752,14 @@ int PathSearch::FindPathNear(
     Node->Parent    = NULL;
     Node->m_Depth   = 3;
     Node->findCount = findFrame;
-    Node->PrevNode  = NULL;
-    Node->NextNode  = NULL;
     Node->m_PathPos = start;
 
-    open = Node;
-
-    while (open) {
-        Node         = open;
-        open->inopen = false;
-        open         = Node->NextNode;
+    OpenPush(Node);
 
-        if (open) {
-            open->PrevNode = NULL;
-        }
+    while (numOpen) {
+        Node         = OpenPop();
+        Node->inopen = false;
+        path_expandedthisframe++;
 
         VectorSub2D(end, Node->m_PathPos, delta);
 
@@ -582,18 +786,7 @@ int PathSearch::FindPathNear(
 
                 if (NewNode->inopen) {
                     NewNode->inopen = false;
-                    next            = NewNode->NextNode;
-                    prev            = NewNode->PrevNode;
-
-                    if (next) {
-                        next->PrevNode = prev;
-                    }
-
-                    if (prev) {
-                        prev->NextNode = next;
-                    } else {
-                        open = next;
-                    }
+                    OpenRemove(NewNode);
                 }
             }
 
@@ -619,36 +812,7 @@ int PathSearch::FindPathNear(
                 NewNode->findCount = findFrame;
                 NewNode->inopen    = true;
 
-                if (!open) {
-                    NewNode->NextNode = NULL;
-                    NewNode->PrevNode = NULL;
-                    open              = NewNode;
-                    continue;
-                }
-
-                if (open->f >= f) {
-                    NewNode->NextNode = open;
-                    NewNode->PrevNode = NULL;
-
-                    open->PrevNode = NewNode;
-                    open           = NewNode;
-                    continue;
-                }
-
-                prev = open;
-                for (next = open->NextNode; next; next = next->NextNode) {
-                    if (next->f >= f) {
-                        break;
-                    }
-                    prev = next;
-                }
-
-                NewNode->NextNode = next;
-                if (next) {
-                    next->PrevNode = NewNode;
-                }
-                prev->NextNode    = NewNode;
-                NewNode->PrevNode = prev;
+                OpenPush(NewNode);
             }
         }
     }
@@ -672,8 +836,6 @@ int PathSearch::FindPathAway(
     int        g;
     PathNode  *NewNode;
     pathway_t *pathway;
-    PathNode  *prev;
-    PathNode  *next;
     int        f;
     float      fBias;
     vec2_t     delta;
@@ -699,7 +861,8 @@ int PathSearch::FindPathAway(
     }
 
     findFrame++;
-    open = NULL;
+    numOpen = 0;
+    path_searchesthisframe++;
 
     VectorSub2D(Node->origin, start, path_startdir);
     VectorSub2D(start, avoid, delta);
@@ -713,20 +876,14 @@ int PathSearch::FindPathAway(
     Node->Parent    = NULL;
     Node->m_Depth   = 2;
     Node->findCount = findFrame;
-    Node->PrevNode  = NULL;
-    Node->NextNode  = NULL;
     Node->m_PathPos = start;
 
-    open = Node;
-
-    while (open) {
-        Node         = open;
-        open->inopen = false;
-        open         = Node->NextNode;
+    OpenPush(Node);
 
-        if (open) {
-            open->PrevNode = NULL;
-        }
+    while (numOpen) {
+        Node         = OpenPop();
+        Node->inopen = false;
+        path_expandedthisframe++;
 
         VectorSub2D(Node->m_PathPos, avoid, delta);
 
@@ -761,18 +918,7 @@ int PathSearch::FindPathAway(
 
                 if (NewNode->inopen) {
                     NewNode->inopen = false;
-                    next            = NewNode->NextNode;
-                    prev            = NewNode->PrevNode;
-
-                    if (next) {
-                        next->PrevNode = prev;
-                    }
-
-                    if (prev) {
-                        prev->NextNode = next;
-                    } else {
-                        open = next;
-                    }
+                    OpenRemove(NewNode);
                 }
             }
 
@@ -792,36 +938,7 @@ int PathSearch::FindPathAway(
                 NewNode->findCount = findFrame;
                 NewNode->inopen    = true;
 
-                if (!open) {
-                    NewNode->NextNode = NULL;
-                    NewNode->PrevNode = NULL;
-                    open              = NewNode;
-                    continue;
-                }
-
-                if (open->f >= f) {
-                    NewNode->NextNode = open;
-                    NewNode->PrevNode = NULL;
-
-                    open->PrevNode = NewNode;
-                    open           = NewNode;
-                    continue;
-                }
-
-                prev = open;
-                for (next = open->NextNode; next; next = next->NextNode) {
-                    if (next->f >= f) {
-                        break;
-                    }
-                    prev = next;
-                }
-
-                NewNode->NextNode = next;
-                if (next) {
-                    next->PrevNode = NewNode;
-                }
-                prev->NextNode    = NewNode;
-                NewNode->PrevNode = prev;
+                OpenPush(NewNode);
             }
         }
     }
@@ -837,7 +954,6 @@ PathNode *PathSearch::FindCornerNodeForWall(
     int        i, g;
     PathNode  *NewNode;
     pathway_t *pathway;
-    PathNode  *prev, *next;
     int        f;
     vec2_t     delta;
     vec2_t     dir;
@@ -876,7 +992,8 @@ PathNode *PathSearch::FindCornerNodeForWall(
     }
 
     findFrame++;
-    open = NULL;
+    numOpen = 0;
+    path_searchesthisframe++;
 
     VectorSub2D(Node->origin, start, path_startdir);
     Node->g = VectorNormalize2D(path_startdir);
@@ -887,20 +1004,14 @@ PathNode *PathSearch::FindCornerNodeForWall(
     Node->Parent    = NULL;
     Node->m_Depth   = 3;
     Node->findCount = findFrame;
-    Node->PrevNode  = 0;
-    Node->NextNode  = 0;
     Node->m_PathPos = start;
 
-    open = Node;
-
-    while (open) {
-        Node         = open;
-        open->inopen = false;
-        open         = Node->NextNode;
+    OpenPush(Node);
 
-        if (open) {
-            open->PrevNode = NULL;
-        }
+    while (numOpen) {
+        Node         = OpenPop();
+        Node->inopen = false;
+        path_expandedthisframe++;
 
         if (Node->Parent && DotProduct(Node->m_PathPos, plane) - plane[3] < 0) {
             VectorSub2D(Node->m_PathPos, start, delta);
@@ -928,18 +1039,7 @@ PathNode *PathSearch::FindCornerNodeForWall(
 
                 if (NewNode->inopen) {
                     NewNode->inopen = false;
-                    next            = NewNode->NextNode;
-                    prev            = NewNode->PrevNode;
-
-                    if (next) {
-                        next->PrevNode = prev;
-                    }
-
-                    if (prev) {
-                        prev->NextNode = next;
-                    } else {
-                        open = next;
-                    }
+                    OpenRemove(NewNode);
                 }
             }
 
@@ -962,36 +1062,7 @@ PathNode *PathSearch::FindCornerNodeForWall(
             NewNode->findCount = findFrame;
             NewNode->inopen    = true;
 
-            if (!open) {
-                NewNode->NextNode = NULL;
-                NewNode->PrevNode = NULL;
-                open              = NewNode;
-                continue;
-            }
-
-            if (open->f >= f) {
-                NewNode->NextNode = open;
-                NewNode->PrevNode = NULL;
-
-                open->PrevNode = NewNode;
-                open           = NewNode;
-                continue;
-            }
-
-            prev = open;
-            for (next = open->NextNode; next; next = next->NextNode) {
-                if (next->f >= f) {
-                    break;
-                }
-                prev = next;
-            }
-
-            NewNode->NextNode = next;
-            if (next) {
-                next->PrevNode = NewNode;
-            }
-            prev->NextNode    = NewNode;
-            NewNode->PrevNode = prev;
+            OpenPush(NewNode);
         }
     }
 
@@ -1069,6 +1140,8 @@ void PathSearch::ResetNodes(void)
     m_bNodesloaded = false;
     m_LoadIndex    = -1;
 
+    ClearPathCache();
+
     if (!startBulkNavMemory && nodecount) {
         for (x = 0; x < PATHMAP_GRIDSIZE; x++) {
             for (y = 0; y < PATHMAP_GRIDSIZE; y++) {
@@ -1117,6 +1190,8 @@ void PathSearch::ClearNodes(void)
     m_bNodesloaded = false;
     m_LoadIndex    = -1;
 
+    ClearPathCache();
+
     if (!startBulkNavMemory && nodecount) {
         for (x = 0; x < PATHMAP_GRIDSIZE; x++) {
             for (y = 0; y < PATHMAP_GRIDSIZE; y++) {
@@ -1185,6 +1260,9 @@ void PathSearch::UpdatePathwaysForBadPlace(const Vector& origin, float radius, i
 
     radiusSqr = radius * radius;
 
+    // The pathways are used by the team again, or not anymore
+    ClearPathCache();
+
     for (i = 0; i < nodecount; i++) {
         PathNode *node = pathnodes[i];
         if (!node) {
@@ -1382,6 +1460,8 @@ void PathNode::ConnectChild(int i)
 
     Child[numChildren] = child;
     numChildren++;
+
+    ClearPathCache();
 }
 
 void PathNode::DisconnectChild(int i)
@@ -1395,6 +1475,8 @@ void PathNode::DisconnectChild(int i)
 
     numChildren--;
     Child[numChildren] = child;
+
+    ClearPathCache();
 }
 
 qboolean PathNode::IsTouching(Entity *e1)
@@ -1810,7 +1892,7 @@ CLASS_DECLARATION(Class, PathSearch, NULL) {
 PathSearch::PathSearch()
 {
     memset(pathnodes, 0, sizeof(pathnodes));
-    open      = 0;
+    numOpen   = 0;
     findFrame = 0;
 }
 
@@ -2292,7 +2374,8 @@ void PathSearch::Init(void)
     //
     // Added in OPM
     //
-    ai_editmode = gi.Cvar_Get("ai_editmode", "0", CVAR_LATCH);
+    ai_editmode      = gi.Cvar_Get("ai_editmode", "0", CVAR_LATCH);
+    ai_showpathstats = gi.Cvar_Get("ai_showpathstats", "0", 0);
 
     navMaster.Init();
 }
@@ -3041,6 +3124,8 @@ void PathSearch::Connect(PathNode *node)
     findFrame++;
     node->findCount = findFrame;
 
+    ClearPathCache();
+
     x = GridCoordinate(node->origin[0]);
     y = GridCoordinate(node->origin[1]);
 
@@ -54,12 +54,16 @@ extern cvar_t *ai_fallheight;
 extern cvar_t *ai_debugpath;
 extern cvar_t *ai_pathchecktime;
 extern cvar_t *ai_pathcheckdist;
+extern cvar_t *ai_showpathstats;
 
 extern int ai_maxnode;
 
 #define MAX_PATHCHECKSPERFRAME 4
 
 extern int path_checksthisframe;
+extern int path_searchesthisframe;
+extern int path_cachehitsthisframe;
+extern int path_expandedthisframe;
 
 #define MAX_PATH_LENGTH  128 // should be more than plenty
 #define NUM_PATHSPERNODE 48
@@ -161,8 +165,7 @@ public:
     float           g;
     class PathNode *Parent;
     bool            inopen;
-    PathNode       *PrevNode;
-    PathNode       *NextNode;
+    int             openIndex;
     short int       pathway;
     const vec_t    *m_PathPos;
     float           dist;
@@ -245,7 +248,8 @@ class PathSearch : public Listener
 
 private:
     static MapCell   PathMap[PATHMAP_GRIDSIZE][PATHMAP_GRIDSIZE];
-    static PathNode *open;
+    static PathNode *openHeap[MAX_PATHNODES];
+    static int       numOpen;
     static int       findFrame;
     static qboolean  m_bNodesloaded;
     static qboolean  m_NodeCheckFailed;
@@ -268,6 +272,12 @@ private:
     static void     ArchiveLoadNodes(void);
     static void     Init(void);
 
+    static void      OpenRaise(int i);
+    static void      OpenSink(int i);
+    static void      OpenPush(PathNode *node);
+    static PathNode *OpenPop(void);
+    static void      OpenRemove(PathNode *node);
+
 public:
     CLASS_PROTOTYPE(PathSearch);
 
@@ -0,0 +1,383 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+/**
+ * @file navigation_recast_cache.cpp
+ * @brief Disk cache of the built navigation meshes.
+ *
+ * The Detour tiles are saved in the home path once built,
+ * and loaded back as long as the BSP and the build configuration are the same.
+ */
+
+#include "g_local.h"
+#include "navigation_recast_load.h"
+#include "navigation_recast_config.h"
+
+#include "DetourAlloc.h"
+#include "DetourNavMesh.h"
+
+static const int NAVCACHE_IDENT = ('C' << 24) + ('V' << 16) + ('A' << 8) + 'N';
+// Increase when the way the navigation mesh is built changes
+static const int NAVCACHE_VERSION = 3;
+
+typedef struct {
+    int             ident;
+    int             version;
+    unsigned int    bspChecksum;
+    unsigned int    configChecksum;
+    dtNavMeshParams params;
+    int             numTiles;
+} navCacheHeader_t;
+
+typedef struct {
+    dtTileRef tileRef;
+    int       dataSize;
+} navCacheTile_t;
+
+static unsigned int NavCacheChecksum(unsigned int hash, const void *data, size_t size)
+{
+    const byte *p = (const byte *)data;
+    size_t      i;
+
+    // FNV-1a
+    for (i = 0; i < size; i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/*
+============
+GetConfigChecksum
+
+Returns the checksum of the parameters the navigation mesh is built with
+============
+*/
+static unsigned int GetConfigChecksum()
+{
+    const float config[] = {
+        NavigationMapConfiguration::recastCellSize,
+        NavigationMapConfiguration::recastCellHeight,
+        NavigationMapConfiguration::agentHeight,
+        NavigationMapConfiguration::agentMaxClimb,
+        NavigationMapConfiguration::agentMaxSlope,
+        NavigationMapConfiguration::agentRadius,
+        (float)NavigationMapConfiguration::regionMinSize,
+        (float)NavigationMapConfiguration::regionMergeSize,
+        NavigationMapConfiguration::edgeMaxLen,
+        NavigationMapConfiguration::edgeMaxError,
+        (float)NavigationMapConfiguration::vertsPerPoly,
+        NavigationMapConfiguration::detailSampleDist,
+        NavigationMapConfiguration::detailSampleMaxError,
+        (float)NavigationMapConfiguration::tileSize,
+        (float)DT_NAVMESH_VERSION,
+        (float)sizeof(dtTileRef)
+    };
+
+    return NavCacheChecksum(2166136261u, config, sizeof(config));
+}
+
+/*
+============
+NavigationMap::GetBSPChecksum
+============
+*/
+unsigned int NavigationMap::GetBSPChecksum(const char *mapname)
+{
+    void        *buffer;
+    long         length;
+    unsigned int checksum;
+
+    length = gi.FS_ReadFile(mapname, &buffer, qtrue);
+    if (length <= 0) {
+        return 0;
+    }
+
+    checksum = NavCacheChecksum(2166136261u, buffer, length);
+    gi.FS_FreeFile(buffer);
+
+    return checksum;
+}
+
+/*
+============
+NavigationMap::GetCachePath
+============
+*/
+str NavigationMap::GetCachePath(const char *mapname)
+{
+    char name[MAX_QPATH];
+
+    // maps/dm/mohdm1.bsp -> navcache/dm/mohdm1.nav
+    if (!Q_stricmpn(mapname, "maps/", 5)) {
+        mapname += 5;
+    }
+
+    COM_StripExtension(mapname, name, sizeof(name));
+
+    return str("navcache/") + name + ".nav";
+}
+
+/*
+============
+NavigationMap::LoadCache
+============
+*/
+bool NavigationMap::LoadCache(RecastBuildContext& buildContext, const char *mapname, unsigned int bspChecksum)
+{
+    str              path;
+    byte            *buffer;
+    long             length;
+    size_t           ofs;
+    navCacheHeader_t header;
+    navCacheTile_t   tile;
+    unsigned char   *data;
+    dtStatus         status;
+    int              i;
+
+    path   = GetCachePath(mapname);
+    length = gi.FS_ReadFile(path.c_str(), (void **)&buffer, qtrue);
+    if (length < (long)sizeof(header)) {
+        if (length >= 0) {
+            gi.FS_FreeFile(buffer);
+        }
+        return false;
+    }
+
+    memcpy(&header, buffer, sizeof(header));
+
+    if (header.ident != NAVCACHE_IDENT || header.version != NAVCACHE_VERSION || header.bspChecksum != bspChecksum
+        || header.configChecksum != GetConfigChecksum()) {
+        gi.Printf("Navigation cache %s is out of date\n", path.c_str());
+        gi.FS_FreeFile(buffer);
+        return false;
+    }
+
+    InitializeExtensions();
+    InitializeNavMesh(buildContext, header.params);
+    InitializeFilter();
+
+    ofs = sizeof(header);
+
+    for (i = 0; i < header.numTiles; i++) {
+        if (ofs + sizeof(tile) > (size_t)length) {
+            break;
+        }
+
+        memcpy(&tile, buffer + ofs, sizeof(tile));
+        ofs += sizeof(tile);
+
+        if (tile.dataSize <= 0 || ofs + tile.dataSize > (size_t)length) {
+            break;
+        }
+
+        data = (unsigned char *)dtAlloc(tile.dataSize, DT_ALLOC_PERM);
+        memcpy(data, buffer + ofs, tile.dataSize);
+        ofs += tile.dataSize;
+
+        status = navMeshDt->addTile(data, tile.dataSize, DT_TILE_FREE_DATA, tile.tileRef, NULL);
+        if (dtStatusFailed(status)) {
+            dtFree(data);
+            break;
+        }
+    }
+
+    gi.FS_FreeFile(buffer);
+
+    if (i < header.numTiles) {
+        gi.Printf("Navigation cache %s is corrupted\n", path.c_str());
+        ClearNavigation();
+        return false;
+    }
+
+    return true;
+}
+
+/*
+============
+NavigationMap::SaveCache
+============
+*/
+void NavigationMap::SaveCache(const char *mapname, unsigned int bspChecksum) const
+{
+    const dtNavMesh  *navMesh = navMeshDt;
+    str               path;
+    navCacheHeader_t  header;
+    navCacheTile_t    tileHeader;
+    const dtMeshTile *tile;
+    byte             *buffer;
+    size_t            size;
+    size_t            ofs;
+    int               i;
+
+    if (!navMesh) {
+        return;
+    }
+
+    header.ident          = NAVCACHE_IDENT;
+    header.version        = NAVCACHE_VERSION;
+    header.bspChecksum    = bspChecksum;
+    header.configChecksum = GetConfigChecksum();
+    header.params         = *navMesh->getParams();
+    header.numTiles       = 0;
+
+    size = sizeof(header);
+    for (i = 0; i < navMesh->getMaxTiles(); i++) {
+        tile = navMesh->getTile(i);
+        if (!tile || !tile->header || !tile->dataSize) {
+            continue;
+        }
+
+        header.numTiles++;
+        size += sizeof(tileHeader) + tile->dataSize;
+    }
+
+    buffer = new byte[size];
+    memcpy(buffer, &header, sizeof(header));
+    ofs = sizeof(header);
+
+    for (i = 0; i < navMesh->getMaxTiles(); i++) {
+        tile = navMesh->getTile(i);
+        if (!tile || !tile->header || !tile->dataSize) {
+            continue;
+        }
+
+        tileHeader.tileRef  = navMesh->getTileRef(tile);
+        tileHeader.dataSize = tile->dataSize;
+
+        memcpy(buffer + ofs, &tileHeader, sizeof(tileHeader));
+        ofs += sizeof(tileHeader);
+        memcpy(buffer + ofs, tile->data, tile->dataSize);
+        ofs += tile->dataSize;
+    }
+
+    path = GetCachePath(mapname);
+    if (gi.FS_WriteFile(path.c_str(), buffer, size) == (int)size) {
+        gi.Printf("Navigation cache written to %s\n", path.c_str());
+    } else {
+        gi.Printf("Couldn't write the navigation cache %s\n", path.c_str());
+    }
+
+    delete[] buffer;
+}
+
+/*
+============
+NavigationMap::StartCacheBuild
+
+Load the first map of the list that exists, the remaining maps are kept in sv_navcachebuild
+============
+*/
+void NavigationMap::StartCacheBuild(char *maps)
+{
+    char       *p;
+    char       *start;
+    const char *mapname;
+
+    p = maps;
+
+    while (p) {
+        start   = p;
+        mapname = COM_Parse(&p);
+        if (!mapname[0]) {
+            break;
+        }
+
+        if (gi.FS_ReadFile(va("maps/%s.bsp", mapname), NULL, qtrue) == -1) {
+            gi.Printf("Skipping %s, the map doesn't exist\n", mapname);
+            continue;
+        }
+
+        gi.cvar_set("sv_navcachebuild", start);
+        gi.SendConsoleCommand(va("map \"%s\"\n", mapname));
+        return;
+    }
+
+    gi.cvar_set("sv_navcachebuild", "");
+    gi.Printf("Finished building the navigation caches\n");
+}
+
+/*
+============
+NavigationMap::BuildCaches
+============
+*/
+void NavigationMap::BuildCaches(const char *maps)
+{
+    char        buffer[MAX_STRING_CHARS];
+    char       *p;
+    const char *first;
+
+    Q_strncpyz(buffer, maps, sizeof(buffer));
+    p     = buffer;
+    first = COM_Parse(&p);
+
+    if (!first[0]) {
+        gi.Printf("No map to build the navigation cache for\n");
+        return;
+    }
+
+    StartCacheBuild(buffer);
+}
+
+/*
+============
+NavigationMap::IsBuildingCache
+
+Returns true if the map is the current one of the maps passed to BuildCaches
+============
+*/
+bool NavigationMap::IsBuildingCache(const char *mapname) const
+{
+    char        buffer[MAX_STRING_CHARS];
+    char       *p;
+    const char *first;
+
+    if (!sv_navcachebuild->string[0]) {
+        return false;
+    }
+
+    Q_strncpyz(buffer, sv_navcachebuild->string, sizeof(buffer));
+    p     = buffer;
+    first = COM_Parse(&p);
+
+    return first[0] && !Q_stricmp(mapname, va("maps/%s.bsp", first));
+}
+
+/*
+============
+NavigationMap::BuildNextCache
+============
+*/
+void NavigationMap::BuildNextCache()
+{
+    char  buffer[MAX_STRING_CHARS];
+    char *p;
+
+    Q_strncpyz(buffer, sv_navcachebuild->string, sizeof(buffer));
+    p = buffer;
+    // skip the map that was just built
+    COM_Parse(&p);
+
+    StartCacheBuild(p);
+}
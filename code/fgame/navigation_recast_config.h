@@ -47,6 +47,9 @@ namespace NavigationMapConfiguration
     static const int   vertsPerPoly         = 6;
     static const float detailSampleDist     = 12.0;
     static const float detailSampleMaxError = 1.3f;
+
+    // Width of the navigation tiles, in cells
+    static const int tileSize = 128;
 } // namespace NavigationMapConfiguration
 
 // Polyflags
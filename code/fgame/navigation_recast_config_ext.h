@@ -36,6 +36,9 @@ namespace NavigationMapExtensionConfiguration
     static const float smallFallHeight = 100;
     static const float mediumFallHeight = 250;
     static const float maxFallHeight = 600;
+
+    // Maximum horizontal distance between the two ends of a jump or fall connection
+    static const float maxConnectionDist = 256;
 }
 
 // Areas
@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "navigation_recast_obstacle.h"
 #include "navigation_recast_path.h"
 #include "navigation_recast_config.h"
+#include "navigation_recast_config_ext.h"
 #include "navigation_recast_helpers.h"
 #include "navigation_recast_debug.h"
 #include "../script/scriptexception.h"
@@ -45,29 +46,406 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DetourNavMeshBuilder.h"
 #include "DetourNavMeshQuery.h"
 #include "DetourNode.h"
+#include "DetourCommon.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <thread>
 
 NavigationMap navigationMap;
 
 /// Recast build context.
 class RecastBuildContext : public rcContext
 {
+public:
+    RecastBuildContext(bool inBuffered = false)
+        : buffered(inBuffered)
+    {}
+
+    /// Print the messages that were kept while building on a worker thread.
+    void FlushLog()
+    {
+        if (messages.length()) {
+            gi.DPrintf("%s", messages.c_str());
+            messages = "";
+        }
+    }
+
 protected:
     virtual void doResetLog() override {}
 
     virtual void doLog(const rcLogCategory category, const char *msg, const int len) override
     {
+        if (buffered) {
+            // Can't print from a worker thread
+            messages += "Recast (category ";
+            messages += (int)category;
+            messages += "): ";
+            messages += msg;
+            messages += "\n";
+            return;
+        }
+
         gi.DPrintf("Recast (category %d): %s\n", (int)category, msg);
     }
+
+private:
+    str  messages;
+    bool buffered;
+};
+
+/// Triangles of the world and of the baked brush entities, in Recast coordinates.
+struct navGeometry_t {
+    float *verts;
+    int   *indexes;
+    int    numVertices;
+    int    numIndexes;
+    float  bmin[3];
+    float  bmax[3];
+
+    // Size of the tile grid covering the geometry
+    int numTilesX;
+    int numTilesY;
+
+    // Triangles overlapping each tile and its border,
+    // from tileTris[tileFirstTri[tile]] to tileTris[tileFirstTri[tile + 1]]
+    int *tileFirstTri;
+    int *tileTris;
+
+    // Triangles of the brush entities that are not baked anymore
+    bool *removedTris;
+
+    navGeometry_t()
+        : verts(NULL)
+        , indexes(NULL)
+        , numVertices(0)
+        , numIndexes(0)
+        , numTilesX(0)
+        , numTilesY(0)
+        , tileFirstTri(NULL)
+        , tileTris(NULL)
+        , removedTris(NULL)
+    {}
+
+    ~navGeometry_t()
+    {
+        delete[] verts;
+        delete[] indexes;
+        delete[] tileFirstTri;
+        delete[] tileTris;
+        delete[] removedTris;
+    }
+};
+
+/// A tile being built, at its location in the tile grid of the navigation mesh.
+struct navTile_t {
+    int   x, y;
+    float bmin[3];
+    float bmax[3];
+
+    // Triangles overlapping the tile and its border
+    int *tris;
+    int  numTris;
+
+    RecastBuildContext                buildContext;
+    rcPolyMesh                       *polyMesh;
+    rcPolyMeshDetail                 *polyMeshDetail;
+    Container<offMeshNavigationPoint> points;
+    unsigned char                    *navData;
+    int                               navDataSize;
+
+    navTile_t()
+        : tris(NULL)
+        , numTris(0)
+        , buildContext(true)
+        , polyMesh(NULL)
+        , polyMeshDetail(NULL)
+        , navData(NULL)
+        , navDataSize(0)
+    {}
+
+    ~navTile_t()
+    {
+        delete[] tris;
+        rcFreePolyMeshDetail(polyMeshDetail);
+        rcFreePolyMesh(polyMesh);
+        dtFree(navData);
+    }
+};
+
+/// Tiles built by the worker threads.
+struct navTileBuild_t {
+    const navGeometry_t *geometry;
+    navTile_t           *tiles;
 };
 
+/// Walkable vertex of a tile, with its position in cells from the origin of the navigation mesh.
+struct navTileVertex_t {
+    int                     cell[3];
+    offMeshNavigationVertex vertex;
+};
+
+static int GetTileBorderSize()
+{
+    const int walkableRadius =
+        (int)ceilf(NavigationMapConfiguration::agentRadius / NavigationMapConfiguration::recastCellSize);
+
+    // Same as the Recast samples, the erosion must match on both sides of the tile edges
+    return walkableRadius + 3;
+}
+
+static int GetNumBuildThreads()
+{
+    if (sv_navthreads->integer >= 0) {
+        return sv_navthreads->integer;
+    }
+
+    // The calling thread builds tiles too
+    return std::max((int)std::thread::hardware_concurrency() - 1, 0);
+}
+
+/*
+============
+CompareTileVertices
+============
+*/
+static int CompareTileVertices(const void *elem1, const void *elem2)
+{
+    const navTileVertex_t *vert1 = (const navTileVertex_t *)elem1;
+    const navTileVertex_t *vert2 = (const navTileVertex_t *)elem2;
+    int                    i;
+
+    for (i = 0; i < 3; i++) {
+        if (vert1->cell[i] != vert2->cell[i]) {
+            return vert1->cell[i] < vert2->cell[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+============
+AddPolyMeshVertices
+
+Add the vertices of the walkable polygons of a tile being built
+============
+*/
+static void AddPolyMeshVertices(Container<navTileVertex_t>& vertices, const navTile_t& tile, int regionBase)
+{
+    const rcPolyMesh *polyMesh = tile.polyMesh;
+    navTileVertex_t   vert;
+    int               i, j;
+
+    for (i = 0; i < polyMesh->npolys; i++) {
+        const unsigned short *poly = &polyMesh->polys[i * polyMesh->nvp * 2];
+
+        if (polyMesh->areas[i] != RC_WALKABLE_AREA) {
+            continue;
+        }
+
+        for (j = 0; j < polyMesh->nvp; j++) {
+            if (poly[j] == RC_MESH_NULL_IDX) {
+                break;
+            }
+
+            assert(poly[j] < polyMesh->nverts);
+
+            const unsigned short *v = &polyMesh->verts[poly[j] * 3];
+
+            vert.cell[0] = tile.x * NavigationMapConfiguration::tileSize + v[0];
+            vert.cell[1] = v[1];
+            vert.cell[2] = tile.y * NavigationMapConfiguration::tileSize + v[2];
+
+            GetPolyMeshVertPosition(polyMesh, poly[j], vert.vertex.pos);
+            vert.vertex.region   = regionBase + polyMesh->regs[i];
+            vert.vertex.building = true;
+
+            vertices.AddObject(vert);
+        }
+    }
+}
+
+/*
+============
+AddNavMeshTileVertices
+
+Add the vertices of the walkable polygons of a tile already in the navigation mesh,
+that are within the specified Recast bounds
+============
+*/
+static void AddNavMeshTileVertices(
+    Container<navTileVertex_t>& vertices,
+    const dtNavMesh            *navMesh,
+    const dtMeshTile           *tile,
+    int                         region,
+    const float                *bmin,
+    const float                *bmax
+)
+{
+    const dtNavMeshParams *params = navMesh->getParams();
+    navTileVertex_t        vert;
+    float                  pos[3];
+    int                    i, j;
+
+    for (i = 0; i < tile->header->polyCount; i++) {
+        const dtPoly *poly = &tile->polys[i];
+
+        if (poly->getType() != DT_POLYTYPE_GROUND || poly->getArea() != RC_WALKABLE_AREA) {
+            continue;
+        }
+
+        for (j = 0; j < poly->vertCount; j++) {
+            const float *v = &tile->verts[poly->verts[j] * 3];
+
+            if (v[0] < bmin[0] || v[0] > bmax[0] || v[2] < bmin[2] || v[2] > bmax[2]) {
+                continue;
+            }
+
+            // Detour has the same vertices as the poly mesh the tile was built from
+            vert.cell[0] = (int)floorf((v[0] - params->orig[0]) / NavigationMapConfiguration::recastCellSize + 0.5f);
+            vert.cell[1] =
+                (int)floorf((v[1] - tile->header->bmin[1]) / NavigationMapConfiguration::recastCellHeight + 0.5f);
+            vert.cell[2] = (int)floorf((v[2] - params->orig[2]) / NavigationMapConfiguration::recastCellSize + 0.5f);
+
+            // Same height as GetPolyMeshVertPosition
+            rcVcopy(pos, v);
+            pos[1] += NavigationMapConfiguration::recastCellHeight;
+            ConvertRecastToGameCoord(pos, vert.vertex.pos);
+
+            vert.vertex.region   = region;
+            vert.vertex.building = false;
+
+            vertices.AddObject(vert);
+        }
+    }
+}
+
+/*
+============
+NavigationMap::GetTileSlot
+
+Returns the index of the tile containing the position in the tiles being built, -1 if it's not being built
+============
+*/
+int NavigationMap::GetTileSlot(const navGeometry_t& geometry, const int *tileSlots, const Vector& pos) const
+{
+    float rcPos[3];
+    int   x, y;
+
+    ConvertGameToRecastCoord(pos, rcPos);
+    navMeshDt->calcTileLoc(rcPos, &x, &y);
+
+    if (x < 0 || y < 0 || x >= geometry.numTilesX || y >= geometry.numTilesY) {
+        return -1;
+    }
+
+    return tileSlots[y * geometry.numTilesX + x];
+}
+
 /*
 ============
 NavigationMap::GatherOffMeshPoints
+
+Connect the walkable vertices of the tiles being built together,
+and with the vertices of the neighbor tiles near them.
+Each point is given to the tile it starts from, as Detour only keeps
+the connections starting in the tile
 ============
 */
-void NavigationMap::GatherOffMeshPoints(Container<offMeshNavigationPoint>& points, const rcPolyMesh *polyMesh)
+void NavigationMap::GatherOffMeshPoints(
+    const navGeometry_t& geometry, navTile_t *tiles, int numTiles, const int *tileSlots
+)
 {
-    size_t i;
+    const dtNavMeshParams             *params = navMeshDt->getParams();
+    const float                        margin = NavigationMapExtensionConfiguration::maxConnectionDist;
+    Container<navTileVertex_t>         tileVertices;
+    Container<offMeshNavigationVertex> vertices;
+    Container<offMeshNavigationPoint>  points;
+    Container<int>                     neighbors;
+    float                              bmin[3], bmax[3];
+    int                                i;
+    int                                x, y;
+    int                                nx, ny;
+    int                                slot;
+
+    //
+    // Gather the vertices of the tiles being built.
+    // Regions are numbered in each tile, so they are made unique
+    //
+
+    for (i = 0; i < numTiles; i++) {
+        if (tiles[i].polyMesh) {
+            AddPolyMeshVertices(tileVertices, tiles[i], i << 16);
+        }
+    }
+
+    //
+    // Gather the vertices of the tiles around them that are already built
+    //
+
+    for (i = 0; i < numTiles; i++) {
+        for (y = tiles[i].y - 1; y <= tiles[i].y + 1; y++) {
+            for (x = tiles[i].x - 1; x <= tiles[i].x + 1; x++) {
+                if (x < 0 || y < 0 || x >= geometry.numTilesX || y >= geometry.numTilesY) {
+                    continue;
+                }
+
+                if (tileSlots[y * geometry.numTilesX + x] != -1 || neighbors.IndexOfObject(y * geometry.numTilesX + x)) {
+                    continue;
+                }
+
+                neighbors.AddObject(y * geometry.numTilesX + x);
+
+                const dtMeshTile *tile = navMeshDt->getTileAt(x, y, 0);
+                if (!tile || !tile->header) {
+                    continue;
+                }
+
+                // Only the vertices close enough to the tiles being built can be connected to them
+                bmin[0] = bmin[2] = FLT_MAX;
+                bmax[0] = bmax[2] = -FLT_MAX;
+
+                for (ny = y - 1; ny <= y + 1; ny++) {
+                    for (nx = x - 1; nx <= x + 1; nx++) {
+                        if (nx < 0 || ny < 0 || nx >= geometry.numTilesX || ny >= geometry.numTilesY) {
+                            continue;
+                        }
+
+                        if (tileSlots[ny * geometry.numTilesX + nx] == -1) {
+                            continue;
+                        }
+
+                        bmin[0] = std::min(bmin[0], params->orig[0] + nx * params->tileWidth - margin);
+                        bmin[2] = std::min(bmin[2], params->orig[2] + ny * params->tileHeight - margin);
+                        bmax[0] = std::max(bmax[0], params->orig[0] + (nx + 1) * params->tileWidth + margin);
+                        bmax[2] = std::max(bmax[2], params->orig[2] + (ny + 1) * params->tileHeight + margin);
+                    }
+                }
+
+                AddNavMeshTileVertices(tileVertices, navMeshDt, tile, -neighbors.NumObjects(), bmin, bmax);
+            }
+        }
+    }
+
+    //
+    // Merge the vertices shared by polygons and by tiles
+    //
+
+    tileVertices.Sort(CompareTileVertices);
+
+    for (i = 1; i <= tileVertices.NumObjects(); i++) {
+        const navTileVertex_t& vert = tileVertices.ObjectAt(i);
+
+        if (i > 1 && !CompareTileVertices(&vert, &tileVertices.ObjectAt(i - 1))) {
+            if (vert.vertex.building) {
+                vertices[vertices.NumObjects() - 1].building = true;
+            }
+            continue;
+        }
+
+        vertices.AddObject(vert.vertex);
+    }
 
     //
     // Look for extensions and extend the navigation map
@@ -75,27 +453,66 @@ void NavigationMap::GatherOffMeshPoints(Container<offMeshNavigationPoint>& point
 
     for (i = 1; i <= extensions.NumObjects(); i++) {
         INavigationMapExtension *navExtension = extensions.ObjectAt(i);
-        navExtension->Handle(points, polyMesh);
+        navExtension->Handle(points, vertices);
+    }
+
+    for (i = 1; i <= points.NumObjects(); i++) {
+        offMeshNavigationPoint point = points.ObjectAt(i);
+
+        slot = GetTileSlot(geometry, tileSlots, point.start);
+        if (slot == -1 && point.bidirectional) {
+            // Can be used the other way around
+            const Vector start = point.start;
+
+            point.start = point.end;
+            point.end   = start;
+
+            slot = GetTileSlot(geometry, tileSlots, point.start);
+        }
+
+        if (slot == -1) {
+            // The tile it starts from is not being built
+            continue;
+        }
+
+        tiles[slot].points.AddObject(point);
     }
 }
 
 /*
 ============
-NavigationMap::InitializeNavMesh
+NavigationMap::GetNavMeshParams
+
+The tile grid covers the whole geometry
 ============
 */
-void NavigationMap::InitializeNavMesh(RecastBuildContext& buildContext, const navMap_t& navMap)
+void NavigationMap::GetNavMeshParams(const navGeometry_t& geometry, dtNavMeshParams& params)
 {
-    dtNavMeshParams params;
-    dtStatus        status;
+    const float  tileWidth = NavigationMapConfiguration::tileSize * NavigationMapConfiguration::recastCellSize;
+    int          numTilesX, numTilesY;
+    unsigned int tileBits;
+
+    numTilesX = std::max((int)ceilf((geometry.bmax[0] - geometry.bmin[0]) / tileWidth), 1);
+    numTilesY = std::max((int)ceilf((geometry.bmax[2] - geometry.bmin[2]) / tileWidth), 1);
+
+    // Polygon references have 22 bits for both the tile and the polygon
+    tileBits = std::min(dtIlog2(dtNextPow2(numTilesX * numTilesY)), 14u);
+
+    rcVcopy(params.orig, geometry.bmin);
+    params.tileWidth  = tileWidth;
+    params.tileHeight = tileWidth;
+    params.maxTiles   = 1 << tileBits;
+    params.maxPolys   = 1 << (22 - tileBits);
+}
 
-    params.orig[0]    = MIN_MAP_BOUNDS;
-    params.orig[1]    = MIN_MAP_BOUNDS;
-    params.orig[2]    = MIN_MAP_BOUNDS;
-    params.tileWidth  = MAP_SIZE * NavigationMapConfiguration::recastCellSize;
-    params.tileHeight = MAP_SIZE * NavigationMapConfiguration::recastCellSize;
-    params.maxTiles   = 32;
-    params.maxPolys   = 32768;
+/*
+============
+NavigationMap::InitializeNavMesh
+============
+*/
+void NavigationMap::InitializeNavMesh(RecastBuildContext& buildContext, const dtNavMeshParams& params)
+{
+    dtStatus status;
 
     navMeshDt = dtAllocNavMesh();
     status    = navMeshDt->init(&params);
@@ -174,23 +591,22 @@ void NavigationMap::ClearExtensions()
 
 /*
 ============
-NavigationMap::BuildDetourData
+NavigationMap::CreateTileData
 ============
 */
-void NavigationMap::BuildDetourData(
-    RecastBuildContext&                      buildContext,
-    rcPolyMesh                              *polyMesh,
-    rcPolyMeshDetail                        *polyMeshDetail,
-    int                                      index,
-    const Container<offMeshNavigationPoint>& points
-)
+void NavigationMap::CreateTileData(RecastBuildContext& buildContext, navTile_t& tile)
 {
-    unsigned char *navData     = NULL;
-    int            navDataSize = 0;
-    dtStatus       status;
-
-    if (polyMesh->npolys < 2) {
-        // Useless mesh
+    rcPolyMesh       *polyMesh       = tile.polyMesh;
+    rcPolyMeshDetail *polyMeshDetail = tile.polyMeshDetail;
+    float            *offMeshConVerts  = NULL;
+    float            *offMeshConRad    = NULL;
+    unsigned short   *offMeshConFlags  = NULL;
+    unsigned char    *offMeshConAreas  = NULL;
+    unsigned char    *offMeshConDir    = NULL;
+    unsigned int     *offMeshConUserID = NULL;
+
+    if (!polyMesh || !polyMesh->npolys) {
+        // Nothing walkable in this tile
         return;
     }
 
@@ -215,13 +631,14 @@ void NavigationMap::BuildDetourData(
     rcVcopy(dtParams.bmax, polyMesh->bmax);
     dtParams.cs          = NavigationMapConfiguration::recastCellSize;
     dtParams.ch          = NavigationMapConfiguration::recastCellHeight;
-    dtParams.tileX       = 0;
-    dtParams.tileY       = 0;
-    dtParams.tileLayer   = index;
+    dtParams.tileX       = tile.x;
+    dtParams.tileY       = tile.y;
+    dtParams.tileLayer   = 0;
     dtParams.buildBvTree = true;
 
-    if (points.NumObjects()) {
-        dtParams.offMeshConCount = offMeshConCount = points.NumObjects();
+    if (tile.points.NumObjects()) {
+        // Detour only keeps the connections starting in this tile
+        dtParams.offMeshConCount = tile.points.NumObjects();
 
         offMeshConVerts  = new float[6 * dtParams.offMeshConCount];
         offMeshConRad    = new float[dtParams.offMeshConCount];
@@ -231,7 +648,7 @@ void NavigationMap::BuildDetourData(
         offMeshConUserID = new unsigned int[dtParams.offMeshConCount];
 
         for (int i = 0; i < dtParams.offMeshConCount; i++) {
-            const offMeshNavigationPoint& point = points.ObjectAt(i + 1);
+            const offMeshNavigationPoint& point = tile.points.ObjectAt(i + 1);
 
             ConvertGameToRecastCoord(point.start, &offMeshConVerts[i * 6]);
             ConvertGameToRecastCoord(point.end, &offMeshConVerts[i * 6 + 3]);
@@ -251,9 +668,11 @@ void NavigationMap::BuildDetourData(
         dtParams.offMeshConUserID = offMeshConUserID;
     }
 
-    dtCreateNavMeshData(&dtParams, &navData, &navDataSize);
+    if (!dtCreateNavMeshData(&dtParams, &tile.navData, &tile.navDataSize)) {
+        buildContext.log(RC_LOG_ERROR, "Failed to create the data of tile %d,%d", tile.x, tile.y);
+    }
 
-    if (points.NumObjects()) {
+    if (tile.points.NumObjects()) {
         delete[] offMeshConVerts;
         delete[] offMeshConRad;
         delete[] offMeshConFlags;
@@ -261,30 +680,18 @@ void NavigationMap::BuildDetourData(
         delete[] offMeshConDir;
         delete[] offMeshConUserID;
     }
-
-    status = navMeshDt->addTile(navData, navDataSize, DT_TILE_FREE_DATA, 0, NULL);
-    if (!dtStatusSucceed(status)) {
-        buildContext.log(RC_LOG_ERROR, "Failed to create tile for navigation mesh");
-    }
 }
 
 /*
 ============
 NavigationMap::GeneratePolyMesh
+
+Rasterize the triangles overlapping the tile, and build its polygons
 ============
 */
-void NavigationMap::GeneratePolyMesh(
-    RecastBuildContext& buildContext,
-    float              *vertsBuffer,
-    int                 numVertices,
-    int                *indexesBuffer,
-    int                 numIndexes,
-    rcPolyMesh       *&       outPolyMesh,
-    rcPolyMeshDetail *& outPolyMeshDetail
-)
+void NavigationMap::GeneratePolyMesh(RecastBuildContext& buildContext, const navGeometry_t& geometry, navTile_t& tile)
 {
-    Vector             minBounds, maxBounds;
-    int                gridSizeX, gridSizeZ;
+    float              minBounds[3], maxBounds[3];
     const unsigned int walkableHeight =
         (int)ceilf(NavigationMapConfiguration::agentHeight / NavigationMapConfiguration::recastCellHeight);
     const unsigned int walkableClimb =
@@ -293,13 +700,25 @@ void NavigationMap::GeneratePolyMesh(
         (int)ceilf(NavigationMapConfiguration::agentRadius / NavigationMapConfiguration::recastCellSize);
     const unsigned int maxEdgeLen =
         (int)(NavigationMapConfiguration::edgeMaxLen / NavigationMapConfiguration::recastCellSize);
-    const unsigned int numTris = numIndexes / 3;
+    const int borderSize = GetTileBorderSize();
+    const int gridSize   = NavigationMapConfiguration::tileSize + borderSize * 2;
+    const int numTris    = tile.numTris;
+    int       i;
+
+    if (!numTris) {
+        return;
+    }
 
     //
-    // Calculate the grid size
+    // The heightfield includes a border so the polygons
+    // at the edges of the tile match the ones of the neighbors
     //
-    rcCalcBounds(vertsBuffer, numVertices, minBounds, maxBounds);
-    rcCalcGridSize(minBounds, maxBounds, NavigationMapConfiguration::recastCellSize, &gridSizeX, &gridSizeZ);
+    rcVcopy(minBounds, tile.bmin);
+    rcVcopy(maxBounds, tile.bmax);
+    minBounds[0] -= borderSize * NavigationMapConfiguration::recastCellSize;
+    minBounds[2] -= borderSize * NavigationMapConfiguration::recastCellSize;
+    maxBounds[0] += borderSize * NavigationMapConfiguration::recastCellSize;
+    maxBounds[2] += borderSize * NavigationMapConfiguration::recastCellSize;
 
     rcHeightfield *heightfield = rcAllocHeightfield();
 
@@ -310,31 +729,48 @@ void NavigationMap::GeneratePolyMesh(
     rcCreateHeightfield(
         &buildContext,
         *heightfield,
-        gridSizeX,
-        gridSizeZ,
+        gridSize,
+        gridSize,
         minBounds,
         maxBounds,
         NavigationMapConfiguration::recastCellSize,
         NavigationMapConfiguration::recastCellHeight
     );
 
+    int *indexesBuffer = new int[numTris * 3];
+    for (i = 0; i < numTris; i++) {
+        const int *tri = &geometry.indexes[tile.tris[i] * 3];
+
+        indexesBuffer[i * 3 + 0] = tri[0];
+        indexesBuffer[i * 3 + 1] = tri[1];
+        indexesBuffer[i * 3 + 2] = tri[2];
+    }
+
     unsigned char *triAreas = new unsigned char[numTris];
     memset(triAreas, 0, sizeof(unsigned char) * numTris);
 
     rcMarkWalkableTriangles(
         &buildContext,
         NavigationMapConfiguration::agentMaxSlope,
-        vertsBuffer,
-        numVertices,
+        geometry.verts,
+        geometry.numVertices,
         indexesBuffer,
         numTris,
         triAreas
     );
     rcRasterizeTriangles(
-        &buildContext, vertsBuffer, numVertices, indexesBuffer, triAreas, numTris, *heightfield, walkableClimb
+        &buildContext,
+        geometry.verts,
+        geometry.numVertices,
+        indexesBuffer,
+        triAreas,
+        numTris,
+        *heightfield,
+        walkableClimb
     );
 
     delete[] triAreas;
+    delete[] indexesBuffer;
 
     //
     // Filter walkable surfaces
@@ -360,12 +796,12 @@ void NavigationMap::GeneratePolyMesh(
     rcBuildRegions(
         &buildContext,
         *compactedHeightfield,
-        0,
+        borderSize,
         Square(NavigationMapConfiguration::regionMinSize),
         Square(NavigationMapConfiguration::regionMergeSize)
     );
 
-    //rcBuildRegionsMonotone(&buildContext, *compactedHeightfield, 0, Square(NavigationMapConfiguration::regionMinSize), Square(NavigationMapConfiguration::regionMergeSize));
+    //rcBuildRegionsMonotone(&buildContext, *compactedHeightfield, borderSize, Square(NavigationMapConfiguration::regionMinSize), Square(NavigationMapConfiguration::regionMergeSize));
 
     //
     // Simplify region contours
@@ -403,42 +839,34 @@ void NavigationMap::GeneratePolyMesh(
     rcFreeCompactHeightfield(compactedHeightfield);
     rcFreeContourSet(contourSet);
 
-    outPolyMesh       = polyMesh;
-    outPolyMeshDetail = polyMeshDetail;
+    // Update poly flags from areas.
+    for (i = 0; i < polyMesh->npolys; ++i) {
+        if (polyMesh->areas[i] == RC_WALKABLE_AREA) {
+            polyMesh->flags[i] = RECAST_POLYFLAG_WALKABLE;
+        }
+    }
+
+    tile.polyMesh       = polyMesh;
+    tile.polyMeshDetail = polyMeshDetail;
 }
 
 /*
 ============
-NavigationMap::BuildRecastMesh
+AddModelGeometry
+
+Append the triangles of the model to the buffers,
+converted to Recast's right-handed Y-up coordinate system
 ============
 */
-void NavigationMap::BuildRecastMesh(
-    RecastBuildContext& buildContext,
-    const navModel_t&   model,
-    const Vector&       origin,
-    const Vector&       angles,
-    rcPolyMesh       *&       outPolyMesh,
-    rcPolyMeshDetail *& outPolyMeshDetail
+static void AddModelGeometry(
+    navGeometry_t& geometry, const navModel_t& model, const Vector& origin, const Vector& angles
 )
 {
-    int numIndexes  = 0;
-    int numVertices = 0;
-    int baseVertice, baseIndice;
-    int i, j;
+    float *vertsBuffer   = &geometry.verts[geometry.numVertices * 3];
+    int   *indexesBuffer = &geometry.indexes[geometry.numIndexes];
+    int    baseVertice, baseIndice;
+    int    i, j;
 
-    for (i = 1; i <= model.surfaces.NumObjects(); i++) {
-        const navSurface_t& surface = model.surfaces.ObjectAt(i);
-
-        numIndexes += surface.indices.NumObjects();
-        numVertices += surface.vertices.NumObjects();
-    }
-
-    //
-    // Recreate the vertice buffer so it's compatible
-    // with Recast's right-handed Y-up coordinate system
-    float *vertsBuffer = new float[numVertices * 3];
-
-    baseIndice  = 0;
     baseVertice = 0;
 
     if (angles != vec_zero) {
@@ -476,9 +904,8 @@ void NavigationMap::BuildRecastMesh(
     }
 
     baseIndice  = 0;
-    baseVertice = 0;
+    baseVertice = geometry.numVertices;
 
-    int *indexesBuffer = new int[numIndexes];
     for (i = 1; i <= model.surfaces.NumObjects(); i++) {
         const navSurface_t& surface = model.surfaces.ObjectAt(i);
 
@@ -494,215 +921,673 @@ void NavigationMap::BuildRecastMesh(
         baseVertice += surface.vertices.NumObjects();
     }
 
-    //
-    // Generate the mesh
-    //
+    geometry.numVertices = baseVertice;
+    geometry.numIndexes += baseIndice;
+}
 
-    rcPolyMesh       *polyMesh;
-    rcPolyMeshDetail *polyMeshDetail;
+static void CountModelGeometry(const navModel_t& model, int& numVertices, int& numIndexes)
+{
+    int i;
 
-    GeneratePolyMesh(buildContext, vertsBuffer, numVertices, indexesBuffer, numIndexes, polyMesh, polyMeshDetail);
+    for (i = 1; i <= model.surfaces.NumObjects(); i++) {
+        const navSurface_t& surface = model.surfaces.ObjectAt(i);
 
-    // Update poly flags from areas.
-    for (int i = 0; i < polyMesh->npolys; ++i) {
-        if (polyMesh->areas[i] == RC_WALKABLE_AREA) {
-            polyMesh->flags[i] = RECAST_POLYFLAG_WALKABLE;
-        }
+        numIndexes += surface.indices.NumObjects();
+        numVertices += surface.vertices.NumObjects();
     }
-
-    delete[] indexesBuffer;
-    delete[] vertsBuffer;
-
-    outPolyMesh       = polyMesh;
-    outPolyMeshDetail = polyMeshDetail;
 }
 
 /*
 ============
-G_Navigation_Frame
+NavigationMap::BuildGeometry
+
+Gather the triangles of the world and of the baked brush entities
 ============
 */
-void G_Navigation_Frame()
+void NavigationMap::BuildGeometry(navGeometry_t& geometry)
 {
-    pathMaster.Update();
-    navigationMap.Update();
-    navigationObstacleMap.Update();
-    G_Navigation_DebugDraw();
+    const navMap_t& navMap      = navigationData.navMap;
+    int             numVertices = 0;
+    int             numIndexes  = 0;
+    int             i;
+
+    CountModelGeometry(navMap.GetWorldMap(), numVertices, numIndexes);
+
+    for (i = 1; i <= bakedEntities.NumObjects(); i++) {
+        const gentity_t *edict = &g_entities[bakedEntities.ObjectAt(i).entnum];
+
+        if (edict->s.modelindex <= navMap.GetNumSubmodels()) {
+            CountModelGeometry(navMap.GetSubmodel(edict->s.modelindex - 1), numVertices, numIndexes);
+        }
+    }
+
+    geometry.verts   = new float[numVertices * 3];
+    geometry.indexes = new int[numIndexes];
+
+    AddModelGeometry(geometry, navMap.GetWorldMap(), vec_origin, vec_zero);
+
+    for (i = 1; i <= bakedEntities.NumObjects(); i++) {
+        navBakedEntity_t& baked = bakedEntities.ObjectAt(i);
+        const gentity_t  *edict = &g_entities[baked.entnum];
+
+        baked.firstTri = geometry.numIndexes / 3;
+
+        if (edict->s.modelindex <= navMap.GetNumSubmodels()) {
+            AddModelGeometry(
+                geometry,
+                navMap.GetSubmodel(edict->s.modelindex - 1),
+                edict->entity->origin,
+                edict->entity->angles
+            );
+        }
+
+        baked.numTris = geometry.numIndexes / 3 - baked.firstTri;
+    }
+
+    geometry.removedTris = new bool[geometry.numIndexes / 3]();
+
+    if (geometry.numVertices) {
+        rcCalcBounds(geometry.verts, geometry.numVertices, geometry.bmin, geometry.bmax);
+    } else {
+        VectorClear(geometry.bmin);
+        VectorClear(geometry.bmax);
+    }
 }
 
 /*
 ============
-NavigationMap::NavigationMap
+BinTriangles
+
+Set the size of the tile grid covering the geometry,
+and give each tile the list of triangles overlapping it, including its border
 ============
 */
-NavigationMap::NavigationMap()
-    : navMeshDt(NULL)
-    , navMeshQuery(NULL)
-    , queryFilter(NULL)
+static void BinTriangles(navGeometry_t& geometry, const dtNavMeshParams& params)
 {
-    validNavigation = false;
+    const float border  = GetTileBorderSize() * NavigationMapConfiguration::recastCellSize;
+    const int   numTris = geometry.numIndexes / 3;
+    int         numTiles;
+    int        *tileNumTris;
+    int         pass;
+    int         i, j;
+    int         x, y;
+
+    geometry.numTilesX = std::max((int)ceilf((geometry.bmax[0] - params.orig[0]) / params.tileWidth), 1);
+    geometry.numTilesY = std::max((int)ceilf((geometry.bmax[2] - params.orig[2]) / params.tileHeight), 1);
+
+    numTiles    = geometry.numTilesX * geometry.numTilesY;
+    tileNumTris = new int[numTiles]();
+
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < numTris; i++) {
+            const int *tri = &geometry.indexes[i * 3];
+            float      triMins[2], triMaxs[2];
+            int        tileMins[2], tileMaxs[2];
+
+            triMins[0] = triMaxs[0] = geometry.verts[tri[0] * 3 + 0];
+            triMins[1] = triMaxs[1] = geometry.verts[tri[0] * 3 + 2];
+            for (j = 1; j < 3; j++) {
+                triMins[0] = std::min(triMins[0], geometry.verts[tri[j] * 3 + 0]);
+                triMaxs[0] = std::max(triMaxs[0], geometry.verts[tri[j] * 3 + 0]);
+                triMins[1] = std::min(triMins[1], geometry.verts[tri[j] * 3 + 2]);
+                triMaxs[1] = std::max(triMaxs[1], geometry.verts[tri[j] * 3 + 2]);
+            }
+
+            tileMins[0] = std::max((int)floorf((triMins[0] - border - params.orig[0]) / params.tileWidth), 0);
+            tileMins[1] = std::max((int)floorf((triMins[1] - border - params.orig[2]) / params.tileHeight), 0);
+            tileMaxs[0] =
+                std::min((int)floorf((triMaxs[0] + border - params.orig[0]) / params.tileWidth), geometry.numTilesX - 1);
+            tileMaxs[1] =
+                std::min((int)floorf((triMaxs[1] + border - params.orig[2]) / params.tileHeight), geometry.numTilesY - 1);
+
+            for (y = tileMins[1]; y <= tileMaxs[1]; y++) {
+                for (x = tileMins[0]; x <= tileMaxs[0]; x++) {
+                    const int tile = y * geometry.numTilesX + x;
+
+                    if (pass) {
+                        geometry.tileTris[geometry.tileFirstTri[tile] + tileNumTris[tile]] = i;
+                    }
+                    tileNumTris[tile]++;
+                }
+            }
+        }
+
+        if (!pass) {
+            // Now that the count is known, fill the lists
+            geometry.tileFirstTri    = new int[numTiles + 1];
+            geometry.tileFirstTri[0] = 0;
+
+            for (i = 0; i < numTiles; i++) {
+                geometry.tileFirstTri[i + 1] = geometry.tileFirstTri[i] + tileNumTris[i];
+                tileNumTris[i]               = 0;
+            }
+
+            geometry.tileTris = new int[geometry.tileFirstTri[numTiles]];
+        }
+    }
+
+    delete[] tileNumTris;
 }
 
 /*
 ============
-NavigationMap::~NavigationMap
+NavigationMap::BuildTilePolyMeshJob
 ============
 */
-NavigationMap::~NavigationMap()
+void NavigationMap::BuildTilePolyMeshJob(void *data, int index)
 {
-    ClearNavigation();
+    navTileBuild_t *build = static_cast<navTileBuild_t *>(data);
+    navTile_t&      tile  = build->tiles[index];
+
+    GeneratePolyMesh(tile.buildContext, *build->geometry, tile);
 }
 
 /*
 ============
-NavigationMap::GetNavMesh
+NavigationMap::CreateTileDataJob
 ============
 */
-dtNavMesh *NavigationMap::GetNavMesh() const
+void NavigationMap::CreateTileDataJob(void *data, int index)
 {
-    return navMeshDt;
+    navTileBuild_t *build = static_cast<navTileBuild_t *>(data);
+    navTile_t&      tile  = build->tiles[index];
+
+    CreateTileData(tile.buildContext, tile);
 }
 
 /*
 ============
-NavigationMap::GetNavMeshQuery
+NavigationMap::BuildTiles
+
+Build the specified tiles of the tile grid, replacing the existing ones.
+The tiles are rasterized on worker threads, the off-mesh connections are gathered
+on the main thread as the extensions trace through the world
 ============
 */
-dtNavMeshQuery *NavigationMap::GetNavMeshQuery() const
+void NavigationMap::BuildTiles(
+    RecastBuildContext& buildContext, const navGeometry_t& geometry, const Container<int>& tileIndexes
+)
 {
-    return navMeshQuery;
+    const dtNavMeshParams *params     = navMeshDt->getParams();
+    const int              numThreads = GetNumBuildThreads();
+    const int              numTiles   = tileIndexes.NumObjects();
+    navTileBuild_t         build;
+    navTile_t             *tiles;
+    int                   *tileSlots;
+    dtTileRef              tileRef;
+    dtStatus               status;
+    int                    i, j;
+
+    tiles     = new navTile_t[numTiles];
+    tileSlots = new int[geometry.numTilesX * geometry.numTilesY];
+
+    for (i = 0; i < geometry.numTilesX * geometry.numTilesY; i++) {
+        tileSlots[i] = -1;
+    }
+
+    for (i = 0; i < numTiles; i++) {
+        navTile_t& tile = tiles[i];
+
+        tile.x = tileIndexes[i] % geometry.numTilesX;
+        tile.y = tileIndexes[i] / geometry.numTilesX;
+
+        tile.bmin[0] = params->orig[0] + tile.x * params->tileWidth;
+        tile.bmin[1] = geometry.bmin[1];
+        tile.bmin[2] = params->orig[2] + tile.y * params->tileHeight;
+        tile.bmax[0] = params->orig[0] + (tile.x + 1) * params->tileWidth;
+        tile.bmax[1] = geometry.bmax[1];
+        tile.bmax[2] = params->orig[2] + (tile.y + 1) * params->tileHeight;
+
+        tileSlots[tileIndexes[i]] = i;
+
+        const int *tileTris = &geometry.tileTris[geometry.tileFirstTri[tileIndexes[i]]];
+        const int  numTris  = geometry.tileFirstTri[tileIndexes[i] + 1] - geometry.tileFirstTri[tileIndexes[i]];
+
+        tile.tris = new int[numTris];
+        for (j = 0; j < numTris; j++) {
+            if (!geometry.removedTris[tileTris[j]]) {
+                tile.tris[tile.numTris++] = tileTris[j];
+            }
+        }
+    }
+
+    build.geometry = &geometry;
+    build.tiles    = tiles;
+
+    gi.RunJobs(numThreads, numTiles, &NavigationMap::BuildTilePolyMeshJob, &build);
+
+    GatherOffMeshPoints(geometry, tiles, numTiles, tileSlots);
+
+    gi.RunJobs(numThreads, numTiles, &NavigationMap::CreateTileDataJob, &build);
+
+    for (i = 0; i < numTiles; i++) {
+        navTile_t& tile = tiles[i];
+
+        tile.buildContext.FlushLog();
+
+        tileRef = navMeshDt->getTileRefAt(tile.x, tile.y, 0);
+        if (tileRef) {
+            navMeshDt->removeTile(tileRef, NULL, NULL);
+        }
+
+        if (!tile.navData) {
+            continue;
+        }
+
+        status = navMeshDt->addTile(tile.navData, tile.navDataSize, DT_TILE_FREE_DATA, 0, NULL);
+        if (!dtStatusSucceed(status)) {
+            buildContext.log(RC_LOG_ERROR, "Failed to add tile %d,%d to the navigation mesh", tile.x, tile.y);
+            continue;
+        }
+
+        // Owned by the navigation mesh now
+        tile.navData = NULL;
+    }
+
+    delete[] tileSlots;
+    delete[] tiles;
 }
 
 /*
 ============
-NavigationMap::GetQueryFilter
+NavigationMap::IsBakeableEntity
+
+Returns true if the entity is a solid brush model that can be part of the tiles
 ============
 */
-const dtQueryFilter *NavigationMap::GetQueryFilter() const
+bool NavigationMap::IsBakeableEntity(gentity_t *edict) const
 {
-    return queryFilter;
+    if (!edict->inuse || !edict->entity || edict->entity == world) {
+        return false;
+    }
+
+    if (edict->solid != SOLID_BSP || !(edict->r.contents & MASK_PLAYERSOLID)) {
+        return false;
+    }
+
+    if (edict->entity->model[0] != '*' || edict->s.modelindex < 1) {
+        return false;
+    }
+
+    // Doors are opened by bots and handled as obstacles
+    if (edict->entity->IsSubclassOfDoor()) {
+        return false;
+    }
+
+    return true;
 }
 
 /*
 ============
-NavigationMap::GetNavigationData
+NavigationMap::SelectBakedEntities
 ============
 */
-const navMap_t& NavigationMap::GetNavigationData() const
+void NavigationMap::SelectBakedEntities()
 {
-    return navigationData.navMap;
+    gentity_t *edict;
+
+    bakedEntities.ClearObjectList();
+
+    for (edict = active_edicts.next; edict != &active_edicts; edict = edict->next) {
+        if (!IsBakeableEntity(edict)) {
+            continue;
+        }
+
+        navBakedEntity_t baked;
+
+        baked.entnum = edict - g_entities;
+        baked.entity = edict->entity;
+        baked.absmin = edict->r.absmin;
+        baked.absmax = edict->r.absmax;
+
+        bakedEntities.AddObject(baked);
+    }
 }
 
 /*
 ============
-NavigationMap::Update
+NavigationMap::LoadNavigationData
+
+Parse the BSP file into triangles, if it's not already done
 ============
 */
-void NavigationMap::Update() {}
+bool NavigationMap::LoadNavigationData(const char *mapname)
+{
+    if (navigationDataLoaded) {
+        return true;
+    }
+
+    navigationData.navMap = navMap_t();
+
+    try {
+        navigationData.ProcessBSPForNavigation(mapname);
+    } catch (const ScriptException& e) {
+        gi.Printf("Failed to load BSP for navigation: %s\n", e.string.c_str());
+        return false;
+    }
+
+    navigationDataLoaded = true;
+    return true;
+}
 
 /*
 ============
-NavigationMap::ClearNavigation
+NavigationMap::LoadGeometry
+
+Parse the BSP file and gather the triangles the tiles are built from
 ============
 */
-void NavigationMap::ClearNavigation()
+bool NavigationMap::LoadGeometry(const char *mapname)
 {
-    size_t i;
+    int start, end;
 
-    validNavigation = false;
+    start = gi.Milliseconds();
 
-    pathMaster.ClearNavigation();
-    navigationObstacleMap.Clear();
+    if (!LoadNavigationData(mapname)) {
+        return false;
+    }
 
-    if (navMeshQuery) {
-        dtFreeNavMeshQuery(navMeshQuery);
-        navMeshQuery = NULL;
+    end = gi.Milliseconds();
+
+    gi.Printf("BSP file loaded and parsed in %.03f seconds\n", (float)((end - start) / 1000.0));
+
+    geometry = new navGeometry_t();
+    BuildGeometry(*geometry);
+
+    if (!geometry->numIndexes) {
+        gi.Printf("No geometry to build the navigation mesh from\n");
+        return false;
     }
 
-    if (navMeshDt) {
-        dtFreeNavMesh(navMeshDt);
-        navMeshDt = NULL;
+    return true;
+}
+
+/*
+============
+NavigationMap::RebuildTiles
+============
+*/
+void NavigationMap::RebuildTiles(const Vector& mins, const Vector& maxs)
+{
+    const float border = GetTileBorderSize() * NavigationMapConfiguration::recastCellSize;
+    float       rcMins[3], rcMaxs[3];
+    float       bmin[3], bmax[3];
+    int         minX, minY, maxX, maxY;
+    int         x, y;
+
+    if (!navMeshDt || !geometry) {
+        // Nothing to build the tiles from
+        return;
     }
 
-    if (queryFilter) {
-        delete queryFilter;
-        queryFilter = NULL;
+    ConvertGameToRecastCoord(mins, rcMins);
+    ConvertGameToRecastCoord(maxs, rcMaxs);
+    rcVcopy(bmin, rcMins);
+    rcVmin(bmin, rcMaxs);
+    rcVcopy(bmax, rcMins);
+    rcVmax(bmax, rcMaxs);
+
+    // The neighbors see the bounds in their border
+    bmin[0] -= border;
+    bmin[2] -= border;
+    bmax[0] += border;
+    bmax[2] += border;
+
+    navMeshDt->calcTileLoc(bmin, &minX, &minY);
+    navMeshDt->calcTileLoc(bmax, &maxX, &maxY);
+
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, geometry->numTilesX - 1);
+    maxY = std::min(maxY, geometry->numTilesY - 1);
+
+    for (y = minY; y <= maxY; y++) {
+        for (x = minX; x <= maxX; x++) {
+            pendingTiles.AddUniqueObject(y * geometry->numTilesX + x);
+        }
+    }
+}
+
+/*
+============
+NavigationMap::BuildPendingTiles
+
+Build the next tiles waiting to be built again, one for each thread,
+so a large change is spread over multiple frames
+============
+*/
+void NavigationMap::BuildPendingTiles()
+{
+    RecastBuildContext buildContext;
+    Container<int>     tileIndexes;
+    const int          maxTiles = GetNumBuildThreads() + 1;
+    int                start, end;
+    int                i, j;
+
+    if (!pendingTiles.NumObjects()) {
+        return;
+    }
+
+    start = gi.Milliseconds();
+
+    for (i = 1; i <= pendingTiles.NumObjects() && i <= maxTiles; i++) {
+        tileIndexes.AddObject(pendingTiles.ObjectAt(i));
     }
 
+    for (i = 1; i <= tileIndexes.NumObjects(); i++) {
+        pendingTiles.RemoveObjectAt(1);
+    }
+
+    InitializeExtensions();
+    BuildTiles(buildContext, *geometry, tileIndexes);
     ClearExtensions();
+
+    //
+    // The rebuilt tiles have new polygons, so the obstacles are added back from scratch
+    //
+    for (i = 0; i < navMeshDt->getMaxTiles(); i++) {
+        const dtMeshTile *tile = static_cast<const dtNavMesh *>(navMeshDt)->getTile(i);
+        if (!tile || !tile->header) {
+            continue;
+        }
+
+        for (j = 0; j < tile->header->polyCount; j++) {
+            tile->polys[j].flags &= ~RECAST_POLYFLAG_BUSY;
+        }
+    }
+
+    navigationObstacleMap.Init();
+
+    if (!pendingTiles.NumObjects() && !bakedEntities.NumObjects()) {
+        // No tile can change anymore
+        delete geometry;
+        geometry = NULL;
+    }
+
+    end = gi.Milliseconds();
+
+    gi.DPrintf(
+        "Rebuilt %d navigation tile(s) in %.03f seconds, %d left\n",
+        tileIndexes.NumObjects(),
+        (float)((end - start) / 1000.0),
+        pendingTiles.NumObjects()
+    );
 }
 
-bool NavigationMap::IsValid() const
+/*
+============
+G_Navigation_Frame
+============
+*/
+void G_Navigation_Frame()
 {
-    return navMeshDt != NULL;
+    pathMaster.Update();
+    navigationMap.Update();
+    navigationObstacleMap.Update();
+    G_Navigation_DebugDraw();
 }
 
 /*
 ============
-NavigationMap::BuildWorldMesh
+NavigationMap::NavigationMap
 ============
 */
-void NavigationMap::BuildWorldMesh(RecastBuildContext& buildContext, const navMap_t& navigationMap)
+NavigationMap::NavigationMap()
+    : navMeshDt(NULL)
+    , navMeshQuery(NULL)
+    , queryFilter(NULL)
+    , geometry(NULL)
 {
-    rcPolyMesh       *polyMesh;
-    rcPolyMeshDetail *polyMeshDetail;
+    navigationDataLoaded = false;
+    validNavigation      = false;
+}
 
-    BuildRecastMesh(buildContext, navigationMap.GetWorldMap(), vec_origin, vec_zero, polyMesh, polyMeshDetail);
+/*
+============
+NavigationMap::~NavigationMap
+============
+*/
+NavigationMap::~NavigationMap()
+{
+    ClearNavigation();
+}
 
-    //
-    // Create detour data
-    //
+/*
+============
+NavigationMap::GetNavMesh
+============
+*/
+dtNavMesh *NavigationMap::GetNavMesh() const
+{
+    return navMeshDt;
+}
 
-    Container<offMeshNavigationPoint> points;
-    GatherOffMeshPoints(points, polyMesh);
+/*
+============
+NavigationMap::GetNavMeshQuery
+============
+*/
+dtNavMeshQuery *NavigationMap::GetNavMeshQuery() const
+{
+    return navMeshQuery;
+}
 
-    BuildDetourData(buildContext, polyMesh, polyMeshDetail, 0, points);
+/*
+============
+NavigationMap::GetQueryFilter
+============
+*/
+const dtQueryFilter *NavigationMap::GetQueryFilter() const
+{
+    return queryFilter;
+}
 
-    rcFreePolyMeshDetail(polyMeshDetail);
-    rcFreePolyMesh(polyMesh);
+/*
+============
+NavigationMap::GetNavigationData
+============
+*/
+const navMap_t& NavigationMap::GetNavigationData() const
+{
+    return navigationData.navMap;
 }
 
 /*
 ============
-NavigationMap::BuildMeshesForEntities
+NavigationMap::Update
+
+Build the tiles again when a baked brush entity is destroyed, hidden or moved
 ============
 */
-void NavigationMap::BuildMeshesForEntities(RecastBuildContext& buildContext, const navMap_t& navigationMap)
+void NavigationMap::Update()
 {
-    gentity_t        *edict;
-    rcPolyMesh       *polyMesh;
-    rcPolyMeshDetail *polyMeshDetail;
+    Vector mins, maxs;
+    bool   changed = false;
+    int    i, j;
 
-    for (edict = active_edicts.next; edict != &active_edicts; edict = edict->next) {
-        if (!edict->entity || edict->entity == world) {
-            continue;
-        }
+    if (!validNavigation) {
+        return;
+    }
+
+    for (i = bakedEntities.NumObjects(); i > 0; i--) {
+        const navBakedEntity_t& baked = bakedEntities.ObjectAt(i);
+        gentity_t              *edict = &g_entities[baked.entnum];
 
-        switch (edict->solid) {
-        case SOLID_TRIGGER:
-        default:
+        if (edict->entity == baked.entity && IsBakeableEntity(edict) && baked.absmin == edict->r.absmin
+            && baked.absmax == edict->r.absmax) {
             continue;
-        case SOLID_BSP:
-            break;
         }
 
-        if (edict->s.modelindex < 1 || edict->s.modelindex > navigationMap.GetNumSubmodels()) {
-            continue;
+        if (!changed) {
+            mins    = baked.absmin;
+            maxs    = baked.absmax;
+            changed = true;
+        } else {
+            AddPointToBounds(baked.absmin, mins, maxs);
+            AddPointToBounds(baked.absmax, mins, maxs);
         }
 
-        const navModel_t& submodel = navigationMap.GetSubmodel(edict->s.modelindex - 1);
-        if (!submodel.surfaces.NumObjects()) {
-            // Could be a trigger
-            continue;
+        if (geometry) {
+            for (j = 0; j < baked.numTris; j++) {
+                geometry->removedTris[baked.firstTri + j] = true;
+            }
         }
 
-        BuildRecastMesh(buildContext, submodel, edict->entity->origin, edict->entity->angles, polyMesh, polyMeshDetail);
+        // From now on it's a dynamic obstacle
+        bakedEntities.RemoveObjectAt(i);
+    }
+
+    if (changed) {
+        RebuildTiles(mins, maxs);
+    }
 
-        BuildDetourData(buildContext, polyMesh, polyMeshDetail, edict->s.modelindex, {});
+    BuildPendingTiles();
+}
 
-        rcFreePolyMeshDetail(polyMeshDetail);
-        rcFreePolyMesh(polyMesh);
+/*
+============
+NavigationMap::ClearNavigation
+============
+*/
+void NavigationMap::ClearNavigation()
+{
+    size_t i;
+
+    validNavigation      = false;
+    navigationDataLoaded = false;
+
+    bakedEntities.FreeObjectList();
+    pendingTiles.FreeObjectList();
+
+    if (geometry) {
+        delete geometry;
+        geometry = NULL;
+    }
+
+    pathMaster.ClearNavigation();
+    navigationObstacleMap.Clear();
+
+    if (navMeshQuery) {
+        dtFreeNavMeshQuery(navMeshQuery);
+        navMeshQuery = NULL;
+    }
+
+    if (navMeshDt) {
+        dtFreeNavMesh(navMeshDt);
+        navMeshDt = NULL;
+    }
+
+    if (queryFilter) {
+        delete queryFilter;
+        queryFilter = NULL;
     }
+
+    ClearExtensions();
+}
+
+bool NavigationMap::IsValid() const
+{
+    return navMeshDt != NULL;
 }
 
 /*
@@ -713,7 +1598,13 @@ NavigationMap::LoadWorldMap
 void NavigationMap::LoadWorldMap(const char *mapname)
 {
     RecastBuildContext buildContext;
+    dtNavMeshParams    params;
+    Container<int>     tileIndexes;
+    unsigned int       bspChecksum;
+    bool               buildingCache;
+    bool               useCache;
     int                start, end;
+    int                i;
 
     gi.Printf("---- Recast Navigation ----\n");
 
@@ -726,32 +1617,67 @@ void NavigationMap::LoadWorldMap(const char *mapname)
         ClearNavigation();
     }
 
-    if (!sv_maxbots->integer) {
+    buildingCache = IsBuildingCache(mapname);
+
+    if (!buildingCache && sv_navcachebuild->string[0]) {
+        // another map was loaded while the caches were being built
+        gi.Printf("Aborted building the navigation caches\n");
+        gi.cvar_set("sv_navcachebuild", "");
+    }
+
+    if (!sv_maxbots->integer && !buildingCache) {
         gi.Printf("No bots, skipping navigation\n");
         return;
     }
 
     if (validNavigation) {
-        return;
+        if (!buildingCache) {
+            return;
+        }
+
+        // load it again so the cache gets written
+        ClearNavigation();
     }
 
-    //
-    // Parse the BSP file into triangles
-    //
+    // The brush entities are part of the tiles as they are when the level starts
+    SelectBakedEntities();
+
+    useCache    = sv_navcache->integer || buildingCache;
+    bspChecksum = 0;
+
+    if (useCache) {
+        bspChecksum = GetBSPChecksum(mapname);
 
-    try {
         start = gi.Milliseconds();
 
-        navigationData.ProcessBSPForNavigation(mapname);
-    } catch (const ScriptException& e) {
-        gi.Printf("Failed to load BSP for navigation: %s\n", e.string.c_str());
-        ClearNavigation();
-        return;
+        if (bspChecksum && LoadCache(buildContext, mapname, bspChecksum)) {
+            end = gi.Milliseconds();
+
+            gi.Printf("Recast navigation mesh loaded from cache in %.03f seconds\n", (float)((end - start) / 1000.0));
+
+            if (bakedEntities.NumObjects()) {
+                // The tiles with brush entities may have to be built again later
+                if (LoadGeometry(mapname)) {
+                    BinTriangles(*geometry, *navMeshDt->getParams());
+                } else {
+                    delete geometry;
+                    geometry = NULL;
+                }
+            }
+
+            FinishLoading(buildingCache);
+            return;
+        }
     }
 
-    end = gi.Milliseconds();
+    //
+    // Parse the BSP file into triangles
+    //
 
-    gi.Printf("BSP file loaded and parsed in %.03f seconds\n", (float)((end - start) / 1000.0));
+    if (!LoadGeometry(mapname)) {
+        FailLoading(buildingCache);
+        return;
+    }
 
     //
     // Build and create the navigation mesh
@@ -759,39 +1685,86 @@ void NavigationMap::LoadWorldMap(const char *mapname)
 
     InitializeExtensions();
 
-    InitializeNavMesh(buildContext, navigationData.navMap);
+    GetNavMeshParams(*geometry, params);
+    InitializeNavMesh(buildContext, params);
     InitializeFilter();
 
-    gi.Printf("Building the navigation mesh...\n");
+    BinTriangles(*geometry, params);
 
-    try {
-        start = gi.Milliseconds();
+    tileIndexes.Resize(geometry->numTilesX * geometry->numTilesY);
+    for (i = 0; i < geometry->numTilesX * geometry->numTilesY; i++) {
+        tileIndexes.AddObject(i);
+    }
 
-        gi.Printf("  Building the world mesh...\n");
-        BuildWorldMesh(buildContext, navigationData.navMap);
+    gi.Printf(
+        "Building the navigation mesh (%d tiles, %d worker threads)...\n",
+        tileIndexes.NumObjects(),
+        GetNumBuildThreads()
+    );
 
-        gi.Printf("  Building meshes for entities...\n");
-        // FIXME: TODO
-        //  Split everything into chunks and use a tile-based approach
-        //BuildMeshesForEntities(buildContext, navigationData.navMap);
+    try {
+        start = gi.Milliseconds();
 
+        BuildTiles(buildContext, *geometry, tileIndexes);
     } catch (const ScriptException& e) {
         gi.Printf("Couldn't build recast navigation mesh: %s\n", e.string.c_str());
-        ClearNavigation();
+        FailLoading(buildingCache);
         return;
     }
 
+    end = gi.Milliseconds();
+
+    gi.Printf("Recast navigation mesh(es) generated in %.03f seconds\n", (float)((end - start) / 1000.0));
+
+    if (useCache && bspChecksum) {
+        SaveCache(mapname, bspChecksum);
+    }
+
+    FinishLoading(buildingCache);
+}
+
+/*
+============
+NavigationMap::FinishLoading
+
+Set up the systems using the navigation mesh, once it's built or loaded
+============
+*/
+void NavigationMap::FinishLoading(bool buildingCache)
+{
     pathMaster.PostLoadNavigation(*this);
     navigationObstacleMap.Init();
 
     // Finished processing the map with extensions
     ClearExtensions();
 
-    end = gi.Milliseconds();
-
-    gi.Printf("Recast navigation mesh(es) generated in %.03f seconds\n", (float)((end - start) / 1000.0));
+    if (geometry && !bakedEntities.NumObjects()) {
+        // Only kept to build the tiles of the brush entities again
+        delete geometry;
+        geometry = NULL;
+    }
 
     validNavigation = true;
+
+    if (buildingCache) {
+        BuildNextCache();
+    }
+}
+
+/*
+============
+NavigationMap::FailLoading
+
+Free what was set up for the map, and skip it if the caches are being built
+============
+*/
+void NavigationMap::FailLoading(bool buildingCache)
+{
+    ClearNavigation();
+
+    if (buildingCache) {
+        BuildNextCache();
+    }
 }
 
 void NavigationMap::CleanUp(qboolean samemap)
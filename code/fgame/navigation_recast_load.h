@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "navigation_bsp.h"
 
 class dtNavMesh;
+struct dtNavMeshParams;
 class dtNavMeshQuery;
 class dtQueryFilter;
 class dtCrowd;
@@ -40,6 +41,28 @@ struct rcPolyMesh;
 struct rcPolyMeshDetail;
 struct offMeshNavigationPoint;
 class INavigationMapExtension;
+struct navGeometry_t;
+struct navTile_t;
+
+/**
+ * @brief Brush entity rasterized into the navigation tiles.
+ *
+ */
+struct navBakedEntity_t {
+    int     entnum;
+    Entity *entity;
+    Vector  absmin;
+    Vector  absmax;
+
+    // Triangles of the entity in the navigation geometry
+    int firstTri;
+    int numTris;
+
+    navBakedEntity_t()
+        : firstTri(0)
+        , numTris(0)
+    {}
+};
 
 /**
  * @brief Full navigation map with meshes and tiles.
@@ -111,60 +134,74 @@ public:
      */
     void Update();
 
+    /**
+     * @brief Queue the tiles overlapping the specified bounds to be built again,
+     * from the world and the brush entities that are still baked.
+     * A few tiles are built each frame by Update().
+     *
+     * @param mins Minimum bounds, in game coordinates.
+     * @param maxs Maximum bounds, in game coordinates.
+     */
+    void RebuildTiles(const Vector& mins, const Vector& maxs);
+
+    /**
+     * @brief Load each map in turn to build its navigation cache.
+     *
+     * @param maps Space-separated list of maps, like sv_maplist.
+     */
+    void BuildCaches(const char *maps);
+
 private:
-    void GatherOffMeshPoints(Container<offMeshNavigationPoint>& points, const rcPolyMesh *polyMesh);
-    void GeneratePolyMesh(
-        RecastBuildContext& buildContext,
-        float              *vertsBuffer,
-        int                 numVertices,
-        int                *indexesBuffer,
-        int                 numIndexes,
-        rcPolyMesh       *&       outPolyMesh,
-        rcPolyMeshDetail *& outPolyMeshDetail
-    );
+    int  GetTileSlot(const navGeometry_t& geometry, const int *tileSlots, const Vector& pos) const;
+    void GatherOffMeshPoints(const navGeometry_t& geometry, navTile_t *tiles, int numTiles, const int *tileSlots);
+
+    static void GeneratePolyMesh(RecastBuildContext& buildContext, const navGeometry_t& geometry, navTile_t& tile);
+    static void CreateTileData(RecastBuildContext& buildContext, navTile_t& tile);
+    static void BuildTilePolyMeshJob(void *data, int index);
+    static void CreateTileDataJob(void *data, int index);
 
     void InitializeExtensions();
     void ClearExtensions();
 
-    void InitializeNavMesh(RecastBuildContext& buildContext, const navMap_t& navMap);
-    void InitializeFilter();
-
-    void BuildDetourData(
-        RecastBuildContext&                      buildContext,
-        rcPolyMesh                              *polyMesh,
-        rcPolyMeshDetail                        *polyMeshDetail,
-        int                                      index,
-        const Container<offMeshNavigationPoint>& points
-    );
-
-    void BuildRecastMesh(
-        RecastBuildContext& buildContext,
-        const navModel_t&   model,
-        const Vector&       origin,
-        const Vector&       angles,
-        rcPolyMesh       *&       outPolyMesh,
-        rcPolyMeshDetail *& outPolyMeshDetail
-    );
+    static void GetNavMeshParams(const navGeometry_t& geometry, dtNavMeshParams& params);
+    void        InitializeNavMesh(RecastBuildContext& buildContext, const dtNavMeshParams& params);
+    void        InitializeFilter();
+    void        FinishLoading(bool buildingCache);
+    void        FailLoading(bool buildingCache);
+
+    bool LoadNavigationData(const char *mapname);
+    bool LoadGeometry(const char *mapname);
+    bool IsBakeableEntity(gentity_t *edict) const;
+    void SelectBakedEntities();
+    void BuildGeometry(navGeometry_t& geometry);
+    void BuildPendingTiles();
+    void BuildTiles(RecastBuildContext& buildContext, const navGeometry_t& geometry, const Container<int>& tileIndexes);
     void ProcessBSPForNavigation(const char *mapname, navMap_t& outNavigationMap);
 
-    void BuildWorldMesh(RecastBuildContext& buildContext, const navMap_t& navigationMap);
-    void BuildMeshesForEntities(RecastBuildContext& buildContext, const navMap_t& navigationMap);
+    static unsigned int GetBSPChecksum(const char *mapname);
+    static str          GetCachePath(const char *mapname);
+    bool                LoadCache(RecastBuildContext& buildContext, const char *mapname, unsigned int bspChecksum);
+    void                SaveCache(const char *mapname, unsigned int bspChecksum) const;
+    bool                IsBuildingCache(const char *mapname) const;
+    void                BuildNextCache();
+    static void         StartCacheBuild(char *maps);
 
 private:
     dtNavMesh      *navMeshDt;
     dtNavMeshQuery *navMeshQuery;
     dtQueryFilter  *queryFilter;
     NavigationBSP   navigationData;
+    bool            navigationDataLoaded;
 
-public:
-    float          *offMeshConVerts;
-    float          *offMeshConRad;
-    unsigned short *offMeshConFlags;
-    unsigned char  *offMeshConAreas;
-    unsigned char  *offMeshConDir;
-    unsigned int   *offMeshConUserID;
-    int             offMeshConCount;
+    // Brush entities that are part of the tiles
+    Container<navBakedEntity_t> bakedEntities;
 
+    // Triangles the tiles are built from, kept while tiles can be built again
+    navGeometry_t *geometry;
+    // Tiles waiting to be built again
+    Container<int> pendingTiles;
+
+public:
     Container<INavigationMapExtension *> extensions;
 
     str  currentMap;
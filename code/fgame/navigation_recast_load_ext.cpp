@@ -31,10 +31,11 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "navigation_recast_config.h"
 #include "navigation_recast_config_ext.h"
 #include "navigation_recast_helpers.h"
-#include "Recast.h"
 #include "entity.h"
 #include "misc.h"
 
+#include <algorithm>
+
 CLASS_DECLARATION(Class, INavigationMapExtension, NULL) {
     {NULL, NULL}
 };
@@ -43,7 +44,9 @@ CLASS_DECLARATION(INavigationMapExtension, NavigationMapExtension_Ladders, NULL)
     {NULL, NULL}
 };
 
-void NavigationMapExtension_Ladders::Handle(Container<offMeshNavigationPoint>& points, const rcPolyMesh *polyMesh)
+void NavigationMapExtension_Ladders::Handle(
+    Container<offMeshNavigationPoint>& points, const Container<offMeshNavigationVertex>& vertices
+)
 {
     const Vector mins(MINS_X, MINS_Y, 0);
     const Vector maxs(MAXS_X, MAXS_Y, NavigationMapConfiguration::agentHeight);
@@ -175,7 +178,7 @@ bool NavigationMapExtension_JumpFall::AreVertsValid(const vec3_t pos1, const vec
     vec3_t delta;
 
     VectorSub2D(pos2, pos1, delta);
-    if (VectorLength2DSquared(delta) > Square(256)) {
+    if (VectorLength2DSquared(delta) > Square(NavigationMapExtensionConfiguration::maxConnectionDist)) {
         return false;
     }
 
@@ -189,79 +192,74 @@ bool NavigationMapExtension_JumpFall::AreVertsValid(const vec3_t pos1, const vec
     return true;
 }
 
-void NavigationMapExtension_JumpFall::Handle(Container<offMeshNavigationPoint>& points, const rcPolyMesh *polyMesh)
+/// Vertex being connected, after it was dropped to the floor.
+struct jumpFallVertex_t {
+    vec3_t        pos;
+    int           region;
+    bool          building;
+    unsigned char type;
+};
+
+void NavigationMapExtension_JumpFall::Handle(
+    Container<offMeshNavigationPoint>& points, const Container<offMeshNavigationVertex>& vertices
+)
 {
-    int             i, j;
-    vec3_t         *vertpos;
-    Vector          pos1, pos2;
-    bool           *walkableVert;
-    unsigned short *vertreg;
-    unsigned char  *verttype;
+    const int         numVerts = vertices.NumObjects();
+    int               i, j;
+    Vector            pos1, pos2;
+    jumpFallVertex_t *verts;
 
-    walkableVert = new bool[polyMesh->nverts];
-    vertpos      = new vec3_t[polyMesh->nverts];
-    vertreg      = new unsigned short[polyMesh->nverts];
-    verttype     = new unsigned char[polyMesh->nverts];
+    verts = new jumpFallVertex_t[numVerts];
 
-    for (i = 0; i < polyMesh->nverts; i++) {
-        walkableVert[i] = false;
-        vertreg[i]      = 0;
-        verttype[i]     = 0;
+    for (i = 0; i < numVerts; i++) {
+        const offMeshNavigationVertex& vertex = vertices[i];
 
-        GetPolyMeshVertPosition(polyMesh, i, vertpos[i]);
-        FixupPoint(vertpos[i]);
+        VectorCopy(vertex.pos, verts[i].pos);
+        FixupPoint(verts[i].pos);
+        verts[i].region   = vertex.region;
+        verts[i].building = vertex.building;
+        verts[i].type     = 0;
     }
 
-    for (i = 0; i < polyMesh->npolys; i++) {
-        const unsigned short *poly = &polyMesh->polys[i * polyMesh->nvp * 2];
+    // Sorted on X so the loops below stop at the vertices that are too far
+    std::sort(verts, verts + numVerts, [](const jumpFallVertex_t& v1, const jumpFallVertex_t& v2) {
+        return v1.pos[0] < v2.pos[0];
+    });
 
-        if (polyMesh->areas[i] != RC_WALKABLE_AREA) {
-            continue;
-        }
+    for (i = 0; i < numVerts; i++) {
+        jumpFallVertex_t& vert1 = verts[i];
 
-        for (j = 0; j < polyMesh->nvp; j++) {
-            if (poly[j] == RC_MESH_NULL_IDX) {
+        for (j = i + 1; j < numVerts; j++) {
+            jumpFallVertex_t& vert2 = verts[j];
+
+            if (vert2.pos[0] - vert1.pos[0] > NavigationMapExtensionConfiguration::maxConnectionDist) {
                 break;
             }
 
-            assert(poly[j] < polyMesh->nverts);
-            walkableVert[poly[j]] = true;
-            vertreg[poly[j]]      = polyMesh->regs[i];
-        }
-    }
-
-    for (i = 0; i < polyMesh->nverts; i++) {
-        if (!walkableVert[i]) {
-            continue;
-        }
-
-        for (j = i + 1; j < polyMesh->nverts; j++) {
-            if (!walkableVert[j]) {
+            if (!vert1.building && !vert2.building) {
                 continue;
             }
 
-            if (vertreg[j] == vertreg[i]) {
+            if (vert2.region == vert1.region) {
                 continue;
             }
 
-            if (!AreVertsValid(vertpos[i], vertpos[j])) {
+            if (!AreVertsValid(vert1.pos, vert2.pos)) {
                 continue;
             }
-            pos1 = vertpos[i];
-            pos2 = vertpos[j];
+            pos1 = vert1.pos;
+            pos2 = vert2.pos;
 
-            offMeshNavigationPoint point;
-
-            if (AddPoint(points, CanConnectStraightPoint(polyMesh, pos1, pos2))) {
-                verttype[i] = verttype[j] = 1;
+            if (AddPoint(points, CanConnectStraightPoint(pos1, pos2))) {
+                vert1.type = vert2.type = 1;
                 continue;
             }
-            if (AddPoint(points, CanConnectJumpPoint(polyMesh, pos1, pos2))) {
-                verttype[i] = verttype[j] = 2;
+            if (AddPoint(points, CanConnectJumpPoint(pos1, pos2))) {
+                vert1.type = vert2.type = 2;
                 continue;
             }
-            if (AddPoint(points, CanConnectFallPoint(polyMesh, pos1, pos2))) {
-                verttype[i] = verttype[j] = 3;
+            if (AddPoint(points, CanConnectFallPoint(pos1, pos2))) {
+                vert1.type = vert2.type = 3;
                 continue;
             }
         }
@@ -273,43 +271,42 @@ void NavigationMapExtension_JumpFall::Handle(Container<offMeshNavigationPoint>&
     //  that would allow the bot to get around the obstacle or exit an area
     //
 
-    for (i = 0; i < polyMesh->nverts; i++) {
-        if (!walkableVert[i]) {
-            continue;
-        }
+    for (i = 0; i < numVerts; i++) {
+        jumpFallVertex_t& vert1 = verts[i];
 
-        for (j = i + 1; j < polyMesh->nverts; j++) {
-            if (!walkableVert[j]) {
-                continue;
+        for (j = i + 1; j < numVerts; j++) {
+            jumpFallVertex_t& vert2 = verts[j];
+
+            if (vert2.pos[0] - vert1.pos[0] > NavigationMapExtensionConfiguration::maxConnectionDist) {
+                break;
             }
 
-            if (vertreg[j] == vertreg[i]) {
+            if (!vert1.building && !vert2.building) {
                 continue;
             }
 
-            if (verttype[i] && verttype[j]) {
+            if (vert2.region == vert1.region) {
                 continue;
             }
 
-            if (!AreVertsValid(vertpos[i], vertpos[j])) {
+            if (vert1.type && vert2.type) {
                 continue;
             }
-            pos1 = vertpos[i];
-            pos2 = vertpos[j];
 
-            offMeshNavigationPoint point;
+            if (!AreVertsValid(vert1.pos, vert2.pos)) {
+                continue;
+            }
+            pos1 = vert1.pos;
+            pos2 = vert2.pos;
 
-            if (AddPoint(points, CanConnectJumpOverLedgePoint(polyMesh, pos1, pos2))) {
-                verttype[i] = verttype[j] = 4;
+            if (AddPoint(points, CanConnectJumpOverLedgePoint(pos1, pos2))) {
+                vert1.type = vert2.type = 4;
                 continue;
             }
         }
     }
 
-    delete[] verttype;
-    delete[] vertreg;
-    delete[] vertpos;
-    delete[] walkableVert;
+    delete[] verts;
 }
 
 void NavigationMapExtension_JumpFall::FixupPoint(vec3_t pos)
@@ -369,7 +366,7 @@ NavigationMap::CanConnectFallPoint
 ============
 */
 offMeshNavigationPoint
-NavigationMapExtension_JumpFall::CanConnectFallPoint(const rcPolyMesh *polyMesh, const Vector& pos1, const Vector& pos2)
+NavigationMapExtension_JumpFall::CanConnectFallPoint(const Vector& pos1, const Vector& pos2)
 {
     const Vector           mins(MINS_X, MINS_Y, 0);
     const Vector           maxs(MAXS_X, MAXS_Y, NavigationMapConfiguration::agentHeight);
@@ -477,7 +474,7 @@ NavigationMap::CanConnectJumpPoint
 ============
 */
 offMeshNavigationPoint
-NavigationMapExtension_JumpFall::CanConnectJumpPoint(const rcPolyMesh *polyMesh, const Vector& pos1, const Vector& pos2)
+NavigationMapExtension_JumpFall::CanConnectJumpPoint(const Vector& pos1, const Vector& pos2)
 {
     const Vector           mins(MINS_X, MINS_Y, 0);
     const Vector           maxs(MAXS_X, MAXS_Y, NavigationMapConfiguration::agentHeight);
@@ -668,9 +665,8 @@ The following action can be performed:
  s─┘ └─e
 ============
 */
-offMeshNavigationPoint NavigationMapExtension_JumpFall::CanConnectJumpOverLedgePoint(
-    const rcPolyMesh *polyMesh, const Vector& pos1, const Vector& pos2
-)
+offMeshNavigationPoint
+NavigationMapExtension_JumpFall::CanConnectJumpOverLedgePoint(const Vector& pos1, const Vector& pos2)
 {
     const Vector           mins(MINS_X, MINS_Y, 0);
     const Vector           maxs(MAXS_X, MAXS_Y, NavigationMapConfiguration::agentHeight);
@@ -850,9 +846,8 @@ offMeshNavigationPoint NavigationMapExtension_JumpFall::CanConnectJumpOverLedgeP
 NavigationMap::CanConnectStraightPoint
 ============
 */
-offMeshNavigationPoint NavigationMapExtension_JumpFall::CanConnectStraightPoint(
-    const rcPolyMesh *polyMesh, const Vector& pos1, const Vector& pos2
-)
+offMeshNavigationPoint
+NavigationMapExtension_JumpFall::CanConnectStraightPoint(const Vector& pos1, const Vector& pos2)
 {
     const Vector           mins(MINS_X, MINS_Y, 0);
     const Vector           maxs(MAXS_X, MAXS_Y, NavigationMapConfiguration::agentHeight);
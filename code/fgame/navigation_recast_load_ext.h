@@ -31,7 +31,23 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "../corepp/vector.h"
 #include "../corepp/container.h"
 
-struct rcPolyMesh;
+/**
+ * @brief A walkable vertex of the navigation mesh, where offmesh points can start or end.
+ *
+ */
+struct offMeshNavigationVertex {
+    Vector pos;
+    // Region of the polygons around the vertex, unique across the tiles
+    int region;
+    // Whether or not the vertex is in one of the tiles being built,
+    // the points between other vertices are already in the navigation mesh
+    bool building;
+
+    offMeshNavigationVertex()
+        : region(0)
+        , building(false)
+    {}
+};
 
 /**
  * @brief An offmesh point that the navigation system will use to find path.
@@ -76,7 +92,14 @@ private:
     CLASS_PROTOTYPE(INavigationMapExtension);
 
 public:
-    virtual void Handle(Container<offMeshNavigationPoint>& points, const rcPolyMesh *polyMesh) {}
+    /**
+     * @brief Add the offmesh points of the tiles being built.
+     *
+     * @param points The list to add the points to.
+     * @param vertices Walkable vertices of the tiles being built and of their neighbors.
+     */
+    virtual void
+    Handle(Container<offMeshNavigationPoint>& points, const Container<offMeshNavigationVertex>& vertices) {}
 
     virtual Container<ExtensionArea> GetSupportedAreas() const { return Container<ExtensionArea>(); }
 };
@@ -87,7 +110,7 @@ private:
     CLASS_PROTOTYPE(NavigationMapExtension_Ladders);
 
 public:
-    void                     Handle(Container<offMeshNavigationPoint>& points, const rcPolyMesh *polyMesh) override;
+    void Handle(Container<offMeshNavigationPoint>& points, const Container<offMeshNavigationVertex>& vertices) override;
     Container<ExtensionArea> GetSupportedAreas() const override;
 };
 
@@ -97,15 +120,15 @@ private:
     CLASS_PROTOTYPE(NavigationMapExtension_JumpFall);
 
 public:
-    void                     Handle(Container<offMeshNavigationPoint>& points, const rcPolyMesh *polyMesh) override;
+    void Handle(Container<offMeshNavigationPoint>& points, const Container<offMeshNavigationVertex>& vertices) override;
     Container<ExtensionArea> GetSupportedAreas() const override;
 
 private:
     void                   FixupPoint(vec3_t pos);
     bool                   AddPoint(Container<offMeshNavigationPoint>& points, const offMeshNavigationPoint& point);
     bool                   AreVertsValid(const vec3_t pos1, const vec3_t pos2) const;
-    offMeshNavigationPoint CanConnectFallPoint(const rcPolyMesh *polyMesh, const Vector& pos1, const Vector& pos2);
-    offMeshNavigationPoint CanConnectJumpPoint(const rcPolyMesh *polyMesh, const Vector& pos1, const Vector& pos2);
-    offMeshNavigationPoint CanConnectJumpOverLedgePoint(const rcPolyMesh *polyMesh, const Vector& pos1, const Vector& pos2);
-    offMeshNavigationPoint CanConnectStraightPoint(const rcPolyMesh *polyMesh, const Vector& pos1, const Vector& pos2);
+    offMeshNavigationPoint CanConnectFallPoint(const Vector& pos1, const Vector& pos2);
+    offMeshNavigationPoint CanConnectJumpPoint(const Vector& pos1, const Vector& pos2);
+    offMeshNavigationPoint CanConnectJumpOverLedgePoint(const Vector& pos1, const Vector& pos2);
+    offMeshNavigationPoint CanConnectStraightPoint(const Vector& pos1, const Vector& pos2);
 };
@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "navigation_recast_path.h"
 #include "navigation_recast_load.h"
 #include "navigation_recast_helpers.h"
+#include "navigate.h"
 #include "level.h"
 
 #include "DetourPathCorridor.h"
@@ -38,6 +39,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "bg_local.h"
 
 #define MAX_NPOLYS 256
+// Number of A* iterations between two checks of the time budget
+#define PATH_SLICE_ITERATIONS 32
 
 RecastPathMaster pathMaster;
 
@@ -50,11 +53,19 @@ public:
     unsigned char  cornerFlags[4];
     dtPolyRef      cornerPolys[4];
     int            ncorners;
+
+    // Path request waiting in the queue
+    dtPolyRef requestStartRef;
+    dtPolyRef requestEndRef;
+    vec3_t    requestStartPt;
+    vec3_t    requestEndPt;
+    qctime_t  requestTime;
 };
 
 RecastPather::RecastPather()
     : lastCheckTime(0)
     , moving(false)
+    , querying(false)
 {
     detourData = new DetourData();
     detourData->corridor.init(256);
@@ -62,6 +73,8 @@ RecastPather::RecastPather()
 
 RecastPather::~RecastPather()
 {
+    pathMaster.CancelRequest(this);
+
     if (detourData) {
         delete detourData;
         detourData = NULL;
@@ -70,69 +83,48 @@ RecastPather::~RecastPather()
 
 void RecastPather::FindPath(const Vector& start, const Vector& end, const PathSearchParameter& parameters)
 {
-    Vector               recastStart, recastEnd;
+    Vector               recastEnd;
     dtPolyRef            startRef, endRef;
     vec3_t               startPt, endPt;
     const dtQueryFilter *filter = navigationMap.GetQueryFilter();
 
     lastorg = start;
-    ResetPosition(start);
 
-    ConvertGameToRecastCoord(start, recastStart);
     ConvertGameToRecastCoord(end, recastEnd);
 
-    endRef   = 0;
-    startRef = detourData->corridor.getFirstPoly();
-    dtVcopy(startPt, detourData->corridor.getPos());
+    endRef = 0;
+    FindStartPoly(start, startRef, startPt);
     navigationMap.GetNavMeshQuery()->findNearestPoly(recastEnd, DETOUR_EXTENT, filter, &endRef, endPt);
 
     if (!startRef || !endRef) {
+        pathMaster.CancelRequest(this);
+        ResetPosition(start);
         return;
     }
 
-    dtPolyRef polys[MAX_NPOLYS];
-    int       nPolys = 0;
-    navigationMap.GetNavMeshQuery()->findPath(startRef, endRef, startPt, endPt, filter, polys, &nPolys, ARRAY_LEN(polys) - 1);
-
-    if (nPolys) {
-        vec3_t   closestPos;
-        dtStatus status;
-
-        if (polys[nPolys - 1] != endRef) {
-            status = navigationMap.GetNavMeshQuery()->closestPointOnPoly(polys[nPolys - 1], endPt, closestPos, 0);
-            if (dtStatusFailed(status)) {
-                VectorCopy(endPt, closestPos);
-            }
-        } else {
-            VectorCopy(endPt, closestPos);
-        }
-
-        moving = true;
-        detourData->corridor.setCorridor(closestPos, polys, nPolys);
-    }
+    RequestPath(startRef, startPt, endRef, endPt);
 }
 
 void RecastPather::FindPathNear(
     const Vector& start, const Vector& end, float radius, const PathSearchParameter& parameters
 )
 {
-    Vector               recastStart, recastEnd;
+    Vector               recastEnd;
     dtPolyRef            startRef, endRef;
     vec3_t               startPt, endPt;
     const dtQueryFilter *filter = navigationMap.GetQueryFilter();
 
     lastorg = start;
-    ResetPosition(start);
 
-    ConvertGameToRecastCoord(start, recastStart);
     ConvertGameToRecastCoord(end, recastEnd);
 
-    endRef   = 0;
-    startRef = detourData->corridor.getFirstPoly();
-    dtVcopy(startPt, detourData->corridor.getPos());
+    endRef = 0;
+    FindStartPoly(start, startRef, startPt);
     navigationMap.GetNavMeshQuery()->findNearestPoly(recastEnd, DETOUR_EXTENT, filter, &endRef, endPt);
 
     if (!startRef || !endRef) {
+        pathMaster.CancelRequest(this);
+        ResetPosition(start);
         return;
     }
 
@@ -141,29 +133,12 @@ void RecastPather::FindPathNear(
             endRef, endPt, radius, filter, &G_Random, &endRef, endPt
         ) != DT_SUCCESS
         || !endRef) {
+        pathMaster.CancelRequest(this);
+        ResetPosition(start);
         return;
     }
 
-    dtPolyRef polys[MAX_NPOLYS];
-    int       nPolys = 0;
-    navigationMap.GetNavMeshQuery()->findPath(startRef, endRef, startPt, endPt, filter, polys, &nPolys, ARRAY_LEN(polys) - 1);
-
-    if (nPolys) {
-        vec3_t   closestPos;
-        dtStatus status;
-
-        if (polys[nPolys - 1] != endRef) {
-            status = navigationMap.GetNavMeshQuery()->closestPointOnPoly(polys[nPolys - 1], endPt, closestPos, 0);
-            if (dtStatusFailed(status)) {
-                VectorCopy(endPt, closestPos);
-            }
-        } else {
-            VectorCopy(endPt, closestPos);
-        }
-
-        moving = true;
-        detourData->corridor.setCorridor(closestPos, polys, nPolys);
-    }
+    RequestPath(startRef, startPt, endRef, endPt);
 }
 
 void RecastPather::FindPathAway(
@@ -174,8 +149,7 @@ void RecastPather::FindPathAway(
     const PathSearchParameter& parameters
 )
 {
-    Vector               recastStart, recastAvoid, recastEnd;
-    Vector               dirNormalized;
+    Vector               recastAvoid;
     dtPolyRef            startRef, endRef;
     vec3_t               startPt, endPt;
     const dtQueryFilter *filter = navigationMap.GetQueryFilter();
@@ -184,22 +158,15 @@ void RecastPather::FindPathAway(
     int                  i, j;
 
     lastorg = start;
-    ResetPosition(start);
 
     startAngle = DEG2RAD(preferredDir.toYaw());
     startPitch = DEG2RAD(preferredDir.toPitch());
 
-    dirNormalized = preferredDir;
-    dirNormalized.normalize();
-
-    ConvertGameToRecastCoord(start, recastStart);
     ConvertGameToRecastCoord(avoid, recastAvoid);
-    ConvertGameToRecastCoord(avoid + dirNormalized * radius, recastEnd);
-
-    startRef = detourData->corridor.getFirstPoly();
-    dtVcopy(startPt, detourData->corridor.getPos());
 
-    if (!startRef) {
+    if (!FindStartPoly(start, startRef, startPt)) {
+        pathMaster.CancelRequest(this);
+        ResetPosition(start);
         return;
     }
 
@@ -216,35 +183,15 @@ void RecastPather::FindPathAway(
             if (navigationMap.GetNavMeshQuery()->findNearestPoly(point, DETOUR_EXTENT, filter, &endRef, endPt)
                     == DT_SUCCESS
                 && endRef) {
-                dtPolyRef polys[MAX_NPOLYS];
-                int       nPolys = 0;
-                navigationMap.GetNavMeshQuery()->findPath(
-                    startRef, endRef, startPt, endPt, filter, polys, &nPolys, ARRAY_LEN(polys) - 1
-                );
-
-                if (nPolys) {
-                    vec3_t   closestPos;
-                    dtStatus status;
-
-                    if (polys[nPolys - 1] != endRef) {
-                        status = navigationMap.GetNavMeshQuery()->closestPointOnPoly(
-                            polys[nPolys - 1], endPt, closestPos, 0
-                        );
-                        if (dtStatusFailed(status)) {
-                            VectorCopy(endPt, closestPos);
-                        }
-                    } else {
-                        VectorCopy(endPt, closestPos);
-                    }
-
-                    moving = true;
-                    detourData->corridor.setCorridor(closestPos, polys, nPolys);
-                }
-
+                RequestPath(startRef, startPt, endRef, endPt);
                 return;
             }
         }
     }
+
+    // Nowhere to go
+    pathMaster.CancelRequest(this);
+    ResetPosition(start);
 }
 
 bool RecastPather::TestPath(const Vector& start, const Vector& end, const PathSearchParameter& parameters)
@@ -317,36 +264,29 @@ void RecastPather::UpdatePos(const Vector& origin)
             // traversed
             traversingOffMeshLink = false;
         }
-    } else if (level.inttime >= lastCheckTime + 2000) {
+    } else if (!querying && level.inttime >= lastCheckTime + 2000) {
+        // a pending request already starts from a recent position
         vec3_t delta;
         VectorSubtract(recastOrigin, detourData->corridor.getPos(), delta);
 
         if (VectorLengthSquared(delta) > Square(64)) {
-            dtPolyRef startRef, endRef;
-            vec3_t    startPt, endPt;
+            dtPolyRef startRef;
+            vec3_t    startPt;
 
             //
-            // Get the target position
+            // Find the path again from the current position to the target,
+            // the current corridor is kept until it's found
             //
-            endRef = detourData->corridor.getLastPoly();
-            VectorCopy(detourData->corridor.getTarget(), endPt);
-
-            ResetPosition(origin);
-
-            startRef = 0;
-            navigationMap.GetNavMeshQuery()->findNearestPoly(recastOrigin, DETOUR_EXTENT, filter, &startRef, startPt);
-
-            if (startRef) {
-                dtPolyRef polys[MAX_NPOLYS];
-                int       nPolys = 0;
-                navigationMap.GetNavMeshQuery()->findPath(
-                    startRef, endRef, startPt, endPt, filter, polys, &nPolys, ARRAY_LEN(polys) - 1
+            if (FindStartPoly(origin, startRef, startPt)) {
+                RequestPath(
+                    startRef,
+                    startPt,
+                    detourData->corridor.getLastPoly(),
+                    detourData->corridor.getTarget()
                 );
-
-                if (nPolys) {
-                    moving = true;
-                    detourData->corridor.setCorridor(endPt, polys, nPolys);
-                }
+            } else {
+                pathMaster.CancelRequest(this);
+                ResetPosition(origin);
             }
         }
 
@@ -391,6 +331,7 @@ void RecastPather::UpdatePos(const Vector& origin)
 
 void RecastPather::Clear()
 {
+    pathMaster.CancelRequest(this);
     ResetPosition(lastorg);
 }
 
@@ -531,7 +472,7 @@ bool RecastPather::HasReachedGoal(const Vector& origin) const
 
 bool RecastPather::IsQuerying() const
 {
-    return false;
+    return querying;
 }
 
 void RecastPather::ResetPosition(const Vector& origin)
@@ -567,8 +508,333 @@ void RecastPather::ResetPosition(const Vector& origin)
     }
 }
 
-void RecastPathMaster::PostLoadNavigation(const NavigationMap& map) {}
+/*
+============
+RecastPather::FindStartPoly
+
+Returns the polygon nearest to the origin, or to the last valid position
+============
+*/
+bool RecastPather::FindStartPoly(const Vector& origin, dtPolyRef& startRef, float *startPt) const
+{
+    const dtQueryFilter *filter = navigationMap.GetQueryFilter();
+    vec3_t               agentPos;
+    dtStatus             status;
+
+    startRef = 0;
+    ConvertGameToRecastCoord(origin, agentPos);
+
+    status = navigationMap.GetNavMeshQuery()->findNearestPoly(agentPos, DETOUR_EXTENT, filter, &startRef, startPt);
+
+    if (dtStatusFailed(status) || !startRef) {
+        // Use the last valid position instead
+        ConvertGameToRecastCoord(lastValidOrg, agentPos);
+        status =
+            navigationMap.GetNavMeshQuery()->findNearestPoly(agentPos, DETOUR_EXTENT, filter, &startRef, startPt);
+    }
+
+    return dtStatusSucceed(status) && startRef;
+}
+
+/*
+============
+RecastPather::RequestPath
 
-void RecastPathMaster::ClearNavigation() {}
+Queue the path request, the current path is kept until the new one is found.
+The pending request is kept if it leads to the same polygon
+============
+*/
+void RecastPather::RequestPath(dtPolyRef startRef, const float *startPt, dtPolyRef endRef, const float *endPt)
+{
+    if (querying && endRef == detourData->requestEndRef) {
+        //
+        // Same goal as the request in progress, let it finish
+        // rather than starting over, or it would never be found
+        // if it's asked again every frame
+        //
+        dtVcopy(detourData->requestEndPt, endPt);
+        return;
+    }
 
-void RecastPathMaster::Update() {}
+    detourData->requestStartRef = startRef;
+    detourData->requestEndRef   = endRef;
+    dtVcopy(detourData->requestStartPt, startPt);
+    dtVcopy(detourData->requestEndPt, endPt);
+    detourData->requestTime = qcclock_t::now();
+
+    querying = true;
+    pathMaster.QueueRequest(this);
+}
+
+/*
+============
+RecastPather::PathFound
+
+Called by the path master once the requested path is found
+============
+*/
+void RecastPather::PathFound(const dtPolyRef *polys, int nPolys)
+{
+    vec3_t   closestPos;
+    dtStatus status;
+
+    querying              = false;
+    traversingOffMeshLink = false;
+    lastCheckTime         = level.inttime;
+    moving                = false;
+
+    detourData->corridor.reset(detourData->requestStartRef, detourData->requestStartPt);
+
+    if (!nPolys) {
+        return;
+    }
+
+    if (polys[nPolys - 1] != detourData->requestEndRef) {
+        status = navigationMap.GetNavMeshQuery()->closestPointOnPoly(
+            polys[nPolys - 1], detourData->requestEndPt, closestPos, 0
+        );
+        if (dtStatusFailed(status)) {
+            VectorCopy(detourData->requestEndPt, closestPos);
+        }
+    } else {
+        VectorCopy(detourData->requestEndPt, closestPos);
+    }
+
+    moving = true;
+    detourData->corridor.setCorridor(closestPos, polys, nPolys);
+}
+
+RecastPathMaster::RecastPathMaster()
+    : slicedQuery(NULL)
+    , currentRequest(NULL)
+    , numRequests(0)
+    , numCompleted(0)
+    , maxQueueDepth(0)
+    , totalLatency(0)
+    , maxLatency(0)
+    , totalUpdateTime(0)
+    , numUpdates(0)
+{}
+
+RecastPathMaster::~RecastPathMaster()
+{
+    ClearNavigation();
+}
+
+void RecastPathMaster::PostLoadNavigation(const NavigationMap& map)
+{
+    ClearNavigation();
+
+    //
+    // The sliced query keeps its state between frames,
+    // so it has its own query object
+    //
+    slicedQuery = dtAllocNavMeshQuery();
+    if (dtStatusFailed(slicedQuery->init(map.GetNavMesh(), MAX_PATHNODES))) {
+        dtFreeNavMeshQuery(slicedQuery);
+        slicedQuery = NULL;
+    }
+
+    numRequests     = 0;
+    numCompleted    = 0;
+    maxQueueDepth   = 0;
+    totalLatency    = 0;
+    maxLatency      = 0;
+    totalUpdateTime = 0;
+    numUpdates      = 0;
+}
+
+void RecastPathMaster::ClearNavigation()
+{
+    int i;
+
+    for (i = 1; i <= requests.NumObjects(); i++) {
+        requests.ObjectAt(i)->querying = false;
+    }
+    requests.FreeObjectList();
+
+    if (currentRequest) {
+        currentRequest->querying = false;
+        currentRequest           = NULL;
+    }
+
+    if (slicedQuery) {
+        dtFreeNavMeshQuery(slicedQuery);
+        slicedQuery = NULL;
+    }
+}
+
+/*
+============
+RecastPathMaster::QueueRequest
+============
+*/
+void RecastPathMaster::QueueRequest(RecastPather *pather)
+{
+    if (!slicedQuery) {
+        pather->PathFound(NULL, 0);
+        return;
+    }
+
+    if (pather == currentRequest) {
+        // The query in progress is for the previous request
+        currentRequest = NULL;
+    } else if (requests.IndexOfObject(pather)) {
+        // Keep its place in the queue
+        return;
+    }
+
+    requests.AddObject(pather);
+    numRequests++;
+
+    if (requests.NumObjects() > maxQueueDepth) {
+        maxQueueDepth = requests.NumObjects();
+    }
+}
+
+/*
+============
+RecastPathMaster::CancelRequest
+============
+*/
+void RecastPathMaster::CancelRequest(RecastPather *pather)
+{
+    if (!pather->querying) {
+        return;
+    }
+
+    pather->querying = false;
+
+    if (pather == currentRequest) {
+        currentRequest = NULL;
+    } else {
+        requests.RemoveObject(pather);
+    }
+}
+
+/*
+============
+RecastPathMaster::StartNextRequest
+
+Returns false if there are no more requests
+============
+*/
+bool RecastPathMaster::StartNextRequest()
+{
+    const DetourData *data;
+
+    if (!requests.NumObjects()) {
+        return false;
+    }
+
+    currentRequest = requests.ObjectAt(1);
+    requests.RemoveObjectAt(1);
+
+    data = currentRequest->detourData;
+    slicedQuery->initSlicedFindPath(
+        data->requestStartRef,
+        data->requestEndRef,
+        data->requestStartPt,
+        data->requestEndPt,
+        navigationMap.GetQueryFilter()
+    );
+
+    return true;
+}
+
+/*
+============
+RecastPathMaster::FinishRequest
+
+Set the path of the current request, the whole path if it was found, or the best partial path
+============
+*/
+void RecastPathMaster::FinishRequest()
+{
+    RecastPather *pather = currentRequest;
+    dtPolyRef     polys[MAX_NPOLYS];
+    int           nPolys = 0;
+    double        latency;
+
+    currentRequest = NULL;
+
+    if (dtStatusFailed(slicedQuery->finalizeSlicedFindPath(polys, &nPolys, ARRAY_LEN(polys) - 1))) {
+        nPolys = 0;
+    }
+
+    latency = std::chrono::duration<double, std::milli>(qcclock_t::now() - pather->detourData->requestTime).count();
+    totalLatency += latency;
+    if (latency > maxLatency) {
+        maxLatency = latency;
+    }
+    numCompleted++;
+
+    pather->PathFound(polys, nPolys);
+}
+
+/*
+============
+RecastPathMaster::Update
+
+Find the queued paths, until the time budget of the frame is spent
+============
+*/
+void RecastPathMaster::Update()
+{
+    const qctime_t start = qcclock_t::now();
+    const qctimedelta_t budget =
+        std::chrono::duration_cast<qctimedelta_t>(std::chrono::duration<float, std::milli>(sv_navBudgetMs->value));
+    dtStatus status;
+    int      doneIters;
+
+    if (!slicedQuery || (!currentRequest && !requests.NumObjects())) {
+        return;
+    }
+
+    for (;;) {
+        if (!currentRequest && !StartNextRequest()) {
+            break;
+        }
+
+        status = slicedQuery->updateSlicedFindPath(PATH_SLICE_ITERATIONS, &doneIters);
+        if (!dtStatusInProgress(status)) {
+            FinishRequest();
+        }
+
+        // No budget means all the paths are found right away
+        if (budget.count() > 0 && qcclock_t::now() - start >= budget) {
+            break;
+        }
+    }
+
+    totalUpdateTime += std::chrono::duration<double, std::milli>(qcclock_t::now() - start).count();
+    numUpdates++;
+}
+
+/*
+============
+RecastPathMaster::PrintStats
+============
+*/
+void RecastPathMaster::PrintStats() const
+{
+    gi.Printf(
+        "Path queue: %d waiting, %d in progress, %d at most\n",
+        requests.NumObjects(),
+        currentRequest ? 1 : 0,
+        maxQueueDepth
+    );
+    gi.Printf(
+        "Path requests: %d queued, %d found, latency %.2f ms average, %.2f ms max\n",
+        numRequests,
+        numCompleted,
+        numCompleted ? totalLatency / numCompleted : 0.0,
+        maxLatency
+    );
+    gi.Printf(
+        "Time finding paths: %.3f ms average over %d frames (budget %.2f ms)\n",
+        numUpdates ? totalUpdateTime / numUpdates : 0.0,
+        numUpdates,
+        sv_navBudgetMs->value
+    );
+}
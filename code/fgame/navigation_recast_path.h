@@ -24,7 +24,9 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "navigation_path.h"
 
-class dtNavMesh;
+#include "DetourNavMesh.h"
+
+class dtNavMeshQuery;
 class dtPathCorridor;
 class NavigationMap;
 struct DetourData;
@@ -63,11 +65,17 @@ public:
     virtual bool    IsQuerying() const override;
 
 private:
+    friend class RecastPathMaster;
+
     void ResetPosition(const Vector& origin);
+    bool FindStartPoly(const Vector& origin, dtPolyRef& startRef, float *startPt) const;
+    void RequestPath(dtPolyRef startRef, const float *startPt, dtPolyRef endRef, const float *endPt);
+    void PathFound(const dtPolyRef *polys, int nPolys);
 
 private:
     DetourData *detourData;
     bool        moving;
+    bool        querying;
     Vector      lastorg;
     Vector      lastValidOrg;
     Vector      currentNodePos;
@@ -75,12 +83,61 @@ private:
     int         traversingOffMeshLink;
 };
 
+/**
+ * @brief Queue of the path requests, found a few at a time with sliced queries
+ * so a lot of bots asking for a path at once don't make a frame take longer.
+ *
+ */
 class RecastPathMaster
 {
 public:
+    RecastPathMaster();
+    ~RecastPathMaster();
+
     void PostLoadNavigation(const NavigationMap& map);
     void ClearNavigation();
     void Update();
+
+    /**
+     * @brief Queue the request of the pather, the path is set once found.
+     * If the pather already has a request, it's replaced,
+     * the pather itself keeps its request if the goal didn't change.
+     *
+     * @param pather The pather whose request data is set.
+     */
+    void QueueRequest(RecastPather *pather);
+
+    /**
+     * @brief Drop the pending request of the pather, if any.
+     *
+     * @param pather The pather.
+     */
+    void CancelRequest(RecastPather *pather);
+
+    /**
+     * @brief Print the queue depth and the latency of the requests.
+     */
+    void PrintStats() const;
+
+private:
+    bool StartNextRequest();
+    void FinishRequest();
+
+private:
+    dtNavMeshQuery            *slicedQuery;
+    Container<RecastPather *>  requests;
+    RecastPather              *currentRequest;
+
+    //
+    // Stats since the navigation was loaded
+    //
+    int    numRequests;
+    int    numCompleted;
+    int    maxQueueDepth;
+    double totalLatency;
+    double maxLatency;
+    double totalUpdateTime;
+    int    numUpdates;
 };
 
 extern RecastPathMaster pathMaster;
@@ -755,13 +755,20 @@ bool BotController::IsValidEnemy(Sentient *sent) const
 
 bool BotController::CheckCondition_Attack(void)
 {
-    Container<Sentient *> sents       = SentientList;
-    float                 maxDistance = 0;
+    FrameContainer<Sentient *> sents;
+    float                      maxDistance = 0;
+    int                        i;
+
+    // the sorted copy is thrown away at the end of the frame
+    sents.Resize(SentientList.NumObjects());
+    for (i = 1; i <= SentientList.NumObjects(); i++) {
+        sents.AddObject(SentientList.ObjectAt(i));
+    }
 
     bot_origin = controlledEnt->origin;
     sents.Sort(sentients_compare);
 
-    for (int i = 1; i <= sents.NumObjects(); i++) {
+    for (i = 1; i <= sents.NumObjects(); i++) {
         Sentient *sent = sents.ObjectAt(i);
 
         if (!IsValidEnemy(sent)) {
@@ -149,7 +149,7 @@ void BotMovement::MoveThink(usercmd_t& botcmd)
             m_iTempAwayState = 0;
             m_iNumBlocks     = 0;
 
-            if (!m_pPath->GetNodeCount()) {
+            if (!m_pPath->GetNodeCount() && !m_pPath->IsQuerying()) {
                 m_vTargetPos   = controlledEntity->origin + Vector(G_CRandom(512), G_CRandom(512), G_CRandom(512));
                 m_vCurrentGoal = m_vTargetPos;
             }
@@ -538,6 +538,12 @@ void BotMovement::AvoidPath(
 
     NewMove();
 
+    if (m_pPath->IsQuerying()) {
+        // The destination is set once the path is found
+        m_iLastMoveTime = level.inttime;
+        return;
+    }
+
     if (!m_pPath->GetNodeCount()) {
         // Random movements
         m_vTargetPos = controlledEntity->origin + Vector(G_Random(256) - 128, G_Random(256) - 128, G_Random(256) - 128);
@@ -569,6 +575,12 @@ void BotMovement::MoveNear(Vector vNear, float fRadius, float *vLeashHome, float
     m_pPath->FindPathNear(controlledEntity->origin, vNear, fRadius, parameters);
     NewMove();
 
+    if (m_pPath->IsQuerying()) {
+        // The path is still being found, keep pathing until it's there
+        m_iLastMoveTime = level.inttime;
+        return;
+    }
+
     if (!m_pPath->GetNodeCount()) {
         m_bPathing = false;
         return;
@@ -601,6 +613,12 @@ void BotMovement::MoveTo(Vector vPos, float *vLeashHome, float fLeashRadius)
 
     NewMove();
 
+    if (m_pPath->IsQuerying()) {
+        // The path is still being found, keep pathing until it's there
+        m_iLastMoveTime = level.inttime;
+        return;
+    }
+
     if (!m_pPath->GetNodeCount()) {
         m_bPathing = false;
         return;
@@ -997,6 +1015,11 @@ bool BotMovement::MoveDone()
         return false;
     }
 
+    if (m_pPath->IsQuerying()) {
+        // Not done until the path is found
+        return false;
+    }
+
     if (!m_pPath->GetNodeCount()) {
         return true;
     }
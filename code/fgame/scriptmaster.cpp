@@ -884,17 +884,18 @@ GameScript *ScriptMaster::GetGameScriptInternal(str& filename)
 
     m_GameScripts[StringDict.addKeyIndex(filename)] = scr;
 
-    if (GetCompiledScript(scr)) {
-        scr->m_Filename = Director.AddString(filename);
-        return scr;
-    }
-
     sourceLength = gi.FS_ReadFile(filename.c_str(), &sourceBuffer, true);
 
     if (sourceLength == -1) {
         throw ScriptException("Can't find '%s'\n", filename.c_str());
     }
 
+    if (GetCompiledScript(scr, sourceBuffer, sourceLength)) {
+        gi.FS_FreeFile(sourceBuffer);
+        scr->m_Filename = Director.AddString(filename);
+        return scr;
+    }
+
     scr->Load(sourceBuffer, sourceLength);
 
     gi.FS_FreeFile(sourceBuffer);
@@ -903,6 +904,8 @@ GameScript *ScriptMaster::GetGameScriptInternal(str& filename)
         throw ScriptException("Script '%s' was not properly loaded", filename.c_str());
     }
 
+    CacheCompiledScript(scr);
+
     return scr;
 }
 
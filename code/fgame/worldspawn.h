@@ -65,9 +65,6 @@ class con_set_Entry<const_str, ConSimple>
     friend con_set<const_str, ConSimple>;
     friend con_set_enum<const_str, ConSimple>;
 
-private:
-    con_set_Entry *next;
-
 public:
     const_str key;
     ConSimple value;
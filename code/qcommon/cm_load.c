@@ -42,13 +42,6 @@ void SetPlaneSignbits (cplane_t *out) {
 }
 #endif //BSPC
 
-// to allow boxes to be treated as brush models, we allocate
-// some extra indexes along with those needed by the map
-#define	BOX_BRUSHES		1
-#define	BOX_SIDES		6
-#define	BOX_LEAFS		2
-#define	BOX_PLANES		12
-
 #define	LL(x) x=LittleLong(x)
 
 
@@ -66,6 +59,7 @@ cvar_t		*cm_playerCurveClip;
 cvar_t		*cm_FCMcacheall;
 cvar_t		*cm_FCMdebug;
 cvar_t		*cm_ter_usesphere;
+cvar_t		*cm_debugSurfaceUpdate;
 #endif
 
 cmodel_t	box_model;
@@ -270,6 +264,8 @@ void CMod_LoadBrushes( gamelump_t *l ) {
 	dbrush_t	*in;
 	cbrush_t	*out;
 	int			i, count;
+	int			numBatches;
+	csidebatch_t	*batches;
 
 	in = ( dbrush_t * )l->buffer;
 	if (l->length % sizeof(*in)) {
@@ -295,6 +291,21 @@ void CMod_LoadBrushes( gamelump_t *l ) {
 		CM_BoundBrush( out );
 	}
 
+	numBatches = CM_NumSideBatches( BOX_SIDES );
+	for ( i = 0 ; i < count ; i++ ) {
+		numBatches += CM_NumSideBatches( cm.brushes[i].numsides );
+	}
+
+	batches = Hunk_Alloc( numBatches * sizeof( *batches ), h_dontcare );
+
+	for ( i = 0 ; i < count ; i++ ) {
+		cm.brushes[i].batches = batches;
+		CM_SetSideBatches( &cm.brushes[i] );
+		batches += CM_NumSideBatches( cm.brushes[i].numsides );
+	}
+
+	// the box brush gets the last ones
+	cm.brushes[count].batches = batches;
 }
 
 /*
@@ -845,6 +856,7 @@ void CM_LoadMap( const char *name, qboolean clientload, int *checksum ) {
 	cm_FCMcacheall = Cvar_Get( "cm_FCMcacheall", "0", CVAR_CHEAT );
 	cm_FCMdebug = Cvar_Get( "cm_FCMdebug", "0", CVAR_CHEAT );
 	cm_ter_usesphere = Cvar_Get( "cm_ter_usesphere", "1", CVAR_CHEAT );
+	cm_debugSurfaceUpdate = Cvar_Get( "r_debugSurfaceUpdate", "1", 0 );
 #endif
 	Com_DPrintf( "CM_LoadMap( %s, %i )\n", name, clientload );
 
@@ -1170,6 +1182,8 @@ void CM_InitBoxHull (void)
 
 		SetPlaneSignbits( p );
 	}
+
+	CM_SetSideBatches( box_brush );
 }
 
 /*
@@ -1198,6 +1212,7 @@ clipHandle_t CM_TempBoxModel( const vec3_t mins, const vec3_t maxs, int contents
 	VectorCopy( mins, box_brush->bounds[0] );
 	VectorCopy( maxs, box_brush->bounds[1] );
 	box_brush->contents = contents;
+	CM_SetSideBatches( box_brush );
 
 	return BOX_MODEL_HANDLE;
 }
@@ -25,6 +25,11 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "cm_polylib.h"
 #include "cm_terrain.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#	define CM_SSE
+#	include <xmmintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -84,18 +89,27 @@ typedef struct {
 	dsideequation_t		*pEq;
 } cbrushside_t;
 
+// the side planes of each brush are also stored in batches of CM_SIDE_BATCH
+// planes, as a structure of arrays so several planes can be tested at once.
+// the last batch is padded with empty planes
+#define	CM_SIDE_BATCH	4
+
+typedef struct {
+	float		normal[3][CM_SIDE_BATCH];
+	float		dist[CM_SIDE_BATCH];
+} csidebatch_t;
+
 typedef struct {
 	int			shaderNum;		// the shader that determined the contents
 	int			contents;
 	vec3_t		bounds[2];
 	int			numsides;
 	cbrushside_t	*sides;
-	int			checkcount;		// to avoid repeated testings
+	csidebatch_t	*batches;
 } cbrush_t;
 
 
 typedef struct {
-	int			checkcount;				// to avoid repeated testings
 	int			surfaceFlags;
 	int			contents;
 
@@ -106,7 +120,6 @@ typedef struct {
 } cPatch_t;
 
 typedef struct {
-	int checkcount;
 	int surfaceFlags;
 	int contents;
 	int shaderNum;
@@ -182,9 +195,36 @@ typedef struct {
 	cTerrain_t		*terrain;
 
 	int				floodvalid;
-	int				checkcount;					// incremented on each trace
 } clipMap_t;
 
+#if defined(_MSC_VER)
+#	define CM_THREAD_LOCAL	__declspec(thread)
+#elif defined(__cplusplus)
+#	define CM_THREAD_LOCAL	thread_local
+#else
+#	define CM_THREAD_LOCAL	_Thread_local
+#endif
+
+// to allow boxes to be treated as brush models, we allocate
+// some extra indexes along with those needed by the map
+#define	BOX_BRUSHES		1
+#define	BOX_SIDES		6
+#define	BOX_LEAFS		2
+#define	BOX_PLANES		12
+
+// brushes, patches and terrain patches can be in multiple leafs,
+// this marks those that were already tested by the current query.
+// each thread has its own marks so that queries can run in parallel
+typedef struct {
+	int			checkcount;		// incremented on each query
+	int			maxBrushes;
+	int			maxSurfaces;
+	int			maxTerrain;
+	int			*brushes;
+	int			*surfaces;
+	int			*terrain;
+} cmChecks_t;
+
 
 // keep 1/8 unit away to keep the position valid before network snapping
 // and to avoid various numeric issues
@@ -212,6 +252,7 @@ typedef struct {
 	float		radius;
 	int			contents;	// ored contents of the model tracing through
 	qboolean	isPoint;	// optimized case
+	cmChecks_t	*checks;	// tested brushes, patches and terrain patches
 	trace_t		trace;		// returned from trace call
 } traceWork_t;
 
@@ -222,6 +263,7 @@ typedef struct leafList_s {
 	int		*list;
 	vec3_t	bounds[2];
 	int		lastLeaf;		// for overflows where each leaf can't be stored individually
+	cmChecks_t	*checks;	// only for CM_StoreBrushes
 	void	(*storeLeafs)( struct leafList_s *ll, int nodenum );
 } leafList_t;
 
@@ -240,11 +282,188 @@ extern	cvar_t		*cm_playerCurveClip;
 extern	cvar_t		*cm_FCMcacheall;
 extern	cvar_t		*cm_FCMdebug;
 extern	cvar_t		*cm_ter_usesphere;
-extern	sphere_t	sphere;
+extern	CM_THREAD_LOCAL sphere_t	sphere;
+extern	cvar_t		*cm_debugSurfaceUpdate;
 
 
 int CM_BoxBrushes( const vec3_t mins, const vec3_t maxs, cbrush_t **list, int listsize );
 
+#define	CM_NumSideBatches( numsides )	( ( ( numsides ) + CM_SIDE_BATCH - 1 ) / CM_SIDE_BATCH )
+
+/*
+==================
+CM_SetSideBatches
+
+Copies the side planes of the brush into its batches
+==================
+*/
+static ID_INLINE void CM_SetSideBatches( cbrush_t *brush ) {
+	int			i;
+	cplane_t	*plane;
+	csidebatch_t	*batch;
+
+	for ( i = 0 ; i < brush->numsides ; i++ ) {
+		plane = brush->sides[i].plane;
+		batch = &brush->batches[i / CM_SIDE_BATCH];
+
+		batch->normal[0][i % CM_SIDE_BATCH] = plane->normal[0];
+		batch->normal[1][i % CM_SIDE_BATCH] = plane->normal[1];
+		batch->normal[2][i % CM_SIDE_BATCH] = plane->normal[2];
+		batch->dist[i % CM_SIDE_BATCH] = plane->dist;
+	}
+
+	// empty planes are never crossed
+	for ( ; i % CM_SIDE_BATCH ; i++ ) {
+		batch = &brush->batches[i / CM_SIDE_BATCH];
+
+		batch->normal[0][i % CM_SIDE_BATCH] = 0;
+		batch->normal[1][i % CM_SIDE_BATCH] = 0;
+		batch->normal[2][i % CM_SIDE_BATCH] = 0;
+		batch->dist[i % CM_SIDE_BATCH] = 0;
+	}
+}
+
+/*
+==================
+CM_TestSideBatch
+
+Computes the distances of the start and end points to the planes of the batch,
+adjusted for mins/maxs with the offsets, or for the capsule if sphere is set.
+Returns a mask of the planes the trace is completely in front of, in which case
+the trace doesn't intersect the brush.
+Gives the same results as computing the distances plane by plane
+==================
+*/
+static ID_INLINE int CM_TestSideBatch( const csidebatch_t *batch, const vec3_t start, const vec3_t end,
+	const vec3_t offsets[8], const sphere_t *sphere, float *d1, float *d2 ) {
+#ifdef CM_SSE
+	__m128	nx, ny, nz;
+	__m128	dist, t;
+	__m128	v1, v2;
+	__m128	zero = _mm_setzero_ps();
+	__m128	negx, negy, negz;
+
+	nx = _mm_loadu_ps( batch->normal[0] );
+	ny = _mm_loadu_ps( batch->normal[1] );
+	nz = _mm_loadu_ps( batch->normal[2] );
+	dist = _mm_loadu_ps( batch->dist );
+
+	if ( sphere ) {
+		// find the closest point on the capsule to the plane
+		t = _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, _mm_set1_ps( sphere->offset[0] ) ),
+			_mm_mul_ps( ny, _mm_set1_ps( sphere->offset[1] ) ) ),
+			_mm_mul_ps( nz, _mm_set1_ps( sphere->offset[2] ) ) );
+		t = _mm_xor_ps( t, _mm_and_ps( _mm_cmplt_ps( t, zero ), _mm_set1_ps( -0.0f ) ) );
+
+		dist = _mm_add_ps( _mm_add_ps( t, dist ), _mm_set1_ps( sphere->radius ) );
+	} else {
+		// the corner is picked by the sign bits of the normal
+		negx = _mm_cmplt_ps( nx, zero );
+		negy = _mm_cmplt_ps( ny, zero );
+		negz = _mm_cmplt_ps( nz, zero );
+
+		t = _mm_add_ps( _mm_add_ps(
+			_mm_mul_ps( _mm_or_ps( _mm_and_ps( negx, _mm_set1_ps( offsets[1][0] ) ), _mm_andnot_ps( negx, _mm_set1_ps( offsets[0][0] ) ) ), nx ),
+			_mm_mul_ps( _mm_or_ps( _mm_and_ps( negy, _mm_set1_ps( offsets[2][1] ) ), _mm_andnot_ps( negy, _mm_set1_ps( offsets[0][1] ) ) ), ny ) ),
+			_mm_mul_ps( _mm_or_ps( _mm_and_ps( negz, _mm_set1_ps( offsets[4][2] ) ), _mm_andnot_ps( negz, _mm_set1_ps( offsets[0][2] ) ) ), nz ) );
+
+		dist = _mm_sub_ps( dist, t );
+	}
+
+	v1 = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( start[0] ), nx ),
+		_mm_mul_ps( _mm_set1_ps( start[1] ), ny ) ),
+		_mm_mul_ps( _mm_set1_ps( start[2] ), nz ) ), dist );
+	v2 = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( end[0] ), nx ),
+		_mm_mul_ps( _mm_set1_ps( end[1] ), ny ) ),
+		_mm_mul_ps( _mm_set1_ps( end[2] ), nz ) ), dist );
+
+	_mm_storeu_ps( d1, v1 );
+	_mm_storeu_ps( d2, v2 );
+
+	return _mm_movemask_ps( _mm_and_ps( _mm_cmpgt_ps( v1, zero ),
+		_mm_or_ps( _mm_cmpge_ps( v2, _mm_set1_ps( SURFACE_CLIP_EPSILON ) ), _mm_cmpge_ps( v2, v1 ) ) ) );
+#else
+	int		i;
+	int		mask;
+	vec3_t	normal;
+	float	dist;
+	float	t;
+
+	mask = 0;
+	for ( i = 0 ; i < CM_SIDE_BATCH ; i++ ) {
+		normal[0] = batch->normal[0][i];
+		normal[1] = batch->normal[1][i];
+		normal[2] = batch->normal[2][i];
+
+		if ( sphere ) {
+			// find the closest point on the capsule to the plane
+			t = DotProduct( normal, sphere->offset );
+			if ( t < 0 ) {
+				t = -t;
+			}
+
+			dist = t + batch->dist[i] + sphere->radius;
+		} else {
+			dist = batch->dist[i] - DotProduct( offsets[ ( normal[0] < 0 ) | ( ( normal[1] < 0 ) << 1 ) | ( ( normal[2] < 0 ) << 2 ) ], normal );
+		}
+
+		d1[i] = DotProduct( start, normal ) - dist;
+		d2[i] = DotProduct( end, normal ) - dist;
+
+		if ( d1[i] > 0 && ( d2[i] >= SURFACE_CLIP_EPSILON || d2[i] >= d1[i] ) ) {
+			mask |= 1 << i;
+		}
+	}
+
+	return mask;
+#endif
+}
+
+cmChecks_t *CM_BeginChecks( void );
+
+/*
+==================
+CM_CheckBrush
+
+Returns qfalse if the brush was already tested by the current query, and marks it otherwise
+==================
+*/
+static ID_INLINE qboolean CM_CheckBrush( cmChecks_t *checks, int brushnum ) {
+	if ( checks->brushes[brushnum] == checks->checkcount ) {
+		return qfalse;
+	}
+	checks->brushes[brushnum] = checks->checkcount;
+	return qtrue;
+}
+
+/*
+==================
+CM_CheckSurface
+==================
+*/
+static ID_INLINE qboolean CM_CheckSurface( cmChecks_t *checks, int surfacenum ) {
+	if ( checks->surfaces[surfacenum] == checks->checkcount ) {
+		return qfalse;
+	}
+	checks->surfaces[surfacenum] = checks->checkcount;
+	return qtrue;
+}
+
+/*
+==================
+CM_CheckTerrain
+==================
+*/
+static ID_INLINE qboolean CM_CheckTerrain( cmChecks_t *checks, cTerrain_t *terrain ) {
+	int terrainnum = terrain - cm.terrain;
+
+	if ( checks->terrain[terrainnum] == checks->checkcount ) {
+		return qfalse;
+	}
+	checks->terrain[terrainnum] = checks->checkcount;
+	return qtrue;
+}
+
 void CM_StoreLeafs( leafList_t *ll, int nodenum );
 void CM_StoreBrushes( leafList_t *ll, int nodenum );
 
@@ -20,6 +20,9 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 ===========================================================================
 */
 
+#ifndef __CM_PUBLIC_H__
+#define __CM_PUBLIC_H__
+
 #include "qfiles.h"
 #include "q_shared.h"
 
@@ -63,6 +66,20 @@ void		CM_TransformedBoxTrace( trace_t *results, const vec3_t start, const vec3_t
 						  clipHandle_t model, int brushmask,
 						  const vec3_t origin, const vec3_t angles, int cylinder );
 
+typedef struct {
+	vec3_t			start;
+	vec3_t			end;
+	vec3_t			mins;
+	vec3_t			maxs;
+	clipHandle_t	model;
+	int				brushmask;
+	int				cylinder;
+	trace_t			trace;		// result
+} boxTrace_t;
+
+// traces can run on any thread, except against temporary box models
+void		CM_BoxTraceBatch( boxTrace_t *traces, int count, int numThreads );
+
 byte		*CM_ClusterPVS (int cluster);
 
 int			CM_PointLeafnum( const vec3_t p );
@@ -111,3 +128,5 @@ float CM_VisualObfuscation(const vec3_t start, const vec3_t end);
 #ifdef __cplusplus
 }
 #endif
+
+#endif // __CM_PUBLIC_H__
@@ -21,6 +21,48 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 #include "cm_local.h"
 
+static CM_THREAD_LOCAL cmChecks_t cm_checks;
+
+/*
+==================
+CM_GrowChecks
+==================
+*/
+static int *CM_GrowChecks( int *marks, int *maxcount, int count ) {
+	if ( count <= *maxcount ) {
+		return marks;
+	}
+
+	// this may run on worker threads, which can't use the zone
+	free( marks );
+	marks = calloc( count, sizeof( *marks ) );
+	if ( !marks ) {
+		Com_Error( ERR_FATAL, "CM_GrowChecks: failed on allocation of %i marks", count );
+	}
+
+	*maxcount = count;
+	return marks;
+}
+
+/*
+==================
+CM_BeginChecks
+
+Starts a new query on the calling thread, where nothing is marked
+==================
+*/
+cmChecks_t *CM_BeginChecks( void ) {
+	cmChecks_t *checks = &cm_checks;
+
+	// the marks of older maps don't matter, they are smaller than the checkcount
+	checks->brushes = CM_GrowChecks( checks->brushes, &checks->maxBrushes, cm.numBrushes + BOX_BRUSHES );
+	checks->surfaces = CM_GrowChecks( checks->surfaces, &checks->maxSurfaces, cm.numSurfaces );
+	checks->terrain = CM_GrowChecks( checks->terrain, &checks->maxTerrain, cm.numTerrain );
+	checks->checkcount++;
+
+	return checks;
+}
+
 
 /*
 ==================
@@ -101,10 +143,9 @@ void CM_StoreBrushes( leafList_t *ll, int nodenum ) {
 	for ( k = 0 ; k < leaf->numLeafBrushes ; k++ ) {
 		brushnum = cm.leafbrushes[leaf->firstLeafBrush+k];
 		b = &cm.brushes[brushnum];
-		if ( b->checkcount == cm.checkcount ) {
+		if ( !CM_CheckBrush( ll->checks, brushnum ) ) {
 			continue;	// already checked this brush in another leaf
 		}
-		b->checkcount = cm.checkcount;
 		for ( i = 0 ; i < 3 ; i++ ) {
 			if ( b->bounds[0][i] >= ll->bounds[1][i] || b->bounds[1][i] <= ll->bounds[0][i] ) {
 				break;
@@ -171,8 +212,6 @@ CM_BoxLeafnums
 int	CM_BoxLeafnums( const vec3_t mins, const vec3_t maxs, int *list, int listsize, int *lastLeaf) {
 	leafList_t	ll;
 
-	cm.checkcount++;
-
 	VectorCopy( mins, ll.bounds[0] );
 	VectorCopy( maxs, ll.bounds[1] );
 	ll.count = 0;
@@ -196,13 +235,12 @@ CM_BoxBrushes
 int CM_BoxBrushes( const vec3_t mins, const vec3_t maxs, cbrush_t **list, int listsize ) {
 	leafList_t	ll;
 
-	cm.checkcount++;
-
 	VectorCopy( mins, ll.bounds[0] );
 	VectorCopy( maxs, ll.bounds[1] );
 	ll.count = 0;
 	ll.maxcount = listsize;
 	ll.list = (void *)list;
+	ll.checks = CM_BeginChecks();
 	ll.storeLeafs = CM_StoreBrushes;
 	ll.lastLeaf = 0;
 	ll.overflowed = qfalse;
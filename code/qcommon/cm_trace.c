@@ -28,7 +28,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 //#define CAPSULE_DEBUG
 
-sphere_t sphere;
+CM_THREAD_LOCAL sphere_t sphere;
 
 /*
 ===============================================================================
@@ -151,11 +151,8 @@ CM_TestBoxInBrush
 */
 void CM_TestBoxInBrush( traceWork_t *tw, cbrush_t *brush ) {
 	int			i;
-	cplane_t	*plane;
-	float		dist;
-	float		d1;
-	cbrushside_t	*side;
-	float		t;
+	int			mask;
+	float		d1[CM_SIDE_BATCH], d2[CM_SIDE_BATCH];
 
 	if (!brush->numsides) {
 		return;
@@ -172,45 +169,19 @@ void CM_TestBoxInBrush( traceWork_t *tw, cbrush_t *brush ) {
 		return;
 	}
 
-   if ( sphere.use ) {
-		// the first six planes are the axial planes, so we only
-		// need to test the remainder
-		for ( i = 6 ; i < brush->numsides ; i++ ) {
-			side = brush->sides + i;
-			plane = side->plane;
-
-			// find the closest point on the capsule to the plane
-			t = DotProduct( plane->normal, sphere.offset );
-			if( t < 0 )
-			{
-				t = -t;
-			}
-
-			// adjust the plane distance apropriately for radius
-			dist = t + plane->dist + sphere.radius;
-
-			d1 = DotProduct( tw->start, plane->normal ) - dist;
-			// if completely in front of face, no intersection
-			if ( d1 > 0 ) {
-				return;
-			}
+	// the first six planes are the axial planes, so we only
+	// need to test the remainder
+	for ( i = 6 & ~( CM_SIDE_BATCH - 1 ) ; i < brush->numsides ; i += CM_SIDE_BATCH ) {
+		// adjust the plane distance apropriately for mins/maxs, or for the capsule
+		mask = CM_TestSideBatch( &brush->batches[ i / CM_SIDE_BATCH ], tw->start, tw->start, tw->offsets,
+			sphere.use ? &sphere : NULL, d1, d2 );
+		if ( i < 6 ) {
+			mask &= ~( ( 1 << ( 6 - i ) ) - 1 );
 		}
-	} else {
-		// the first six planes are the axial planes, so we only
-		// need to test the remainder
-		for ( i = 6 ; i < brush->numsides ; i++ ) {
-			side = brush->sides + i;
-			plane = side->plane;
-
-			// adjust the plane distance apropriately for mins/maxs
-			dist = plane->dist - DotProduct( tw->offsets[ plane->signbits ], plane->normal );
-
-			d1 = DotProduct( tw->start, plane->normal ) - dist;
 
-			// if completely in front of face, no intersection
-			if ( d1 > 0 ) {
-				return;
-			}
+		// if completely in front of face, no intersection
+		if ( mask ) {
+			return;
 		}
 	}
 
@@ -230,6 +201,7 @@ CM_TestInLeaf
 void CM_TestInLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 	int			k;
 	int			brushnum;
+	int			surfacenum;
 	cbrush_t	*b;
 	cPatch_t	*patch;
 	cTerrain_t	*terrain;
@@ -238,10 +210,9 @@ void CM_TestInLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 	for (k=0 ; k<leaf->numLeafBrushes ; k++) {
 		brushnum = cm.leafbrushes[leaf->firstLeafBrush+k];
 		b = &cm.brushes[brushnum];
-		if (b->checkcount == cm.checkcount) {
+		if ( !CM_CheckBrush( tw->checks, brushnum ) ) {
 			continue;	// already checked this brush in another leaf
 		}
-		b->checkcount = cm.checkcount;
 
 		if ( !(b->contents & tw->contents)) {
 			continue;
@@ -260,14 +231,14 @@ void CM_TestInLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 	if ( !cm_noCurves->integer ) {
 #endif //BSPC
 		for ( k = 0 ; k < leaf->numLeafSurfaces ; k++ ) {
-			patch = cm.surfaces[ cm.leafsurfaces[ leaf->firstLeafSurface + k ] ];
+			surfacenum = cm.leafsurfaces[ leaf->firstLeafSurface + k ];
+			patch = cm.surfaces[ surfacenum ];
 			if ( !patch ) {
 				continue;
 			}
-			if ( patch->checkcount == cm.checkcount ) {
+			if ( !CM_CheckSurface( tw->checks, surfacenum ) ) {
 				continue;	// already checked this brush in another leaf
 			}
-			patch->checkcount = cm.checkcount;
 
 			if ( !(patch->contents & tw->contents)) {
 				continue;
@@ -286,10 +257,9 @@ void CM_TestInLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 		if( !terrain ) {
 			continue;
 		}
-		if( terrain->checkcount == cm.checkcount ) {
+		if( !CM_CheckTerrain( tw->checks, terrain ) ) {
 			continue;
 		}
-		terrain->checkcount = cm.checkcount;
 
 		if( CM_PositionTestInTerrainCollide( tw, &terrain->tc ) ) {
 			tw->trace.fraction = 0;
@@ -432,13 +402,8 @@ void CM_PositionTest( traceWork_t *tw ) {
 	ll.lastLeaf = 0;
 	ll.overflowed = qfalse;
 
-	cm.checkcount++;
-
 	CM_BoxLeafnums_r( &ll, 0 );
 
-
-	cm.checkcount++;
-
 	// test the contents of the leafs
 	for (i=0 ; i < ll.count ; i++) {
 		CM_TestInLeaf( tw, &cm.leafs[leafs[i]] );
@@ -505,15 +470,14 @@ CM_TraceThroughBrush
 ================
 */
 void CM_TraceThroughBrush( traceWork_t *tw, cbrush_t *brush ) {
-	int			i;
+	int			i, j;
+	int			numsides;
 	cplane_t	*plane, *clipplane, *clipplane2;
-	float		dist;
 	float		enterFrac, leaveFrac, leaveFrac2;
-	float		d1, d2;
+	float		d1[CM_SIDE_BATCH], d2[CM_SIDE_BATCH];
 	qboolean	getout, startout;
 	float		f;
 	cbrushside_t	*side, *leadside, *leadside2;
-	float		t;
 
 	if( !brush->numsides ) {
 		return;
@@ -530,104 +494,39 @@ void CM_TraceThroughBrush( traceWork_t *tw, cbrush_t *brush ) {
 
 	leadside = NULL;
 	if( !( brush->contents & CONTENTS_FENCE ) || !tw->isPoint ) {
-		if( sphere.use ) {
-			//
-			// compare the trace against all planes of the brush
-			// find the latest time the trace crosses a plane towards the interior
-			// and the earliest time the trace crosses a plane towards the exterior
-			//
-			for( i = 0; i < brush->numsides; i++ ) {
-				side = brush->sides + i;
-				plane = side->plane;
-
-				// find the closest point on the capsule to the plane
-				t = DotProduct( plane->normal, sphere.offset );
-				if( t < 0 )
-				{
-					t = -t;
-				}
-
-				// adjust the plane distance apropriately for radius
-				dist = t + plane->dist + sphere.radius;
-
-				d1 = DotProduct( tw->start, plane->normal ) - dist;
-				d2 = DotProduct( tw->end, plane->normal ) - dist;
-
-				// if it doesn't cross the plane, the plane isn't relevent
-				if( d1 <= 0 && d2 <= 0 ) {
-					continue;
-				}
-
-				if( d2 > 0 ) {
-					getout = qtrue;	// endpoint is not in solid
-				}
-				if( d1 > 0 ) {
-					startout = qtrue;
-				}
-
+		//
+		// compare the trace against all planes of the brush
+		// find the latest time the trace crosses a plane towards the interior
+		// and the earliest time the trace crosses a plane towards the exterior
+		//
+		for( i = 0; i < brush->numsides; i += CM_SIDE_BATCH ) {
+			// adjust the plane distance apropriately for mins/maxs, or for the capsule
+			if( CM_TestSideBatch( &brush->batches[ i / CM_SIDE_BATCH ], tw->start, tw->end, tw->offsets,
+				sphere.use ? &sphere : NULL, d1, d2 ) ) {
 				// if completely in front of face, no intersection with the entire brush
-				if( d1 > 0 && ( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) ) {
-					return;
-				}
-
-				// crosses face
-				if( d1 > d2 ) {	// enter
-					f = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-					if( f < 0 ) {
-						f = 0;
-					}
-					if( f > enterFrac ) {
-						enterFrac = f;
-						clipplane = plane;
-						leadside = side;
-					}
-				}
-				else {	// leave
-					f = ( d1 + SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-					if( f > 1 ) {
-						f = 1;
-					}
-					if( f < leaveFrac ) {
-						leaveFrac = f;
-					}
-				}
+				return;
 			}
-		} else {
-			//
-			// compare the trace against all planes of the brush
-			// find the latest time the trace crosses a plane towards the interior
-			// and the earliest time the trace crosses a plane towards the exterior
-			//
-			for( i = 0; i < brush->numsides; i++ ) {
-				side = brush->sides + i;
-				plane = side->plane;
 
-				// adjust the plane distance apropriately for mins/maxs
-				dist = plane->dist - DotProduct( tw->offsets[ plane->signbits ], plane->normal );
-
-				d1 = DotProduct( tw->start, plane->normal ) - dist;
-				d2 = DotProduct( tw->end, plane->normal ) - dist;
+			numsides = Q_min( brush->numsides - i, CM_SIDE_BATCH );
+			for( j = 0; j < numsides; j++ ) {
+				side = brush->sides + i + j;
+				plane = side->plane;
 
 				// if it doesn't cross the plane, the plane isn't relevent
-				if( d1 <= 0 && d2 <= 0 ) {
+				if( d1[j] <= 0 && d2[j] <= 0 ) {
 					continue;
 				}
 
-				if( d2 > 0 ) {
+				if( d2[j] > 0 ) {
 					getout = qtrue;	// endpoint is not in solid
 				}
-				if( d1 > 0 ) {
+				if( d1[j] > 0 ) {
 					startout = qtrue;
-
-					// if completely in front of face, no intersection with the entire brush
-					if( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) {
-						return;
-					}
 				}
 
 				// crosses face
-				if( d1 > d2 ) { // enter
-					f = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+				if( d1[j] > d2[j] ) { // enter
+					f = ( d1[j] - SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
 					if( f < 0 ) {
 						f = 0;
 					}
@@ -637,7 +536,7 @@ void CM_TraceThroughBrush( traceWork_t *tw, cbrush_t *brush ) {
 						leadside = side;
 					}
 				} else { // leave
-					f = ( d1 + SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+					f = ( d1[j] + SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
 					if( f > 1 ) {
 						f = 1;
 					}
@@ -687,49 +586,45 @@ void CM_TraceThroughBrush( traceWork_t *tw, cbrush_t *brush ) {
 		// find the latest time the trace crosses a plane towards the interior
 		// and the earliest time the trace crosses a plane towards the exterior
 		//
-		for( i = 0; i < brush->numsides; i++ ) {
-			side = brush->sides + i;
-			plane = side->plane;
-
+		for( i = 0; i < brush->numsides; i += CM_SIDE_BATCH ) {
 			// adjust the plane distance apropriately for mins/maxs
-			dist = plane->dist - DotProduct( tw->offsets[ plane->signbits ], plane->normal );
-
-			d1 = DotProduct( tw->start, plane->normal ) - dist;
-			d2 = DotProduct( tw->end, plane->normal ) - dist;
-
-			// if it doesn't cross the plane, the plane isn't relevent
-			if( d1 <= 0 && d2 <= 0 ) {
-				continue;
-			}
-
-			if( d1 > 0 ) {
+			if( CM_TestSideBatch( &brush->batches[ i / CM_SIDE_BATCH ], tw->start, tw->end, tw->offsets, NULL, d1, d2 ) ) {
 				// if completely in front of face, no intersection with the entire brush
-				if( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) {
-					return;
-				}
+				return;
 			}
 
-			// crosses face
-			if( d1 > d2 ) {	// enter
-				f = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-				if( f < 0 ) {
-					f = 0;
-				}
-				if( f > enterFrac ) {
-					enterFrac = f;
-					clipplane = plane;
-					leadside = side;
-				}
-			} else {	// leave
-				f = ( d1 + SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-				if( f > 1 ) {
-					f = 1;
+			numsides = Q_min( brush->numsides - i, CM_SIDE_BATCH );
+			for( j = 0; j < numsides; j++ ) {
+				side = brush->sides + i + j;
+				plane = side->plane;
+
+				// if it doesn't cross the plane, the plane isn't relevent
+				if( d1[j] <= 0 && d2[j] <= 0 ) {
+					continue;
 				}
-				if( f < leaveFrac ) {
-					leaveFrac = f;
-					clipplane2 = plane;
-					leadside2 = side;
-					leaveFrac2 = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+
+				// crosses face
+				if( d1[j] > d2[j] ) {	// enter
+					f = ( d1[j] - SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
+					if( f < 0 ) {
+						f = 0;
+					}
+					if( f > enterFrac ) {
+						enterFrac = f;
+						clipplane = plane;
+						leadside = side;
+					}
+				} else {	// leave
+					f = ( d1[j] + SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
+					if( f > 1 ) {
+						f = 1;
+					}
+					if( f < leaveFrac ) {
+						leaveFrac = f;
+						clipplane2 = plane;
+						leadside2 = side;
+						leaveFrac2 = ( d1[j] - SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
+					}
 				}
 			}
 		}
@@ -777,17 +672,19 @@ CM_TraceToLeaf
 */
 void CM_TraceToLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 	int k;
+	int brushnum;
+	int surfacenum;
 	cbrush_t *b;
 	cPatch_t *patch;
 	cTerrain_t *terrain;
 
 	// test box position against all brushes in the leaf
 	for( k = 0; k<leaf->numLeafBrushes; k++ ) {
-		b = &cm.brushes[ cm.leafbrushes[ leaf->firstLeafBrush + k ] ];
-		if( b->checkcount == cm.checkcount ) {
+		brushnum = cm.leafbrushes[ leaf->firstLeafBrush + k ];
+		b = &cm.brushes[ brushnum ];
+		if( !CM_CheckBrush( tw->checks, brushnum ) ) {
 			continue;	// already checked this brush in another leaf
 		}
-		b->checkcount = cm.checkcount;
 
 		if( !( b->contents & tw->contents ) ) {
 			continue;
@@ -806,14 +703,14 @@ void CM_TraceToLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 	if( !cm_noCurves->integer ) {
 #endif //BSPC
 		for( k = 0; k < leaf->numLeafSurfaces; k++ ) {
-			patch = cm.surfaces[ cm.leafsurfaces[ leaf->firstLeafSurface + k ] ];
+			surfacenum = cm.leafsurfaces[ leaf->firstLeafSurface + k ];
+			patch = cm.surfaces[ surfacenum ];
 			if( !patch ) {
 				continue;
 			}
-			if( patch->checkcount == cm.checkcount ) {
+			if( !CM_CheckSurface( tw->checks, surfacenum ) ) {
 				continue;	// already checked this brush in another leaf
 			}
-			patch->checkcount = cm.checkcount;
 
 			if( !( patch->contents & tw->contents ) ) {
 				continue;
@@ -832,10 +729,9 @@ void CM_TraceToLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 		if( !terrain ) {
 			continue;
 		}
-		if( terrain->checkcount == cm.checkcount ) {
+		if( !CM_CheckTerrain( tw->checks, terrain ) ) {
 			continue;
 		}
-		terrain->checkcount = cm.checkcount;
 
 		CM_TraceThroughTerrain( tw, terrain );
 		if( !tw->trace.fraction ) {
@@ -1267,13 +1163,12 @@ void CM_BoxTrace( trace_t *results, const vec3_t start, const vec3_t end,
 
 	cmod = CM_ClipHandleToModel( model );
 
-	cm.checkcount++;		// for multi-check avoidance
-
 	c_traces++;				// for statistics, may be zeroed
 
 	// fill in a default trace
 	Com_Memset( &tw, 0, sizeof( tw ) );
 	tw.trace.fraction = 1;	// assume it goes the entire distance until shown otherwise
+	tw.checks = CM_BeginChecks();	// for multi-check avoidance
 
 	// set basic parms
 	tw.trace.location = -1; // clear out unneeded location
@@ -1504,6 +1399,24 @@ void CM_TransformedBoxTrace( trace_t *results, const vec3_t start, const vec3_t
 	*results = trace;
 }
 
+static void CM_BoxTraceJob( void *data, int index ) {
+	boxTrace_t	*bt = &((boxTrace_t *)data)[index];
+
+	CM_BoxTrace( &bt->trace, bt->start, bt->end, bt->mins, bt->maxs, bt->model, bt->brushmask, bt->cylinder );
+}
+
+/*
+==================
+CM_BoxTraceBatch
+
+Runs independent traces on numThreads worker threads.
+The models must not be temporary box models, as they are shared
+==================
+*/
+void CM_BoxTraceBatch( boxTrace_t *traces, int count, int numThreads ) {
+	Com_RunJobs( numThreads, count, CM_BoxTraceJob, traces );
+}
+
 /*
 ================
 CM_SightTraceThroughPatch
@@ -1541,15 +1454,13 @@ CM_SightTraceThroughBrush
 */
 qboolean CM_SightTraceThroughBrush( traceWork_t *tw, cbrush_t *brush )
 {
-	int				i;
-	cplane_t		*plane;
-	float			dist;
+	int				i, j;
+	int				numsides;
 	float			enterFrac, leaveFrac, leaveFrac2;
-	float			d1, d2;
+	float			d1[CM_SIDE_BATCH], d2[CM_SIDE_BATCH];
 	qboolean		startout;
 	float			f;
 	cbrushside_t	*side, *leadside, *leadside2;
-	float			t;
 
 	if( !brush->numsides ) {
 		return qtrue;
@@ -1564,97 +1475,33 @@ qboolean CM_SightTraceThroughBrush( traceWork_t *tw, cbrush_t *brush )
 
 	leadside = NULL;
 	if( !( brush->contents & CONTENTS_FENCE ) || !tw->isPoint ) {
-		if( sphere.use ) {
-			//
-			// compare the trace against all planes of the brush
-			// find the latest time the trace crosses a plane towards the interior
-			// and the earliest time the trace crosses a plane towards the exterior
-			//
-			for( i = 0; i < brush->numsides; i++ ) {
-				side = brush->sides + i;
-				plane = side->plane;
-
-				// find the closest point on the capsule to the plane
-				t = DotProduct( plane->normal, sphere.offset );
-				if( t < 0 )
-				{
-					t = -t;
-				}
-
-				// adjust the plane distance apropriately for radius
-				dist = t + plane->dist + sphere.radius;
-
-				d1 = DotProduct( tw->start, plane->normal ) - dist;
-				d2 = DotProduct( tw->end, plane->normal ) - dist;
-
-				// if it doesn't cross the plane, the plane isn't relevent
-				if( d1 <= 0 && d2 <= 0 ) {
-					continue;
-				}
-
-				if( d1 > 0 ) {
-					startout = qtrue;
-				}
-
+		//
+		// compare the trace against all planes of the brush
+		// find the latest time the trace crosses a plane towards the interior
+		// and the earliest time the trace crosses a plane towards the exterior
+		//
+		for( i = 0; i < brush->numsides; i += CM_SIDE_BATCH ) {
+			// adjust the plane distance apropriately for mins/maxs, or for the capsule
+			if( CM_TestSideBatch( &brush->batches[ i / CM_SIDE_BATCH ], tw->start, tw->end, tw->offsets,
+				sphere.use ? &sphere : NULL, d1, d2 ) ) {
 				// if completely in front of face, no intersection with the entire brush
-				if( d1 > 0 && ( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) ) {
-					return qtrue;
-				}
-
-				// crosses face
-				if( d1 > d2 ) {	// enter
-					f = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-					if( f < 0 ) {
-						f = 0;
-					}
-					if( f > enterFrac ) {
-						enterFrac = f;
-						leadside = side;
-					}
-				}
-				else {	// leave
-					f = ( d1 + SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-					if( f > 1 ) {
-						f = 1;
-					}
-					if( f < leaveFrac ) {
-						leaveFrac = f;
-					}
-				}
+				return qtrue;
 			}
-		} else {
-			//
-			// compare the trace against all planes of the brush
-			// find the latest time the trace crosses a plane towards the interior
-			// and the earliest time the trace crosses a plane towards the exterior
-			//
-			for( i = 0; i < brush->numsides; i++ ) {
-				side = brush->sides + i;
-				plane = side->plane;
-
-				// adjust the plane distance apropriately for mins/maxs
-				dist = plane->dist - DotProduct( tw->offsets[ plane->signbits ], plane->normal );
-
-				d1 = DotProduct( tw->start, plane->normal ) - dist;
-				d2 = DotProduct( tw->end, plane->normal ) - dist;
 
+			numsides = Q_min( brush->numsides - i, CM_SIDE_BATCH );
+			for( j = 0; j < numsides; j++ ) {
 				// if it doesn't cross the plane, the plane isn't relevent
-				if( d1 <= 0 && d2 <= 0 ) {
+				if( d1[j] <= 0 && d2[j] <= 0 ) {
 					continue;
 				}
 
-				if( d1 > 0 ) {
+				if( d1[j] > 0 ) {
 					startout = qtrue;
-
-					// if completely in front of face, no intersection with the entire brush
-					if( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) {
-						return qtrue;
-					}
 				}
 
 				// crosses face
-				if( d1 > d2 ) { // enter
-					f = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+				if( d1[j] > d2[j] ) { // enter
+					f = ( d1[j] - SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
 					if( f < 0 ) {
 						f = 0;
 					}
@@ -1662,7 +1509,7 @@ qboolean CM_SightTraceThroughBrush( traceWork_t *tw, cbrush_t *brush )
 						enterFrac = f;
 					}
 				} else { // leave
-					f = ( d1 + SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+					f = ( d1[j] + SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
 					if( f > 1 ) {
 						f = 1;
 					}
@@ -1694,47 +1541,42 @@ qboolean CM_SightTraceThroughBrush( traceWork_t *tw, cbrush_t *brush )
 		// find the latest time the trace crosses a plane towards the interior
 		// and the earliest time the trace crosses a plane towards the exterior
 		//
-		for( i = 0; i < brush->numsides; i++ ) {
-			side = brush->sides + i;
-			plane = side->plane;
-
+		for( i = 0; i < brush->numsides; i += CM_SIDE_BATCH ) {
 			// adjust the plane distance apropriately for mins/maxs
-			dist = plane->dist - DotProduct( tw->offsets[ plane->signbits ], plane->normal );
-
-			d1 = DotProduct( tw->start, plane->normal ) - dist;
-			d2 = DotProduct( tw->end, plane->normal ) - dist;
-
-			// if it doesn't cross the plane, the plane isn't relevent
-			if( d1 <= 0 && d2 <= 0 ) {
-				continue;
-			}
-
-			if( d1 > 0 ) {
+			if( CM_TestSideBatch( &brush->batches[ i / CM_SIDE_BATCH ], tw->start, tw->end, tw->offsets, NULL, d1, d2 ) ) {
 				// if completely in front of face, no intersection with the entire brush
-				if( d2 >= SURFACE_CLIP_EPSILON || d2 >= d1 ) {
-					return qtrue;
-				}
+				return qtrue;
 			}
 
-			// crosses face
-			if( d1 > d2 ) {	// enter
-				f = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-				if( f < 0 ) {
-					f = 0;
-				}
-				if( f > enterFrac ) {
-					enterFrac = f;
-					leadside = side;
-				}
-			} else {	// leave
-				f = ( d1 + SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
-				if( f > 1 ) {
-					f = 1;
+			numsides = Q_min( brush->numsides - i, CM_SIDE_BATCH );
+			for( j = 0; j < numsides; j++ ) {
+				side = brush->sides + i + j;
+
+				// if it doesn't cross the plane, the plane isn't relevent
+				if( d1[j] <= 0 && d2[j] <= 0 ) {
+					continue;
 				}
-				if( f < leaveFrac ) {
-					leaveFrac = f;
-					leadside2 = side;
-					leaveFrac2 = ( d1 - SURFACE_CLIP_EPSILON ) / ( d1 - d2 );
+
+				// crosses face
+				if( d1[j] > d2[j] ) {	// enter
+					f = ( d1[j] - SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
+					if( f < 0 ) {
+						f = 0;
+					}
+					if( f > enterFrac ) {
+						enterFrac = f;
+						leadside = side;
+					}
+				} else {	// leave
+					f = ( d1[j] + SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
+					if( f > 1 ) {
+						f = 1;
+					}
+					if( f < leaveFrac ) {
+						leaveFrac = f;
+						leadside2 = side;
+						leaveFrac2 = ( d1[j] - SURFACE_CLIP_EPSILON ) / ( d1[j] - d2[j] );
+					}
 				}
 			}
 		}
@@ -1774,17 +1616,19 @@ CM_SightTraceToLeaf
 */
 qboolean CM_SightTraceToLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 	int k;
+	int brushnum;
+	int surfacenum;
 	cbrush_t *b;
 	cPatch_t *patch;
 	cTerrain_t *terrain;
 
 	// test box position against all brushes in the leaf
 	for( k = 0; k<leaf->numLeafBrushes; k++ ) {
-		b = &cm.brushes[ cm.leafbrushes[ leaf->firstLeafBrush + k ] ];
-		if( b->checkcount == cm.checkcount ) {
+		brushnum = cm.leafbrushes[ leaf->firstLeafBrush + k ];
+		b = &cm.brushes[ brushnum ];
+		if( !CM_CheckBrush( tw->checks, brushnum ) ) {
 			continue;	// already checked this brush in another leaf
 		}
-		b->checkcount = cm.checkcount;
 
 		if( !( b->contents & tw->contents ) ) {
 			continue;
@@ -1802,14 +1646,14 @@ qboolean CM_SightTraceToLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 	if( !cm_noCurves->integer ) {
 #endif //BSPC
 		for( k = 0; k < leaf->numLeafSurfaces; k++ ) {
-			patch = cm.surfaces[ cm.leafsurfaces[ leaf->firstLeafSurface + k ] ];
+			surfacenum = cm.leafsurfaces[ leaf->firstLeafSurface + k ];
+			patch = cm.surfaces[ surfacenum ];
 			if( !patch ) {
 				continue;
 			}
-			if( patch->checkcount == cm.checkcount ) {
+			if( !CM_CheckSurface( tw->checks, surfacenum ) ) {
 				continue;	// already checked this brush in another leaf
 			}
-			patch->checkcount = cm.checkcount;
 
 			if( !( patch->contents & tw->contents ) ) {
 				continue;
@@ -1827,10 +1671,9 @@ qboolean CM_SightTraceToLeaf( traceWork_t *tw, cLeaf_t *leaf ) {
 		if( !terrain ) {
 			continue;
 		}
-		if( terrain->checkcount == cm.checkcount ) {
+		if( !CM_CheckTerrain( tw->checks, terrain ) ) {
 			continue;
 		}
-		terrain->checkcount = cm.checkcount;
 
 		if( !CM_SightTraceThroughTerrain( tw, terrain ) ) {
 			return qfalse;
@@ -1968,8 +1811,6 @@ qboolean CM_BoxSightTrace( const vec3_t start, const vec3_t end, const vec3_t mi
 
 	cmod = CM_ClipHandleToModel( model );
 
-	cm.checkcount++;		// for multi-check avoidance
-
 	c_traces++;				// for statistics, may be zeroed
 
 	if( !cm.numNodes ) {
@@ -1979,6 +1820,7 @@ qboolean CM_BoxSightTrace( const vec3_t start, const vec3_t end, const vec3_t mi
 	// fill in a default trace
 	Com_Memset( &tw, 0, sizeof( tw ) );
 	tw.trace.fraction = 1;	// assume it goes the entire distance until shown otherwise
+	tw.checks = CM_BeginChecks();	// for multi-check avoidance
 
 	// set basic parms
 	tw.contents = brushmask;
@@ -321,17 +321,18 @@ CM_ObfuscationTraceToLeaf
 float CM_ObfuscationTraceToLeaf(traceWork_t *tw, cLeaf_t *leaf)
 {
     int       k;
+    int       brushnum;
     cbrush_t *b;
     float     total;
 
     total = 0;
     // test box position against all brushes in the leaf
     for (k = 0; k < leaf->numLeafBrushes; k++) {
-        b = &cm.brushes[cm.leafbrushes[leaf->firstLeafBrush + k]];
-        if (b->checkcount == cm.checkcount) {
+        brushnum = cm.leafbrushes[leaf->firstLeafBrush + k];
+        b        = &cm.brushes[brushnum];
+        if (!CM_CheckBrush(tw->checks, brushnum)) {
             continue; // already checked this brush in another leaf
         }
-        b->checkcount = cm.checkcount;
 
         if (!(b->contents & CONTENTS_DONOTENTER)) {
             continue;
@@ -455,7 +456,7 @@ float CM_ObfuscationTrace(const vec3_t start, const vec3_t end, clipHandle_t han
     model = CM_ClipHandleToModel(handle);
 
     c_traces++;
-    cm.checkcount++;
+    tw.checks = CM_BeginChecks();
 
     VectorCopy(start, tw.start);
     VectorCopy(end, tw.end);
@@ -483,6 +483,7 @@ void Cmd_WriteAliases( fileHandle_t f )
 typedef struct cmd_function_s
 {
 	struct cmd_function_s	*next;
+	struct cmd_function_s	*hashNext;
 	const char				*name;
 	xcommand_t				function;
 	completionFunc_t	complete;
@@ -496,6 +497,14 @@ static	char		cmd_cmd[BIG_INFO_STRING]; // the original command we received (no t
 
 static	cmd_function_t	*cmd_functions;		// possible commands to execute
 
+#define	CMD_HASH_SIZE	512
+static	cmd_function_t	*cmd_hashTable[CMD_HASH_SIZE];
+
+static	cmd_function_t	**cmd_sorted;		// cmd_functions ordered by name, for completion
+static	int				cmd_numSorted;
+static	int				cmd_maxSorted;
+static	qboolean		cmd_sortedValid;
+
 /*
 ============
 Cmd_Argc
@@ -759,6 +768,101 @@ void Cmd_TokenizeStringIgnoreQuotes( const char *text_in ) {
 	Cmd_TokenizeString2( text_in, qtrue );
 }
 
+/*
+============
+Cmd_HashValue
+
+Folds case, so that names differing only in case share a chain
+============
+*/
+static unsigned int Cmd_HashValue( const char *name ) {
+	unsigned int	hash;
+
+	hash = 0;
+	while( *name ) {
+		hash = hash * 31 + tolower( *( const unsigned char * )name );
+		name++;
+	}
+	return hash & ( CMD_HASH_SIZE - 1 );
+}
+
+/*
+============
+Cmd_CompareNames
+============
+*/
+static int QDECL Cmd_CompareNames( const void *a, const void *b ) {
+	return Q_stricmp( ( *( cmd_function_t ** )a )->name, ( *( cmd_function_t ** )b )->name );
+}
+
+/*
+============
+Cmd_SortCommands
+
+Rebuilds the sorted index after commands were added or removed
+============
+*/
+static void Cmd_SortCommands( void ) {
+	cmd_function_t	*cmd;
+	int				count;
+
+	if( cmd_sortedValid ) {
+		return;
+	}
+
+	count = 0;
+	for( cmd = cmd_functions; cmd; cmd = cmd->next ) {
+		count++;
+	}
+
+	if( count > cmd_maxSorted ) {
+		if( cmd_sorted ) {
+			Z_Free( cmd_sorted );
+		}
+		cmd_maxSorted = count + 64;
+		cmd_sorted = Z_TagMalloc( cmd_maxSorted * sizeof( *cmd_sorted ), TAG_STRINGS_AND_COMMANDS );
+	}
+
+	cmd_numSorted = 0;
+	for( cmd = cmd_functions; cmd; cmd = cmd->next ) {
+		cmd_sorted[cmd_numSorted++] = cmd;
+	}
+
+	qsort( cmd_sorted, cmd_numSorted, sizeof( *cmd_sorted ), Cmd_CompareNames );
+	cmd_sortedValid = qtrue;
+}
+
+/*
+============
+Cmd_FindSortedPrefix
+
+Returns the index of the first sorted command starting with partial,
+or cmd_numSorted if there is none
+============
+*/
+static int Cmd_FindSortedPrefix( const char *partial, size_t len ) {
+	int		low, high, mid;
+
+	Cmd_SortCommands();
+
+	low = 0;
+	high = cmd_numSorted;
+	while( low < high ) {
+		mid = ( low + high ) / 2;
+		if( Q_stricmpn( cmd_sorted[mid]->name, partial, len ) < 0 ) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	if( low < cmd_numSorted && Q_stricmpn( cmd_sorted[low]->name, partial, len ) ) {
+		return cmd_numSorted;
+	}
+
+	return low;
+}
+
 /*
 ============
 Cmd_FindCommand
@@ -767,7 +871,7 @@ Cmd_FindCommand
 cmd_function_t *Cmd_FindCommand( const char *cmd_name )
 {
 	cmd_function_t *cmd;
-	for( cmd = cmd_functions; cmd; cmd = cmd->next )
+	for( cmd = cmd_hashTable[Cmd_HashValue( cmd_name )]; cmd; cmd = cmd->hashNext )
 		if( !Q_stricmp( cmd_name, cmd->name ) )
 			return cmd;
 	return NULL;
@@ -780,6 +884,7 @@ Cmd_AddCommand
 */
 void	Cmd_AddCommand( const char *cmd_name, xcommand_t function ) {
 	cmd_function_t	*cmd;
+	unsigned int	hash;
 	
 	// fail if the command already exists
 	if( Cmd_FindCommand( cmd_name ) )
@@ -797,6 +902,12 @@ void	Cmd_AddCommand( const char *cmd_name, xcommand_t function ) {
 	cmd->complete = NULL;
 	cmd->next = cmd_functions;
 	cmd_functions = cmd;
+
+	hash = Cmd_HashValue( cmd_name );
+	cmd->hashNext = cmd_hashTable[hash];
+	cmd_hashTable[hash] = cmd;
+
+	cmd_sortedValid = qfalse;
 }
 
 /*
@@ -807,11 +918,9 @@ Cmd_SetCommandCompletionFunc
 void Cmd_SetCommandCompletionFunc( const char *command, completionFunc_t complete ) {
 	cmd_function_t	*cmd;
 
-	for( cmd = cmd_functions; cmd; cmd = cmd->next ) {
-		if( !Q_stricmp( command, cmd->name ) ) {
-			cmd->complete = complete;
-			return;
-		}
+	cmd = Cmd_FindCommand( command );
+	if( cmd ) {
+		cmd->complete = complete;
 	}
 }
 
@@ -823,7 +932,8 @@ Cmd_RemoveCommand
 void	Cmd_RemoveCommand( const char *cmd_name ) {
 	cmd_function_t	*cmd, **back;
 
-	back = &cmd_functions;
+	// the hash is case-folded, so an exact match is in the same chain
+	back = &cmd_hashTable[Cmd_HashValue( cmd_name )];
 	while( 1 ) {
 		cmd = *back;
 		if ( !cmd ) {
@@ -831,15 +941,23 @@ void	Cmd_RemoveCommand( const char *cmd_name ) {
 			return;
 		}
 		if ( !strcmp( cmd_name, cmd->name ) ) {
-			*back = cmd->next;
-			if (cmd->name) {
-				Z_Free( ( void * )cmd->name );
-			}
-			Z_Free (cmd);
-			return;
+			*back = cmd->hashNext;
+			break;
 		}
-		back = &cmd->next;
+		back = &cmd->hashNext;
+	}
+
+	for( back = &cmd_functions; *back != cmd; back = &( *back )->next ) {
 	}
+	*back = cmd->next;
+
+	// the sorted index must not keep pointing to the freed command
+	cmd_sortedValid = qfalse;
+
+	if (cmd->name) {
+		Z_Free( ( void * )cmd->name );
+	}
+	Z_Free (cmd);
 }
 
 /*
@@ -886,13 +1004,9 @@ Cmd_CompleteArgument
 void Cmd_CompleteArgument( const char *command, char *args, int argNum ) {
 	cmd_function_t	*cmd;
 
-	for( cmd = cmd_functions; cmd; cmd = cmd->next ) {
-		if( !Q_stricmp( command, cmd->name ) ) {
-			if ( cmd->complete ) {
-				cmd->complete( args, argNum );
-			}
-			return;
-		}
+	cmd = Cmd_FindCommand( command );
+	if( cmd && cmd->complete ) {
+		cmd->complete( args, argNum );
 	}
 }
 
@@ -907,24 +1021,21 @@ const char *Cmd_CompleteCommand( const char *partial )
 	size_t len;
 	cmd_function_t *cmd;
 	cmdalias_t *a;
+	int i;
 
 	len = strlen( partial );
 	if( !len ) {
 		return NULL;
 	}
 
-	for( cmd = cmd_functions; cmd != NULL; cmd = cmd->next )
-	{
-		if( !Q_stricmp( partial, cmd->name ) ) {
-			return cmd->name;
-		}
+	cmd = Cmd_FindCommand( partial );
+	if( cmd ) {
+		return cmd->name;
 	}
 
-	for( cmd = cmd_functions; cmd != NULL; cmd = cmd->next )
-	{
-		if( !Q_stricmpn( partial, cmd->name, len ) ) {
-			return cmd->name;
-		}
+	i = Cmd_FindSortedPrefix( partial, len );
+	if( i < cmd_numSorted ) {
+		return cmd_sorted[i]->name;
 	}
 
 	for( a = cmd_alias; a != NULL; a = a->next )
@@ -945,23 +1056,24 @@ Cmd_CompleteCommandByNumber
 const char *Cmd_CompleteCommandByNumber( const char *partial, int number )
 {
 	size_t len;
-	cmd_function_t *cmd;
 	cmdalias_t *a;
+	int i;
 
 	len = strlen( partial );
 	if( !len ) {
 		return NULL;
 	}
 
-	for( cmd = cmd_functions; cmd != NULL; cmd = cmd->next )
+	// matching commands are contiguous in the sorted index
+	for( i = Cmd_FindSortedPrefix( partial, len ); i < cmd_numSorted; i++ )
 	{
-		if( !strncmp( partial, cmd->name, len ) )
-		{
-			if( !number ) {
-				return cmd->name;
-			}
-			number--;
+		if( Q_stricmpn( partial, cmd_sorted[i]->name, len ) ) {
+			break;
 		}
+		if( !number ) {
+			return cmd_sorted[i]->name;
+		}
+		number--;
 	}
 
 	for( a = cmd_alias; a != NULL; a = a->next )
@@ -986,7 +1098,7 @@ A complete command line has been parsed, so try to execute it
 ============
 */
 void	Cmd_ExecuteString( const char *text ) {	
-	cmd_function_t	*cmd, **prev;
+	cmd_function_t	*cmd;
 	cmdalias_t		*a;
 
 	// execute the command line
@@ -995,25 +1107,13 @@ void	Cmd_ExecuteString( const char *text ) {
 		return;		// no tokens
 	}
 
-	// check registered command functions	
-	for ( prev = &cmd_functions ; *prev ; prev = &cmd->next ) {
-		cmd = *prev;
-		if ( !Q_stricmp( cmd_argv[0],cmd->name ) ) {
-			// rearrange the links so that the command will be
-			// near the head of the list next time it is used
-			*prev = cmd->next;
-			cmd->next = cmd_functions;
-			cmd_functions = cmd;
-
-			// perform the action
-			if ( !cmd->function ) {
-				// let the cgame or game handle it
-				break;
-			} else {
-				cmd->function ();
-			}
-			return;
-		}
+	// check registered command functions
+	// commands without a function are handled by the cgame or game
+	cmd = Cmd_FindCommand( cmd_argv[0] );
+	if ( cmd && cmd->function ) {
+		// perform the action
+		cmd->function ();
+		return;
 	}
 
 	for( a = cmd_alias; a != NULL; a = a->next )
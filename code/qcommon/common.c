@@ -121,6 +121,7 @@ cvar_t	*com_legacyprotocol;
 cvar_t	*com_basegame;
 cvar_t  *com_homepath;
 cvar_t	*com_busyWait;
+cvar_t	*com_msgstats;
 #ifndef DEDICATED
 cvar_t  *con_autochat;
 #endif
@@ -1915,6 +1916,8 @@ void Com_Init( char *commandLine ) {
 	com_maxfpsMinimized = Cvar_Get( "com_maxfpsMinimized", "0", CVAR_ARCHIVE );
 	com_abnormalExit = Cvar_Get( "com_abnormalExit", "0", CVAR_ROM );
 	com_busyWait = Cvar_Get("com_busyWait", "0", CVAR_ARCHIVE);
+	// gather the message statistics reported by changeVectors
+	com_msgstats = Cvar_Get("com_msgstats", "0", 0);
 
 	if( com_dedicated->integer )
 	{
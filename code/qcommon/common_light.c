@@ -70,3 +70,17 @@ void QDECL Com_Error(int code, const char *fmt, ...)
 
     fprintf(stderr, "%s", text);
 }
+
+#ifdef ZONE_DEBUG
+void *Z_MallocDebug(int size, const char *label, const char *file, int line)
+#else
+void *Z_Malloc(int size)
+#endif
+{
+    return calloc(1, size);
+}
+
+void Z_Free(void *ptr)
+{
+    free(ptr);
+}
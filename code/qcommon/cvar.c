@@ -35,6 +35,10 @@ int			cvar_numIndexes;
 #define FILE_HASH_SIZE		256
 static	cvar_t	*hashTable[FILE_HASH_SIZE];
 
+static	cvar_t		*cvar_sorted[MAX_CVARS];	// cvar_vars ordered by name, for completion
+static	int			cvar_numSorted;
+static	qboolean	cvar_sortedValid;
+
 qboolean cvar_global_force = qfalse;
 
 static void Cvar_FlagsCheck(int flags);
@@ -303,6 +307,56 @@ static const char *Cvar_Validate( cvar_t *var,
 }
 
 
+/*
+============
+Cvar_CompareNames
+============
+*/
+static int QDECL Cvar_CompareNames( const void *a, const void *b ) {
+	return Q_stricmp( ( *( cvar_t ** )a )->name, ( *( cvar_t ** )b )->name );
+}
+
+/*
+============
+Cvar_FindSortedPrefix
+
+Returns the index of the first sorted cvar starting with partial,
+or cvar_numSorted if there is none. The index is rebuilt after cvars
+were created or unset
+============
+*/
+static int Cvar_FindSortedPrefix( const char *partial, size_t len ) {
+	cvar_t	*cvar;
+	int		low, high, mid;
+
+	if( !cvar_sortedValid ) {
+		cvar_numSorted = 0;
+		for( cvar = cvar_vars; cvar != NULL; cvar = cvar->next ) {
+			cvar_sorted[cvar_numSorted++] = cvar;
+		}
+
+		qsort( cvar_sorted, cvar_numSorted, sizeof( *cvar_sorted ), Cvar_CompareNames );
+		cvar_sortedValid = qtrue;
+	}
+
+	low = 0;
+	high = cvar_numSorted;
+	while( low < high ) {
+		mid = ( low + high ) / 2;
+		if( Q_stricmpn( cvar_sorted[mid]->name, partial, len ) < 0 ) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	if( low < cvar_numSorted && Q_stricmpn( cvar_sorted[low]->name, partial, len ) ) {
+		return cvar_numSorted;
+	}
+
+	return low;
+}
+
 /*
 ============
 Cvar_CompleteVariable
@@ -312,24 +366,21 @@ const char *Cvar_CompleteVariable( const char *partial )
 {
 	cvar_t *cvar;
 	size_t len;
+	int i;
 
 	len = strlen( partial );
 	if( !len ) {
 		return NULL;
 	}
 
-	for( cvar = cvar_vars; cvar != NULL; cvar = cvar->next )
-	{
-		if( !Q_stricmp( partial, cvar->name ) ) {
-			return cvar->name;
-		}
+	cvar = Cvar_FindVar( partial );
+	if( cvar ) {
+		return cvar->name;
 	}
 
-	for( cvar = cvar_vars; cvar != NULL; cvar = cvar->next )
-	{
-		if( !Q_stricmpn( partial, cvar->name, len ) ) {
-			return cvar->name;
-		}
+	i = Cvar_FindSortedPrefix( partial, len );
+	if( i < cvar_numSorted ) {
+		return cvar_sorted[i]->name;
 	}
 
 	return NULL;
@@ -342,23 +393,24 @@ Cvar_CompleteVariableByNumber
 */
 const char *Cvar_CompleteVariableByNumber( const char *partial, int number )
 {
-	cvar_t *cvar;
 	size_t len;
+	int i;
 
 	len = strlen( partial );
 	if( !len ) {
 		return NULL;
 	}
 
-	for( cvar = cvar_vars; cvar != NULL; cvar = cvar->next )
+	// matching cvars are contiguous in the sorted index
+	for( i = Cvar_FindSortedPrefix( partial, len ); i < cvar_numSorted; i++ )
 	{
-		if( !Q_stricmpn( partial, cvar->name, len ) )
-		{
-			if( !number ) {
-				return cvar->name;
-			}
-			number--;
+		if( Q_stricmpn( partial, cvar_sorted[i]->name, len ) ) {
+			break;
+		}
+		if( !number ) {
+			return cvar_sorted[i]->name;
 		}
+		number--;
 	}
 
 	return NULL;
@@ -541,6 +593,8 @@ cvar_t *Cvar_Get( const char *var_name, const char *var_value, int flags ) {
 	var->hashPrev = NULL;
 	hashTable[hash] = var;
 
+	cvar_sortedValid = qfalse;
+
 	return var;
 }
 
@@ -1439,6 +1493,8 @@ cvar_t *Cvar_Unset(cvar_t *cv)
 	if(cv->hashNext)
 		cv->hashNext->hashPrev = cv->hashPrev;
 
+	cvar_sortedValid = qfalse;
+
 	Com_Memset(cv, '\0', sizeof(*cv));
 	
 	return next;
@@ -27,7 +27,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "q_shared.h"
 #include "qcommon.h"
 
-static int			bloc = 0;
+// snapshots are encoded by multiple threads
+static thread_local int	bloc = 0;
 
 void	Huff_putBit( int bit, byte *fout, int *offset) {
 	bloc = *offset;
@@ -340,6 +341,34 @@ void Huff_offsetTransmit (huff_t *huff, int ch, byte *fout, int *offset, int max
 	*offset = bloc;
 }
 
+/* Get the prefix code of every symbol, for trees that are no longer updated.
+ * Returns qfalse if a symbol is missing or its code is longer than 32 bits */
+qboolean Huff_BuildCodes (huff_t *huff, huffCode_t *codes) {
+	node_t	*node;
+	int		ch;
+
+	for (ch = 0; ch < HMAX; ch++) {
+		codes[ch].bits = 0;
+		codes[ch].length = 0;
+
+		node = huff->loc[ch];
+		if (!node) {
+			return qfalse;
+		}
+
+		/* walk up from the leaf, the bit of the root is sent first */
+		for (; node->parent; node = node->parent) {
+			if (codes[ch].length == 32) {
+				return qfalse;
+			}
+			codes[ch].bits = (codes[ch].bits << 1) | (node->parent->right == node);
+			codes[ch].length++;
+		}
+	}
+
+	return qtrue;
+}
+
 void Huff_Decompress(msg_t *mbuf, int offset) {
 	int			ch, i, j;
 	size_t		cch;
@@ -0,0 +1,221 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// jobs.cpp: Worker threads running independent jobs in parallel
+
+#include "q_shared.h"
+#include "qcommon.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobPool
+{
+public:
+    JobPool(int numThreads);
+    ~JobPool();
+
+    void Run(int count, jobFunc_t func, void *data);
+    int  NumThreads() const;
+
+private:
+    void WorkerThread();
+    void RunJobs();
+
+private:
+    std::vector<std::thread> threads;
+    std::mutex               mutex;
+    std::condition_variable  wake;
+    std::condition_variable  done;
+    unsigned int             generation;
+    int                      busyThreads;
+    bool                     shouldExit;
+
+    //
+    // Current batch
+    //
+    jobFunc_t        jobFunc;
+    void            *jobData;
+    int              jobCount;
+    std::atomic<int> nextJob;
+};
+
+static JobPool   *jobPool;
+static std::mutex jobLock;
+
+JobPool::JobPool(int numThreads)
+{
+    int i;
+
+    generation  = 0;
+    busyThreads = 0;
+    shouldExit  = false;
+    jobFunc     = NULL;
+    jobData     = NULL;
+    jobCount    = 0;
+    nextJob     = 0;
+
+    for (i = 0; i < numThreads; i++) {
+        threads.emplace_back(&JobPool::WorkerThread, this);
+    }
+}
+
+JobPool::~JobPool()
+{
+    size_t i;
+
+    {
+        std::lock_guard<std::mutex> l(mutex);
+        shouldExit = true;
+        wake.notify_all();
+    }
+
+    for (i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+int JobPool::NumThreads() const
+{
+    return (int)threads.size();
+}
+
+void JobPool::RunJobs()
+{
+    int index;
+
+    for (index = nextJob++; index < jobCount; index = nextJob++) {
+        jobFunc(jobData, index);
+    }
+}
+
+void JobPool::WorkerThread()
+{
+    unsigned int lastGeneration = 0;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> l(mutex);
+            wake.wait(l, [&] { return shouldExit || generation != lastGeneration; });
+
+            if (shouldExit) {
+                return;
+            }
+
+            lastGeneration = generation;
+        }
+
+        RunJobs();
+
+        {
+            std::lock_guard<std::mutex> l(mutex);
+            if (--busyThreads == 0) {
+                done.notify_one();
+            }
+        }
+    }
+}
+
+void JobPool::Run(int count, jobFunc_t func, void *data)
+{
+    {
+        std::lock_guard<std::mutex> l(mutex);
+
+        jobFunc     = func;
+        jobData     = data;
+        jobCount    = count;
+        nextJob     = 0;
+        busyThreads = (int)threads.size();
+        generation++;
+
+        wake.notify_all();
+    }
+
+    // the calling thread takes jobs too
+    RunJobs();
+
+    {
+        std::unique_lock<std::mutex> l(mutex);
+        done.wait(l, [&] { return busyThreads == 0; });
+    }
+}
+
+/*
+=================
+Com_RunJobs
+
+Calls func for each index in [0, count), using numThreads worker threads
+in addition to the calling thread. Returns once all jobs are done.
+Jobs must not call Com_Error or Com_Printf, and must use Com_LockJobs
+around code that isn't re-entrant
+=================
+*/
+void Com_RunJobs(int numThreads, int count, jobFunc_t func, void *data)
+{
+    int i;
+
+    if (numThreads <= 0 || count <= 1) {
+        for (i = 0; i < count; i++) {
+            func(data, i);
+        }
+        return;
+    }
+
+    if (jobPool && jobPool->NumThreads() != numThreads) {
+        delete jobPool;
+        jobPool = NULL;
+    }
+
+    if (!jobPool) {
+        jobPool = new JobPool(numThreads);
+    }
+
+    jobPool->Run(count, func, data);
+}
+
+/*
+=================
+Com_ShutdownJobs
+
+Stops the worker threads
+=================
+*/
+void Com_ShutdownJobs(void)
+{
+    if (jobPool) {
+        delete jobPool;
+        jobPool = NULL;
+    }
+}
+
+void Com_LockJobs(void)
+{
+    jobLock.lock();
+}
+
+void Com_UnlockJobs(void)
+{
+    jobLock.unlock();
+}
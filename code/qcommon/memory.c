@@ -31,6 +31,30 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #define	ZONEID			0x7331
 #define ZONEID_CONST	0xC057
+#define ZONEID_ARENA	0x7332		// carved out of an arena chunk
+
+//
+// Tags that are only freed all at once live in big chunks,
+// so Z_FreeTags throws away a few chunks instead of each block
+//
+#ifdef ZONE_DEBUG
+// each block is allocated on its own in debug, so memory tools can check each of them
+#define Z_IsArenaTag( tag )		qfalse
+#else
+#define Z_IsArenaTag( tag )		( ( tag ) == TAG_STATIC || ( tag ) == TAG_STATIC_RENDERER )
+#endif
+
+#define ZONE_CHUNK_SIZE			( 1024 * 1024 )
+#define ZONE_CHUNK_ALIGN		16
+
+//
+// Small blocks of the other tags are kept on free lists by size
+// and reused instead of going back to the system
+//
+#define ZONE_SMALL_ALIGN		32
+#define ZONE_SMALL_MAX			512
+#define ZONE_SMALL_CLASSES		( ZONE_SMALL_MAX / ZONE_SMALL_ALIGN )
+#define ZONE_SMALL_MAXFREE		512		// blocks kept per size class
 
 void Z_CheckHeap(void);
 
@@ -70,7 +94,190 @@ memconstant_t numberstring[] =
 	{ {sizeof( memconstant_t ), NULL, NULL, ZONEID_CONST}, {'9', 0} },
 };
 
+typedef struct memchunk_s {
+	struct memchunk_s	*next;
+	size_t				size;			// including the header
+	size_t				used;
+} memchunk_t;
+
+#define CHUNK_HEADER_SIZE	PAD( sizeof( memchunk_t ), ZONE_CHUNK_ALIGN )
+
 static memblock_t mem_blocks[ TAG_NUM_TOTAL_TAGS ];
+static memchunk_t *mem_chunks[ TAG_NUM_TOTAL_TAGS ];	// the first one is being filled
+
+static memblock_t *mem_freeSmall[ ZONE_SMALL_CLASSES ];
+static int mem_numFreeSmall[ ZONE_SMALL_CLASSES ];
+
+/*
+========================
+Z_ArenaAlloc
+
+Bump allocation from the current chunk of the tag
+========================
+*/
+static memblock_t *Z_ArenaAlloc( int tag, size_t size )
+{
+	memchunk_t *chunk;
+	memblock_t *block;
+
+	size = PAD( size, ZONE_CHUNK_ALIGN );
+	chunk = mem_chunks[ tag ];
+
+	if( !chunk || chunk->used + size > chunk->size )
+	{
+		if( CHUNK_HEADER_SIZE + size > ZONE_CHUNK_SIZE / 4 )
+		{
+			// too big to share a chunk, give it its own and keep filling the current one
+			chunk = ( memchunk_t * )malloc( CHUNK_HEADER_SIZE + size );
+			if( !chunk ) {
+				Com_Error( ERR_FATAL, "Z_TagMalloc: failed on allocation of %zu bytes", size );
+			}
+
+			chunk->size = CHUNK_HEADER_SIZE + size;
+			chunk->used = chunk->size;
+
+			if( mem_chunks[ tag ] ) {
+				chunk->next = mem_chunks[ tag ]->next;
+				mem_chunks[ tag ]->next = chunk;
+			} else {
+				chunk->next = NULL;
+				mem_chunks[ tag ] = chunk;
+			}
+
+			block = ( memblock_t * )( ( byte * )chunk + CHUNK_HEADER_SIZE );
+			block->size = size;
+			return block;
+		}
+
+		chunk = ( memchunk_t * )malloc( ZONE_CHUNK_SIZE );
+		if( !chunk ) {
+			Com_Error( ERR_FATAL, "Z_TagMalloc: failed on allocation of %i bytes", ZONE_CHUNK_SIZE );
+		}
+
+		chunk->size = ZONE_CHUNK_SIZE;
+		chunk->used = CHUNK_HEADER_SIZE;
+		chunk->next = mem_chunks[ tag ];
+		mem_chunks[ tag ] = chunk;
+	}
+
+	block = ( memblock_t * )( ( byte * )chunk + chunk->used );
+	block->size = size;
+	chunk->used += size;
+
+	return block;
+}
+
+/*
+========================
+Z_FreeArena
+
+Free all the chunks of the tag but the current one, which is reused
+========================
+*/
+static void Z_FreeArena( int tag, qboolean all )
+{
+	memchunk_t *chunk;
+	memchunk_t *next;
+
+	chunk = mem_chunks[ tag ];
+	if( !chunk ) {
+		return;
+	}
+
+	for( next = chunk->next; next; next = chunk->next )
+	{
+		chunk->next = next->next;
+		free( next );
+	}
+
+	if( all || chunk->size != ZONE_CHUNK_SIZE ) {
+		free( chunk );
+		mem_chunks[ tag ] = NULL;
+	} else {
+		chunk->used = CHUNK_HEADER_SIZE;
+	}
+}
+
+#ifndef ZONE_DEBUG
+/*
+========================
+Z_SmallAlloc
+
+size is a multiple of ZONE_SMALL_ALIGN
+========================
+*/
+static memblock_t *Z_SmallAlloc( size_t size )
+{
+	int sizeClass = ( int )( size / ZONE_SMALL_ALIGN ) - 1;
+	memblock_t *block;
+
+	block = mem_freeSmall[ sizeClass ];
+	if( block ) {
+		mem_freeSmall[ sizeClass ] = block->next;
+		mem_numFreeSmall[ sizeClass ]--;
+		return block;
+	}
+
+	block = ( memblock_t * )malloc( size );
+	if( !block ) {
+		Com_Error( ERR_FATAL, "Z_TagMalloc: failed on allocation of %zu bytes", size );
+	}
+
+	block->size = size;
+	return block;
+}
+#endif
+
+/*
+========================
+Z_ReleaseBlock
+
+Give a malloc'd block back, small blocks go to the free list of their size
+========================
+*/
+static void Z_ReleaseBlock( memblock_t *block )
+{
+#ifndef ZONE_DEBUG
+	int sizeClass;
+
+	if( block->size <= ZONE_SMALL_MAX )
+	{
+		sizeClass = ( int )( block->size / ZONE_SMALL_ALIGN ) - 1;
+
+		if( mem_numFreeSmall[ sizeClass ] < ZONE_SMALL_MAXFREE )
+		{
+			block->id = 0;
+			block->next = mem_freeSmall[ sizeClass ];
+			mem_freeSmall[ sizeClass ] = block;
+			mem_numFreeSmall[ sizeClass ]++;
+			return;
+		}
+	}
+#endif
+
+	free( block );
+}
+
+/*
+========================
+Z_ClearFreeLists
+========================
+*/
+static void Z_ClearFreeLists( void )
+{
+	memblock_t *block;
+	int k;
+
+	for( k = 0; k < ZONE_SMALL_CLASSES; k++ )
+	{
+		while( ( block = mem_freeSmall[ k ] ) != NULL ) {
+			mem_freeSmall[ k ] = block->next;
+			free( block );
+		}
+
+		mem_numFreeSmall[ k ] = 0;
+	}
+}
 
 /*
 ========================
@@ -106,7 +313,7 @@ void Z_Free( void *ptr )
 		return;
 	}
 
-	if( block->id != ZONEID ) {
+	if( block->id != ZONEID && block->id != ZONEID_ARENA ) {
 		Com_Error( ERR_FATAL, "Z_Free: freed a pointer without ZONEID" );
 	}
 
@@ -122,8 +329,14 @@ void Z_Free( void *ptr )
 	block->prev = block;
 	block->next = block;
 
+	if( block->id == ZONEID_ARENA ) {
+		// the memory is reclaimed when the whole tag is freed
+		block->id = 0;
+		return;
+	}
+
 	// free the block
-	free( block );
+	Z_ReleaseBlock( block );
 }
 
 /*
@@ -136,10 +349,18 @@ void Z_FreeTags( int tag )
 	memblock_t *block;
 	memblock_t *next;
 
-	for( block = mem_blocks[ tag ].next; block != &mem_blocks[ tag ]; block = next )
+	if( Z_IsArenaTag( tag ) )
+	{
+		// the blocks are in the chunks
+		Z_FreeArena( tag, qfalse );
+	}
+	else
 	{
-		next = block->next;
-		Z_Free( ( ( byte * )block + sizeof( memblock_t ) ) );
+		for( block = mem_blocks[ tag ].next; block != &mem_blocks[ tag ]; block = next )
+		{
+			next = block->next;
+			Z_Free( ( ( byte * )block + sizeof( memblock_t ) ) );
+		}
 	}
 
 	mem_blocks[ tag ].prev = &mem_blocks[ tag ];
@@ -180,9 +401,24 @@ void *Z_TagMalloc( int size, int tag ) {
 #endif
 	size = PAD( size, sizeof( intptr_t ) );		// align to 32/64 bit boundary
 
-	block = ( memblock_t * )malloc( size );
-	block->id = ZONEID;
-	block->size = size;
+	if( Z_IsArenaTag( tag ) ) {
+		block = Z_ArenaAlloc( tag, size );
+		block->id = ZONEID_ARENA;
+#ifndef ZONE_DEBUG
+	} else if( size <= ZONE_SMALL_MAX ) {
+		block = Z_SmallAlloc( PAD( size, ZONE_SMALL_ALIGN ) );
+		block->id = ZONEID;
+#endif
+	} else {
+		block = ( memblock_t * )malloc( size );
+		if( !block ) {
+			Com_Error( ERR_FATAL, "Z_TagMalloc: failed on allocation of %i bytes", size );
+		}
+
+		block->id = ZONEID;
+		block->size = size;
+	}
+
 	block->next = &mem_blocks[ tag ];
 	block->prev = mem_blocks[ tag ].prev;
 	block->prev->next = block;
@@ -218,7 +454,7 @@ void Z_CheckHeap( void )
 	{
 		for( block = mem_blocks[ k ].next; block != &mem_blocks[ k ]; block = block->next )
 		{
-			if( *( int * )( ( byte * )block + block->size - 4 ) != ZONEID ) {
+			if( *( int * )( ( byte * )block + block->size - sizeof( int ) ) != ZONEID ) {
 				Com_Error( ERR_FATAL, "Z_CheckHeap: memory block wrote past end" );
 			}
 		}
@@ -275,6 +511,7 @@ void Z_Meminfo_f( void )
 	size_t numBlocks;
 	size_t numBytes;
 	memblock_t *block;
+	memchunk_t *chunk;
 
 	totalBlocks = 0;
 	totalBytes = 0;
@@ -352,6 +589,29 @@ void Z_Meminfo_f( void )
 	}
 
 	Com_Printf( "\n%.2f Kbytes in %zu blocks in all memory pools\n", ( float )totalBytes / 1024.0f, totalBlocks );
+
+	numBlocks = 0;
+	numBytes = 0;
+
+	for( k = 0; k < TAG_NUM_TOTAL_TAGS; k++ )
+	{
+		for( chunk = mem_chunks[ k ]; chunk; chunk = chunk->next ) {
+			numBlocks++;
+			numBytes += chunk->size;
+		}
+	}
+
+	Com_Printf( "%.2f Kbytes reserved in %zu arena chunks\n", ( float )numBytes / 1024.0f, numBlocks );
+
+	numBlocks = 0;
+	numBytes = 0;
+
+	for( k = 0; k < ZONE_SMALL_CLASSES; k++ ) {
+		numBlocks += mem_numFreeSmall[ k ];
+		numBytes += ( size_t )mem_numFreeSmall[ k ] * ( k + 1 ) * ZONE_SMALL_ALIGN;
+	}
+
+	Com_Printf( "%.2f Kbytes in %zu free small blocks\n", ( float )numBytes / 1024.0f, numBlocks );
 	Com_Printf( "\n%.2f megabytes in 'new' system memory\n", 1.024f );
 
 #ifndef DEDICATED
@@ -393,7 +653,10 @@ void Z_Shutdown( void ) {
 
 	for( k = 0; k < TAG_NUM_TOTAL_TAGS; k++ ) {
 		Z_FreeTags( k );
+		Z_FreeArena( k, qtrue );
 	}
+
+	Z_ClearFreeLists();
 }
 
 /*
@@ -24,6 +24,10 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 huffman_t msgHuff;
 
+// prefix codes of msgHuff.compressor, the tree doesn't change once initialized
+static huffCode_t msgHuffCodes[HMAX];
+static qboolean msgHuffCodesValid = qfalse;
+
 qboolean msgInit = qfalse;
 
 int oldsize = 0;
@@ -51,6 +55,10 @@ int coordstats[MAX_PACKED_COORD];
 int iEntityFieldChanges[256];
 int alphastats[257];
 
+// Only gathered when com_msgstats is set, snapshots are then written
+// from the main thread so the counters don't need to be synchronized
+#define MSG_STAT(x) do { if ( com_msgstats->integer ) { x; } } while ( 0 )
+
 // Scrambled string conversion (write)
 const uint8_t StrCharToNetByte[256] =
 {
@@ -226,11 +234,78 @@ int MSG_ReadNegateValue(int value, int bits)
 	}
 }
 
+/*
+=================
+MSG_WriteHuffBits
+
+Writes the bits with the code table of msgHuff, through a 64-bit accumulator.
+The output is the same as sending them one by one through the tree.
+Returns qfalse if the bits may not fit, so the caller handles the overflow
+=================
+*/
+static qboolean MSG_WriteHuffBits( msg_t *msg, unsigned int value, int bits ) {
+	const huffCode_t	*code;
+	uint64_t			acc;
+	byte				*out;
+	int					accBits;
+	int					nbits;
+	int					length;
+	int					i;
+
+	nbits = bits & 7;
+
+	// check for overflows once for the whole field
+	length = nbits;
+	for ( i = nbits; i < bits; i += 8 ) {
+		length += msgHuffCodes[(value >> i) & 0xff].length;
+	}
+
+	if ( (size_t)( msg->bit + length ) >= msg->maxsize << 3 ) {
+		return qfalse;
+	}
+
+	out = msg->data + (msg->bit >> 3);
+	accBits = msg->bit & 7;
+
+	// like Huff_putBit, a byte is cleared when its first bit is written
+	acc = accBits ? *out : 0;
+
+	// the bits that don't make a full byte are not encoded
+	acc |= (uint64_t)(value & ((1 << nbits) - 1)) << accBits;
+	accBits += nbits;
+
+	for ( i = nbits; i < bits; i += 8 ) {
+		code = &msgHuffCodes[(value >> i) & 0xff];
+		acc |= (uint64_t)code->bits << accBits;
+		accBits += code->length;
+
+		if ( accBits >= 32 ) {
+			out[0] = (byte)acc;
+			out[1] = (byte)(acc >> 8);
+			out[2] = (byte)(acc >> 16);
+			out[3] = (byte)(acc >> 24);
+			out += 4;
+			acc >>= 32;
+			accBits -= 32;
+		}
+	}
+
+	for ( ; accBits > 0; accBits -= 8 ) {
+		*out++ = (byte)acc;
+		acc >>= 8;
+	}
+
+	msg->bit += length;
+	msg->cursize = (msg->bit>>3)+1;
+
+	return qtrue;
+}
+
 // negative bit values include signs
 void MSG_WriteBits( msg_t *msg, int value, int bits ) {
 	int	i;
 
-	oldsize += bits;
+	MSG_STAT( oldsize += bits );
 
 	if ( msg->overflowed ) {
 		return;
@@ -289,6 +364,9 @@ void MSG_WriteBits( msg_t *msg, int value, int bits ) {
 		}
 	} else {
 		value &= (0xffffffff>>(32-bits));
+		if ( msgHuffCodesValid && MSG_WriteHuffBits( msg, value, bits ) ) {
+			return;
+		}
 		if (bits&7) {
 			int nbits;
 			nbits = bits&7;
@@ -505,7 +583,7 @@ void MSG_WriteBigString( msg_t *sb, const char *s ) {
 
 void MSG_WriteScrambledString_ver_15(msg_t* sb, const char* s) {
 	if (!s) {
-		strstats[0]++;
+		MSG_STAT( strstats[0]++ );
 		MSG_WriteByte(sb, StrCharToNetByte[0]);
 	}
 	else {
@@ -515,7 +593,7 @@ void MSG_WriteScrambledString_ver_15(msg_t* sb, const char* s) {
 
 		l = strlen(s);
 		if (l >= MAX_STRING_CHARS) {
-			strstats[0]++;
+			MSG_STAT( strstats[0]++ );
 			Com_Printf("MSG_WriteString: MAX_STRING_CHARS");
 			MSG_WriteByte(sb, StrCharToNetByte[0]);
 			return;
@@ -524,7 +602,7 @@ void MSG_WriteScrambledString_ver_15(msg_t* sb, const char* s) {
 
 		for (i = 0; i <= l; i++) {
 			unsigned char c = string[i];
-			strstats[c]++;
+			MSG_STAT( strstats[c]++ );
 			MSG_WriteByte(sb, StrCharToNetByte[c]);
 		}
 	}
@@ -532,7 +610,7 @@ void MSG_WriteScrambledString_ver_15(msg_t* sb, const char* s) {
 
 void MSG_WriteScrambledBigString_ver_15(msg_t* sb, const char* s) {
 	if (!s) {
-		strstats[0]++;
+		MSG_STAT( strstats[0]++ );
 		MSG_WriteByte(sb, StrCharToNetByte[0]);
 	}
 	else {
@@ -542,7 +620,7 @@ void MSG_WriteScrambledBigString_ver_15(msg_t* sb, const char* s) {
 
 		l = strlen(s);
 		if (l >= BIG_INFO_STRING) {
-			strstats[0]++;
+			MSG_STAT( strstats[0]++ );
 			Com_Printf("MSG_WriteString: BIG_INFO_STRING");
 			MSG_WriteByte(sb, StrCharToNetByte[0]);
 			return;
@@ -551,7 +629,7 @@ void MSG_WriteScrambledBigString_ver_15(msg_t* sb, const char* s) {
 
 		for (i = 0; i <= l; i++) {
 			unsigned char c = string[i];
-			strstats[c]++;
+			MSG_STAT( strstats[c]++ );
 			MSG_WriteByte(sb, StrCharToNetByte[c]);
 		}
 	}
@@ -1076,7 +1154,7 @@ void MSG_WriteDeltaUsercmdKey( msg_t *msg, int key, usercmd_t *from, usercmd_t *
 	{
 		// no change
 		MSG_WriteBits(msg, 0, 1);
-		oldsize += 7;
+		MSG_STAT( oldsize += 7 );
 		return;
 	}
 
@@ -1136,7 +1214,7 @@ void MSG_WriteDeltaEyeInfo(msg_t* msg, usereyes_t* from, usereyes_t* to) {
 	}
 	else {
 		MSG_WriteBits(msg, 0, 1);
-		oldsize += 7;
+		MSG_STAT( oldsize += 7 );
 	}
 }
 
@@ -1871,7 +1949,7 @@ void MSG_WriteRegular_ver_15(msg_t* sb, int bits, int size, const void* toF)
 
 		if (fullFloat == 0.0f) {
 			MSG_WriteBits(sb, 0, 1);
-			oldsize += FLOAT_INT_BITS;
+			MSG_STAT( oldsize += FLOAT_INT_BITS );
 		}
 		else {
 			MSG_WriteBits(sb, 1, 1);
@@ -2002,7 +2080,7 @@ void MSG_WriteRegular_ver_6(msg_t* sb, int bits, int size, const void* toF)
 
 		if (fullFloat == 0.0f) {
 			MSG_WriteBits(sb, 0, 1);
-			oldsize += FLOAT_INT_BITS;
+			MSG_STAT( oldsize += FLOAT_INT_BITS );
 		}
 		else {
 			MSG_WriteBits(sb, 1, 1);
@@ -2136,6 +2214,64 @@ unsigned short MSG_ReadEntityNum(msg_t* sb)
 	}
 }
 
+#define ENTITYSTATE_WORDS	(sizeof(entityState_t) / sizeof(unsigned int))
+
+static_assert(sizeof(entityState_t) % sizeof(unsigned int) == 0, "entityState_t must be made of 32-bit words");
+
+/*
+==================
+MSG_GetChangedWords
+
+Compares the states one 32-bit word at a time, in a loop that compilers vectorize,
+and sets the bit of each word that differs. Returns qfalse if the states are identical
+==================
+*/
+static qboolean MSG_GetChangedWords( const entityState_t *from, const entityState_t *to, unsigned int *changed ) {
+	const unsigned int	*fromW, *toW;
+	unsigned int		bits, any;
+	size_t				i, j, count;
+
+	fromW = (const unsigned int *)from;
+	toW = (const unsigned int *)to;
+	any = 0;
+
+	for ( i = 0; i < ENTITYSTATE_WORDS; i += 32 ) {
+		count = ENTITYSTATE_WORDS - i;
+		if ( count > 32 ) {
+			count = 32;
+		}
+
+		bits = 0;
+		for ( j = 0; j < count; j++ ) {
+			bits |= (unsigned int)( fromW[i + j] != toW[i + j] ) << j;
+		}
+
+		changed[i / 32] = bits;
+		any |= bits;
+	}
+
+	return any != 0;
+}
+
+/*
+==================
+MSG_FieldWordsChanged
+
+Returns qtrue if one of the words covered by the field differs
+==================
+*/
+static qboolean MSG_FieldWordsChanged( const unsigned int *changed, const netField_t *field ) {
+	size_t w;
+
+	for ( w = field->offset / 4; w <= ( field->offset + field->size - 1 ) / 4; w++ ) {
+		if ( changed[w / 32] & ( 1u << ( w & 31 ) ) ) {
+			return qtrue;
+		}
+	}
+
+	return qfalse;
+}
+
 /*
 ==================
 MSG_WriteDeltaEntity
@@ -2155,6 +2291,7 @@ void MSG_WriteDeltaEntity( msg_t *msg, struct entityState_s *from, struct entity
 	size_t numFields;
 	int *fromF, *toF;
 	qboolean deltasNeeded[numBiggestEntityStateFields];
+	unsigned int changedWords[( ENTITYSTATE_WORDS + 31 ) / 32];
 
 	// all fields should be 32 bits to avoid any compiler packing issues
 	// the "number" field is not part of the field list
@@ -2181,8 +2318,19 @@ void MSG_WriteDeltaEntity( msg_t *msg, struct entityState_s *from, struct entity
     entityStateFields = MSG_GetEntityStateFields(numFields);
 
 	lc = 0;
+	// most entities didn't change since the delta base,
+	// and fields with identical bytes never need a delta
+	if ( !MSG_GetChangedWords( from, to, changedWords ) ) {
+		numFields = 0;
+	}
+
 	// build the change vector as bytes so it is endien independent
 	for ( i = 0, field = entityStateFields ; i < numFields; i++, field++ ) {
+		if ( !MSG_FieldWordsChanged( changedWords, field ) ) {
+			deltasNeeded[i] = qfalse;
+			continue;
+		}
+
 		fromF = (int *)( (byte *)from + field->offset );
 		toF = (int *)( (byte *)to + field->offset );
 		deltasNeeded[i] = MSG_DeltaNeeded(fromF, toF, field->type, field->bits, field->size);
@@ -2209,7 +2357,7 @@ void MSG_WriteDeltaEntity( msg_t *msg, struct entityState_s *from, struct entity
 
 	MSG_WriteByte( msg, lc );	// # of changes
 
-	oldsize += numFields;
+	MSG_STAT( oldsize += numFields );
 
 	for ( i = 0, field = entityStateFields ; i < lc ; i++, field++ ) {
 		fromF = (int *)( (byte *)from + field->offset );
@@ -2315,7 +2463,7 @@ int MSG_PackAnimTime(float time, int bits)
 		packed = 0;
 	}
 
-	timestats[packed]++;
+	MSG_STAT( timestats[packed]++ );
 
 	return packed;
 }
@@ -2338,7 +2486,7 @@ int MSG_PackAnimWeight(float weight, int bits)
 		packed = 0;
 	}
 
-	weightstats[packed]++;
+	MSG_STAT( weightstats[packed]++ );
 
 	return packed;
 }
@@ -2361,7 +2509,7 @@ int MSG_PackScale(float scale, int bits)
 		packed = 0;
 	}
 
-	scalestats[packed]++;
+	MSG_STAT( scalestats[packed]++ );
 
 	return packed;
 }
@@ -2384,7 +2532,7 @@ int MSG_PackAlpha(float alpha, int bits)
 		packed = 0;
 	}
 
-	alphastats[packed]++;
+	MSG_STAT( alphastats[packed]++ );
 
 	return packed;
 }
@@ -2396,7 +2544,7 @@ int MSG_PackCoord(float coord)
 	packed = (unsigned int)round(coord * 4.0 + MAX_PACKED_COORD_HALF);
 
 	if (packed < MAX_PACKED_COORD) {
-		coordstats[packed]++;
+		MSG_STAT( coordstats[packed]++ );
 	}
 // 	else {
 // 		Com_DPrintf("Illegal XYZ coordinates for an entity, small information lost in transmission\n");
@@ -2415,7 +2563,7 @@ int MSG_PackCoordExtra(float coord)
 	//  This check wasn't added in >= 2.0
 	//  which means a player could crash a server when out of bounds
 	if (packed < MAX_PACKED_COORD_EXTRA) {
-		++coordextrastats[packed];
+		MSG_STAT( ++coordextrastats[packed] );
 	}
 //	else {
 //		Com_DPrintf("Illegal XYZ coordinates for an entity, information lost in transmission\n");
@@ -3506,7 +3654,7 @@ void MSG_WriteDeltaPlayerstate(msg_t *msg, struct playerState_s *from, struct pl
 
 	MSG_WriteByte( msg, lc );	// # of changes
 
-	oldsize += numFields - lc;
+	MSG_STAT( oldsize += numFields - lc );
 
 	for ( i = 0, field = playerStateFields ; i < lc ; i++, field++ ) {
 		fromF = (int *)( (byte *)from + field->offset );
@@ -3595,7 +3743,7 @@ void MSG_WriteDeltaPlayerstate(msg_t *msg, struct playerState_s *from, struct pl
 
 	if (!statsbits && !activeitemsbits && !ammobits && !ammo_amountbits && !max_ammo_amountbits) {
 		MSG_WriteBits( msg, 0, 1 );	// no change
-		oldsize += 5;
+		MSG_STAT( oldsize += 5 );
 		return;
 	}
 	MSG_WriteBits( msg, 1, 1 );	// changed
@@ -4111,4 +4259,6 @@ void MSG_initHuffman( void ) {
 			Huff_addRef(&msgHuff.decompressor,	(byte)i);			// Do update
 		}
 	}
+
+	msgHuffCodesValid = Huff_BuildCodes(&msgHuff.compressor, msgHuffCodes);
 }
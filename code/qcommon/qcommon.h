@@ -1053,6 +1053,7 @@ extern	cvar_t	*cl_packetdelay;
 extern	cvar_t	*sv_packetdelay;
 
 extern	cvar_t* com_protocol;
+extern	cvar_t* com_msgstats;
 #ifdef LEGACY_PROTOCOL
 extern	cvar_t* com_legacyprotocol;
 #endif
@@ -1174,6 +1175,16 @@ qboolean Com_ShiftedStrStr(const char* shifted, const char* name, int offset);
 qboolean COM_IsMapValid(const char* name);
 void Com_SwapSaveStruct(savegamestruct_t* save);
 
+//
+// Worker threads
+//
+typedef void (*jobFunc_t)(void *data, int index);
+
+void Com_RunJobs(int numThreads, int count, jobFunc_t func, void *data);
+void Com_ShutdownJobs(void);
+void Com_LockJobs(void);
+void Com_UnlockJobs(void);
+
 
 /*
 ==============================================================
@@ -1514,6 +1525,11 @@ typedef struct {
 	huff_t		decompressor;
 } huffman_t;
 
+typedef struct {
+	unsigned int	bits;		// prefix code, the first bit to send is the lowest one
+	int				length;
+} huffCode_t;
+
 void	Huff_Compress(msg_t *buf, int offset);
 void	Huff_Decompress(msg_t *buf, int offset);
 void	Huff_Init(huffman_t *huff);
@@ -1524,6 +1540,7 @@ void	Huff_offsetReceive (node_t *node, int *ch, byte *fin, int *offset, int maxo
 void	Huff_offsetTransmit (huff_t *huff, int ch, byte *fout, int *offset, int maxoffset);
 void	Huff_putBit( int bit, byte *fout, int *offset);
 int		Huff_getBit( byte *fout, int *offset);
+qboolean	Huff_BuildCodes( huff_t *huff, huffCode_t *codes );
 
 extern huffman_t clientHuffTables;
 
@@ -0,0 +1,222 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// tr_skin.c: CPU skinning of skeletal meshes, independent of the renderer
+
+#include "tr_skin.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#    define SKIN_SSE
+#    include <xmmintrin.h>
+#endif
+
+static const skelBoneCache_t *SkinBone(const skelBoneCache_t *bones, const int *boneMap, int boneIndex)
+{
+    return &bones[boneMap ? boneMap[boneIndex] : boneIndex];
+}
+
+#ifdef SKIN_SSE
+
+/*
+=============
+SkinTransform
+
+Returns point * matrix, each bone row is padded to 4 floats so a row is a vector.
+The operations are done in the same order as the scalar code so the results are the same
+=============
+*/
+static ID_INLINE __m128 SkinTransform(const skelBoneCache_t *bone, const float *point)
+{
+    __m128 v;
+
+    v = _mm_add_ps(
+        _mm_mul_ps(_mm_set1_ps(point[0]), _mm_loadu_ps(bone->matrix[0])),
+        _mm_mul_ps(_mm_set1_ps(point[1]), _mm_loadu_ps(bone->matrix[1]))
+    );
+
+    return _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(point[2]), _mm_loadu_ps(bone->matrix[2])));
+}
+
+static ID_INLINE void SkinStore3(float *out, __m128 v)
+{
+    // the fourth component belongs to the caller
+    _mm_storel_pi((__m64 *)out, v);
+    _mm_store_ss(out + 2, _mm_movehl_ps(v, v));
+}
+
+static void SkinVertex(
+    const skeletorVertex_t *vert,
+    const skelBoneCache_t  *bones,
+    const int              *boneMap,
+    const vec3_t            totalmorph,
+    float                   scale,
+    float                  *outXyz,
+    float                  *outNormal
+)
+{
+    const skelWeight_t    *weight;
+    const skelBoneCache_t *bone;
+    __m128                 v;
+    __m128                 out;
+    vec3_t                 point;
+    int                    weightNum;
+
+    weight = (const skelWeight_t *)((const byte *)vert + sizeof(skeletorVertex_t)
+                                    + sizeof(skeletorMorph_t) * vert->numMorphs);
+
+    bone = SkinBone(bones, boneMap, weight->boneIndex);
+    SkinStore3(outNormal, SkinTransform(bone, vert->normal));
+
+    out = _mm_setzero_ps();
+
+    for (weightNum = 0; weightNum < vert->numWeights; weightNum++, weight++) {
+        bone = SkinBone(bones, boneMap, weight->boneIndex);
+
+        if (!weightNum && totalmorph) {
+            VectorAdd(totalmorph, weight->offset, point);
+            v = SkinTransform(bone, point);
+        } else {
+            v = SkinTransform(bone, weight->offset);
+        }
+
+        v   = _mm_add_ps(v, _mm_loadu_ps(bone->offset));
+        out = _mm_add_ps(out, _mm_mul_ps(v, _mm_set1_ps(weight->boneWeight)));
+    }
+
+    SkinStore3(outXyz, _mm_mul_ps(out, _mm_set1_ps(scale)));
+}
+
+#else
+
+static void SkinTransform(const skelBoneCache_t *bone, const float *point, vec3_t out)
+{
+    out[0] = point[0] * bone->matrix[0][0] + point[1] * bone->matrix[1][0] + point[2] * bone->matrix[2][0];
+    out[1] = point[0] * bone->matrix[0][1] + point[1] * bone->matrix[1][1] + point[2] * bone->matrix[2][1];
+    out[2] = point[0] * bone->matrix[0][2] + point[1] * bone->matrix[1][2] + point[2] * bone->matrix[2][2];
+}
+
+static void SkinVertex(
+    const skeletorVertex_t *vert,
+    const skelBoneCache_t  *bones,
+    const int              *boneMap,
+    const vec3_t            totalmorph,
+    float                   scale,
+    float                  *outXyz,
+    float                  *outNormal
+)
+{
+    const skelWeight_t    *weight;
+    const skelBoneCache_t *bone;
+    vec3_t                 v;
+    vec3_t                 out;
+    vec3_t                 point;
+    int                    weightNum;
+
+    weight = (const skelWeight_t *)((const byte *)vert + sizeof(skeletorVertex_t)
+                                    + sizeof(skeletorMorph_t) * vert->numMorphs);
+
+    bone = SkinBone(bones, boneMap, weight->boneIndex);
+    SkinTransform(bone, vert->normal, outNormal);
+
+    VectorClear(out);
+
+    for (weightNum = 0; weightNum < vert->numWeights; weightNum++, weight++) {
+        bone = SkinBone(bones, boneMap, weight->boneIndex);
+
+        if (!weightNum && totalmorph) {
+            VectorAdd(totalmorph, weight->offset, point);
+            SkinTransform(bone, point, v);
+        } else {
+            SkinTransform(bone, weight->offset, v);
+        }
+
+        out[0] += (v[0] + bone->offset[0]) * weight->boneWeight;
+        out[1] += (v[1] + bone->offset[1]) * weight->boneWeight;
+        out[2] += (v[2] + bone->offset[2]) * weight->boneWeight;
+    }
+
+    VectorScale(out, scale, outXyz);
+}
+
+#endif
+
+/*
+=============
+R_SkinVertexes
+
+Transforms the vertexes of a skeletal surface by the bones of the entity.
+boneMap maps the bones of the mesh to the entity bones, when the mesh isn't the first one of the model.
+morphs are the morph target weights of the entity, or NULL if it has none
+=============
+*/
+void R_SkinVertexes(
+    const skeletorVertex_t *verts,
+    int                     numVerts,
+    const skelBoneCache_t  *bones,
+    const int              *boneMap,
+    const int              *morphs,
+    float                   scale,
+    const skinOutput_t     *out
+)
+{
+    const skeletorVertex_t *vert;
+    const skeletorMorph_t  *morph;
+    vec3_t                  totalmorph;
+    float                  *outXyz;
+    float                  *outNormal;
+    float                  *outTexCoords;
+    int                     vertNum;
+    int                     morphNum;
+
+    vert         = verts;
+    outXyz       = out->xyz;
+    outNormal    = out->normal;
+    outTexCoords = out->texCoords;
+
+    for (vertNum = 0; vertNum < numVerts; vertNum++) {
+        if (morphs) {
+            // the morph targets are folded into the first weight
+            VectorClear(totalmorph);
+
+            morph = (const skeletorMorph_t *)((const byte *)vert + sizeof(skeletorVertex_t));
+            for (morphNum = 0; morphNum < vert->numMorphs; morphNum++, morph++) {
+                if (morphs[morph->morphIndex]) {
+                    VectorMA(totalmorph, morphs[morph->morphIndex], morph->offset, totalmorph);
+                }
+            }
+
+            SkinVertex(vert, bones, boneMap, totalmorph, scale, outXyz, outNormal);
+        } else {
+            SkinVertex(vert, bones, boneMap, NULL, scale, outXyz, outNormal);
+        }
+
+        outTexCoords[0] = vert->texCoords[0];
+        outTexCoords[1] = vert->texCoords[1];
+
+        vert = (const skeletorVertex_t *)((const byte *)vert + sizeof(skeletorVertex_t)
+                                          + sizeof(skeletorMorph_t) * vert->numMorphs
+                                          + sizeof(skelWeight_t) * vert->numWeights);
+        outXyz += out->xyzStride;
+        outNormal += out->normalStride;
+        outTexCoords += out->texCoordStride;
+    }
+}
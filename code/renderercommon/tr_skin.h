@@ -0,0 +1,58 @@
+/*
+===========================================================================
+Copyright (C) 2025 the OpenMoHAA team
+
+This file is part of OpenMoHAA source code.
+
+OpenMoHAA source code is free software; you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation; either version 2 of the License,
+or (at your option) any later version.
+
+OpenMoHAA source code is distributed in the hope that it will be
+useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with OpenMoHAA source code; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+===========================================================================
+*/
+
+// tr_skin.h: CPU skinning of skeletal meshes, independent of the renderer
+
+#pragma once
+
+#include "../qcommon/q_shared.h"
+#include "../tiki/tiki_shared.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//
+// Where the skinned vertexes are written, strides are in floats
+//
+typedef struct skinOutput_s {
+    float *xyz;
+    int    xyzStride;
+    float *normal;
+    int    normalStride;
+    float *texCoords;
+    int    texCoordStride;
+} skinOutput_t;
+
+void R_SkinVertexes(
+    const skeletorVertex_t *verts,
+    int                     numVerts,
+    const skelBoneCache_t  *bones,
+    const int              *boneMap,
+    const int              *morphs,
+    float                   scale,
+    const skinOutput_t     *out
+);
+
+#ifdef __cplusplus
+}
+#endif
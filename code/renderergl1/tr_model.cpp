@@ -23,6 +23,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 // tr_models.cpp -- model loading and caching
 
 #include "tr_local.h"
+#include "../renderercommon/tr_skin.h"
 #include "../corepp/tiki.h"
 #include "../corepp/vector.h"
 
@@ -940,80 +941,6 @@ void R_AddSkelSurfaces(trRefEntity_t *ent)
     // FIXME: setup LOD
 }
 
-/*
-=============
-SkelVertGetNormal
-=============
-*/
-inline static void SkelVertGetNormal(skeletorVertex_t *vert, skelBoneCache_t *bone, vec3_t out)
-{
-    out[0] = vert->normal[0] * bone->matrix[0][0] + vert->normal[1] * bone->matrix[1][0]
-           + vert->normal[2] * bone->matrix[2][0];
-
-    out[1] = vert->normal[0] * bone->matrix[0][1] + vert->normal[1] * bone->matrix[1][1]
-           + vert->normal[2] * bone->matrix[2][1];
-
-    out[2] = vert->normal[0] * bone->matrix[0][2] + vert->normal[1] * bone->matrix[1][2]
-           + vert->normal[2] * bone->matrix[2][2];
-}
-
-/*
-=============
-SkelMorphGetXyz
-=============
-*/
-inline static void SkelMorphGetXyz(skeletorMorph_t *morph, int *morphcache, vec3_t out)
-{
-    VectorMA(out, *morphcache, morph->offset, out);
-}
-
-/*
-=============
-SkelWeightGetXyz
-=============
-*/
-inline static void SkelWeightGetXyz(skelWeight_t *weight, skelBoneCache_t *bone, vec3_t out)
-{
-    out[0] += ((weight->offset[0] * bone->matrix[0][0] + weight->offset[1] * bone->matrix[1][0]
-                + weight->offset[2] * bone->matrix[2][0])
-               + bone->offset[0])
-            * weight->boneWeight;
-
-    out[1] += ((weight->offset[0] * bone->matrix[0][1] + weight->offset[1] * bone->matrix[1][1]
-                + weight->offset[2] * bone->matrix[2][1])
-               + bone->offset[1])
-            * weight->boneWeight;
-
-    out[2] += ((weight->offset[0] * bone->matrix[0][2] + weight->offset[1] * bone->matrix[1][2]
-                + weight->offset[2] * bone->matrix[2][2])
-               + bone->offset[2])
-            * weight->boneWeight;
-}
-
-/*
-=============
-SkelWeightMorphGetXyz
-=============
-*/
-inline static void SkelWeightMorphGetXyz(skelWeight_t *weight, skelBoneCache_t *bone, vec3_t totalmorph, vec3_t out)
-{
-    vec3_t point;
-
-    VectorAdd(totalmorph, weight->offset, point);
-
-    out[0] += ((point[0] * bone->matrix[0][0] + point[1] * bone->matrix[1][0] + point[2] * bone->matrix[2][0])
-               + bone->offset[0])
-            * weight->boneWeight;
-
-    out[1] += ((point[0] * bone->matrix[0][1] + point[1] * bone->matrix[1][1] + point[2] * bone->matrix[2][1])
-               + bone->offset[1])
-            * weight->boneWeight;
-
-    out[2] += ((point[0] * bone->matrix[0][2] + point[1] * bone->matrix[1][2] + point[2] * bone->matrix[2][2])
-               + bone->offset[2])
-            * weight->boneWeight;
-}
-
 /*
 =============
 RB_SkelMesh
@@ -1024,20 +951,12 @@ void RB_SkelMesh(skelSurfaceGame_t *sf)
     unsigned int       baseIndex, baseVertex;
     unsigned int       render_count;
     unsigned int       indexes;
-    float             *outXyz;
-    vec4_t            *outNormal;
     skelIndex_t       *triangles;
     skelIndex_t       *collapse_map;
-    skeletorVertex_t  *newVerts;
-    skeletorMorph_t   *morph;
-    skelWeight_t      *weight;
-    int                vertNum;
-    int                morphNum;
-    int                weightNum;
     skelBoneCache_t   *bones;
-    skelBoneCache_t   *bone;
     int               *morphs;
-    int               *morphcache;
+    int                boneMap[TIKI_MAX_BONES];
+    skinOutput_t       skin;
     float              scale;
     dtiki_t           *tiki;
     int                mesh;
@@ -1146,10 +1065,6 @@ void RB_SkelMesh(skelSurfaceGame_t *sf)
     baseVertex   = tess.numVertexes;
     tess.numVertexes += render_count;
 
-    outXyz    = tess.xyz[baseVertex];
-    outNormal = &tess.normal[baseVertex];
-    newVerts  = sf->pVerts;
-
     if (render_count == sf->numVerts) {
         for (i = 0; i < indexes; i++) {
             tess.indexes[baseIndex + i] = baseVertex + triangles[i];
@@ -1189,215 +1104,31 @@ void RB_SkelMesh(skelSurfaceGame_t *sf)
     }
 
     //
-    // just copy the vertexes
+    // skin the vertexes
     //
-    bones  = &TIKI_Skel_Bones[backEnd.currentEntity->e.bonestart];
-    morphs = &skeletorMorphCache[backEnd.currentEntity->e.morphstart];
-
+    bones = &TIKI_Skel_Bones[backEnd.currentEntity->e.bonestart];
     if (backEnd.currentEntity->e.hasMorph) {
-        if (mesh > 0) {
-            for (vertNum = 0; vertNum < render_count; vertNum++) {
-                vec3_t normal;
-                vec3_t out;
-                vec3_t totalmorph;
-                int    channelNum;
-                int    boneNum;
-
-                VectorClear(out);
-                VectorClear(outXyz);
-                VectorClear(totalmorph);
-
-                weight = (skelWeight_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
-                                          + sizeof(skeletorMorph_t) * newVerts->numMorphs);
-                morph  = (skeletorMorph_t *)((byte *)newVerts + sizeof(skeletorVertex_t));
-
-                for (morphNum = 0; morphNum < newVerts->numMorphs; morphNum++) {
-                    morphcache = &morphs[morph->morphIndex];
-
-                    if (*morphcache) {
-                        SkelMorphGetXyz(morph, morphcache, totalmorph);
-                    }
-
-                    morph++;
-                }
-
-                if (newVerts->numMorphs) {
-                    channelNum = skelmodel->pBones[morph->morphIndex].channel;
-                } else {
-                    channelNum = skelmodel->pBones[weight->boneIndex].channel;
-                }
-
-                boneNum = ri.TIKI_GetLocalChannel(tiki, channelNum);
-                bone    = &bones[boneNum];
-
-                SkelVertGetNormal(newVerts, bone, normal);
-
-                for (weightNum = 0; weightNum < newVerts->numWeights; weightNum++) {
-                    channelNum = skelmodel->pBones[weight->boneIndex].channel;
-                    boneNum    = ri.TIKI_GetLocalChannel(tiki, channelNum);
-                    bone       = &bones[boneNum];
-
-                    if (!weightNum) {
-                        SkelWeightMorphGetXyz(weight, bone, totalmorph, out);
-                    } else {
-                        SkelWeightGetXyz(weight, bone, out);
-                    }
-
-                    weight++;
-                }
-
-                VectorCopy(normal, *outNormal);
-                VectorScale(out, scale, outXyz);
-
-                tess.texCoords[baseVertex + vertNum][0][0] = newVerts->texCoords[0];
-                tess.texCoords[baseVertex + vertNum][0][1] = newVerts->texCoords[1];
-                // FIXME: fill in lightmapST for completeness?
-
-                newVerts = (skeletorVertex_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
-                                                + sizeof(skeletorMorph_t) * newVerts->numMorphs
-                                                + sizeof(skelWeight_t) * newVerts->numWeights);
-                outXyz += 4;
-                outNormal++;
-            }
-        } else {
-            for (vertNum = 0; vertNum < render_count; vertNum++) {
-                vec3_t normal;
-                vec3_t out;
-                vec3_t totalmorph;
-
-                VectorClear(out);
-                VectorClear(outXyz);
-                VectorClear(totalmorph);
-
-                weight = (skelWeight_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
-                                          + sizeof(skeletorMorph_t) * newVerts->numMorphs);
-                morph  = (skeletorMorph_t *)((byte *)newVerts + sizeof(skeletorVertex_t));
-
-                for (morphNum = 0; morphNum < newVerts->numMorphs; morphNum++) {
-                    morphcache = &morphs[morph->morphIndex];
-
-                    if (*morphcache) {
-                        SkelMorphGetXyz(morph, morphcache, totalmorph);
-                    }
-
-                    morph++;
-                }
-
-                if (newVerts->numMorphs) {
-                    bone = &bones[morph->morphIndex];
-                } else {
-                    bone = &bones[weight->boneIndex];
-                }
-
-                SkelVertGetNormal(newVerts, bone, normal);
-
-                for (weightNum = 0; weightNum < newVerts->numWeights; weightNum++) {
-                    bone = &bones[weight->boneIndex];
-
-                    if (!weightNum) {
-                        SkelWeightMorphGetXyz(weight, bone, totalmorph, out);
-                    } else {
-                        SkelWeightGetXyz(weight, bone, out);
-                    }
-
-                    weight++;
-                }
-
-                VectorCopy(normal, *outNormal);
-                VectorScale(out, scale, outXyz);
-
-                tess.texCoords[baseVertex + vertNum][0][0] = newVerts->texCoords[0];
-                tess.texCoords[baseVertex + vertNum][0][1] = newVerts->texCoords[1];
-                // FIXME: fill in lightmapST for completeness?
-
-                newVerts = (skeletorVertex_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
-                                                + sizeof(skeletorMorph_t) * newVerts->numMorphs
-                                                + sizeof(skelWeight_t) * newVerts->numWeights);
-                outXyz += 4;
-                outNormal++;
-            }
-        }
+        morphs = &skeletorMorphCache[backEnd.currentEntity->e.morphstart];
     } else {
-        if (mesh > 0) {
-            for (vertNum = 0; vertNum < render_count; vertNum++) {
-                vec3_t normal;
-                vec3_t out;
-                int    channelNum;
-                int    boneNum;
-
-                VectorClear(out);
-                VectorClear(outXyz);
-
-                weight = (skelWeight_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
-                                          + sizeof(skeletorMorph_t) * newVerts->numMorphs);
-
-                channelNum = skelmodel->pBones[weight->boneIndex].channel;
-                boneNum    = ri.TIKI_GetLocalChannel(tiki, channelNum);
-                bone       = &bones[boneNum];
-
-                SkelVertGetNormal(newVerts, bone, normal);
-
-                for (weightNum = 0; weightNum < newVerts->numWeights; weightNum++) {
-                    channelNum = skelmodel->pBones[weight->boneIndex].channel;
-                    boneNum    = ri.TIKI_GetLocalChannel(tiki, channelNum);
-                    bone       = &bones[boneNum];
-
-                    SkelWeightGetXyz(weight, bone, out);
-
-                    weight++;
-                }
-
-                VectorCopy(normal, *outNormal);
-                VectorScale(out, scale, outXyz);
-
-                tess.texCoords[baseVertex + vertNum][0][0] = newVerts->texCoords[0];
-                tess.texCoords[baseVertex + vertNum][0][1] = newVerts->texCoords[1];
-                // FIXME: fill in lightmapST for completeness?
-
-                newVerts = (skeletorVertex_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
-                                                + sizeof(skeletorMorph_t) * newVerts->numMorphs
-                                                + sizeof(skelWeight_t) * newVerts->numWeights);
-                outXyz += 4;
-                outNormal++;
-            }
-        } else {
-            for (vertNum = 0; vertNum < render_count; vertNum++) {
-                vec3_t normal;
-                vec3_t out;
-
-                VectorClear(out);
-                VectorClear(outXyz);
-
-                weight = (skelWeight_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
-                                          + sizeof(skeletorMorph_t) * newVerts->numMorphs);
-
-                bone = &bones[weight->boneIndex];
-                SkelVertGetNormal(newVerts, bone, normal);
-
-                for (weightNum = 0; weightNum < newVerts->numWeights; weightNum++) {
-                    bone = &bones[weight->boneIndex];
-
-                    SkelWeightGetXyz(weight, bone, out);
-
-                    weight++;
-                }
-
-                VectorCopy(normal, *outNormal);
-                VectorScale(out, scale, outXyz);
-
-                tess.texCoords[baseVertex + vertNum][0][0] = newVerts->texCoords[0];
-                tess.texCoords[baseVertex + vertNum][0][1] = newVerts->texCoords[1];
-                // FIXME: fill in lightmapST for completeness?
+        morphs = NULL;
+    }
 
-                newVerts = (skeletorVertex_t *)((byte *)newVerts + sizeof(skeletorVertex_t)
-                                                + sizeof(skeletorMorph_t) * newVerts->numMorphs
-                                                + sizeof(skelWeight_t) * newVerts->numWeights);
-                outXyz += 4;
-                outNormal++;
-            }
+    if (mesh > 0) {
+        // the bones of the other meshes are looked up once for the whole surface
+        for (i = 0; i < skelmodel->numBones; i++) {
+            boneMap[i] = ri.TIKI_GetLocalChannel(tiki, skelmodel->pBones[i].channel);
         }
     }
 
+    skin.xyz            = tess.xyz[baseVertex];
+    skin.xyzStride      = sizeof(tess.xyz[0]) / sizeof(float);
+    skin.normal         = tess.normal[baseVertex];
+    skin.normalStride   = sizeof(tess.normal[0]) / sizeof(float);
+    skin.texCoords      = tess.texCoords[baseVertex][0];
+    skin.texCoordStride = sizeof(tess.texCoords[0]) / sizeof(float);
+
+    R_SkinVertexes(sf->pVerts, render_count, bones, mesh > 0 ? boneMap : NULL, morphs, scale, &skin);
+
 #if 0
 	if( backEnd.currentEntity->e.staticModelIndex ) {
 		mstaticModel_t *sm;
@@ -84,10 +84,23 @@ signed char ScriptCompiler::PrevVarStackOffset()
 
 void ScriptCompiler::AbsorbPrevOpcode()
 {
+    unsigned int offset;
+
     m_iVarStackOffset -= PrevVarStackOffset();
 
     code_pos -= OpcodeLength(PrevOpcode());
 
+    // forget the operands of the absorbed opcode
+    offset = code_pos - code_ptr;
+
+    while (stringPositions.NumObjects() && stringPositions.ObjectAt(stringPositions.NumObjects()) >= offset) {
+        stringPositions.RemoveObjectAt(stringPositions.NumObjects());
+    }
+
+    while (switchPositions.NumObjects() && switchPositions.ObjectAt(switchPositions.NumObjects()) >= offset) {
+        switchPositions.RemoveObjectAt(switchPositions.NumObjects());
+    }
+
     if (!prev_opcode_pos) {
         prev_opcode_pos = 100;
     }
@@ -114,6 +127,11 @@ void ScriptCompiler::AccumulatePrevOpcode(int opcode, int iVarStackOffset)
     prev_opcodes[(pos + 1) % 100].opcode = OP_PREVIOUS;
 }
 
+void ScriptCompiler::AddStringPosition()
+{
+    stringPositions.AddObject(code_pos - code_ptr);
+}
+
 void ScriptCompiler::AddBreakJumpLocation(unsigned char *pos)
 {
     if (iBreakJumpLocCount < BREAK_JUMP_LOCATION_COUNT) {
@@ -280,14 +298,25 @@ void ScriptCompiler::EmitAssignmentStatement(sval_t lhs, unsigned int sourcePos)
         EmitOpcode(OP_LOAD_GAME_VAR + listener_val.node[1].intValue, sourcePos);
     }
 
+    AddStringPosition();
     EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
 }
 
 void ScriptCompiler::EmitBoolJumpFalse(unsigned int sourcePos)
 {
+    int prev;
+
     if (PrevOpcode() == OP_UN_CAST_BOOLEAN) {
         AbsorbPrevOpcode();
-        EmitOpcode(OP_VAR_JUMP_FALSE4, sourcePos);
+
+        prev = PrevOpcode();
+        if (prev >= OP_BIN_EQUALITY && prev <= OP_BIN_GREATER_THAN_OR_EQUAL) {
+            // fuse the comparison with the jump
+            AbsorbPrevOpcode();
+            EmitOpcode(OP_BIN_EQUALITY_JUMP_FALSE4 + prev - OP_BIN_EQUALITY, sourcePos);
+        } else {
+            EmitOpcode(OP_VAR_JUMP_FALSE4, sourcePos);
+        }
     } else {
         EmitOpcode(OP_BOOL_JUMP_FALSE4, sourcePos);
     }
@@ -507,13 +536,17 @@ void ScriptCompiler::EmitField(sval_t listener_val, sval_t field_val, unsigned i
         || (eventnum && BuiltinReadVariable(sourcePos, listener_val.node[1].intValue, eventnum))) {
         EmitValue(listener_val);
         EmitOpcode(OP_STORE_FIELD, sourcePos);
+        AddStringPosition();
         EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
     } else if (PrevOpcode() != (OP_LOAD_GAME_VAR + listener_val.node[1].intValue) || prev_index != index) {
         EmitOpcode(OP_STORE_GAME_VAR + listener_val.node[1].intValue, sourcePos);
+        AddStringPosition();
         EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
     } else {
         AbsorbPrevOpcode();
         EmitOpcode(OP_LOAD_STORE_GAME_VAR + listener_val.node[1].intValue, sourcePos);
+        // reuse the string index of the absorbed opcode
+        AddStringPosition();
         code_pos += sizeof(unsigned int);
     }
 }
@@ -933,6 +966,7 @@ void ScriptCompiler::EmitParameter(sval_t lhs, unsigned int sourcePos)
         EmitOpcode(OP_LOAD_GAME_VAR + listener_val.node[1].intValue, sourcePos);
 
         unsigned int index = Director.AddString(name);
+        AddStringPosition();
         EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
     }
 }
@@ -979,6 +1013,7 @@ void ScriptCompiler::EmitRef(sval_t val, unsigned int sourcePos)
 
     EmitValue(val.node[1]);
     EmitOpcode(OP_STORE_FIELD_REF, sourcePos);
+    AddStringPosition();
     EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
 }
 
@@ -1000,6 +1035,7 @@ void ScriptCompiler::EmitString(str value, unsigned int sourcePos)
     }
 
     EmitOpcode(OP_STORE_STRING, sourcePos);
+    AddStringPosition();
     EmitOpcodeValue((unsigned int)index, sizeof(unsigned int));
 }
 
@@ -1013,6 +1049,7 @@ void ScriptCompiler::EmitSwitch(sval_t val, unsigned int sourcePos)
     stateScript      = script->CreateSwitchStateScript();
 
     EmitOpcode(OP_SWITCH, sourcePos);
+    switchPositions.AddObject(code_pos - code_ptr);
     EmitOpcodeValue(stateScript, sizeof(StateScript *));
 
     bStartCanBreak          = bCanBreak;
@@ -1566,6 +1603,9 @@ bool ScriptCompiler::Compile(GameScript *gameScript, unsigned char *progBuffer,
 
     gameScript->m_ProgToSource = new con_set<const unsigned char *, sourceinfo_t>;
 
+    stringPositions.ClearObjectList();
+    switchPositions.ClearObjectList();
+
     compileSuccess = true;
 
     prev_opcodes[prev_opcode_pos].opcode = OP_PREVIOUS;
@@ -1579,6 +1619,9 @@ bool ScriptCompiler::Compile(GameScript *gameScript, unsigned char *progBuffer,
 
             outLength = code_pos - code_ptr;
             success   = true;
+
+            gameScript->m_StringPositions = stringPositions;
+            gameScript->m_SwitchPositions = switchPositions;
         } else {
             outLength = 0;
         }
@@ -1684,26 +1727,133 @@ void CompileAssemble(const char *filename, const char *outputfile)
     arc.Close();
 }
 
-bool GetCompiledScript(GameScript *scr)
+// Compiled scripts are cached on disk, they are only valid
+// for the same source, opcodes and event numbers
+#define SCRIPT_CACHE_VERSION 1
+
+static str ScriptCacheFilename(GameScript *scr)
+{
+    return "cache/scripts/" + scr->Filename() + ".bin";
+}
+
+static uint64_t ScriptCacheChecksum(const void *data, size_t length, uint64_t hash = 14695981039346656037ull)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    size_t               i;
+
+    // FNV-1a
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ p[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+static uint64_t EventTableChecksum()
+{
+    static uint64_t checksum = 0;
+    command_t      *cmd;
+    int             i;
+
+    if (checksum) {
+        return checksum;
+    }
+
+    // event numbers are emitted in the program
+    checksum = ScriptCacheChecksum(NULL, 0);
+    for (i = 1; i < Event::NumEventCommands(); i++) {
+        cmd      = Event::GetEventInfo(i);
+        checksum = ScriptCacheChecksum(cmd->command, strlen(cmd->command) + 1, checksum);
+        checksum = ScriptCacheChecksum(&cmd->type, sizeof(cmd->type), checksum);
+    }
+
+    return checksum;
+}
+
+static bool ArchiveScriptCacheHeader(Archiver& arc, const void *sourceBuffer, size_t sourceLength)
+{
+    unsigned int version        = SCRIPT_CACHE_VERSION;
+    unsigned int numOpcodes     = OP_MAX;
+    unsigned int pointerSize    = sizeof(void *);
+    unsigned int length         = sourceLength;
+    uint64_t     eventChecksum  = EventTableChecksum();
+    uint64_t     sourceChecksum = ScriptCacheChecksum(sourceBuffer, sourceLength);
+    unsigned int cachedVersion  = version;
+    unsigned int cachedOpcodes  = numOpcodes;
+    unsigned int cachedPointer  = pointerSize;
+    unsigned int cachedLength   = length;
+    uint64_t     cachedEvents   = eventChecksum;
+    uint64_t     cachedSource   = sourceChecksum;
+
+    arc.ArchiveUnsigned(&cachedVersion);
+    arc.ArchiveUnsigned(&cachedOpcodes);
+    arc.ArchiveUnsigned(&cachedPointer);
+    arc.ArchiveUnsigned(&cachedLength);
+    arc.ArchiveRaw(&cachedEvents, sizeof(cachedEvents));
+    arc.ArchiveRaw(&cachedSource, sizeof(cachedSource));
+
+    return arc.NoErrors() && cachedVersion == version && cachedOpcodes == numOpcodes && cachedPointer == pointerSize
+        && cachedLength == length && cachedEvents == eventChecksum && cachedSource == sourceChecksum;
+}
+
+bool GetCompiledScript(GameScript *scr, const void *sourceBuffer, size_t sourceLength)
 {
-    /*
     Archiver arc;
+    str      filename;
+
+    if (!g_scriptcache->integer) {
+        return false;
+    }
+
+    filename = ScriptCacheFilename(scr);
 
     arc.SetSilent(true);
-    arc.Read(scr->Filename(), false);
 
-    if (!arc.NoErrors()) {
+    if (!arc.Read(filename, false)) {
         return false;
     }
 
-    arc.SetSilent(false);
+    if (!ArchiveScriptCacheHeader(arc, sourceBuffer, sourceLength)) {
+        // outdated, the script will be cached again once compiled
+        arc.Close();
+        return false;
+    }
 
     scr->Archive(arc);
 
     arc.Close();
 
+    if (!scr->successCompile) {
+        gi.DPrintf2("Couldn't load the compiled script '%s', recompiling\n", filename.c_str());
+        scr->Close();
+        return false;
+    }
+
+    // still needed to print the source of script errors
+    scr->LoadSource(sourceBuffer, sourceLength);
+
     return true;
-    */
-    // FIXME: not used?
-    return false;
+}
+
+void CacheCompiledScript(GameScript *scr)
+{
+    Archiver arc;
+    str      filename;
+
+    if (!g_scriptcache->integer || !scr->m_ProgBuffer || !scr->m_ProgLength || !scr->m_SourceBuffer) {
+        return;
+    }
+
+    filename = ScriptCacheFilename(scr);
+
+    arc.SetSilent(true);
+
+    if (!arc.Create(filename, false)) {
+        return;
+    }
+
+    ArchiveScriptCacheHeader(arc, scr->m_SourceBuffer, scr->m_SourceLength);
+    scr->Archive(arc);
+
+    arc.Close();
 }
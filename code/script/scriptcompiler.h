@@ -70,6 +70,11 @@ public:
 
     bool compileSuccess;
 
+    // program offsets of string indexes and switch state scripts,
+    // used to relocate the program when it is cached
+    Container<unsigned int> stringPositions;
+    Container<unsigned int> switchPositions;
+
     static int current_label;
 
 public:
@@ -81,6 +86,7 @@ public:
     void          AbsorbPrevOpcode();
     void          ClearPrevOpcode();
     void          AccumulatePrevOpcode(int opcode, int iVarStackOffset);
+    void          AddStringPosition();
 
     void AddBreakJumpLocation(unsigned char *pos);
     void AddContinueJumpLocation(unsigned char *pos);
@@ -179,4 +185,5 @@ private:
 extern ScriptCompiler Compiler;
 
 void CompileAssemble(const char *filename, const char *outputfile);
-bool GetCompiledScript(GameScript *scr);
+bool GetCompiledScript(GameScript *scr, const void *sourceBuffer, size_t sourceLength);
+void CacheCompiledScript(GameScript *scr);
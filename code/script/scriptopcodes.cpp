@@ -164,6 +164,13 @@ static opcode_t OpcodeInfo[] = {
 
     {"OPCODE_END",                       1,                        -1,   0},
     {"OPCODE_RETURN",                    1,                        -1,   0},
+
+    {"OPCODE_BIN_EQUALITY_JUMP_FALSE4",              5,            -2,   0},
+    {"OPCODE_BIN_INEQUALITY_JUMP_FALSE4",            5,            -2,   0},
+    {"OPCODE_BIN_LESS_THAN_JUMP_FALSE4",             5,            -2,   0},
+    {"OPCODE_BIN_GREATER_THAN_JUMP_FALSE4",          5,            -2,   0},
+    {"OPCODE_BIN_LESS_THAN_OR_EQUAL_JUMP_FALSE4",    5,            -2,   0},
+    {"OPCODE_BIN_GREATER_THAN_OR_EQUAL_JUMP_FALSE4", 5,            -2,   0},
 };
 
 static const char *aszVarGroupNames[] = {"game", "level", "local", "parm", "self"};
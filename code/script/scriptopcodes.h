@@ -192,6 +192,15 @@ typedef enum {
     OP_END,
     OP_RETURN,
 
+    // superinstructions: comparison followed by a jump,
+    // in the same order as the comparison opcodes
+    OP_BIN_EQUALITY_JUMP_FALSE4,
+    OP_BIN_INEQUALITY_JUMP_FALSE4,
+    OP_BIN_LESS_THAN_JUMP_FALSE4,
+    OP_BIN_GREATER_THAN_JUMP_FALSE4,
+    OP_BIN_LESS_THAN_OR_EQUAL_JUMP_FALSE4,
+    OP_BIN_GREATER_THAN_OR_EQUAL_JUMP_FALSE4,
+
     OP_PREVIOUS,
     OP_MAX = OP_PREVIOUS
 } opcode_e;
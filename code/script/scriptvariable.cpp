@@ -39,8 +39,11 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #    include "../fgame/simpleentity.h"
 #endif
 
+#include <new>
 #include <utility>
 
+unsigned int script_allocsthisframe = 0;
+
 template<>
 int HashCode<ScriptVariable>(const ScriptVariable& key)
 {
@@ -205,10 +208,10 @@ void ScriptVariable::ArchiveInternal(Archiver& arc)
     switch (type) {
     case VARIABLE_STRING:
         if (arc.Loading()) {
-            m_data.stringValue = new str;
+            new (m_data.stringValue) str;
         }
 
-        arc.ArchiveString(m_data.stringValue);
+        arc.ArchiveString(&stringData());
         break;
 
     case VARIABLE_INTEGER:
@@ -238,10 +241,10 @@ void ScriptVariable::ArchiveInternal(Archiver& arc)
 
     case VARIABLE_LISTENER:
         if (arc.Loading()) {
-            m_data.listenerValue = new SafePtr<Listener>;
+            new (m_data.listenerValue) WeakRef<Listener>;
         }
 
-        arc.ArchiveSafePointer(m_data.listenerValue);
+        arc.ArchiveWeakRef(&listenerData());
         break;
 
     case VARIABLE_ARRAY:
@@ -270,10 +273,6 @@ void ScriptVariable::ArchiveInternal(Archiver& arc)
         break;
 
     case VARIABLE_VECTOR:
-        if (arc.Loading()) {
-            m_data.vectorValue = new float[3];
-        }
-
         arc.ArchiveVec3(m_data.vectorValue);
         break;
 
@@ -307,6 +306,7 @@ ScriptConstArrayHolder::ScriptConstArrayHolder(ScriptVariable *pVar, unsigned in
     refCount   = 0;
     this->size = size;
 
+    script_allocsthisframe++;
     constArrayValue = new ScriptVariable[size + 1];
 
     for (unsigned int i = 0; i < size; i++) {
@@ -319,6 +319,7 @@ ScriptConstArrayHolder::ScriptConstArrayHolder(unsigned int size)
     refCount   = 0;
     this->size = size;
 
+    script_allocsthisframe++;
     constArrayValue = new ScriptVariable[size + 1];
 }
 
@@ -446,6 +447,7 @@ void ScriptVariable::CastConstArrayValue(void)
         return;
 
     case VARIABLE_ARRAY:
+        script_allocsthisframe++;
         constArrayValue = new ScriptConstArrayHolder(m_data.arrayValue->arrayValue.size());
 
         en = m_data.arrayValue->arrayValue;
@@ -459,6 +461,7 @@ void ScriptVariable::CastConstArrayValue(void)
         break;
 
     case VARIABLE_CONTAINER:
+        script_allocsthisframe++;
         constArrayValue = new ScriptConstArrayHolder(m_data.containerValue->NumObjects());
 
         for (int i = m_data.containerValue->NumObjects(); i > 0; i--) {
@@ -470,17 +473,20 @@ void ScriptVariable::CastConstArrayValue(void)
         listeners = *m_data.safeContainerValue;
 
         if (listeners) {
+            script_allocsthisframe++;
             constArrayValue = new ScriptConstArrayHolder(listeners->NumObjects());
 
             for (int i = listeners->NumObjects(); i > 0; i--) {
                 constArrayValue->constArrayValue[i - 1].setListenerValue(listeners->ObjectAt(i));
             }
         } else {
+            script_allocsthisframe++;
             constArrayValue = new ScriptConstArrayHolder(0);
         }
         break;
 
     default:
+        script_allocsthisframe++;
         constArrayValue                     = new ScriptConstArrayHolder(1);
         constArrayValue->constArrayValue[0] = *this;
 
@@ -522,11 +528,7 @@ void ScriptVariable::ClearInternal()
 {
     switch (GetType()) {
     case VARIABLE_STRING:
-        if (m_data.stringValue) {
-            delete m_data.stringValue;
-            m_data.stringValue = NULL;
-        }
-
+        stringData().~str();
         break;
 
     case VARIABLE_ARRAY:
@@ -549,14 +551,6 @@ void ScriptVariable::ClearInternal()
         m_data.constArrayValue = NULL;
         break;
 
-    case VARIABLE_LISTENER:
-        if (m_data.listenerValue) {
-            delete m_data.listenerValue;
-            m_data.listenerValue = NULL;
-        }
-
-        break;
-
     case VARIABLE_SAFECONTAINER:
         if (m_data.safeContainerValue) {
             delete m_data.safeContainerValue;
@@ -570,11 +564,6 @@ void ScriptVariable::ClearInternal()
         m_data.pointerValue = NULL;
         break;
 
-    case VARIABLE_VECTOR:
-        delete[] m_data.vectorValue;
-        m_data.vectorValue = NULL;
-        break;
-
     default:
         break;
     }
@@ -592,6 +581,26 @@ void ScriptVariable::ClearPointerInternal() const
     m_data.pointerValue->Clear();
 }
 
+str& ScriptVariable::stringData()
+{
+    return *reinterpret_cast<str *>(m_data.stringValue);
+}
+
+const str& ScriptVariable::stringData() const
+{
+    return *reinterpret_cast<const str *>(m_data.stringValue);
+}
+
+WeakRef<Listener>& ScriptVariable::listenerData()
+{
+    return *reinterpret_cast<WeakRef<Listener> *>(m_data.listenerValue);
+}
+
+const WeakRef<Listener>& ScriptVariable::listenerData() const
+{
+    return *reinterpret_cast<const WeakRef<Listener> *>(m_data.listenerValue);
+}
+
 const char *ScriptVariable::GetTypeName() const
 {
     return typenames[GetType()];
@@ -618,13 +627,13 @@ bool ScriptVariable::IsEntity(void) const
         return false;
     }
 
-    if (!m_data.listenerValue->Pointer()) {
+    if (!listenerData().Pointer()) {
         // Fixed in OPM
         //  Not sure why OG returns true
         return false;
     }
 #if defined(GAME_DLL)
-    if (!checkInheritance(Entity::classinfostatic(), m_data.listenerValue->Pointer()->classinfo())) {
+    if (!checkInheritance(Entity::classinfostatic(), listenerData().Pointer()->classinfo())) {
         return false;
     }
 #endif
@@ -655,13 +664,13 @@ bool ScriptVariable::IsSimpleEntity(void) const
         return false;
     }
 
-    if (!m_data.listenerValue->Pointer()) {
+    if (!listenerData().Pointer()) {
         // Fixed in OPM
         //  Not sure why OG returns true
         return false;
     }
 #    if defined(GAME_DLL)
-    if (!checkInheritance(Entity::classinfostatic(), m_data.listenerValue->Pointer()->classinfo())) {
+    if (!checkInheritance(Entity::classinfostatic(), listenerData().Pointer()->classinfo())) {
         return false;
     }
 #    endif
@@ -695,7 +704,7 @@ void ScriptVariable::PrintValue(void)
 #endif
 
     case VARIABLE_STRING:
-        printf("%s", m_data.stringValue->c_str());
+        printf("%s", stringData().c_str());
         break;
 
     case VARIABLE_INTEGER:
@@ -711,7 +720,7 @@ void ScriptVariable::PrintValue(void)
         break;
 
     case VARIABLE_LISTENER:
-        printf("<Listener>%p", m_data.listenerValue->Pointer());
+        printf("<Listener>%p", listenerData().Pointer());
         break;
 
     case VARIABLE_REF:
@@ -786,7 +795,7 @@ size_t ScriptVariable::size(void) const
         return stringValue().length();
 
     case VARIABLE_LISTENER:
-        return *m_data.listenerValue != NULL;
+        return listenerData() != NULL;
 
     case VARIABLE_ARRAY:
         return m_data.arrayValue->arrayValue.size();
@@ -833,7 +842,7 @@ bool ScriptVariable::booleanNumericValue(void)
         return fabs(m_data.floatValue) >= 0.00009999999747378752;
 
     case VARIABLE_LISTENER:
-        return (*m_data.listenerValue) != NULL;
+        return listenerData() != NULL;
 
     default:
         throw ScriptException("Cannot cast '%s' to boolean numeric", GetTypeName());
@@ -849,11 +858,7 @@ bool ScriptVariable::booleanValue(void) const
         return false;
 
     case VARIABLE_STRING:
-        if (m_data.stringValue) {
-            return m_data.stringValue->length() != 0;
-        }
-
-        return false;
+        return stringData().length() != 0;
 
     case VARIABLE_INTEGER:
         return m_data.intValue != 0;
@@ -865,7 +870,7 @@ bool ScriptVariable::booleanValue(void) const
         return m_data.intValue != STRING_EMPTY;
 
     case VARIABLE_LISTENER:
-        return (*m_data.listenerValue) != NULL;
+        return listenerData() != NULL;
 
     default:
         return true;
@@ -936,7 +941,7 @@ Entity *ScriptVariable::entityValue(void)
         ent = static_cast<Entity *>(world->GetScriptTarget(stringValue()));
         break;
     case VARIABLE_LISTENER:
-        ent = static_cast<Entity *>(m_data.listenerValue->Pointer());
+        ent = static_cast<Entity *>(listenerData().Pointer());
         break;
     default:
         throw ScriptException("Cannot cast '%s' to entity", typenames[GetType()]);
@@ -1103,7 +1108,7 @@ Listener *ScriptVariable::listenerValue(void) const
 #endif
 
     case VARIABLE_LISTENER:
-        return (Listener *)m_data.listenerValue->Pointer();
+        return (Listener *)listenerData().Pointer();
 
     default:
         throw ScriptException("Cannot cast '%s' to listener", typenames[GetType()]);
@@ -1134,6 +1139,7 @@ void ScriptVariable::newPointer(void)
 {
     type = VARIABLE_POINTER;
 
+    script_allocsthisframe++;
     m_data.pointerValue = new ScriptPointer();
     m_data.pointerValue->add(this);
 }
@@ -1161,7 +1167,7 @@ str ScriptVariable::stringValue() const
 #endif
 
     case VARIABLE_STRING:
-        return *m_data.stringValue;
+        return stringData();
 
     case VARIABLE_INTEGER:
         return str(m_data.intValue);
@@ -1173,17 +1179,17 @@ str ScriptVariable::stringValue() const
         return str(m_data.charValue);
 
     case VARIABLE_LISTENER:
-        if (m_data.listenerValue->Pointer()) {
+        if (listenerData().Pointer()) {
 #ifdef WITH_SCRIPT_ENGINE
-            if (m_data.listenerValue->Pointer()->isSubclassOf(SimpleEntity)) {
-                SimpleEntity *s = (SimpleEntity *)m_data.listenerValue->Pointer();
+            if (listenerData().Pointer()->isSubclassOf(SimpleEntity)) {
+                SimpleEntity *s = (SimpleEntity *)listenerData().Pointer();
                 return s->targetname;
             } else {
-                string = "class '" + str(m_data.listenerValue->Pointer()->getClassname()) + "'";
+                string = "class '" + str(listenerData().Pointer()->getClassname()) + "'";
                 return string;
             }
 #else
-            string = "class '" + str(m_data.listenerValue->Pointer()->getClassname()) + "'";
+            string = "class '" + str(listenerData().Pointer()->getClassname()) + "'";
             return string;
 #endif
         } else {
@@ -1236,16 +1242,16 @@ Vector ScriptVariable::vectorValue(void) const
         return Vector(x, y, z);
     case VARIABLE_LISTENER:
         {
-            if (!m_data.listenerValue->Pointer()) {
+            if (!listenerData().Pointer()) {
                 throw ScriptException("Cannot cast NULL to vector");
             }
 
 #ifdef WITH_SCRIPT_ENGINE
-            if (!checkInheritance(&SimpleEntity::ClassInfo, m_data.listenerValue->Pointer()->classinfo())) {
+            if (!checkInheritance(&SimpleEntity::ClassInfo, listenerData().Pointer()->classinfo())) {
                 throw ScriptException("Cannot cast '%s' to vector", GetTypeName());
             }
 
-            SimpleEntity *ent = (SimpleEntity *)m_data.listenerValue->Pointer();
+            SimpleEntity *ent = (SimpleEntity *)listenerData().Pointer();
 
             return Vector(ent->origin[0], ent->origin[1], ent->origin[2]);
 #else
@@ -1319,6 +1325,7 @@ void ScriptVariable::setArrayAtRef(ScriptVariable& index, ScriptVariable& value)
     case VARIABLE_NONE:
         type = VARIABLE_ARRAY;
 
+        script_allocsthisframe++;
         m_data.arrayValue = new ScriptArrayHolder;
 
         if (value.GetType() != VARIABLE_NONE) {
@@ -1397,6 +1404,7 @@ void ScriptVariable::setSafeContainerValue(ConList *newvalue)
     ClearInternal();
 
     if (newvalue) {
+        script_allocsthisframe++;
         type                      = VARIABLE_SAFECONTAINER;
         m_data.safeContainerValue = new SafePtr<ConList>(newvalue);
     } else {
@@ -1406,6 +1414,7 @@ void ScriptVariable::setSafeContainerValue(ConList *newvalue)
 
 void ScriptVariable::setConstArrayValue(ScriptVariable *pVar, unsigned int size)
 {
+    script_allocsthisframe++;
     ScriptConstArrayHolder *constArray = new ScriptConstArrayHolder(pVar, size);
 
     ClearInternal();
@@ -1454,7 +1463,7 @@ void ScriptVariable::setListenerValue(Listener *newvalue)
 
     type = VARIABLE_LISTENER;
 
-    m_data.listenerValue = new SafePtr<Listener>(newvalue);
+    new (m_data.listenerValue) WeakRef<Listener>(newvalue);
 }
 
 void ScriptVariable::setPointer(const ScriptVariable& newvalue)
@@ -1474,22 +1483,22 @@ void ScriptVariable::setRefValue(ScriptVariable *ref)
 
 void ScriptVariable::setStringValue(str newvalue)
 {
-    str *s;
+    if (GetType() == VARIABLE_STRING) {
+        stringData() = std::move(newvalue);
+        return;
+    }
 
     ClearInternal();
     type = VARIABLE_STRING;
 
-    s = new str(newvalue);
-
-    m_data.stringValue = s;
+    new (m_data.stringValue) str(std::move(newvalue));
 }
 
 void ScriptVariable::setVectorValue(const Vector& newvector)
 {
     ClearInternal();
 
-    type               = VARIABLE_VECTOR;
-    m_data.vectorValue = new float[3];
+    type = VARIABLE_VECTOR;
     newvector.copyTo(m_data.vectorValue);
 }
 
@@ -1559,7 +1568,18 @@ void ScriptVariable::operator+=(const ScriptVariable& value)
         + VARIABLE_LISTENER                     *VARIABLE_MAX: // ( const string )		+		( listener )
     case VARIABLE_STRING + VARIABLE_VECTOR      *VARIABLE_MAX: // ( string )			+		( vector )
     case VARIABLE_CONSTSTRING + VARIABLE_VECTOR *VARIABLE_MAX: // ( const string )		+		( vector )
-        setStringValue(stringValue() + value.stringValue());
+        if (currentType == VARIABLE_STRING) {
+            const char *oldData = stringData().c_str();
+
+            // append in place rather than building a new string
+            stringData().append(value.stringValue());
+            if (stringData().c_str() != oldData) {
+                script_allocsthisframe++;
+            }
+        } else {
+            setStringValue(stringValue() + value.stringValue());
+            script_allocsthisframe++;
+        }
         break;
 
     case VARIABLE_VECTOR + VARIABLE_VECTOR *VARIABLE_MAX:
@@ -1737,7 +1757,7 @@ void ScriptVariable::operator/=(const ScriptVariable& value)
         break;
 
     case VARIABLE_VECTOR + VARIABLE_VECTOR *VARIABLE_MAX: // ( vector ) / ( vector )
-        m_data.vectorValue = vec_zero;
+        VectorClear(m_data.vectorValue);
 
         if (value.m_data.vectorValue[0] != 0) {
             m_data.vectorValue[0] = m_data.vectorValue[0] / value.m_data.vectorValue[0];
@@ -1852,7 +1872,7 @@ void ScriptVariable::operator%=(const ScriptVariable& value)
         break;
 
     case VARIABLE_VECTOR + VARIABLE_VECTOR *VARIABLE_MAX: // ( vector ) % ( vector )
-        m_data.vectorValue = vec_zero;
+        VectorClear(m_data.vectorValue);
 
         if (value.m_data.vectorValue[0] != 0) {
             m_data.vectorValue[0] = fmod(m_data.vectorValue[0], value.m_data.vectorValue[0]);
@@ -1994,18 +2014,7 @@ bool ScriptVariable::operator==(const ScriptVariable& value)
 
     case VARIABLE_LISTENER + VARIABLE_LISTENER *VARIABLE_MAX: // ( listener ) == ( listener )
         {
-            Class *lval = NULL;
-            Class *rval = NULL;
-
-            if (m_data.listenerValue) {
-                lval = m_data.listenerValue->Pointer();
-            }
-
-            if (value.m_data.listenerValue) {
-                rval = value.m_data.listenerValue->Pointer();
-            }
-
-            return lval == rval;
+            return listenerData().Pointer() == value.listenerData().Pointer();
         }
 
     case VARIABLE_INTEGER + VARIABLE_INTEGER *VARIABLE_MAX: // ( int ) == ( int )
@@ -2092,7 +2101,7 @@ ScriptVariable& ScriptVariable::operator=(const ScriptVariable& variable)
             break;
 
         case VARIABLE_STRING:
-            m_data.stringValue = new str(*variable.m_data.stringValue);
+            new (m_data.stringValue) str(variable.stringData());
             break;
 
         case VARIABLE_FLOAT:
@@ -2108,7 +2117,7 @@ ScriptVariable& ScriptVariable::operator=(const ScriptVariable& variable)
             break;
 
         case VARIABLE_LISTENER:
-            m_data.listenerValue = new SafePtr<Listener>(*variable.m_data.listenerValue);
+            new (m_data.listenerValue) WeakRef<Listener>(variable.listenerData());
             break;
 
         case VARIABLE_ARRAY:
@@ -2126,6 +2135,7 @@ ScriptVariable& ScriptVariable::operator=(const ScriptVariable& variable)
             break;
 
         case VARIABLE_SAFECONTAINER:
+            script_allocsthisframe++;
             m_data.safeContainerValue = new SafePtr<ConList>(*variable.m_data.safeContainerValue);
             break;
 
@@ -2135,7 +2145,6 @@ ScriptVariable& ScriptVariable::operator=(const ScriptVariable& variable)
             break;
 
         case VARIABLE_VECTOR:
-            m_data.vectorValue = (float *)new float[3];
             VectorCopy(variable.m_data.vectorValue, m_data.vectorValue);
             break;
         }
@@ -2151,7 +2160,7 @@ ScriptVariable& ScriptVariable::operator=(const ScriptVariable& variable)
             break;
 
         case VARIABLE_STRING:
-            *m_data.stringValue = *variable.m_data.stringValue;
+            stringData() = variable.stringData();
             break;
 
         case VARIABLE_FLOAT:
@@ -2167,7 +2176,7 @@ ScriptVariable& ScriptVariable::operator=(const ScriptVariable& variable)
             break;
 
         case VARIABLE_LISTENER:
-            *m_data.listenerValue = *variable.m_data.listenerValue;
+            listenerData() = variable.listenerData();
             break;
 
         case VARIABLE_ARRAY:
@@ -2189,6 +2198,7 @@ ScriptVariable& ScriptVariable::operator=(const ScriptVariable& variable)
 
         case VARIABLE_SAFECONTAINER:
             ClearInternal();
+            script_allocsthisframe++;
             m_data.safeContainerValue = new SafePtr<ConList>(*variable.m_data.safeContainerValue);
             break;
 
@@ -2237,6 +2247,7 @@ ScriptVariable& ScriptVariable::operator[](ScriptVariable& index)
     case VARIABLE_NONE:
         type = VARIABLE_ARRAY;
 
+        script_allocsthisframe++;
         m_data.arrayValue = new ScriptArrayHolder;
         return m_data.arrayValue->arrayValue[index];
 
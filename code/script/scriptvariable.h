@@ -67,6 +67,10 @@ static const char *typenames[] = {
     "double"
 };
 
+// heap allocations made for variable values since the start of the frame,
+// this includes strings that had to be built or grown
+extern unsigned int script_allocsthisframe;
+
 class ScriptArrayHolder;
 class ScriptConstArrayHolder;
 class ScriptPointer;
@@ -84,11 +88,13 @@ public:
         char               charValue;
         float              floatValue;
         int                intValue;
-        SafePtr<Listener> *listenerValue;
-        str               *stringValue;
-        float             *vectorValue;
         void              *anyValue;
 
+        // strings, vectors and listeners are stored in place, without a separate allocation
+        alignas(str) unsigned char stringValue[sizeof(str)];
+        float vectorValue[3];
+        alignas(WeakRef<Listener>) unsigned char listenerValue[sizeof(WeakRef<Listener>)];
+
         ScriptVariable *refValue;
 
         ScriptArrayHolder      *arrayValue;
@@ -104,6 +110,12 @@ private:
     void ClearInternal();
     void ClearPointerInternal() const;
 
+    str&       stringData();
+    const str& stringData() const;
+
+    WeakRef<Listener>&       listenerData();
+    const WeakRef<Listener>& listenerData() const;
+
 public:
     ScriptVariable();
     ScriptVariable(const ScriptVariable& variable);
@@ -295,9 +307,6 @@ class con_set_Entry<short3, ScriptVariable>
     friend con_set<short3, ScriptVariable>;
     friend con_set_enum<short3, ScriptVariable>;
 
-private:
-    con_set_Entry *next;
-
 public:
     ScriptVariable value;
 
@@ -53,6 +53,35 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #endif
 
+// the execution time is checked every few commands
+#define VM_COMMAND_CHECK_COUNT 15000
+
+#if defined(SCRIPTVM_COMPUTED_GOTO)
+
+//
+// Each opcode handler jumps directly to the next handler through the dispatch table,
+// the loop is only used to trace, check the execution time and stop running
+//
+#    define VM_DISPATCH(op) goto *dispatchTable[op]
+#    define VM_CASE(op)     case op: vm_##op
+#    define VM_DEFAULT      default: vm_default
+#    define VM_NEXT                                                                                  \
+        if (!bTrace && state == STATE_RUNNING && ++Director.cmdCount < VM_COMMAND_CHECK_COUNT) { \
+            m_PrevCodePos = m_CodePos;                                                           \
+            opcode        = m_CodePos++;                                                         \
+            goto *dispatchTable[*opcode];                                                        \
+        }                                                                                        \
+        break
+
+#else
+
+#    define VM_DISPATCH(op)
+#    define VM_CASE(op) case op
+#    define VM_DEFAULT  default
+#    define VM_NEXT     break
+
+#endif
+
 static const ScriptVM *currentScriptFile;
 static unsigned int    currentScriptLine;
 
@@ -464,6 +493,22 @@ bool ScriptVM::doJumpVarIf(bool booleanValue)
     return jumpVar(offset, booleanValue);
 }
 
+void ScriptVM::doCompareJumpFalse(void (ScriptVariable::*compare)(ScriptVariable& variable))
+{
+    ScriptVariable& a = m_VMStack.Pop();
+    ScriptVariable& b = m_VMStack.GetTop();
+
+    try {
+        (b.*compare)(a);
+    } catch (...) {
+        // the result was cleared, jump like the separate opcodes
+        doJumpIf(!m_VMStack.Pop().booleanValue());
+        throw;
+    }
+
+    doJumpIf(!m_VMStack.Pop().m_data.intValue);
+}
+
 void ScriptVM::loadTopInternal(Listener *listener)
 {
     const const_str variable = fetchOpcodeValue<op_name_t>();
@@ -1017,21 +1062,6 @@ Executes a program
 */
 void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
 {
-    unsigned char *opcode;
-
-    ScriptVariable *a;
-    ScriptVariable *b;
-    ScriptVariable *c;
-
-    op_name_t fieldNameIndex;
-
-    Listener *listener;
-
-    Event           ev;
-    ScriptVariable *var = NULL;
-
-    TargetList *targetList;
-
     if (Director.stackCount >= MAX_STACK_DEPTH) {
         state = STATE_EXECUTION;
 
@@ -1063,8 +1093,191 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
 
     state = STATE_RUNNING;
 
+    // the trace is checked once, so the usual path is compiled without it
+    if (g_scripttrace->integer) {
+        executeOpcodes<true>();
+    } else {
+        executeOpcodes<false>();
+    }
+
+    Director.stackCount--;
+
+    if (g_scripttrace->integer && CanScriptTracePrint()) {
+        gi.DPrintf2(
+            "---FRAME: %i (%p) -------------------------------------------------------------------\n",
+            Director.stackCount,
+            this
+        );
+    }
+
+    switch (state) {
+    case STATE_WAITING:
+        delete m_Thread;
+        delete this;
+        break;
+    case STATE_SUSPENDED:
+        state = STATE_EXECUTION;
+        break;
+    case STATE_DESTROYED:
+        delete this;
+        break;
+    }
+}
+
+/*
+====================
+executeOpcodes
+
+Runs the program until the VM stops running
+====================
+*/
+template<bool bTrace>
+void ScriptVM::executeOpcodes()
+{
+    unsigned char *opcode;
+
+    ScriptVariable *a;
+    ScriptVariable *b;
+    ScriptVariable *c;
+
+    op_name_t fieldNameIndex;
+
+    Listener *listener;
+
+    TargetList *targetList;
+
+#if defined(SCRIPTVM_COMPUTED_GOTO)
+    static void *dispatchTable[256];
+
+    if (!dispatchTable[0]) {
+        int i;
+
+        for (i = 0; i < 256; i++) {
+            dispatchTable[i] = &&vm_default;
+        }
+
+        dispatchTable[OP_BIN_BITWISE_AND]                       = &&vm_OP_BIN_BITWISE_AND;
+        dispatchTable[OP_BIN_BITWISE_OR]                        = &&vm_OP_BIN_BITWISE_OR;
+        dispatchTable[OP_BIN_BITWISE_EXCL_OR]                   = &&vm_OP_BIN_BITWISE_EXCL_OR;
+        dispatchTable[OP_BIN_EQUALITY]                          = &&vm_OP_BIN_EQUALITY;
+        dispatchTable[OP_BIN_INEQUALITY]                        = &&vm_OP_BIN_INEQUALITY;
+        dispatchTable[OP_BIN_GREATER_THAN]                      = &&vm_OP_BIN_GREATER_THAN;
+        dispatchTable[OP_BIN_GREATER_THAN_OR_EQUAL]             = &&vm_OP_BIN_GREATER_THAN_OR_EQUAL;
+        dispatchTable[OP_BIN_LESS_THAN]                         = &&vm_OP_BIN_LESS_THAN;
+        dispatchTable[OP_BIN_LESS_THAN_OR_EQUAL]                = &&vm_OP_BIN_LESS_THAN_OR_EQUAL;
+        dispatchTable[OP_BIN_PLUS]                              = &&vm_OP_BIN_PLUS;
+        dispatchTable[OP_BIN_MINUS]                             = &&vm_OP_BIN_MINUS;
+        dispatchTable[OP_BIN_MULTIPLY]                          = &&vm_OP_BIN_MULTIPLY;
+        dispatchTable[OP_BIN_DIVIDE]                            = &&vm_OP_BIN_DIVIDE;
+        dispatchTable[OP_BIN_PERCENTAGE]                        = &&vm_OP_BIN_PERCENTAGE;
+        dispatchTable[OP_BIN_SHIFT_LEFT]                        = &&vm_OP_BIN_SHIFT_LEFT;
+        dispatchTable[OP_BIN_SHIFT_RIGHT]                       = &&vm_OP_BIN_SHIFT_RIGHT;
+        dispatchTable[OP_BOOL_JUMP_FALSE4]                      = &&vm_OP_BOOL_JUMP_FALSE4;
+        dispatchTable[OP_BOOL_JUMP_TRUE4]                       = &&vm_OP_BOOL_JUMP_TRUE4;
+        dispatchTable[OP_VAR_JUMP_FALSE4]                       = &&vm_OP_VAR_JUMP_FALSE4;
+        dispatchTable[OP_BIN_EQUALITY_JUMP_FALSE4]              = &&vm_OP_BIN_EQUALITY_JUMP_FALSE4;
+        dispatchTable[OP_BIN_INEQUALITY_JUMP_FALSE4]            = &&vm_OP_BIN_INEQUALITY_JUMP_FALSE4;
+        dispatchTable[OP_BIN_LESS_THAN_JUMP_FALSE4]             = &&vm_OP_BIN_LESS_THAN_JUMP_FALSE4;
+        dispatchTable[OP_BIN_GREATER_THAN_JUMP_FALSE4]          = &&vm_OP_BIN_GREATER_THAN_JUMP_FALSE4;
+        dispatchTable[OP_BIN_LESS_THAN_OR_EQUAL_JUMP_FALSE4]    = &&vm_OP_BIN_LESS_THAN_OR_EQUAL_JUMP_FALSE4;
+        dispatchTable[OP_BIN_GREATER_THAN_OR_EQUAL_JUMP_FALSE4] = &&vm_OP_BIN_GREATER_THAN_OR_EQUAL_JUMP_FALSE4;
+        dispatchTable[OP_VAR_JUMP_TRUE4]                        = &&vm_OP_VAR_JUMP_TRUE4;
+        dispatchTable[OP_BOOL_LOGICAL_AND]                      = &&vm_OP_BOOL_LOGICAL_AND;
+        dispatchTable[OP_BOOL_LOGICAL_OR]                       = &&vm_OP_BOOL_LOGICAL_OR;
+        dispatchTable[OP_VAR_LOGICAL_AND]                       = &&vm_OP_VAR_LOGICAL_AND;
+        dispatchTable[OP_VAR_LOGICAL_OR]                        = &&vm_OP_VAR_LOGICAL_OR;
+        dispatchTable[OP_BOOL_STORE_FALSE]                      = &&vm_OP_BOOL_STORE_FALSE;
+        dispatchTable[OP_BOOL_STORE_TRUE]                       = &&vm_OP_BOOL_STORE_TRUE;
+        dispatchTable[OP_BOOL_UN_NOT]                           = &&vm_OP_BOOL_UN_NOT;
+        dispatchTable[OP_CALC_VECTOR]                           = &&vm_OP_CALC_VECTOR;
+        dispatchTable[OP_EXEC_CMD0]                             = &&vm_OP_EXEC_CMD0;
+        dispatchTable[OP_EXEC_CMD1]                             = &&vm_OP_EXEC_CMD1;
+        dispatchTable[OP_EXEC_CMD2]                             = &&vm_OP_EXEC_CMD2;
+        dispatchTable[OP_EXEC_CMD3]                             = &&vm_OP_EXEC_CMD3;
+        dispatchTable[OP_EXEC_CMD4]                             = &&vm_OP_EXEC_CMD4;
+        dispatchTable[OP_EXEC_CMD5]                             = &&vm_OP_EXEC_CMD5;
+        dispatchTable[OP_EXEC_CMD_COUNT1]                       = &&vm_OP_EXEC_CMD_COUNT1;
+        dispatchTable[OP_EXEC_CMD_METHOD0]                      = &&vm_OP_EXEC_CMD_METHOD0;
+        dispatchTable[OP_EXEC_CMD_METHOD1]                      = &&vm_OP_EXEC_CMD_METHOD1;
+        dispatchTable[OP_EXEC_CMD_METHOD2]                      = &&vm_OP_EXEC_CMD_METHOD2;
+        dispatchTable[OP_EXEC_CMD_METHOD3]                      = &&vm_OP_EXEC_CMD_METHOD3;
+        dispatchTable[OP_EXEC_CMD_METHOD4]                      = &&vm_OP_EXEC_CMD_METHOD4;
+        dispatchTable[OP_EXEC_CMD_METHOD5]                      = &&vm_OP_EXEC_CMD_METHOD5;
+        dispatchTable[OP_EXEC_CMD_METHOD_COUNT1]                = &&vm_OP_EXEC_CMD_METHOD_COUNT1;
+        dispatchTable[OP_EXEC_METHOD0]                          = &&vm_OP_EXEC_METHOD0;
+        dispatchTable[OP_EXEC_METHOD1]                          = &&vm_OP_EXEC_METHOD1;
+        dispatchTable[OP_EXEC_METHOD2]                          = &&vm_OP_EXEC_METHOD2;
+        dispatchTable[OP_EXEC_METHOD3]                          = &&vm_OP_EXEC_METHOD3;
+        dispatchTable[OP_EXEC_METHOD4]                          = &&vm_OP_EXEC_METHOD4;
+        dispatchTable[OP_EXEC_METHOD5]                          = &&vm_OP_EXEC_METHOD5;
+        dispatchTable[OP_EXEC_METHOD_COUNT1]                    = &&vm_OP_EXEC_METHOD_COUNT1;
+        dispatchTable[OP_FUNC]                                  = &&vm_OP_FUNC;
+        dispatchTable[OP_JUMP4]                                 = &&vm_OP_JUMP4;
+        dispatchTable[OP_JUMP_BACK4]                            = &&vm_OP_JUMP_BACK4;
+        dispatchTable[OP_LOAD_ARRAY_VAR]                        = &&vm_OP_LOAD_ARRAY_VAR;
+        dispatchTable[OP_LOAD_FIELD_VAR]                        = &&vm_OP_LOAD_FIELD_VAR;
+        dispatchTable[OP_LOAD_CONST_ARRAY1]                     = &&vm_OP_LOAD_CONST_ARRAY1;
+        dispatchTable[OP_LOAD_GAME_VAR]                         = &&vm_OP_LOAD_GAME_VAR;
+        dispatchTable[OP_LOAD_GROUP_VAR]                        = &&vm_OP_LOAD_GROUP_VAR;
+        dispatchTable[OP_LOAD_LEVEL_VAR]                        = &&vm_OP_LOAD_LEVEL_VAR;
+        dispatchTable[OP_LOAD_LOCAL_VAR]                        = &&vm_OP_LOAD_LOCAL_VAR;
+        dispatchTable[OP_LOAD_OWNER_VAR]                        = &&vm_OP_LOAD_OWNER_VAR;
+        dispatchTable[OP_LOAD_PARM_VAR]                         = &&vm_OP_LOAD_PARM_VAR;
+        dispatchTable[OP_LOAD_SELF_VAR]                         = &&vm_OP_LOAD_SELF_VAR;
+        dispatchTable[OP_LOAD_STORE_GAME_VAR]                   = &&vm_OP_LOAD_STORE_GAME_VAR;
+        dispatchTable[OP_LOAD_STORE_GROUP_VAR]                  = &&vm_OP_LOAD_STORE_GROUP_VAR;
+        dispatchTable[OP_LOAD_STORE_LEVEL_VAR]                  = &&vm_OP_LOAD_STORE_LEVEL_VAR;
+        dispatchTable[OP_LOAD_STORE_LOCAL_VAR]                  = &&vm_OP_LOAD_STORE_LOCAL_VAR;
+        dispatchTable[OP_LOAD_STORE_OWNER_VAR]                  = &&vm_OP_LOAD_STORE_OWNER_VAR;
+        dispatchTable[OP_LOAD_STORE_PARM_VAR]                   = &&vm_OP_LOAD_STORE_PARM_VAR;
+        dispatchTable[OP_LOAD_STORE_SELF_VAR]                   = &&vm_OP_LOAD_STORE_SELF_VAR;
+        dispatchTable[OP_MARK_STACK_POS]                        = &&vm_OP_MARK_STACK_POS;
+        dispatchTable[OP_STORE_PARAM]                           = &&vm_OP_STORE_PARAM;
+        dispatchTable[OP_RESTORE_STACK_POS]                     = &&vm_OP_RESTORE_STACK_POS;
+        dispatchTable[OP_STORE_ARRAY]                           = &&vm_OP_STORE_ARRAY;
+        dispatchTable[OP_STORE_ARRAY_REF]                       = &&vm_OP_STORE_ARRAY_REF;
+        dispatchTable[OP_STORE_FIELD_REF]                       = &&vm_OP_STORE_FIELD_REF;
+        dispatchTable[OP_STORE_FIELD]                           = &&vm_OP_STORE_FIELD;
+        dispatchTable[OP_STORE_FLOAT]                           = &&vm_OP_STORE_FLOAT;
+        dispatchTable[OP_STORE_INT0]                            = &&vm_OP_STORE_INT0;
+        dispatchTable[OP_STORE_INT1]                            = &&vm_OP_STORE_INT1;
+        dispatchTable[OP_STORE_INT2]                            = &&vm_OP_STORE_INT2;
+        dispatchTable[OP_STORE_INT3]                            = &&vm_OP_STORE_INT3;
+        dispatchTable[OP_STORE_INT4]                            = &&vm_OP_STORE_INT4;
+        dispatchTable[OP_STORE_GAME_VAR]                        = &&vm_OP_STORE_GAME_VAR;
+        dispatchTable[OP_STORE_GROUP_VAR]                       = &&vm_OP_STORE_GROUP_VAR;
+        dispatchTable[OP_STORE_LEVEL_VAR]                       = &&vm_OP_STORE_LEVEL_VAR;
+        dispatchTable[OP_STORE_LOCAL_VAR]                       = &&vm_OP_STORE_LOCAL_VAR;
+        dispatchTable[OP_STORE_OWNER_VAR]                       = &&vm_OP_STORE_OWNER_VAR;
+        dispatchTable[OP_STORE_PARM_VAR]                        = &&vm_OP_STORE_PARM_VAR;
+        dispatchTable[OP_STORE_SELF_VAR]                        = &&vm_OP_STORE_SELF_VAR;
+        dispatchTable[OP_STORE_GAME]                            = &&vm_OP_STORE_GAME;
+        dispatchTable[OP_STORE_GROUP]                           = &&vm_OP_STORE_GROUP;
+        dispatchTable[OP_STORE_LEVEL]                           = &&vm_OP_STORE_LEVEL;
+        dispatchTable[OP_STORE_LOCAL]                           = &&vm_OP_STORE_LOCAL;
+        dispatchTable[OP_STORE_OWNER]                           = &&vm_OP_STORE_OWNER;
+        dispatchTable[OP_STORE_PARM]                            = &&vm_OP_STORE_PARM;
+        dispatchTable[OP_STORE_SELF]                            = &&vm_OP_STORE_SELF;
+        dispatchTable[OP_STORE_NIL]                             = &&vm_OP_STORE_NIL;
+        dispatchTable[OP_STORE_NULL]                            = &&vm_OP_STORE_NULL;
+        dispatchTable[OP_STORE_STRING]                          = &&vm_OP_STORE_STRING;
+        dispatchTable[OP_STORE_VECTOR]                          = &&vm_OP_STORE_VECTOR;
+        dispatchTable[OP_SWITCH]                                = &&vm_OP_SWITCH;
+        dispatchTable[OP_UN_CAST_BOOLEAN]                       = &&vm_OP_UN_CAST_BOOLEAN;
+        dispatchTable[OP_UN_COMPLEMENT]                         = &&vm_OP_UN_COMPLEMENT;
+        dispatchTable[OP_UN_MINUS]                              = &&vm_OP_UN_MINUS;
+        dispatchTable[OP_UN_DEC]                                = &&vm_OP_UN_DEC;
+        dispatchTable[OP_UN_INC]                                = &&vm_OP_UN_INC;
+        dispatchTable[OP_UN_SIZE]                               = &&vm_OP_UN_SIZE;
+        dispatchTable[OP_UN_TARGETNAME]                         = &&vm_OP_UN_TARGETNAME;
+        dispatchTable[OP_VAR_UN_NOT]                            = &&vm_OP_VAR_UN_NOT;
+        dispatchTable[OP_DONE]                                  = &&vm_OP_DONE;
+        dispatchTable[OP_NOP]                                   = &&vm_OP_NOP;
+    }
+#endif
+
     while (state == STATE_RUNNING) {
-        if (g_scripttrace->integer && CanScriptTracePrint()) {
+        if (bTrace && CanScriptTracePrint()) {
             switch (g_scripttrace->integer) {
             case 1:
             case 3:
@@ -1103,327 +1316,359 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
             }
 
             opcode = m_CodePos++;
+            VM_DISPATCH(*opcode);
+
             switch (*opcode) {
-            case OP_BIN_BITWISE_AND:
+            VM_CASE(OP_BIN_BITWISE_AND):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b &= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_BITWISE_OR:
+            VM_CASE(OP_BIN_BITWISE_OR):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b |= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_BITWISE_EXCL_OR:
+            VM_CASE(OP_BIN_BITWISE_EXCL_OR):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b ^= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_EQUALITY:
+            VM_CASE(OP_BIN_EQUALITY):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->setIntValue(*b == *a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_INEQUALITY:
+            VM_CASE(OP_BIN_INEQUALITY):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->setIntValue(*b != *a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_GREATER_THAN:
+            VM_CASE(OP_BIN_GREATER_THAN):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->greaterthan(*a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_GREATER_THAN_OR_EQUAL:
+            VM_CASE(OP_BIN_GREATER_THAN_OR_EQUAL):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->greaterthanorequal(*a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_LESS_THAN:
+            VM_CASE(OP_BIN_LESS_THAN):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->lessthan(*a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_LESS_THAN_OR_EQUAL:
+            VM_CASE(OP_BIN_LESS_THAN_OR_EQUAL):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 b->lessthanorequal(*a);
-                break;
+                VM_NEXT;
 
-            case OP_BIN_PLUS:
+            VM_CASE(OP_BIN_PLUS):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b += *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_MINUS:
+            VM_CASE(OP_BIN_MINUS):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b -= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_MULTIPLY:
+            VM_CASE(OP_BIN_MULTIPLY):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b *= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_DIVIDE:
+            VM_CASE(OP_BIN_DIVIDE):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b /= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_PERCENTAGE:
+            VM_CASE(OP_BIN_PERCENTAGE):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b %= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_SHIFT_LEFT:
+            VM_CASE(OP_BIN_SHIFT_LEFT):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b <<= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BIN_SHIFT_RIGHT:
+            VM_CASE(OP_BIN_SHIFT_RIGHT):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.GetTop();
 
                 *b >>= *a;
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_JUMP_FALSE4:
+            VM_CASE(OP_BOOL_JUMP_FALSE4):
                 doJumpIf(!m_VMStack.Pop().m_data.intValue);
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_JUMP_TRUE4:
+            VM_CASE(OP_BOOL_JUMP_TRUE4):
                 doJumpIf(m_VMStack.Pop().m_data.intValue);
-                break;
+                VM_NEXT;
 
-            case OP_VAR_JUMP_FALSE4:
+            VM_CASE(OP_VAR_JUMP_FALSE4):
                 doJumpIf(!m_VMStack.Pop().booleanValue());
-                break;
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_EQUALITY_JUMP_FALSE4):
+                a = &m_VMStack.Pop();
+                b = &m_VMStack.Pop();
+
+                doJumpIf(!(*b == *a));
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_INEQUALITY_JUMP_FALSE4):
+                a = &m_VMStack.Pop();
+                b = &m_VMStack.Pop();
+
+                doJumpIf(*b == *a);
+                VM_NEXT;
 
-            case OP_VAR_JUMP_TRUE4:
+            VM_CASE(OP_BIN_LESS_THAN_JUMP_FALSE4):
+                doCompareJumpFalse(&ScriptVariable::lessthan);
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_GREATER_THAN_JUMP_FALSE4):
+                doCompareJumpFalse(&ScriptVariable::greaterthan);
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_LESS_THAN_OR_EQUAL_JUMP_FALSE4):
+                doCompareJumpFalse(&ScriptVariable::lessthanorequal);
+                VM_NEXT;
+
+            VM_CASE(OP_BIN_GREATER_THAN_OR_EQUAL_JUMP_FALSE4):
+                doCompareJumpFalse(&ScriptVariable::greaterthanorequal);
+                VM_NEXT;
+
+            VM_CASE(OP_VAR_JUMP_TRUE4):
                 doJumpIf(m_VMStack.Pop().booleanValue());
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_LOGICAL_AND:
+            VM_CASE(OP_BOOL_LOGICAL_AND):
                 doJumpVarIf(!m_VMStack.GetTop().m_data.intValue);
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_LOGICAL_OR:
+            VM_CASE(OP_BOOL_LOGICAL_OR):
                 doJumpVarIf(m_VMStack.GetTop().m_data.intValue);
-                break;
+                VM_NEXT;
 
-            case OP_VAR_LOGICAL_AND:
+            VM_CASE(OP_VAR_LOGICAL_AND):
                 if (!doJumpVarIf(m_VMStack.GetTop().booleanValue())) {
                     m_VMStack.GetTop().SetFalse();
                 }
-                break;
+                VM_NEXT;
 
-            case OP_VAR_LOGICAL_OR:
+            VM_CASE(OP_VAR_LOGICAL_OR):
                 if (!doJumpVarIf(!m_VMStack.GetTop().booleanValue())) {
                     m_VMStack.GetTop().SetTrue();
                 }
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_STORE_FALSE:
+            VM_CASE(OP_BOOL_STORE_FALSE):
                 m_VMStack.PushAndGet().SetFalse();
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_STORE_TRUE:
+            VM_CASE(OP_BOOL_STORE_TRUE):
                 m_VMStack.PushAndGet().SetTrue();
-                break;
+                VM_NEXT;
 
-            case OP_BOOL_UN_NOT:
+            VM_CASE(OP_BOOL_UN_NOT):
                 m_VMStack.GetTop().m_data.intValue = (m_VMStack.GetTop().m_data.intValue == 0);
-                break;
+                VM_NEXT;
 
-            case OP_CALC_VECTOR:
+            VM_CASE(OP_CALC_VECTOR):
                 c = &m_VMStack.Pop();
                 b = &m_VMStack.Pop();
                 a = &m_VMStack.GetTop();
 
                 m_VMStack.GetTop().setVectorValue(Vector(a->floatValue(), b->floatValue(), c->floatValue()));
-                break;
+                VM_NEXT;
 
-            case OP_EXEC_CMD0:
+            VM_CASE(OP_EXEC_CMD0):
                 {
                     execCmdCommon(0);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD1:
+            VM_CASE(OP_EXEC_CMD1):
                 {
                     execCmdCommon(1);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD2:
+            VM_CASE(OP_EXEC_CMD2):
                 {
                     execCmdCommon(2);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD3:
+            VM_CASE(OP_EXEC_CMD3):
                 {
                     execCmdCommon(3);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD4:
+            VM_CASE(OP_EXEC_CMD4):
                 {
                     execCmdCommon(4);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD5:
+            VM_CASE(OP_EXEC_CMD5):
                 {
                     execCmdCommon(5);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_COUNT1:
+            VM_CASE(OP_EXEC_CMD_COUNT1):
                 {
                     const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
                     execCmdCommon(numParms);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD0:
+            VM_CASE(OP_EXEC_CMD_METHOD0):
                 {
                     execCmdMethodCommon(0);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD1:
+            VM_CASE(OP_EXEC_CMD_METHOD1):
                 {
                     execCmdMethodCommon(1);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD2:
+            VM_CASE(OP_EXEC_CMD_METHOD2):
                 {
                     execCmdMethodCommon(2);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD3:
+            VM_CASE(OP_EXEC_CMD_METHOD3):
                 {
                     execCmdMethodCommon(3);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD4:
+            VM_CASE(OP_EXEC_CMD_METHOD4):
                 {
                     execCmdMethodCommon(4);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD5:
+            VM_CASE(OP_EXEC_CMD_METHOD5):
                 {
                     execCmdMethodCommon(5);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_CMD_METHOD_COUNT1:
+            VM_CASE(OP_EXEC_CMD_METHOD_COUNT1):
                 {
                     const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
                     execCmdMethodCommon(numParms);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD0:
+            VM_CASE(OP_EXEC_METHOD0):
                 {
                     execMethodCommon(0);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD1:
+            VM_CASE(OP_EXEC_METHOD1):
                 {
                     execMethodCommon(1);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD2:
+            VM_CASE(OP_EXEC_METHOD2):
                 {
                     execMethodCommon(2);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD3:
+            VM_CASE(OP_EXEC_METHOD3):
                 {
                     execMethodCommon(3);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD4:
+            VM_CASE(OP_EXEC_METHOD4):
                 {
                     execMethodCommon(4);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD5:
+            VM_CASE(OP_EXEC_METHOD5):
                 {
                     execMethodCommon(5);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_EXEC_METHOD_COUNT1:
+            VM_CASE(OP_EXEC_METHOD_COUNT1):
                 {
                     const op_parmNum_t numParms = fetchOpcodeValue<op_parmNum_t>();
                     execMethodCommon(numParms);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_FUNC:
+            VM_CASE(OP_FUNC):
                 {
                     execFunction(Director);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_JUMP4:
+            VM_CASE(OP_JUMP4):
                 jump(fetchOpcodeValue<unsigned int>());
-                break;
+                VM_NEXT;
 
-            case OP_JUMP_BACK4:
+            VM_CASE(OP_JUMP_BACK4):
                 jumpBack(fetchActualOpcodeValue<unsigned int>());
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_ARRAY_VAR:
+            VM_CASE(OP_LOAD_ARRAY_VAR):
                 a = &m_VMStack.Pop();
                 b = &m_VMStack.Pop();
                 c = &m_VMStack.Pop();
 
                 b->setArrayAt(*a, *c);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_FIELD_VAR:
+            VM_CASE(OP_LOAD_FIELD_VAR):
                 a = &m_VMStack.Pop();
 
                 try {
@@ -1447,34 +1692,34 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                     throw;
                 }
 
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_CONST_ARRAY1:
+            VM_CASE(OP_LOAD_CONST_ARRAY1):
                 {
                     op_arrayParmNum_t numParms = fetchOpcodeValue<op_arrayParmNum_t>();
 
                     ScriptVariable& pTop = m_VMStack.PopAndGet(numParms - 1);
                     pTop.setConstArrayValue(&pTop, numParms);
-                    break;
+                    VM_NEXT;
                 }
 
-            case OP_LOAD_GAME_VAR:
+            VM_CASE(OP_LOAD_GAME_VAR):
                 loadTop(&game);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_GROUP_VAR:
+            VM_CASE(OP_LOAD_GROUP_VAR):
                 loadTop(m_ScriptClass);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_LEVEL_VAR:
+            VM_CASE(OP_LOAD_LEVEL_VAR):
                 loadTop(&level);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_LOCAL_VAR:
+            VM_CASE(OP_LOAD_LOCAL_VAR):
                 loadTop(m_Thread);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_OWNER_VAR:
+            VM_CASE(OP_LOAD_OWNER_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_VMStack.Pop();
                     m_CodePos += sizeof(unsigned int);
@@ -1488,13 +1733,13 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                 }
 
                 loadTop(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_PARM_VAR:
+            VM_CASE(OP_LOAD_PARM_VAR):
                 loadTop(&parm);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_SELF_VAR:
+            VM_CASE(OP_LOAD_SELF_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_VMStack.Pop();
                     m_CodePos += sizeof(unsigned int);
@@ -1502,25 +1747,25 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                 }
 
                 loadTop(m_ScriptClass->m_Self);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_GAME_VAR:
+            VM_CASE(OP_LOAD_STORE_GAME_VAR):
                 loadStoreTop(&game);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_GROUP_VAR:
+            VM_CASE(OP_LOAD_STORE_GROUP_VAR):
                 loadStoreTop(m_ScriptClass);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_LEVEL_VAR:
+            VM_CASE(OP_LOAD_STORE_LEVEL_VAR):
                 loadStoreTop(&level);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_LOCAL_VAR:
+            VM_CASE(OP_LOAD_STORE_LOCAL_VAR):
                 loadStoreTop(m_Thread);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_OWNER_VAR:
+            VM_CASE(OP_LOAD_STORE_OWNER_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_CodePos += sizeof(unsigned int);
                     ScriptError("self is NULL");
@@ -1532,27 +1777,27 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                 }
 
                 loadStoreTop(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_PARM_VAR:
+            VM_CASE(OP_LOAD_STORE_PARM_VAR):
                 loadStoreTop(&parm);
-                break;
+                VM_NEXT;
 
-            case OP_LOAD_STORE_SELF_VAR:
+            VM_CASE(OP_LOAD_STORE_SELF_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_CodePos += sizeof(unsigned int);
                     ScriptError("self is NULL");
                 }
 
                 loadStoreTop(m_ScriptClass->m_Self);
-                break;
+                VM_NEXT;
 
-            case OP_MARK_STACK_POS:
+            VM_CASE(OP_MARK_STACK_POS):
                 m_StackPos             = &m_VMStack.GetTop();
                 m_VMStack.m_bMarkStack = true;
-                break;
+                VM_NEXT;
 
-            case OP_STORE_PARAM:
+            VM_CASE(OP_STORE_PARAM):
                 if (fastEvent.dataSize) {
                     m_VMStack.SetTop(*(fastEvent.data++));
                     fastEvent.dataSize--;
@@ -1560,24 +1805,24 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                     m_VMStack.SetTop(*(m_StackPos + 1));
                     m_VMStack.GetTop().Clear();
                 }
-                break;
+                VM_NEXT;
 
-            case OP_RESTORE_STACK_POS:
+            VM_CASE(OP_RESTORE_STACK_POS):
                 m_VMStack.SetTop(*m_StackPos);
                 m_VMStack.m_bMarkStack = false;
-                break;
+                VM_NEXT;
 
-            case OP_STORE_ARRAY:
+            VM_CASE(OP_STORE_ARRAY):
                 m_VMStack.Pop();
                 m_VMStack.GetTop().evalArrayAt(*(m_VMStack.GetTopPtr() + 1));
-                break;
+                VM_NEXT;
 
-            case OP_STORE_ARRAY_REF:
+            VM_CASE(OP_STORE_ARRAY_REF):
                 m_VMStack.Pop();
                 m_VMStack.GetTop().setArrayRefValue(*(m_VMStack.GetTopPtr() + 1));
-                break;
+                VM_NEXT;
 
-            case OP_STORE_FIELD_REF:
+            VM_CASE(OP_STORE_FIELD_REF):
                 try {
                     try {
                         listener = m_VMStack.GetTop().listenerValue();
@@ -1600,14 +1845,14 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                         // having a listener variable means the variable was just created
                         m_VMStack.GetTop().setRefValue(listenerVar);
                     }
-                    break;
+                    VM_NEXT;
                 } catch (...) {
                     ScriptVariable *const pTop = m_VMStack.GetTopPtr();
                     pTop->setRefValue(pTop);
                     throw;
                 }
 
-            case OP_STORE_FIELD:
+            VM_CASE(OP_STORE_FIELD):
                 try {
                     listener = m_VMStack.GetTop().listenerValue();
 
@@ -1622,55 +1867,55 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                 }
 
                 storeTop<true>(listener);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_FLOAT:
+            VM_CASE(OP_STORE_FLOAT):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setFloatValue(fetchOpcodeValue<float>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT0:
+            VM_CASE(OP_STORE_INT0):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(0);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT1:
+            VM_CASE(OP_STORE_INT1):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(fetchOpcodeValue<byte>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT2:
+            VM_CASE(OP_STORE_INT2):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(fetchOpcodeValue<short>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT3:
+            VM_CASE(OP_STORE_INT3):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(fetchOpcodeValue<short3>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_INT4:
+            VM_CASE(OP_STORE_INT4):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setIntValue(fetchOpcodeValue<int>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_GAME_VAR:
+            VM_CASE(OP_STORE_GAME_VAR):
                 storeTop(&game);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_GROUP_VAR:
+            VM_CASE(OP_STORE_GROUP_VAR):
                 storeTop(m_ScriptClass);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_LEVEL_VAR:
+            VM_CASE(OP_STORE_LEVEL_VAR):
                 storeTop(&level);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_LOCAL_VAR:
+            VM_CASE(OP_STORE_LOCAL_VAR):
                 storeTop(m_Thread);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_OWNER_VAR:
+            VM_CASE(OP_STORE_OWNER_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_VMStack.PushAndGet().Clear();
                     m_CodePos += sizeof(unsigned int);
@@ -1684,13 +1929,13 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                 }
 
                 storeTop(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_PARM_VAR:
+            VM_CASE(OP_STORE_PARM_VAR):
                 storeTop(&parm);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_SELF_VAR:
+            VM_CASE(OP_STORE_SELF_VAR):
                 if (!m_ScriptClass->m_Self) {
                     m_VMStack.PushAndGet().Clear();
                     m_CodePos += sizeof(unsigned int);
@@ -1698,29 +1943,29 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                 }
 
                 storeTop(m_ScriptClass->m_Self);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_GAME:
+            VM_CASE(OP_STORE_GAME):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(&game);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_GROUP:
+            VM_CASE(OP_STORE_GROUP):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(m_ScriptClass);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_LEVEL:
+            VM_CASE(OP_STORE_LEVEL):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(&level);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_LOCAL:
+            VM_CASE(OP_STORE_LOCAL):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(m_Thread);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_OWNER:
+            VM_CASE(OP_STORE_OWNER):
                 if (m_ScriptClass->m_Self) {
                     m_VMStack.Push();
                 } else {
@@ -1729,69 +1974,69 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                 }
 
                 m_VMStack.GetTop().setListenerValue(m_ScriptClass->m_Self->GetScriptOwner());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_PARM:
+            VM_CASE(OP_STORE_PARM):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(&parm);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_SELF:
+            VM_CASE(OP_STORE_SELF):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(m_ScriptClass->m_Self);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_NIL:
+            VM_CASE(OP_STORE_NIL):
                 m_VMStack.Push();
                 m_VMStack.GetTop().Clear();
-                break;
+                VM_NEXT;
 
-            case OP_STORE_NULL:
+            VM_CASE(OP_STORE_NULL):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setListenerValue(NULL);
-                break;
+                VM_NEXT;
 
-            case OP_STORE_STRING:
+            VM_CASE(OP_STORE_STRING):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setConstStringValue(fetchOpcodeValue<unsigned int>());
-                break;
+                VM_NEXT;
 
-            case OP_STORE_VECTOR:
+            VM_CASE(OP_STORE_VECTOR):
                 m_VMStack.Push();
                 m_VMStack.GetTop().setVectorValue(fetchOpcodeValue<Vector>());
-                break;
+                VM_NEXT;
 
-            case OP_SWITCH:
+            VM_CASE(OP_SWITCH):
                 if (!Switch(fetchActualOpcodeValue<StateScript *>(), m_VMStack.Pop())) {
                     m_CodePos += sizeof(StateScript *);
                 }
-                break;
+                VM_NEXT;
 
-            case OP_UN_CAST_BOOLEAN:
+            VM_CASE(OP_UN_CAST_BOOLEAN):
                 m_VMStack.GetTop().CastBoolean();
-                break;
+                VM_NEXT;
 
-            case OP_UN_COMPLEMENT:
+            VM_CASE(OP_UN_COMPLEMENT):
                 m_VMStack.GetTop().complement();
-                break;
+                VM_NEXT;
 
-            case OP_UN_MINUS:
+            VM_CASE(OP_UN_MINUS):
                 m_VMStack.GetTop().minus();
-                break;
+                VM_NEXT;
 
-            case OP_UN_DEC:
+            VM_CASE(OP_UN_DEC):
                 m_VMStack.GetTop()--;
-                break;
+                VM_NEXT;
 
-            case OP_UN_INC:
+            VM_CASE(OP_UN_INC):
                 m_VMStack.GetTop()++;
-                break;
+                VM_NEXT;
 
-            case OP_UN_SIZE:
+            VM_CASE(OP_UN_SIZE):
                 m_VMStack.GetTop().setIntValue((int)m_VMStack.GetTop().size());
-                break;
+                VM_NEXT;
 
-            case OP_UN_TARGETNAME:
+            VM_CASE(OP_UN_TARGETNAME):
                 // retrieve the target name
                 if (world) {
                     targetList = world->GetExistingTargetList(m_VMStack.GetTop().stringValue());
@@ -1817,20 +2062,20 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
                     // multiple listeners
                     m_VMStack.GetTop().setContainerValue((Container<SafePtr<Listener>> *)&targetList->list);
                 }
-                break;
+                VM_NEXT;
 
-            case OP_VAR_UN_NOT:
+            VM_CASE(OP_VAR_UN_NOT):
                 m_VMStack.GetTop().setIntValue(m_VMStack.GetTop().booleanValue());
-                break;
+                VM_NEXT;
 
-            case OP_DONE:
+            VM_CASE(OP_DONE):
                 End();
-                break;
+                VM_NEXT;
 
-            case OP_NOP:
-                break;
+            VM_CASE(OP_NOP):
+                VM_NEXT;
 
-            default:
+            VM_DEFAULT:
                 assert(!"Invalid opcode");
                 if (*opcode < OP_MAX) {
                     gi.DPrintf("unknown opcode %d ('%s')\n", *opcode, OpcodeName(*opcode));
@@ -1842,7 +2087,7 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
 
             Director.cmdCount++;
 
-            if (Director.cmdCount >= 15000) {
+            if (Director.cmdCount >= VM_COMMAND_CHECK_COUNT) {
                 if (!Director.cmdTime) {
                     Director.cmdTime  = gi.Milliseconds();
                     Director.cmdCount = 0;
@@ -1882,29 +2127,6 @@ void ScriptVM::Execute(ScriptVariable *data, int dataSize, str label)
             HandleScriptException(exc);
         }
     }
-
-    Director.stackCount--;
-
-    if (g_scripttrace->integer && CanScriptTracePrint()) {
-        gi.DPrintf2(
-            "---FRAME: %i (%p) -------------------------------------------------------------------\n",
-            Director.stackCount,
-            this
-        );
-    }
-
-    switch (state) {
-    case STATE_WAITING:
-        delete m_Thread;
-        delete this;
-        break;
-    case STATE_SUSPENDED:
-        state = STATE_EXECUTION;
-        break;
-    case STATE_DESTROYED:
-        delete this;
-        break;
-    }
 }
 
 /*
@@ -1966,12 +2188,7 @@ void ScriptVM::SetFastData(ScriptVariable *data, int dataSize)
     }
 
     if (dataSize) {
-        fastEvent.data     = new ScriptVariable[dataSize];
-        fastEvent.dataSize = dataSize;
-
-        for (int i = 0; i < dataSize; i++) {
-            fastEvent.data[i] = std::move(data[i]);
-        }
+        fastEvent.MoveValues(data, dataSize);
 
         m_pOldData    = fastEvent.data;
         m_OldDataSize = fastEvent.dataSize;
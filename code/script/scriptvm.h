@@ -195,6 +195,9 @@ private:
     unsigned char *ProgBuffer();
     void           HandleScriptException(ScriptException& exc);
 
+    template<bool bTrace>
+    void executeOpcodes();
+
 public:
     void *operator new(size_t size);
     void  operator delete(void *ptr);
@@ -240,6 +243,7 @@ private:
     bool jumpVar(unsigned int offset, bool booleanValue);
     void doJumpIf(bool booleanValue);
     bool doJumpVarIf(bool booleanValue);
+    void doCompareJumpFalse(void (ScriptVariable::*compare)(ScriptVariable& variable));
 
     void fetchOpcodeValue(void *outValue, size_t size);
     void fetchActualOpcodeValue(void *outValue, size_t size);
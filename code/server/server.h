@@ -66,7 +66,7 @@ typedef struct svEntity_s {
 	int			clusternums[MAX_ENT_CLUSTERS];
 	int			lastCluster;		// if all the clusters don't fit in clusternums
 	int			areanum, areanum2;
-	int			snapshotCounter;	// used to prevent double adding from portal views
+	int			linkContents;		// contents when it was linked, for the sight trace cache
 } svEntity_t;
 
 typedef enum {
@@ -85,7 +85,6 @@ typedef struct {
 	// https://zerowing.idsoftware.com/bugzilla/show_bug.cgi?id=475
 	// the serverId associated with the current checksumFeed (always <= serverId)
 	int       checksumFeedServerId;	
-	int				snapshotCounter;	// incremented for each snapshot built
 	int				timeResidual;		// <= 1000 / sv_frame->value
 	int				nextFrameTime;		// when time > nextFrameTime, process world
 	float			frameTime;
@@ -390,6 +389,11 @@ extern	cvar_t	*sv_strictAuth;
 extern	cvar_t	*sv_banFile;
 
 extern  cvar_t  *sv_logContext;
+extern  cvar_t  *sv_snapshotThreads;
+// more threads than that only add contention, there is one job per client
+#define MAX_SNAPSHOT_THREADS	16
+extern  cvar_t  *sv_sightTraceCache;
+extern  cvar_t  *sv_traceinfo;
 
 extern	serverBan_t serverBans[SERVER_MAXBANS];
 extern	int serverBansCount;
@@ -539,6 +543,7 @@ void SV_WriteFrameToClient (client_t *client, msg_t *msg);
 void SV_SendMessageToClient( msg_t *msg, client_t *client );
 void SV_SendClientMessages( void );
 void SV_SendClientSnapshot( client_t *client );
+void SV_ShutdownSnapshotThreads( void );
 qboolean SV_IsValidSnapshotClient(client_t* client);
 
 //
@@ -610,6 +615,9 @@ int SV_PointContents( const vec3_t p, int passEntityNum );
 
 qboolean SV_SightTraceEntity( gentity_t *touch, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int contentmask, qboolean cylinder );
 qboolean SV_SightTrace( const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int passEntityNum2, int contentmask, qboolean cylinder );
+void SV_ClearSightTraceCache( void );
+void SV_BeginSightTraceFrame( void );
+void SV_EndSightTraceFrame( void );
 qboolean SV_HitEntity(gentity_t* pEnt, gentity_t* pOther);
 void SV_Trace( trace_t *results, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int contentmask, qboolean cylinder, qboolean traceDeep );
 void SV_TraceDeep( trace_t *results, const vec3_t vStart, const vec3_t vEnd, int iBrushMask, gentity_t *touch );
@@ -1931,6 +1931,7 @@ void SV_InitGameProgs( void ) {
 	import.KickClientForReason			= SV_GameKickClientForReason;
 
     import.Cvar_Find                    = Cvar_FindVar;
+    import.RunJobs                      = Com_RunJobs;
 
 	ge = Sys_GetGameAPI( &import );
 
@@ -1115,6 +1115,13 @@ void SV_Init (void)
 
     // Added in OPM
     sv_logContext = Cvar_Get("sv_logContext", "1", 0);
+    // number of worker threads building the client snapshots, 0 builds them on the main thread
+    sv_snapshotThreads = Cvar_Get("sv_snapshotThreads", "0", CVAR_ARCHIVE);
+    Cvar_CheckRange(sv_snapshotThreads, 0, MAX_SNAPSHOT_THREADS, qtrue);
+    // answer repeated sight traces of a frame from a cache
+    sv_sightTraceCache = Cvar_Get("sv_sightTraceCache", "0", 0);
+    // also registered by the game, which shows its trace counts
+    sv_traceinfo = Cvar_Get("sv_traceinfo", "0", 0);
 
 	Q_strncpyz( svs.gameName, "current", sizeof(svs.gameName) );
 
@@ -1190,6 +1197,7 @@ void SV_Shutdown( const char *finalmsg ) {
 	}
 
 	SV_RemoveOperatorCommands();
+	SV_ShutdownSnapshotThreads();
 	SV_ShutdownGamespy();
 	SV_MasterShutdown();
 	SV_ShutdownGameProgs();
@@ -81,6 +81,9 @@ cvar_t	*sv_strictAuth;
 cvar_t	*sv_banFile;
 
 cvar_t  *sv_logContext;
+cvar_t  *sv_snapshotThreads;
+cvar_t  *sv_sightTraceCache;
+cvar_t  *sv_traceinfo;
 
 serverBan_t serverBans[SERVER_MAXBANS];
 int serverBansCount = 0;
@@ -1131,9 +1134,13 @@ void SV_Frame( int msec ) {
 		{
 			const char *err;
 
+			SV_BeginSightTraceFrame();
+
 			// let everything in the world think and move
 			ge->RunFrame( svs.time, frameMsec );
 
+			SV_EndSightTraceFrame();
+
 			err = ge->errorMessage;
 			if( err )
 			{
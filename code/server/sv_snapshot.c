@@ -140,7 +140,9 @@ static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg ) {
 	} else if ( client->netchan.outgoingSequence - client->deltaMessage 
 		>= (PACKET_BACKUP - 3) ) {
 		// client hasn't gotten a good message through in a long time
+		Com_LockJobs();
 		Com_DPrintf ("%s: Delta request from out of date packet.\n", client->name);
+		Com_UnlockJobs();
 		oldframe = NULL;
 		lastframe = 0;
 	} else {
@@ -150,7 +152,9 @@ static void SV_WriteSnapshotToClient( client_t *client, msg_t *msg ) {
 
 		// the snapshot's entities may still have rolled off the buffer, though
 		if ( oldframe->first_entity <= svs.nextSnapshotEntities - svs.numSnapshotEntities ) {
+			Com_LockJobs();
 			Com_DPrintf ("%s: Delta request from out of date entities.\n", client->name);
+			Com_UnlockJobs();
 			oldframe = NULL;
 			lastframe = 0;
 		}
@@ -270,8 +274,20 @@ Build a client snapshot structure
 typedef struct {
 	int		numSnapshotEntities;
 	int		snapshotEntities[MAX_SNAPSHOT_ENTITIES];	
+
+	// snapshots may be built in parallel, so everything specific
+	// to the snapshot is kept here rather than in the entities
+	byte		addedEntities[MAX_GENTITIES / 8];	// used to prevent double adding from portal views
+	int			renderfx[MAX_GENTITIES];			// RF_SNAPSHOT_FLAGS of the added entities
+	qboolean	checkedEntities;					// all the entities were checked, they must be marked as sent
+	const char	*error;								// raised once the snapshot is built
 } snapshotEntityNumbers_t;
 
+// renderfx flags that are set for each snapshot
+#define RF_SNAPSHOT_FLAGS (RF_SHADOW_PLANE | RF_WRAP_FRAMES | RF_SKYENTITY)
+
+#define SV_IsEntityAdded(eNums, num)	((eNums)->addedEntities[(num) >> 3] & (1 << ((num) & 7)))
+
 /*
 =======================
 SV_QsortEntityNumbers
@@ -362,12 +378,21 @@ static qboolean SV_ClipMoveToBSPEntities(const vec3_t start, const vec3_t end, i
 		}
 
 		// might intersect, so do an exact clip
+		if (!touch->r.bmodel) {
+			// temp box models are shared, and snapshots may be built in parallel
+			Com_LockJobs();
+		}
+
 		clipHandle = SV_ClipHandleForEntity(touch);
 
 		CM_TransformedBoxTrace(&trace, start, end,
 			vec3_origin, vec3_origin, clipHandle, mask,
 			touch->s.origin, touch->r.currentAngles, qfalse);
 
+		if (!touch->r.bmodel) {
+			Com_UnlockJobs();
+		}
+
 		if (trace.allsolid || trace.startsolid || trace.fraction != 1) {
 			return qfalse;
 		}
@@ -402,22 +427,20 @@ SV_ClientIsVisibleTrace
 qboolean SV_ClientIsVisibleTrace(const vec3_t fromOrigin, const vec3_t toOrigin, float height, float dot) {
 	vec3_t dir;
 	vec3_t end;
+	qboolean visible;
 
 	VectorSubtract(toOrigin, fromOrigin, dir);
     VectorNormalize(dir);
     //VectorMA(toOrigin, -height, dir, end);
 	VectorCopy(toOrigin, end);
 
-	if (SV_WorldTrace(fromOrigin, end, (CONTENTS_SLIME | CONTENTS_LAVA | CONTENTS_SOLID))) {
-		return qtrue;
+	visible = SV_WorldTrace(fromOrigin, end, (CONTENTS_SLIME | CONTENTS_LAVA | CONTENTS_SOLID));
+	if (!visible && dot >= 0) {
+		end[2] -= height;
+		visible = SV_WorldTrace(fromOrigin, end, (CONTENTS_SLIME | CONTENTS_LAVA | CONTENTS_SOLID));
 	}
 
-	if (dot < 0) {
-		return qfalse;
-    }
-
-	end[2] -= height;
-	return SV_WorldTrace(fromOrigin, end, (CONTENTS_SLIME | CONTENTS_LAVA | CONTENTS_SOLID));
+	return visible;
 }
 
 /*
@@ -509,58 +532,58 @@ qboolean SV_ClientIsVisible(int toNum, int fromNum, int distCheck, const vec3_t
 SV_AddEntToSnapshot
 ===============
 */
-static void SV_AddEntToSnapshot( svEntity_t *svEnt, gentity_t *gEnt, snapshotEntityNumbers_t *eNums, svEntity_t* portalEnt, qboolean portalsky) {
+static void SV_AddEntToSnapshot( gentity_t *gEnt, snapshotEntityNumbers_t *eNums, svEntity_t* portalEnt, qboolean portalsky) {
+	int num = gEnt->s.number;
+
 	// if we have already added this entity to this snapshot, don't add again
-	if ( svEnt->snapshotCounter == sv.snapshotCounter ) {
-		gEnt->s.renderfx &= ~(RF_SHADOW_PLANE | RF_WRAP_FRAMES);
-		gEnt->s.renderfx |= RF_WRAP_FRAMES;
+	if ( SV_IsEntityAdded( eNums, num ) ) {
+		eNums->renderfx[num] &= ~(RF_SHADOW_PLANE | RF_WRAP_FRAMES);
+		eNums->renderfx[num] |= RF_WRAP_FRAMES;
 		return;
 	}
-	svEnt->snapshotCounter = sv.snapshotCounter;
+	eNums->addedEntities[num >> 3] |= 1 << (num & 7);
 
 	// if we are full, silently discard entities
 	if ( eNums->numSnapshotEntities == MAX_SNAPSHOT_ENTITIES ) {
 		return;
 	}
 
-	gEnt->s.renderfx &= ~(RF_SHADOW_PLANE | RF_WRAP_FRAMES | RF_SKYENTITY);
+	eNums->renderfx[num] = 0;
 
 	if ( portalEnt ) {
-		gEnt->s.renderfx |= RF_SHADOW_PLANE;
+		eNums->renderfx[num] |= RF_SHADOW_PLANE;
 	} else if ( portalsky ) {
-		gEnt->s.renderfx |= RF_SKYENTITY;
+		eNums->renderfx[num] |= RF_SKYENTITY;
 	}
 
-	gEnt->r.lastNetTime = svs.time - svs.startTime;
-	eNums->snapshotEntities[ eNums->numSnapshotEntities ] = gEnt->s.number;
+	eNums->snapshotEntities[ eNums->numSnapshotEntities ] = num;
 	eNums->numSnapshotEntities++;
 }
 
 /*
 ===============
 EntityDistCheck
+
+Culls the sphere against the farplane,
+the view distance is scaled by fovScale
 ===============
 */
-int EntityDistCheck(const vec3_t origin, const vec3_t forward, const gentity_t* ent, float farplane, float fov) {
+int EntityDistCheck(const vec3_t origin, const vec3_t forward, const vec3_t centroid, float radius, float fovScale, float farplane, float fov) {
 	vec3_t dir;
 	float farplaneMax;
 	float length;
 	float fovCheck;
 	float dot;
 
-	VectorSubtract(origin, ent->r.centroid, dir);
-	length = VectorNormalize(dir) - ent->r.radius;
+	VectorSubtract(origin, centroid, dir);
+	length = VectorNormalize(dir) - radius;
 
 	farplaneMax = farplane + 128;
 	if (length >= farplaneMax) {
 		return CULL_OUT;
 	}
 
-	fovCheck = fov / 80 * length;
-
-	if (ent->s.number < svs.iNumClients && VectorLength(ent->s.pos.trDelta) < 5) {
-		fovCheck *= 0.25f;
-	}
+	fovCheck = fov / 80 * length * fovScale;
 
 	if (fovCheck <= 640) {
 		return CULL_IN;
@@ -579,26 +602,341 @@ int EntityDistCheck(const vec3_t origin, const vec3_t forward, const gentity_t*
 	return CULL_CLIP;
 }
 
+/*
+=============================================================================
+
+Snapshot frame
+
+Entities don't change while the snapshots of a server frame are built,
+so everything that doesn't depend on the client is only checked once
+
+=============================================================================
+*/
+
+#define	MAX_PVS_CACHE	64
+
+// what the snapshots check of a sendable entity
+#define	SNAPENT_SKYORIGIN		1		// RF_SKYORIGIN
+#define	SNAPENT_BROADCAST		2		// SVF_BROADCAST or SVF_SENDONCE
+#define	SNAPENT_NOTHINGTODRAW	4		// no model, no loop sound and no SVF_SENDPVS
+#define	SNAPENT_ALWAYSDRAW		8		// level-wide loop sound or RF_ALWAYSDRAW
+#define	SNAPENT_NOFARPLANE		16		// SVF_NOFARPLANE
+#define	SNAPENT_SINGLECLIENT	32		// SVF_SINGLECLIENT
+#define	SNAPENT_NOTSINGLECLIENT	64		// SVF_NOTSINGLECLIENT
+#define	SNAPENT_NOCLUSTERS		128		// the entity itself doesn't touch any cluster
+
+typedef struct {
+	int		area;
+	int		cluster;
+	byte	visibleEntities[MAX_GENTITIES / 8];	// indexed by sendable entity
+} pvsCache_t;
+
+typedef struct {
+	int			depth;
+
+	// entities that can be sent to clients, each array is indexed
+	// by sendable entity so the client loop reads them in order
+	// instead of going through the gentities and svEntities
+	int			numEntities;
+	int			entityNums[MAX_GENTITIES];
+	int			flags[MAX_GENTITIES];
+	int			parentNums[MAX_GENTITIES];
+	int			singleClients[MAX_GENTITIES];
+
+	// farplane culling, from the parent if there is one
+	vec3_t		cullOrigins[MAX_GENTITIES];
+	float		cullRadius[MAX_GENTITIES];
+	float		fovScales[MAX_GENTITIES];
+
+	// PVS, from the parent if there is one
+	int			areanums[MAX_GENTITIES];
+	int			areanums2[MAX_GENTITIES];
+	int			numClusters[MAX_GENTITIES];
+	int			lastClusters[MAX_GENTITIES];
+	int			clusterNums[MAX_GENTITIES][MAX_ENT_CLUSTERS];
+
+	// entities in the PVS of the clusters seen so far,
+	// clients in the same cluster and area get the same result
+	int			numPVSCache;
+	pvsCache_t	pvsCache[MAX_PVS_CACHE];
+} snapshotFrame_t;
+
+static snapshotFrame_t	sv_snapshotFrame;
+
+/*
+===============
+SV_IsEntitySendable
+
+Returns true if the entity may be sent to any client
+===============
+*/
+static qboolean SV_IsEntitySendable(gentity_t *ent) {
+	gentity_t *parentEnt;
+
+	// never send unused entities
+	if (!ent->inuse) {
+		return qfalse;
+	}
+
+	// never send entities that aren't linked in
+	if ( !ent->r.linked ) {
+		return qfalse;
+	}
+	// entities can be flagged to explicitly not be sent to the client
+	if ( ent->r.svFlags & SVF_NOCLIENT ) {
+		return qfalse;
+	}
+
+	if (ent->s.parent != ENTITYNUM_NONE) {
+		parentEnt = SV_GentityNum(ent->s.parent);
+		// parents that will not send to clients will be skipped
+		if (parentEnt && parentEnt->r.svFlags & SVF_NOCLIENT) {
+			return qfalse;
+		}
+	}
+
+	return qtrue;
+}
+
+/*
+===============
+SV_AddSendableEntity
+
+Copies what the snapshots check of the entity
+===============
+*/
+static void SV_AddSendableEntity(int e, gentity_t *ent) {
+	snapshotFrame_t	*frame = &sv_snapshotFrame;
+	gentity_t		*cullEnt;
+	svEntity_t		*svEnt, *svCheckEnt;
+	int				flags;
+	int				i, j;
+
+	i = frame->numEntities++;
+
+	svEnt = SV_SvEntityForGentity( ent );
+
+	if (ent->s.parent != ENTITYNUM_NONE) {
+		cullEnt = SV_GentityNum(ent->s.parent);
+		svCheckEnt = SV_SvEntityForGentity( cullEnt );
+	} else {
+		cullEnt = ent;
+		svCheckEnt = svEnt;
+	}
+
+	flags = 0;
+	if (ent->s.renderfx & RF_SKYORIGIN) {
+		flags |= SNAPENT_SKYORIGIN;
+	}
+	if (ent->r.svFlags & (SVF_BROADCAST | SVF_SENDONCE)) {
+		flags |= SNAPENT_BROADCAST;
+	}
+	if (!(ent->r.svFlags & SVF_SENDPVS) && !ent->s.modelindex && !ent->s.loopSound) {
+		flags |= SNAPENT_NOTHINGTODRAW;
+	}
+	if ((ent->s.loopSound && ent->s.loopSoundMinDist == LEVEL_WIDE_MIN_DIST) || ent->s.renderfx & RF_ALWAYSDRAW) {
+		flags |= SNAPENT_ALWAYSDRAW;
+	}
+	if (ent->r.svFlags & SVF_NOFARPLANE) {
+		flags |= SNAPENT_NOFARPLANE;
+	}
+	if (ent->r.svFlags & SVF_SINGLECLIENT) {
+		flags |= SNAPENT_SINGLECLIENT;
+	}
+	if (ent->r.svFlags & SVF_NOTSINGLECLIENT) {
+		flags |= SNAPENT_NOTSINGLECLIENT;
+	}
+	if (!svEnt->numClusters) {
+		flags |= SNAPENT_NOCLUSTERS;
+	}
+
+	frame->entityNums[i] = e;
+	frame->flags[i] = flags;
+	frame->parentNums[i] = ent->s.parent;
+	frame->singleClients[i] = ent->r.singleClient;
+
+	VectorCopy(cullEnt->r.centroid, frame->cullOrigins[i]);
+	frame->cullRadius[i] = cullEnt->r.radius;
+	// standing clients are seen from further away
+	if (cullEnt->s.number < svs.iNumClients && VectorLength(cullEnt->s.pos.trDelta) < 5) {
+		frame->fovScales[i] = 0.25f;
+	} else {
+		frame->fovScales[i] = 1;
+	}
+
+	frame->areanums[i] = svCheckEnt->areanum;
+	frame->areanums2[i] = svCheckEnt->areanum2;
+	frame->numClusters[i] = svCheckEnt->numClusters;
+	frame->lastClusters[i] = svCheckEnt->lastCluster;
+	for (j = 0; j < svCheckEnt->numClusters; j++) {
+		frame->clusterNums[i][j] = svCheckEnt->clusternums[j];
+	}
+}
+
+/*
+===============
+SV_IsEntityInPVS
+
+Returns true if the sendable entity, or its parent, is in a connected area and touches a visible cluster
+===============
+*/
+static qboolean SV_IsEntityInPVS(int index, int clientarea, const byte *clientpvs) {
+	const snapshotFrame_t	*frame = &sv_snapshotFrame;
+	const int	*clusterNums;
+	int			numClusters, lastCluster;
+	int			i, l;
+
+	// ignore if not touching a PV leaf
+	// check area
+	if ( !CM_AreasConnected( clientarea, frame->areanums[index] ) ) {
+		// doors can legally straddle two areas, so
+		// we may need to check another one
+		if ( !CM_AreasConnected( clientarea, frame->areanums2[index] ) ) {
+			return qfalse;		// blocked by a door
+		}
+	}
+
+	// check individual leafs
+	if( frame->flags[index] & SNAPENT_NOCLUSTERS ) {
+		return qfalse;
+	}
+
+	clusterNums = frame->clusterNums[index];
+	numClusters = frame->numClusters[index];
+	lastCluster = frame->lastClusters[index];
+
+	l = 0;
+	for ( i=0 ; i < numClusters ; i++ ) {
+		l = clusterNums[i];
+		if ( clientpvs[l >> 3] & (1 << (l&7) ) ) {
+			break;
+		}
+	}
+
+	// if we haven't found it to be visible,
+	// check overflow clusters that coudln't be stored
+	if ( i == numClusters ) {
+		if ( lastCluster ) {
+			for ( ; l <= lastCluster ; l++ ) {
+				if ( clientpvs[l >> 3] & (1 << (l&7) ) ) {
+					break;
+				}
+			}
+			if ( l == lastCluster ) {
+				return qfalse;	// not visible
+			}
+		} else {
+			return qfalse;
+		}
+	}
+
+	return qtrue;
+}
+
+/*
+===============
+SV_BeginSnapshotFrame
+
+Gathers the entities that can be sent,
+calls can be nested
+===============
+*/
+static void SV_BeginSnapshotFrame(void) {
+	gentity_t	*ent;
+	int			e;
+
+	if (sv_snapshotFrame.depth++) {
+		return;
+	}
+
+	sv_snapshotFrame.numEntities = 0;
+	sv_snapshotFrame.numPVSCache = 0;
+
+	for ( e = 0 ; e < sv.num_entities ; e++ ) {
+		ent = SV_GentityNum(e);
+		if (SV_IsEntitySendable(ent)) {
+			SV_AddSendableEntity(e, ent);
+		}
+	}
+}
+
+/*
+===============
+SV_EndSnapshotFrame
+===============
+*/
+static void SV_EndSnapshotFrame(void) {
+	assert(sv_snapshotFrame.depth > 0);
+	sv_snapshotFrame.depth--;
+}
+
+/*
+===============
+SV_EntitiesInPVS
+
+Returns the sendable entities that are in the PVS of the cluster,
+or NULL if the cache is full
+===============
+*/
+static const byte *SV_EntitiesInPVS(int clientarea, int clientcluster, const byte *clientpvs) {
+	pvsCache_t	*cache;
+	int			i;
+
+	// snapshots may be built in parallel
+	Com_LockJobs();
+
+	for (i = 0; i < sv_snapshotFrame.numPVSCache; i++) {
+		cache = &sv_snapshotFrame.pvsCache[i];
+		if (cache->area == clientarea && cache->cluster == clientcluster) {
+			Com_UnlockJobs();
+			return cache->visibleEntities;
+		}
+	}
+
+	if (sv_snapshotFrame.numPVSCache == MAX_PVS_CACHE) {
+		Com_UnlockJobs();
+		return NULL;
+	}
+
+	cache = &sv_snapshotFrame.pvsCache[sv_snapshotFrame.numPVSCache];
+	cache->area = clientarea;
+	cache->cluster = clientcluster;
+	Com_Memset(cache->visibleEntities, 0, sizeof(cache->visibleEntities));
+
+	for (i = 0; i < sv_snapshotFrame.numEntities; i++) {
+		if (SV_IsEntityInPVS(i, clientarea, clientpvs)) {
+			cache->visibleEntities[i >> 3] |= 1 << (i & 7);
+		}
+	}
+
+	sv_snapshotFrame.numPVSCache++;
+	Com_UnlockJobs();
+
+	return cache->visibleEntities;
+}
+
 /*
 ===============
 SV_AddEntitiesVisibleFromPoint
 ===============
 */
 static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t* frame, snapshotEntityNumbers_t* eNums, svEntity_t* portalEnt, qboolean portalsky, client_t* client, const vec3_t angles ) {
+	const snapshotFrame_t	*sendable = &sv_snapshotFrame;
 	int		e, i;
+	int		flags;
+	int		parent;
 	gentity_t *ent;
-	gentity_t *parentEnt;
 	playerState_t *ps;
-	svEntity_t	*svEnt, *svCheckEnt;
-	int		l;
+	svEntity_t	*svEnt;
 	int		clientarea, clientcluster;
 	int		leafnum;
 	int		c_fullsend;
 	byte	*clientpvs;
-	byte	*bitvector;
+	const byte	*visibleEntities;
 	gentity_t* skyorigin = NULL;
 	int		num;
 	int		check = 0;
+	float	farplane;
 	vec3_t	forward, right;
 
 	// during an error shutdown message we may need to transmit
@@ -608,6 +946,8 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 		return;
 	}
 
+	assert(sendable->depth > 0);
+
 	ps = SV_GameClientNum(client - svs.clients);
 
 	num = 1;
@@ -623,39 +963,32 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 	frame->areabytes = CM_WriteAreaBits( frame->areabits, clientarea );
 
 	clientpvs = CM_ClusterPVS (clientcluster);
+	visibleEntities = SV_EntitiesInPVS (clientarea, clientcluster, clientpvs);
 
 	AngleVectors(angles, forward, right, NULL);
 
-	c_fullsend = 0;
+	farplane = sv.farplane;
+	if (farplane < 1) farplane = 12000;
+	if (farplane > 12000) farplane = 12000;
 
-	for ( e = 0 ; e < sv.num_entities ; e++ ) {
-		ent = SV_GentityNum(e);
+	// the entities are marked as sent once the snapshot is built
+	eNums->checkedEntities = qtrue;
 
-		// never send unused entities
-		if (!ent->inuse) {
-			continue;
-		}
+	c_fullsend = 0;
 
-		// mark the entity as sent
-		ent->r.svFlags |= SVF_SENT;
+	for ( i = 0 ; i < sendable->numEntities ; i++ ) {
+		e = sendable->entityNums[i];
+		flags = sendable->flags[i];
 
-		// never send entities that aren't linked in
-		if ( !ent->r.linked ) {
-			continue;
-		}
-		// entities can be flagged to explicitly not be sent to the client
-		if ( ent->r.svFlags & SVF_NOCLIENT ) {
-			continue;
-		}
 		// entities can be flagged to be sent to only one client
-		if ( ent->r.svFlags & SVF_SINGLECLIENT ) {
-			if ( ent->r.singleClient != frame->ps.clientNum ) {
+		if ( flags & SNAPENT_SINGLECLIENT ) {
+			if ( sendable->singleClients[i] != frame->ps.clientNum ) {
 				continue;
 			}
 		}
 		// entities can be flagged to be sent to everyone but one client
-		if ( ent->r.svFlags & SVF_NOTSINGLECLIENT ) {
-			if ( ent->r.singleClient == frame->ps.clientNum ) {
+		if ( flags & SNAPENT_NOTSINGLECLIENT ) {
+			if ( sendable->singleClients[i] == frame->ps.clientNum ) {
 				continue;
 			}
 		}
@@ -671,139 +1004,88 @@ static void SV_AddEntitiesVisibleFromPoint(const vec3_t origin, clientSnapshot_t
 		}
 		*/
 
-		parentEnt = NULL;
-		if (ent->s.parent != ENTITYNUM_NONE) {
-			parentEnt = SV_GentityNum(ent->s.parent);
-			// parents that will not send to clients will be skipped
-			if (parentEnt && parentEnt->r.svFlags & SVF_NOCLIENT) {
-				continue;
-			}
-		}
-
-		svEnt = SV_SvEntityForGentity( ent );
-
 		// don't double add an entity through portals
-		if ( svEnt->snapshotCounter == sv.snapshotCounter ) {
+		if ( SV_IsEntityAdded( eNums, e ) ) {
 			continue;
 		}
 
-		if (ent->s.renderfx & RF_SKYORIGIN) {
+		ent = SV_GentityNum(e);
+
+		if (flags & SNAPENT_SKYORIGIN) {
 			if (sv.skyportal && !portalsky && !portalEnt) {
 				if (skyorigin) {
-					Com_Error(ERR_DROP, "SV_AddEntitiesVisibleFromPoint: duplicate sky origin");
+					eNums->error = "SV_AddEntitiesVisibleFromPoint: duplicate sky origin";
 				}
 				skyorigin = ent;
-				SV_AddEntToSnapshot(svEnt, ent, eNums, NULL, qfalse);
+				SV_AddEntToSnapshot(ent, eNums, NULL, qfalse);
 			}
 			continue;
 		}
 
 		// broadcast entities are always sent
 		// or broadcast entities that are sent once
-		if ( (ent->r.svFlags & SVF_BROADCAST) || (ent->r.svFlags & SVF_SENDONCE)  ) {
-			SV_AddEntToSnapshot( svEnt, ent, eNums, portalEnt, portalsky);
+		if ( flags & SNAPENT_BROADCAST ) {
+			SV_AddEntToSnapshot( ent, eNums, portalEnt, portalsky);
 			continue;
 		}
 
-		if (parentEnt) {
-			svEntity_t* parentSvEnt = SV_SvEntityForGentity(parentEnt);
-			if (parentSvEnt->snapshotCounter == sv.snapshotCounter) {
-				SV_AddEntToSnapshot(svEnt, ent, eNums, portalEnt, portalsky);
+		parent = sendable->parentNums[i];
+		if (parent != ENTITYNUM_NONE) {
+			if (SV_IsEntityAdded(eNums, parent)) {
+				SV_AddEntToSnapshot(ent, eNums, portalEnt, portalsky);
 				continue;
-			} else if (g_gametype->integer != GT_SINGLE_PLAYER && ent->s.parent < svs.iNumClients) {
+			} else if (g_gametype->integer != GT_SINGLE_PLAYER && parent < svs.iNumClients) {
 				SV_AddNonPVSSound(client, ent);
 				continue;
 			}
 
-			svCheckEnt = parentSvEnt;
-		} else {
-			svCheckEnt = svEnt;
 		}
 
-		if (!(ent->r.svFlags & SVF_SENDPVS) && !ent->s.modelindex && !ent->s.loopSound) {
+		if (flags & SNAPENT_NOTHINGTODRAW) {
 			// don't send entities that have nothing to draw
 			continue;
 		}
 
-		if ((ent->s.loopSound && ent->s.loopSoundMinDist == LEVEL_WIDE_MIN_DIST) || ent->s.renderfx & RF_ALWAYSDRAW) {
+		if (flags & SNAPENT_ALWAYSDRAW) {
             // loopsound entities should be sent regardless
-			SV_AddEntToSnapshot(svEnt, ent, eNums, portalEnt, portalsky);
+			SV_AddEntToSnapshot(ent, eNums, portalEnt, portalsky);
             continue;
 		}
 
 		// ignore if not touching a PV leaf
-		// check area
-		if ( !CM_AreasConnected( clientarea, svCheckEnt->areanum ) ) {
-			// doors can legally straddle two areas, so
-			// we may need to check another one
-			if ( !CM_AreasConnected( clientarea, svCheckEnt->areanum2 ) ) {
-				continue;		// blocked by a door
-			}
-		}
-
-		if (g_gametype->integer != GT_SINGLE_PLAYER && !(ent->r.svFlags & SVF_NOFARPLANE)) {
-			float farplane = sv.farplane;
-
-			if (farplane < 1) farplane = 12000;
-			if (farplane > 12000) farplane = 12000;
-
-			check = EntityDistCheck(origin, forward, parentEnt ? parentEnt : ent, farplane, ps->fov);
-			if (check == CULL_OUT) {
-				continue;
-			}
-		}
-
-		// check individual leafs
-		if( !svEnt->numClusters ) {
+		if ( visibleEntities ? !(visibleEntities[i >> 3] & (1 << (i & 7))) : !SV_IsEntityInPVS(i, clientarea, clientpvs) ) {
 			continue;
 		}
 
-		bitvector = clientpvs;
-
-		l = 0;
-		for ( i=0 ; i < svCheckEnt->numClusters ; i++ ) {
-			l = svCheckEnt->clusternums[i];
-			if ( bitvector[l >> 3] & (1 << (l&7) ) ) {
-				break;
-			}
-		}
-
-		// if we haven't found it to be visible,
-		// check overflow clusters that coudln't be stored
-		if ( i == svCheckEnt->numClusters ) {
-			if ( svCheckEnt->lastCluster ) {
-				for ( ; l <= svCheckEnt->lastCluster ; l++ ) {
-					if ( bitvector[l >> 3] & (1 << (l&7) ) ) {
-						break;
-					}
-				}
-				if ( l == svCheckEnt->lastCluster ) {
-					continue;	// not visible
-				}
-			} else {
+		if (g_gametype->integer != GT_SINGLE_PLAYER && !(flags & SNAPENT_NOFARPLANE)) {
+			check = EntityDistCheck(origin, forward, sendable->cullOrigins[i], sendable->cullRadius[i], sendable->fovScales[i], farplane, ps->fov);
+			if (check == CULL_OUT) {
 				continue;
 			}
 		}
 
-		if (svEnt->snapshotCounter == sv.snapshotCounter) {
-			ent->s.renderfx &= ~(RF_WRAP_FRAMES | RF_SHADOW_PLANE);
-			ent->s.renderfx |= RF_WRAP_FRAMES;
+		if (SV_IsEntityAdded(eNums, e)) {
+			eNums->renderfx[e] &= ~(RF_WRAP_FRAMES | RF_SHADOW_PLANE);
+			eNums->renderfx[e] |= RF_WRAP_FRAMES;
 			continue;
 		}
 
-		if (g_gametype->integer != GT_SINGLE_PLAYER && ent->s.number < svs.iNumClients) {
-			if (!SV_ClientIsVisible(ent->s.number, client - svs.clients, check, forward, right)) {
+		if (g_gametype->integer != GT_SINGLE_PLAYER && e < svs.iNumClients) {
+			if (!SV_ClientIsVisible(e, client - svs.clients, check, forward, right)) {
 				SV_AddNonPVSSound(client, ent);
 				continue;
 			}
 		}
 
 		// add it
-		SV_AddEntToSnapshot( svEnt, ent, eNums, portalEnt, portalsky);
+		SV_AddEntToSnapshot( ent, eNums, portalEnt, portalsky);
 
 		// if its a portal entity, add everything visible from its camera position
-		if ( ent->r.svFlags & SVF_PORTAL && svEnt != portalEnt ) {
-			SV_AddEntitiesVisibleFromPoint( ent->s.origin2, frame, eNums, svEnt, qfalse, client, angles  );
+		if ( ent->r.svFlags & SVF_PORTAL ) {
+			svEnt = SV_SvEntityForGentity( ent );
+			if ( svEnt != portalEnt ) {
+				SV_AddEntitiesVisibleFromPoint( ent->s.origin2, frame, eNums, svEnt, qfalse, client, angles  );
+			}
 		}
 	}
 
@@ -1026,27 +1308,23 @@ currently doesn't.
 For viewing through other player's eyes, clent can be something other than client->gentity
 =============
 */
-static void SV_BuildClientSnapshot( client_t *client ) {
+static void SV_BuildClientSnapshot( client_t *client, snapshotEntityNumbers_t *eNums ) {
 	vec3_t						org;
 	vec3_t						ang;
 	clientSnapshot_t			*frame;
-	snapshotEntityNumbers_t		entityNumbers;
 	int							i;
-	gentity_t					*ent;
-	entityState_t				*state;
-	svEntity_t					*svEnt;
 	gentity_t					*clent;
 	int							clientNum;
 	playerState_t				*ps;
 
-	// bump the counter used to prevent double adding
-	sv.snapshotCounter++;
-
 	// this is the frame we are creating
 	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
 
 	// clear everything in this snapshot
-	entityNumbers.numSnapshotEntities = 0;
+	eNums->numSnapshotEntities = 0;
+	eNums->checkedEntities = qfalse;
+	eNums->error = NULL;
+	Com_Memset( eNums->addedEntities, 0, sizeof( eNums->addedEntities ) );
 	Com_Memset( frame->areabits, 0, sizeof( frame->areabits ) );
 
   // https://zerowing.idsoftware.com/bugzilla/show_bug.cgi?id=62
@@ -1068,9 +1346,9 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 	// be regenerated from the playerstate
 	clientNum = frame->ps.clientNum;
 	if ( clientNum < 0 || clientNum >= MAX_GENTITIES ) {
-		Com_Error( ERR_DROP, "SV_SvEntityForGentity: bad gEnt" );
+		eNums->error = "SV_SvEntityForGentity: bad gEnt";
+		return;
 	}
-	svEnt = &sv.svEntities[ clientNum ];
 	
 	// su44: that's not done in MoHAA
 	//svEnt->snapshotCounter = sv.snapshotCounter;
@@ -1087,38 +1365,86 @@ static void SV_BuildClientSnapshot( client_t *client ) {
 		VectorCopy(ps->viewangles, ang);
 	}
 
-	SV_AddEntToSnapshot(svEnt, SV_GentityNum(client - svs.clients), &entityNumbers, NULL, qfalse);
+	SV_AddEntToSnapshot(SV_GentityNum(client - svs.clients), eNums, NULL, qfalse);
+
+	// the viewed client isn't added again either
+	eNums->addedEntities[clientNum >> 3] |= 1 << (clientNum & 7);
 
 	// add all the entities directly visible to the eye, which
 	// may include portal entities that merge other viewpoints
-	SV_AddEntitiesVisibleFromPoint( org, frame, &entityNumbers, NULL, qfalse, client, ang );
+	SV_AddEntitiesVisibleFromPoint( org, frame, eNums, NULL, qfalse, client, ang );
 
 	// if there were portals visible, there may be out of order entities
 	// in the list which will need to be resorted for the delta compression
 	// to work correctly.  This also catches the error condition
 	// of an entity being included twice.
-	qsort( entityNumbers.snapshotEntities, entityNumbers.numSnapshotEntities, 
-		sizeof( entityNumbers.snapshotEntities[0] ), SV_QsortEntityNumbers );
+	qsort( eNums->snapshotEntities, eNums->numSnapshotEntities, 
+		sizeof( eNums->snapshotEntities[0] ), SV_QsortEntityNumbers );
 
 	// now that all viewpoint's areabits have been OR'd together, invert
 	// all of them to make it a mask vector, which is what the renderer wants
 	for ( i = 0 ; i < MAX_MAP_AREA_BYTES/4 ; i++ ) {
 		((int *)frame->areabits)[i] = ((int *)frame->areabits)[i] ^ -1;
 	}
+}
+
+/*
+=============
+SV_MarkEntitiesSent
+=============
+*/
+static void SV_MarkEntitiesSent( void ) {
+	gentity_t	*ent;
+	int			e;
+
+	for ( e = 0 ; e < sv.num_entities ; e++ ) {
+		ent = SV_GentityNum(e);
+
+		if (ent->inuse) {
+			ent->r.svFlags |= SVF_SENT;
+		}
+	}
+}
+
+/*
+=============
+SV_StoreClientSnapshot
+
+Copies the entity states of the built snapshot,
+this must be done in the order of the clients
+=============
+*/
+static void SV_StoreClientSnapshot( client_t *client, snapshotEntityNumbers_t *eNums ) {
+	clientSnapshot_t			*frame;
+	int							i;
+	gentity_t					*ent;
+	entityState_t				*state;
+
+	if ( eNums->error ) {
+		Com_Error( ERR_DROP, "%s", eNums->error );
+	}
+
+	if ( !client->gentity || client->state == CS_ZOMBIE ) {
+		return;
+	}
+
+	frame = &client->frames[ client->netchan.outgoingSequence & PACKET_MASK ];
 
-	
 	// copy the entity states out
 	frame->num_entities = 0;
 	frame->first_entity = svs.nextSnapshotEntities;
-	for ( i = 0 ; i < entityNumbers.numSnapshotEntities ; i++ ) {
-		ent = SV_GentityNum(entityNumbers.snapshotEntities[i]);
+	for ( i = 0 ; i < eNums->numSnapshotEntities ; i++ ) {
+		ent = SV_GentityNum(eNums->snapshotEntities[i]);
 		if (ent->client && ent->s.number < svs.iNumClients) {
 			assert(ent->s.number < MAX_CLIENTS);
 			client->lastRadarTime[ent->s.number] = svs.time;
 		}
 
+		ent->r.lastNetTime = svs.time - svs.startTime;
+
 		state = &svs.snapshotEntities[svs.nextSnapshotEntities % svs.numSnapshotEntities];
 		*state = ent->s;
+		state->renderfx = (ent->s.renderfx & ~RF_SNAPSHOT_FLAGS) | eNums->renderfx[ent->s.number];
 		svs.nextSnapshotEntities++;
 		// this should never hit, map should always be restarted first in SV_Frame
 		if ( svs.nextSnapshotEntities >= 0x7FFFFFFE ) {
@@ -1168,7 +1494,9 @@ static void SV_WriteVoipToClient(client_t *cl, msg_t *msg)
 	        		MSG_WriteData(msg, packet->data, packet->len);
                         }
 
+			Com_LockJobs();
 			Z_Free(packet);
+			Com_UnlockJobs();
 		}
 
 		cl->queuedVoipPackets -= i;
@@ -1199,39 +1527,23 @@ void SV_SendMessageToClient(msg_t *msg, client_t *client)
 
 /*
 =======================
-SV_SendClientSnapshot
-
-Also called by SV_FinalMessage
+SV_WriteClientMessage
 
+Writes the snapshot and the pending messages of the client
 =======================
 */
-void SV_SendClientSnapshot( client_t *client ) {
-	byte		msg_buf[MAX_MSGLEN];
-	msg_t		msg;
-
-	// build the snapshot
-	SV_BuildClientSnapshot( client );
-
-	// bots need to have their snapshots build, but
-	// the query them directly without needing to be sent
-	if ( client->gentity && client->gentity->r.svFlags & SVF_MONSTER ) {
-		return;
-	}
-
-    MSG_Init(&msg, msg_buf, sizeof(msg_buf));
-    msg.allowoverflow = qtrue;
-
+static void SV_WriteClientMessage( client_t *client, msg_t *msg ) {
     // NOTE, MRE: all server->client messages now acknowledge
     // let the client know which reliable clientCommands we have received
-    MSG_WriteLong(&msg, client->lastClientCommand);
+    MSG_WriteLong(msg, client->lastClientCommand);
 
 	if (g_gametype->integer <= GT_SINGLE_PLAYER || client->serverIdAcknowledge == sv.serverId || client->serverIdAcknowledge == sv.restartedServerId) {
 		// (re)send any reliable server commands
-		SV_UpdateServerCommandsToClient( client, &msg );
+		SV_UpdateServerCommandsToClient( client, msg );
 
 		// send over all the relevant entityState_t
 		// and the playerState_t
-		SV_WriteSnapshotToClient( client, &msg );
+		SV_WriteSnapshotToClient( client, msg );
 
 		// clear the sounds on the client, preventing them to be sent each at packet
 		SV_ClearSounds( client );
@@ -1240,17 +1552,61 @@ void SV_SendClientSnapshot( client_t *client ) {
 		client->stringToPrint[ 0 ] = 0;
 
 		// su44: write any pending MoHAA cg messages
-		SV_WriteCGMToClient( client, &msg );
+		SV_WriteCGMToClient( client, msg );
 
 #ifdef USE_VOIP
-		SV_WriteVoipToClient(client, &msg);
+		SV_WriteVoipToClient(client, msg);
 #endif
 	} else {
 		// Fixed in 2.0
 		//  Don't send snapshots until the player has acknowledged the server id (which happens when the client enters the world).
 		//  This also prevent sending CG messages while the client connects, as the cgame module is loaded when parsing the gamestate
-		MSG_WriteSVC(&msg, svc_nop);
+		MSG_WriteSVC(msg, svc_nop);
 	}
+}
+
+/*
+=======================
+SV_IsBotClient
+
+Bots need to have their snapshots build, but
+they query them directly without needing to be sent
+=======================
+*/
+static qboolean SV_IsBotClient( client_t *client ) {
+	return client->gentity && client->gentity->r.svFlags & SVF_MONSTER;
+}
+
+/*
+=======================
+SV_SendClientSnapshot
+
+Also called by SV_FinalMessage
+
+=======================
+*/
+void SV_SendClientSnapshot( client_t *client ) {
+	byte		msg_buf[MAX_MSGLEN];
+	msg_t		msg;
+	snapshotEntityNumbers_t entityNumbers;
+
+	// build the snapshot
+	SV_BeginSnapshotFrame();
+	SV_BuildClientSnapshot( client, &entityNumbers );
+	SV_EndSnapshotFrame();
+	if ( entityNumbers.checkedEntities ) {
+		SV_MarkEntitiesSent();
+	}
+	SV_StoreClientSnapshot( client, &entityNumbers );
+
+	if ( SV_IsBotClient( client ) ) {
+		return;
+	}
+
+    MSG_Init(&msg, msg_buf, sizeof(msg_buf));
+    msg.allowoverflow = qtrue;
+
+	SV_WriteClientMessage( client, &msg );
 
 	// check for overflow
 	if ( msg.overflowed ) {
@@ -1261,6 +1617,137 @@ void SV_SendClientSnapshot( client_t *client ) {
 	SV_SendMessageToClient( &msg, client );
 }
 
+/*
+=============================================================================
+
+Parallel snapshots
+
+Snapshots of the clients are independent, so they are built and encoded
+by worker threads. Entity states are copied out and messages are sent
+on the main thread, in the order of the clients.
+
+=============================================================================
+*/
+
+typedef struct {
+	client_t				*client;
+	snapshotEntityNumbers_t	entityNumbers;
+	msg_t					msg;
+	byte					msgBuf[MAX_MSGLEN];
+} snapshotJob_t;
+
+static snapshotJob_t	*sv_snapshotJobs;
+static int				sv_maxSnapshotJobs;
+
+/*
+=======================
+SV_BuildSnapshotJob
+=======================
+*/
+static void SV_BuildSnapshotJob( void *data, int index ) {
+	snapshotJob_t *job = &((snapshotJob_t *)data)[index];
+
+	SV_BuildClientSnapshot( job->client, &job->entityNumbers );
+}
+
+/*
+=======================
+SV_WriteSnapshotJob
+=======================
+*/
+static void SV_WriteSnapshotJob( void *data, int index ) {
+	snapshotJob_t *job = &((snapshotJob_t *)data)[index];
+
+	if ( SV_IsBotClient( job->client ) ) {
+		return;
+	}
+
+	MSG_Init( &job->msg, job->msgBuf, sizeof( job->msgBuf ) );
+	job->msg.allowoverflow = qtrue;
+
+	SV_WriteClientMessage( job->client, &job->msg );
+}
+
+/*
+=======================
+SV_NumSnapshotThreads
+
+Returns the number of worker threads building the snapshots
+=======================
+*/
+static int SV_NumSnapshotThreads( void ) {
+	if ( com_msgstats->integer ) {
+		// the message statistics aren't synchronized
+		return 0;
+	}
+
+	return sv_snapshotThreads->integer;
+}
+
+/*
+=======================
+SV_SendClientSnapshots
+
+Same as calling SV_SendClientSnapshot for each job
+=======================
+*/
+static void SV_SendClientSnapshots( snapshotJob_t *jobs, int numJobs ) {
+	snapshotJob_t	*job;
+	qboolean		checkedEntities;
+	int				i;
+
+	Com_RunJobs( SV_NumSnapshotThreads(), numJobs, SV_BuildSnapshotJob, jobs );
+
+	checkedEntities = qfalse;
+	for ( i = 0; i < numJobs; i++ ) {
+		checkedEntities |= jobs[i].entityNumbers.checkedEntities;
+	}
+
+	if ( checkedEntities ) {
+		SV_MarkEntitiesSent();
+	}
+
+	for ( i = 0; i < numJobs; i++ ) {
+		SV_StoreClientSnapshot( jobs[i].client, &jobs[i].entityNumbers );
+	}
+
+	Com_RunJobs( SV_NumSnapshotThreads(), numJobs, SV_WriteSnapshotJob, jobs );
+
+	for ( i = 0; i < numJobs; i++ ) {
+		job = &jobs[i];
+
+		if ( SV_IsBotClient( job->client ) ) {
+			continue;
+		}
+
+		// check for overflow
+		if ( job->msg.overflowed ) {
+			Com_Printf ("WARNING: msg overflowed for %s\n", job->client->name);
+			MSG_Clear (&job->msg);
+		}
+
+		SV_SendMessageToClient( &job->msg, job->client );
+	}
+}
+
+/*
+=======================
+SV_ShutdownSnapshotThreads
+=======================
+*/
+void SV_ShutdownSnapshotThreads( void ) {
+	Com_ShutdownJobs();
+
+	if ( sv_snapshotJobs ) {
+		Z_Free( sv_snapshotJobs );
+		sv_snapshotJobs = NULL;
+		sv_maxSnapshotJobs = 0;
+	}
+
+	// an error may have been thrown while building the snapshots
+	sv_snapshotFrame.depth = 0;
+}
+
 /*
 =======================
 SV_SendClientMessages
@@ -1270,8 +1757,25 @@ void SV_SendClientMessages(void)
 {
 	int				i;
 	int				rate;
+	int				numJobs;
+	qboolean		parallel;
 	client_t		*c;
 
+	parallel = SV_NumSnapshotThreads() > 0;
+	if ( parallel && sv_maxSnapshotJobs != sv_maxclients->integer ) {
+		if ( sv_snapshotJobs ) {
+			Z_Free( sv_snapshotJobs );
+		}
+
+		sv_maxSnapshotJobs = sv_maxclients->integer;
+		sv_snapshotJobs = Z_Malloc( sizeof( snapshotJob_t ) * sv_maxSnapshotJobs );
+	}
+
+	numJobs = 0;
+
+	// the entities are the same for all snapshots of this frame
+	SV_BeginSnapshotFrame();
+
 	// send a message to each connected client
 	for(i=0; i < sv_maxclients->integer; i++)
 	{
@@ -1309,11 +1813,29 @@ void SV_SendClientMessages(void)
 			}
 		}
 
+		if (parallel) {
+			// sent below with the other clients
+			sv_snapshotJobs[numJobs++].client = c;
+			continue;
+		}
+
 		// generate and send a new message
 		SV_SendClientSnapshot(c);
 		c->lastSnapshotTime = svs.time;
 		c->rateDelayed = qfalse;
     }
+
+	if (numJobs) {
+		SV_SendClientSnapshots(sv_snapshotJobs, numJobs);
+
+		for (i = 0; i < numJobs; i++) {
+			c = sv_snapshotJobs[i].client;
+			c->lastSnapshotTime = svs.time;
+			c->rateDelayed = qfalse;
+		}
+	}
+
+	SV_EndSnapshotFrame();
 }
 
 qboolean SV_IsValidSnapshotClient(client_t* client) {
@@ -24,6 +24,8 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "server.h"
 #include "../corepp/tiki.h"
 
+static void SV_LinkContents( int contents );
+
 /*
 ================
 SV_ClipHandleForEntity
@@ -151,6 +153,8 @@ void SV_ClearWorld( void ) {
 	Com_Memset( sv_worldSectors, 0, sizeof(sv_worldSectors) );
 	sv_numworldSectors = 0;
 
+	SV_ClearSightTraceCache();
+
 	// get world map bounds
 	h = CM_InlineModel( 0 );
 	CM_ModelBounds( h, mins, maxs );
@@ -187,6 +191,8 @@ void SV_UnlinkEntity( gentity_t *gEnt ) {
 	}
 	ent->worldSector = NULL;
 
+	SV_LinkContents( ent->linkContents );
+
 	if ( ws->entities == ent ) {
 		ws->entities = ent->nextEntityInWorldSector;
 		return;
@@ -361,6 +367,9 @@ void SV_LinkEntity( gentity_t *gEnt ) {
 	ent->nextEntityInWorldSector = node->entities;
 	node->entities = ent;
 
+	ent->linkContents = gEnt->r.contents;
+	SV_LinkContents( ent->linkContents );
+
 	gEnt->r.linked = qtrue;
 }
 
@@ -725,12 +734,10 @@ qboolean SV_SightTraceEntity( gentity_t *touch, const vec3_t start, const vec3_t
 
 /*
 ==================
-SV_SightTrace
-
-Returns false if something was hit.
+SV_SightTraceUncached
 ==================
 */
-qboolean SV_SightTrace( const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int passEntityNum2, int contentmask, qboolean cylinder ) {
+static qboolean SV_SightTraceUncached( const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int passEntityNum2, int contentmask, qboolean cylinder ) {
 	moveclip_t clip;
 	int i;
 
@@ -764,6 +771,193 @@ qboolean SV_SightTrace( const vec3_t start, const vec3_t mins, const vec3_t maxs
 	// clip to other solid entities
 	return SV_ClipSightToEntities( &clip, passEntityNum2 );
 }
+
+/*
+===============================================================================
+
+SIGHT TRACE CACHE
+
+AI code does the same sight traces several times per frame.
+Sight traces with the same parameters give the same result until an entity
+that can block them is linked or unlinked, so with sv_sightTraceCache
+they are answered from a cache that is emptied on each frame
+
+===============================================================================
+*/
+
+#define	SIGHT_CACHE_SIZE	4096	// must be a power of two
+
+typedef struct {
+	vec3_t		start;
+	vec3_t		end;
+	vec3_t		mins;
+	vec3_t		maxs;
+	int			passEntityNum;
+	int			passEntityNum2;
+	int			contentmask;
+	qboolean	cylinder;
+} sightTraceKey_t;
+
+typedef struct {
+	sightTraceKey_t	key;
+	int				frame;
+	int				linkCount;		// sv_linkCount when the trace was done
+	qboolean		result;
+} sightTraceEntry_t;
+
+static sightTraceEntry_t	sv_sightCache[ SIGHT_CACHE_SIZE ];
+static int					sv_sightCacheFrame = 1;
+static int					sv_sightCacheHits;
+static int					sv_sightCacheMisses;
+
+// incremented when an entity is linked or unlinked
+static int					sv_linkCount;
+// sv_linkCount when an entity with each of the content bits was linked or unlinked
+static int					sv_contentsLinkCount[ 32 ];
+
+/*
+==================
+SV_ClearSightTraceCache
+==================
+*/
+void SV_ClearSightTraceCache( void ) {
+	sv_sightCacheFrame++;
+
+	if ( sv_linkCount > ( 1 << 30 ) ) {
+		// no entry is valid anymore, start over before wrapping around
+		sv_linkCount = 0;
+		Com_Memset( sv_contentsLinkCount, 0, sizeof( sv_contentsLinkCount ) );
+	}
+}
+
+/*
+==================
+SV_BeginSightTraceFrame
+==================
+*/
+void SV_BeginSightTraceFrame( void ) {
+	SV_ClearSightTraceCache();
+
+	sv_sightCacheHits = 0;
+	sv_sightCacheMisses = 0;
+}
+
+/*
+==================
+SV_EndSightTraceFrame
+
+Shows how many traces were saved
+==================
+*/
+void SV_EndSightTraceFrame( void ) {
+	if ( !sv_sightTraceCache->integer || !sv_traceinfo->integer ) {
+		return;
+	}
+
+	Com_DebugPrintf( "%0.2f : Sight trace cache %3d hits %3d misses\n", svs.time / 1000.0f, sv_sightCacheHits, sv_sightCacheMisses );
+}
+
+/*
+==================
+SV_LinkContents
+
+Invalidates the cached traces that entities with these contents can block
+==================
+*/
+static void SV_LinkContents( int contents ) {
+	int i;
+
+	sv_linkCount++;
+
+	for ( i = 0; contents; i++, contents = (unsigned int)contents >> 1 ) {
+		if ( contents & 1 ) {
+			sv_contentsLinkCount[ i ] = sv_linkCount;
+		}
+	}
+}
+
+/*
+==================
+SV_HashSightTraceKey
+==================
+*/
+static unsigned int SV_HashSightTraceKey( const sightTraceKey_t *key ) {
+	const unsigned int	*words = ( const unsigned int * )key;
+	unsigned int		hash;
+	size_t				i;
+
+	// FNV-1a, word by word
+	hash = 2166136261u;
+	for ( i = 0; i < sizeof( *key ) / sizeof( *words ); i++ ) {
+		hash = ( hash ^ words[ i ] ) * 16777619u;
+	}
+
+	return hash ^ ( hash >> 16 );
+}
+
+/*
+==================
+SV_SightCacheValid
+==================
+*/
+static qboolean SV_SightCacheValid( const sightTraceEntry_t *entry ) {
+	int contents;
+	int i;
+
+	if ( entry->frame != sv_sightCacheFrame ) {
+		return qfalse;
+	}
+
+	contents = entry->key.contentmask;
+	for ( i = 0; contents; i++, contents = (unsigned int)contents >> 1 ) {
+		if ( ( contents & 1 ) && sv_contentsLinkCount[ i ] > entry->linkCount ) {
+			return qfalse;
+		}
+	}
+
+	return qtrue;
+}
+
+/*
+==================
+SV_SightTrace
+
+Returns false if something was hit.
+==================
+*/
+qboolean SV_SightTrace( const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, int passEntityNum, int passEntityNum2, int contentmask, qboolean cylinder ) {
+	sightTraceKey_t		key;
+	sightTraceEntry_t	*entry;
+
+	if ( !sv_sightTraceCache->integer ) {
+		return SV_SightTraceUncached( start, mins, maxs, end, passEntityNum, passEntityNum2, contentmask, cylinder );
+	}
+
+	Com_Memset( &key, 0, sizeof( key ) );
+	VectorCopy( start, key.start );
+	VectorCopy( end, key.end );
+	VectorCopy( mins, key.mins );
+	VectorCopy( maxs, key.maxs );
+	key.passEntityNum = passEntityNum;
+	key.passEntityNum2 = passEntityNum2;
+	key.contentmask = contentmask;
+	key.cylinder = cylinder;
+
+	entry = &sv_sightCache[ SV_HashSightTraceKey( &key ) & ( SIGHT_CACHE_SIZE - 1 ) ];
+	if ( SV_SightCacheValid( entry ) && !memcmp( &entry->key, &key, sizeof( key ) ) ) {
+		sv_sightCacheHits++;
+		return entry->result;
+	}
+
+	sv_sightCacheMisses++;
+
+	entry->key = key;
+	entry->frame = sv_sightCacheFrame;
+	entry->linkCount = sv_linkCount;
+	entry->result = SV_SightTraceUncached( start, mins, maxs, end, passEntityNum, passEntityNum2, contentmask, cylinder );
+
+	return entry->result;
+}
 /*
 ==================
 SV_HitEntity
@@ -1067,23 +1067,10 @@ float DecodeFrameValue(skanChannelHdr *channelFrames, int desiredFrameNum)
 {
     skanGameFrame *foundFrame;
     size_t         frameSize;
-    int            i;
 
     frameSize = (sizeof(skanGameFrame) - sizeof(skanGameFrame::pChannelData) + sizeof(float));
 
-    foundFrame = channelFrames->ary_frames;
-
-    for (i = 0; i < channelFrames->nFramesInChannel; i++) {
-        if (foundFrame->nFrameNum >= desiredFrameNum) {
-            break;
-        }
-
-        foundFrame = (skanGameFrame *)((byte *)foundFrame + frameSize);
-    }
-
-    if (foundFrame->nFrameNum > desiredFrameNum) {
-        foundFrame = (skanGameFrame *)((byte *)channelFrames->ary_frames + foundFrame->nPrevFrameIndex * frameSize);
-    }
+    foundFrame = SkelFindChannelFrame(channelFrames, desiredFrameNum, frameSize);
 
     return foundFrame->pChannelData[0];
 }
@@ -63,9 +63,7 @@ typedef struct {
 
 #ifdef __cplusplus
 
-template<typename T>
-class Container;
-
+#    include "../corepp/container_fwd.h"
 #    include "../corepp/container.h"
 
 class skelAnimStoreFrameList_c
@@ -77,6 +77,50 @@ typedef struct skelAnimDataGameHeader_s skelAnimDataGameHeader_t;
 
 #ifdef __cplusplus
 
+/*
+====================
+SkelFindChannelFrame
+
+Returns the keyframe holding the channel value at desiredFrameNum.
+Keyframes are sorted by frame number, so they are binary searched.
+Frames past the last keyframe keep its value
+====================
+*/
+inline skanGameFrame *SkelFindChannelFrame(const skanChannelHdr *channelFrames, int desiredFrameNum, size_t frameSize)
+{
+    byte          *frames = (byte *)channelFrames->ary_frames;
+    byte          *base;
+    skanGameFrame *foundFrame;
+    int            count, half;
+
+    if (channelFrames->nFramesInChannel <= 0) {
+        return channelFrames->ary_frames;
+    }
+
+    // find the first keyframe at or after the desired frame,
+    // without branching on the comparison as the frames are random from one channel to another
+    base  = frames;
+    count = channelFrames->nFramesInChannel;
+    while (count > 1) {
+        half = count >> 1;
+        base = ((skanGameFrame *)(base + (half - 1) * frameSize))->nFrameNum < desiredFrameNum ? base + half * frameSize
+                                                                                                : base;
+        count -= half;
+    }
+
+    foundFrame = (skanGameFrame *)base;
+    if (foundFrame->nFrameNum < desiredFrameNum) {
+        // past the last keyframe
+        return foundFrame;
+    }
+
+    if (foundFrame->nFrameNum > desiredFrameNum) {
+        foundFrame = (skanGameFrame *)(frames + foundFrame->nPrevFrameIndex * frameSize);
+    }
+
+    return foundFrame;
+}
+
 typedef struct skelAnimDataGameHeader_s {
     int                  flags;
     size_t               nBytesUsed;
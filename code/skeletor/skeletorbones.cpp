@@ -165,46 +165,24 @@ void SkeletorLoadBonesFromBuffer(skelChannelList_c *boneList, skelHeaderGame_t *
 
 float *DecodeRLEPosValue(skanChannelHdr *channelFrames, int desiredFrameNum)
 {
-    skanGameFrame *foundFrame = channelFrames->ary_frames;
+    skanGameFrame *foundFrame;
     size_t         frameSize;
-    int            i;
 
     frameSize = (sizeof(skanGameFrame) - sizeof(skanGameFrame::pChannelData) + sizeof(vec3_t));
 
-    for (i = 0; i < channelFrames->nFramesInChannel; i++) {
-        if (foundFrame->nFrameNum >= desiredFrameNum) {
-            break;
-        }
-
-        foundFrame = (skanGameFrame *)((byte *)foundFrame + frameSize);
-    }
-
-    if (foundFrame->nFrameNum > desiredFrameNum) {
-        foundFrame = (skanGameFrame *)((byte *)channelFrames->ary_frames + foundFrame->nPrevFrameIndex * frameSize);
-    }
+    foundFrame = SkelFindChannelFrame(channelFrames, desiredFrameNum, frameSize);
 
     return foundFrame->pChannelData;
 }
 
 float *DecodeRLERotValue(skanChannelHdr *channelFrames, int desiredFrameNum)
 {
-    skanGameFrame *foundFrame = channelFrames->ary_frames;
+    skanGameFrame *foundFrame;
     size_t         frameSize;
-    int            i;
 
     frameSize = (sizeof(skanGameFrame) - sizeof(skanGameFrame::pChannelData) + sizeof(vec4_t));
 
-    for (i = 0; i < channelFrames->nFramesInChannel; i++) {
-        if (foundFrame->nFrameNum >= desiredFrameNum) {
-            break;
-        }
-
-        foundFrame = (skanGameFrame *)((byte *)foundFrame + frameSize);
-    }
-
-    if (foundFrame->nFrameNum > desiredFrameNum) {
-        foundFrame = (skanGameFrame *)((byte *)channelFrames->ary_frames + foundFrame->nPrevFrameIndex * frameSize);
-    }
+    foundFrame = SkelFindChannelFrame(channelFrames, desiredFrameNum, frameSize);
 
     return foundFrame->pChannelData;
 }